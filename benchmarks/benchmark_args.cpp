@@ -68,6 +68,19 @@ int parsePositiveIntArg(std::span<const std::string> args, std::string_view key,
     return fallback;
 }
 
+int parseNonNegativeIntArg(std::span<const std::string> args, std::string_view key, int fallback) {
+    for (const std::string& value : parseCsvArg(args, key)) {
+        char* end = nullptr;
+        errno = 0;
+        const long parsed = std::strtol(value.c_str(), &end, 10);
+        if (errno == 0 && end != value.c_str() && *end == '\0' && parsed >= 0 &&
+            parsed <= std::numeric_limits<int>::max()) {
+            return static_cast<int>(parsed);
+        }
+    }
+    return fallback;
+}
+
 int parsePositiveIntArg(int argc, char** argv, std::string_view key, int fallback) {
     std::vector<std::string> args;
     args.reserve(static_cast<std::size_t>(argc > 1 ? argc - 1 : 0));
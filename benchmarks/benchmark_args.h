@@ -9,6 +9,7 @@ namespace BenchmarkArgs {
 
 int parsePositiveIntArg(std::span<const std::string> args, std::string_view key, int fallback);
 int parsePositiveIntArg(int argc, char** argv, std::string_view key, int fallback);
+int parseNonNegativeIntArg(std::span<const std::string> args, std::string_view key, int fallback);
 std::string parseStringArg(std::span<const std::string> args, std::string_view key,
                            std::string_view fallback);
 std::vector<std::string> parseCsvArg(std::span<const std::string> args, std::string_view key);
@@ -0,0 +1,80 @@
+#include "benchmark_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace BenchmarkStats {
+namespace {
+constexpr double kNormalQuantile95 = 1.959964;
+
+double sortedMedian(const std::vector<double>& sorted) {
+    const std::size_t middle = sorted.size() / 2;
+    if (sorted.size() % 2 == 1) {
+        return sorted[middle];
+    }
+    return (sorted[middle - 1] + sorted[middle]) / 2.0;
+}
+
+std::string formatOptional(const std::optional<double>& value) {
+    return value ? std::format("{:.2f}", *value) : "null";
+}
+} // namespace
+
+Summary summarize(std::span<const double> values) {
+    Summary summary;
+    if (values.empty()) {
+        return summary;
+    }
+
+    std::vector<double> sorted(values.begin(), values.end());
+    std::ranges::sort(sorted);
+    summary.samples = sorted.size();
+    summary.median = sortedMedian(sorted);
+    summary.min = sorted.front();
+    summary.max = sorted.back();
+
+    std::vector<double> deviations;
+    deviations.reserve(sorted.size());
+    for (double value : sorted) {
+        deviations.push_back(std::abs(value - summary.median));
+    }
+    std::ranges::sort(deviations);
+    summary.mad = sortedMedian(deviations);
+    if (sorted.size() < kMinIntervalSamples) {
+        return summary;
+    }
+
+    // The 1-based ranks n/2 - z*sqrt(n)/2 and 1 + n/2 + z*sqrt(n)/2 bracket the median with ~95%
+    // coverage; with few samples they clamp to the extremes.
+    const double count = static_cast<double>(sorted.size());
+    const double halfWidth = kNormalQuantile95 * std::sqrt(count) / 2.0;
+    const auto lowRank = static_cast<std::ptrdiff_t>(std::floor(count / 2.0 - halfWidth)) - 1;
+    const auto highRank = static_cast<std::ptrdiff_t>(std::ceil(count / 2.0 + halfWidth));
+    const auto last = static_cast<std::ptrdiff_t>(sorted.size()) - 1;
+    summary.ciLow = sorted[static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(lowRank, 0, last))];
+    summary.ciHigh =
+        sorted[static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(highRank, 0, last))];
+    return summary;
+}
+
+std::string toJson(const Summary& summary) {
+    return std::format("{{\"samples\": {}, \"median\": {:.2f}, \"mad\": {:.2f}, \"min\": {:.2f}, "
+                       "\"max\": {:.2f}, \"ci_low\": {}, \"ci_high\": {}}}",
+                       summary.samples, summary.median, summary.mad, summary.min, summary.max,
+                       formatOptional(summary.ciLow), formatOptional(summary.ciHigh));
+}
+
+std::string intervalText(const Summary& summary) {
+    if (!summary.ciLow || !summary.ciHigh) {
+        return "n/a";
+    }
+    return std::format("[{:.0f}, {:.0f}]", *summary.ciLow, *summary.ciHigh);
+}
+
+} // namespace BenchmarkStats
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace BenchmarkStats {
+
+// Fewest samples whose range covers the median with 95% probability: min to max of n samples
+// misses it with probability 2 / 2^n, so five samples give only 94% and three 75%.
+inline constexpr std::size_t kMinIntervalSamples = 6;
+
+// Robust summary of repeated measurements of one quantity. The confidence interval is the
+// distribution-free 95% interval for the median, taken from the sample's order statistics, so a
+// single outlier run neither shifts the median nor widens the interval by much. It is empty with
+// fewer than kMinIntervalSamples samples.
+struct Summary {
+    std::size_t samples = 0;
+    double median = 0.0;
+    double mad = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    std::optional<double> ciLow;
+    std::optional<double> ciHigh;
+};
+
+Summary summarize(std::span<const double> values);
+std::string toJson(const Summary& summary);
+// "[low, high]", or "n/a" without an interval.
+std::string intervalText(const Summary& summary);
+
+} // namespace BenchmarkStats
@@ -7,12 +7,14 @@
 #include <algorithm>
 #include <cstddef>
 #include <format>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace BenchmarkSuite {
@@ -33,6 +35,60 @@ bool hasRequestedId(const PositionCase& position, std::span<const std::string> i
     return std::find(idFilters.begin(), idFilters.end(), position.id) != idFilters.end() ||
            std::find(idFilters.begin(), idFilters.end(), position.name) != idFilters.end();
 }
+
+std::string trimmed(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r");
+    return std::string(text.substr(first, last - first + 1));
+}
+
+// Splits `opcode operand;` pairs, leaving semicolons inside quoted operands alone.
+std::vector<std::pair<std::string, std::string>> parseEpdOperations(std::string_view text) {
+    std::vector<std::pair<std::string, std::string>> operations;
+    std::string current;
+    const auto flush = [&] {
+        const std::string operation = trimmed(current);
+        current.clear();
+        if (operation.empty()) {
+            return;
+        }
+        const auto split = operation.find_first_of(" \t");
+        std::string operand =
+            split == std::string::npos ? std::string{} : trimmed(operation.substr(split));
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+            operand = operand.substr(1, operand.size() - 2);
+        }
+        operations.emplace_back(operation.substr(0, split), operand);
+    };
+
+    bool quoted = false;
+    for (char character : text) {
+        if (character == '"') {
+            quoted = !quoted;
+        }
+        if (character == ';' && !quoted) {
+            flush();
+            continue;
+        }
+        current += character;
+    }
+    flush();
+    return operations;
+}
+
+std::vector<std::string> splitTags(std::string tags) {
+    std::ranges::replace(tags, ',', ' ');
+    std::istringstream stream(tags);
+    std::vector<std::string> split;
+    std::string tag;
+    while (stream >> tag) {
+        split.push_back(tag);
+    }
+    return split;
+}
 } // namespace
 
 std::vector<PositionCase> defaultCorpus() {
@@ -60,12 +116,62 @@ std::vector<PositionCase> defaultCorpus() {
     };
 }
 
+std::vector<PositionCase> loadEpdCorpus(const std::string& path) {
+    std::vector<PositionCase> corpus;
+    std::ifstream in(path);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.starts_with('#')) {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string placement;
+        std::string side;
+        std::string castling;
+        std::string enPassant;
+        if (!(fields >> placement >> side >> castling >> enPassant)) {
+            continue;
+        }
+        std::string operations;
+        std::getline(fields, operations);
+
+        PositionCase position;
+        position.id = std::format("epd{}", lineNumber);
+        std::string halfmoveClock = "0";
+        std::string fullmoveNumber = "1";
+        for (const auto& [opcode, operand] : parseEpdOperations(operations)) {
+            if (opcode == "id" && !operand.empty()) {
+                position.id = operand;
+            } else if (opcode == "c0") {
+                position.tags = splitTags(operand);
+            } else if (opcode == "hmvc" && !operand.empty()) {
+                halfmoveClock = operand;
+            } else if (opcode == "fmvn" && !operand.empty()) {
+                fullmoveNumber = operand;
+            }
+        }
+        position.name = position.id;
+        position.fen = std::format("{} {} {} {} {} {}", placement, side, castling, enPassant,
+                                   halfmoveClock, fullmoveNumber);
+        corpus.push_back(std::move(position));
+    }
+    return corpus;
+}
+
 std::vector<PositionCase> selectPositions(std::span<const std::string> args) {
     const std::vector<std::string> requestedIds = BenchmarkArgs::parseCsvArg(args, "--positions");
     const std::vector<std::string> requestedTags = BenchmarkArgs::parseCsvArg(args, "--tags");
+    const std::string epdPath = BenchmarkArgs::parseStringArg(args, "--epd", "");
+
+    std::vector<PositionCase> corpus = epdPath.empty() ? defaultCorpus() : loadEpdCorpus(epdPath);
+    if (!epdPath.empty() && corpus.empty()) {
+        std::cerr << "No positions loaded from EPD corpus: " << epdPath << '\n';
+    }
 
     std::vector<PositionCase> selected;
-    for (const auto& position : defaultCorpus()) {
+    for (const auto& position : corpus) {
         if (!hasRequestedId(position, requestedIds)) {
             continue;
         }
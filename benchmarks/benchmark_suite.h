@@ -20,6 +20,10 @@ struct PositionCase {
 };
 
 std::vector<PositionCase> defaultCorpus();
+// Each non-empty EPD line is one case: the first four fields are the position, an `id "..."`
+// operation names it and a `c0 "..."` operation lists its comma-separated tags. Selected with
+// --epd=<file> in place of the default corpus.
+std::vector<PositionCase> loadEpdCorpus(const std::string& path);
 std::vector<PositionCase> selectPositions(std::span<const std::string> args);
 OutputFormat parseOutputFormat(std::span<const std::string> args);
 std::string outputFormatName(OutputFormat format);
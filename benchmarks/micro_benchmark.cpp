@@ -1,12 +1,17 @@
 #include "benchmark_args.h"
 #include "benchmark_suite.h"
+#include "perf_counters.h"
 #include "src/core/ChessBoard.h"
+#include "src/evaluation/Evaluation.h"
 #include "src/search/AdvancedSearch.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -15,8 +20,22 @@ constexpr int kDefaultIterations = 2000000;
 struct MicroRow {
     std::string id;
     long long elapsedMs = 0;
+    PerfCounters::Sample counters;
 };
 
+// Runs one microbenchmark with the counters wrapped around it. The setup inside each benchmark is
+// counted too; it is negligible next to the timed loop.
+MicroRow measure(PerfCounters::Group& counters, std::string id,
+                 const std::function<long long()>& benchmark) {
+    counters.start();
+    const long long elapsedMs = benchmark();
+    return {std::move(id), elapsedMs, counters.stop()};
+}
+
+bool hasCounters(const std::vector<MicroRow>& rows) {
+    return std::ranges::any_of(rows, [](const MicroRow& row) { return row.counters.any(); });
+}
+
 long long benchNullMovePruning(const std::vector<Board>& boards, int iterations) {
     volatile int sink = 0;
     const auto start = std::chrono::steady_clock::now();
@@ -62,6 +81,23 @@ long long benchBookKeyPath(const std::vector<Board>& boards, int iterations) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 }
 
+long long benchEvaluatePosition(const std::vector<Board>& boards, int iterations,
+                                EvalTier maxTier) {
+    volatile int sink = 0;
+    EvalWindow window;
+    window.maxTier = maxTier;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        const Board& b = boards[static_cast<std::size_t>(i) % boards.size()];
+        sink += evaluateTiered(b, window).score;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    if (sink == -1) {
+        std::cerr << "unreachable\n";
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
 void printTextReport(const std::vector<MicroRow>& rows, int iterations, std::size_t corpusSize) {
     long long totalMs = 0;
     std::cout << "Micro benchmark\n";
@@ -72,6 +108,14 @@ void printTextReport(const std::vector<MicroRow>& rows, int iterations, std::siz
         std::cout << row.id << '\t' << row.elapsedMs << '\n';
     }
     std::cout << "TOTAL\ttotal_ms=" << totalMs << '\n';
+
+    if (!hasCounters(rows)) {
+        std::cout << "COUNTERS\tunavailable\n";
+        return;
+    }
+    for (const auto& row : rows) {
+        std::cout << "COUNTERS\t" << row.id << '\t' << PerfCounters::toText(row.counters) << '\n';
+    }
 }
 
 void printJsonReport(const std::vector<MicroRow>& rows, int iterations, std::size_t corpusSize) {
@@ -82,11 +126,13 @@ void printJsonReport(const std::vector<MicroRow>& rows, int iterations, std::siz
     std::cout << "{\n";
     std::cout << "  \"benchmark\": \"micro_benchmark\",\n";
     std::cout << "  \"config\": {\"iterations\": " << iterations
-              << ", \"corpus_size\": " << corpusSize << "},\n";
+              << ", \"corpus_size\": " << corpusSize
+              << ", \"perf_counters\": " << (hasCounters(rows) ? "true" : "false") << "},\n";
     std::cout << "  \"results\": [\n";
     for (std::size_t i = 0; i < rows.size(); ++i) {
         std::cout << "    {\"id\": \"" << BenchmarkSuite::jsonEscape(rows[i].id)
-                  << "\", \"elapsed_ms\": " << rows[i].elapsedMs << "}";
+                  << "\", \"elapsed_ms\": " << rows[i].elapsedMs
+                  << ", \"counters\": " << PerfCounters::toJson(rows[i].counters) << "}";
         if (i + 1 < rows.size()) {
             std::cout << ',';
         }
@@ -125,10 +171,19 @@ int main(int argc, char** argv) { // NOLINT(bugprone-exception-escape)
             boards.push_back(board);
         }
 
+        PerfCounters::Group counters;
         rows = {
-            {"nullMovePruning", benchNullMovePruning(boards, iterations)},
-            {"getGamePhase", benchGamePhase(boards, iterations)},
-            {"bookKeyPath", benchBookKeyPath(boards, iterations)},
+            measure(counters, "nullMovePruning",
+                    [&] { return benchNullMovePruning(boards, iterations); }),
+            measure(counters, "getGamePhase", [&] { return benchGamePhase(boards, iterations); }),
+            measure(counters, "bookKeyPath", [&] { return benchBookKeyPath(boards, iterations); }),
+            measure(counters, "evaluatePosition",
+                    [&] { return benchEvaluatePosition(boards, iterations, EvalTier::TACTICAL); }),
+            measure(counters, "evaluatePositionTier0",
+                    [&] { return benchEvaluatePosition(boards, iterations, EvalTier::MATERIAL); }),
+            measure(counters, "evaluatePositionTier2", [&] {
+                return benchEvaluatePosition(boards, iterations, EvalTier::POSITIONAL);
+            }),
         };
     }
 
@@ -0,0 +1,243 @@
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_COUNTERS_HAS_PERF_EVENT 1
+#else
+#define PERF_COUNTERS_HAS_PERF_EVENT 0
+#endif
+
+namespace PerfCounters {
+namespace {
+constexpr int kClosed = -1;
+constexpr std::array<Event, kEventCount> kEvents = {
+    Event::CYCLES,     Event::INSTRUCTIONS, Event::BRANCH_MISSES,
+    Event::L1D_MISSES, Event::LLC_MISSES,   Event::DTLB_MISSES,
+};
+
+#if PERF_COUNTERS_HAS_PERF_EVENT
+struct EventConfig {
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::uint64_t cacheReadMisses(std::uint64_t cache) {
+    return cache | (static_cast<std::uint64_t>(PERF_COUNT_HW_CACHE_OP_READ) << 8U) |
+           (static_cast<std::uint64_t>(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16U);
+}
+
+EventConfig eventConfig(Event event) {
+    switch (event) {
+        case Event::CYCLES:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        case Event::INSTRUCTIONS:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+        case Event::BRANCH_MISSES:
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+        case Event::L1D_MISSES:
+            return {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_L1D)};
+        case Event::LLC_MISSES:
+            return {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_LL)};
+        case Event::DTLB_MISSES:
+            return {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_DTLB)};
+    }
+    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+}
+
+int openEvent(Event event) {
+    const EventConfig config = eventConfig(event);
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = config.type;
+    attr.config = config.config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    // Kernel and hypervisor time is excluded so counting works at perf_event_paranoid=2.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    const long descriptor = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return descriptor < 0 ? kClosed : static_cast<int>(descriptor);
+}
+
+std::optional<Group::Reading> readCounter(int descriptor) {
+    Group::Reading reading;
+    static_assert(sizeof(reading) == 3 * sizeof(std::uint64_t));
+    if (read(descriptor, &reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading))) {
+        return std::nullopt;
+    }
+    return reading;
+}
+
+// The region's count, scaled by the share of the region the counter was scheduled.
+std::optional<std::uint64_t> scaledDifference(const Group::Reading& begin,
+                                              const Group::Reading& end) {
+    const std::uint64_t value = end.value - begin.value;
+    const std::uint64_t enabled = end.timeEnabled - begin.timeEnabled;
+    const std::uint64_t running = end.timeRunning - begin.timeRunning;
+    if (running == 0) {
+        return std::nullopt;
+    }
+    if (running >= enabled) {
+        return value;
+    }
+    return static_cast<std::uint64_t>(static_cast<double>(value) *
+                                      static_cast<double>(enabled) /
+                                      static_cast<double>(running));
+}
+#endif
+
+std::string formatCount(const std::optional<std::uint64_t>& count) {
+    return count ? std::to_string(*count) : "null";
+}
+} // namespace
+
+std::string_view eventName(Event event) {
+    switch (event) {
+        case Event::CYCLES:
+            return "cycles";
+        case Event::INSTRUCTIONS:
+            return "instructions";
+        case Event::BRANCH_MISSES:
+            return "branch_misses";
+        case Event::L1D_MISSES:
+            return "l1d_misses";
+        case Event::LLC_MISSES:
+            return "llc_misses";
+        case Event::DTLB_MISSES:
+            return "dtlb_misses";
+    }
+    return "unknown";
+}
+
+std::optional<std::uint64_t> Sample::count(Event event) const {
+    return counts[static_cast<std::size_t>(event)];
+}
+
+bool Sample::any() const {
+    return std::ranges::any_of(counts, [](const auto& count) { return count.has_value(); });
+}
+
+Sample total(std::span<const Sample> samples) {
+    Sample summed;
+    if (samples.empty()) {
+        return summed;
+    }
+    for (std::size_t index = 0; index < kEventCount; ++index) {
+        std::uint64_t sum = 0;
+        bool complete = true;
+        for (const Sample& sample : samples) {
+            if (!sample.counts[index]) {
+                complete = false;
+                break;
+            }
+            sum += *sample.counts[index];
+        }
+        if (complete) {
+            summed.counts[index] = sum;
+        }
+    }
+    return summed;
+}
+
+std::string toJson(const Sample& sample) {
+    std::string json = "{";
+    for (Event event : kEvents) {
+        json += std::format("\"{}\": {}, ", eventName(event), formatCount(sample.count(event)));
+    }
+    const auto cycles = sample.count(Event::CYCLES);
+    const auto instructions = sample.count(Event::INSTRUCTIONS);
+    if (cycles && instructions && *cycles > 0) {
+        json += std::format("\"ipc\": {:.3f}}}", static_cast<double>(*instructions) /
+                                                     static_cast<double>(*cycles));
+    } else {
+        json += "\"ipc\": null}";
+    }
+    return json;
+}
+
+std::string toText(const Sample& sample) {
+    std::string text;
+    for (Event event : kEvents) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += std::format("{}={}", eventName(event), formatCount(sample.count(event)));
+    }
+    return text;
+}
+
+Group::Group() {
+    descriptors.fill(kClosed);
+#if PERF_COUNTERS_HAS_PERF_EVENT
+    for (Event event : kEvents) {
+        descriptors[static_cast<std::size_t>(event)] = openEvent(event);
+    }
+#endif
+}
+
+Group::~Group() {
+#if PERF_COUNTERS_HAS_PERF_EVENT
+    for (int descriptor : descriptors) {
+        if (descriptor != kClosed) {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool Group::available() const {
+    return std::ranges::any_of(descriptors,
+                               [](int descriptor) { return descriptor != kClosed; });
+}
+
+void Group::start() {
+#if PERF_COUNTERS_HAS_PERF_EVENT
+    for (std::size_t index = 0; index < kEventCount; ++index) {
+        if (descriptors[index] != kClosed) {
+            started[index] = readCounter(descriptors[index]);
+        }
+    }
+    for (int descriptor : descriptors) {
+        if (descriptor != kClosed) {
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+Sample Group::stop() {
+    Sample sample;
+#if PERF_COUNTERS_HAS_PERF_EVENT
+    for (int descriptor : descriptors) {
+        if (descriptor != kClosed) {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (std::size_t index = 0; index < kEventCount; ++index) {
+        if (descriptors[index] == kClosed || !started[index]) {
+            continue;
+        }
+        if (const auto reading = readCounter(descriptors[index])) {
+            sample.counts[index] = scaledDifference(*started[index], *reading);
+        }
+    }
+#endif
+    started.fill(std::nullopt);
+    return sample;
+}
+
+} // namespace PerfCounters
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace PerfCounters {
+
+enum class Event : unsigned char {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_MISSES,
+    LLC_MISSES,
+    DTLB_MISSES,
+};
+
+inline constexpr std::size_t kEventCount = 6;
+
+std::string_view eventName(Event event);
+
+// Counts for one measured region. An event the kernel, CPU or permissions do not allow counting
+// stays empty, as does every event off Linux.
+struct Sample {
+    std::array<std::optional<std::uint64_t>, kEventCount> counts;
+
+    [[nodiscard]] std::optional<std::uint64_t> count(Event event) const;
+    [[nodiscard]] bool any() const;
+};
+
+// Per-event totals; an event missing from any sample is missing from the total.
+Sample total(std::span<const Sample> samples);
+std::string toJson(const Sample& sample);
+std::string toText(const Sample& sample);
+
+// User-space counters for the calling thread and threads it starts while counting. Each event is
+// opened on its own so one unsupported event does not take the others with it; multiplexed
+// counts are scaled to the full measured time. A region is the difference between the readings
+// at start() and stop(), since a reset clears neither the enabled and running times nor the
+// counts folded in from exited threads.
+class Group {
+public:
+    Group();
+    ~Group();
+    Group(const Group&) = delete;
+    Group& operator=(const Group&) = delete;
+    Group(Group&&) = delete;
+    Group& operator=(Group&&) = delete;
+
+    [[nodiscard]] bool available() const;
+    void start();
+    Sample stop();
+
+    // A counter value with its cumulative enabled and running times in nanoseconds.
+    struct Reading {
+        std::uint64_t value = 0;
+        std::uint64_t timeEnabled = 0;
+        std::uint64_t timeRunning = 0;
+    };
+
+private:
+    std::array<int, kEventCount> descriptors{};
+    std::array<std::optional<Reading>, kEventCount> started{};
+};
+
+} // namespace PerfCounters
@@ -1,5 +1,6 @@
 #include "benchmark_args.h"
 #include "benchmark_suite.h"
+#include "perf_counters.h"
 #include "src/core/ChessBoard.h"
 #include "src/core/ChessPiece.h"
 #include "src/core/Move.h"
@@ -25,8 +26,13 @@ struct PerftRow {
     std::uint64_t nodes = 0;
     long long elapsedMs = 0;
     double nps = 0.0;
+    PerfCounters::Sample counters;
 };
 
+bool hasCounters(const std::vector<PerftRow>& rows) {
+    return std::ranges::any_of(rows, [](const PerftRow& row) { return row.counters.any(); });
+}
+
 std::uint64_t perft(Board& board, ChessPieceColor color, int depth) {
     if (depth == 0) {
         return 1;
@@ -80,19 +86,29 @@ void printTextReport(const std::vector<PerftRow>& rows, int maxDepth) {
         std::cout << row.id << '\t' << row.depth << '\t' << row.nodes << '\t' << row.elapsedMs
                   << '\t' << row.nps << '\n';
     }
+
+    if (!hasCounters(rows)) {
+        std::cout << "COUNTERS\tunavailable\n";
+        return;
+    }
+    for (const auto& row : rows) {
+        std::cout << "COUNTERS\t" << row.id << '\t' << PerfCounters::toText(row.counters) << '\n';
+    }
 }
 
 void printJsonReport(const std::vector<PerftRow>& rows, int maxDepth) {
     std::cout << "{\n";
     std::cout << "  \"benchmark\": \"perft_benchmark\",\n";
-    std::cout << "  \"config\": {\"max_depth\": " << maxDepth << "},\n";
+    std::cout << "  \"config\": {\"max_depth\": " << maxDepth
+              << ", \"perf_counters\": " << (hasCounters(rows) ? "true" : "false") << "},\n";
     std::cout << "  \"results\": [\n";
     for (std::size_t i = 0; i < rows.size(); ++i) {
         const auto& row = rows[i];
         std::cout << "    {\"id\": \"" << BenchmarkSuite::jsonEscape(row.id)
                   << "\", \"position_name\": \"" << BenchmarkSuite::jsonEscape(row.positionName)
                   << "\", \"depth\": " << row.depth << ", \"nodes\": " << row.nodes
-                  << ", \"elapsed_ms\": " << row.elapsedMs << ", \"nps\": " << row.nps << "}";
+                  << ", \"elapsed_ms\": " << row.elapsedMs << ", \"nps\": " << row.nps
+                  << ", \"counters\": " << PerfCounters::toJson(row.counters) << "}";
         if (i + 1 < rows.size()) {
             std::cout << ',';
         }
@@ -121,20 +137,24 @@ int main(int argc, char** argv) { // NOLINT(bugprone-exception-escape)
     {
         BenchmarkSuite::ScopedStdoutSilencer silencer(format == BenchmarkSuite::OutputFormat::JSON);
         BenchmarkSuite::initializeEngineState();
+        PerfCounters::Group counters;
 
         for (const auto& position : positions) {
             for (int depth = 1; depth <= maxDepth; ++depth) {
                 Board board;
                 board.InitializeFromFEN(position.fen);
+                counters.start();
                 const auto start = std::chrono::steady_clock::now();
                 const std::uint64_t nodes = perft(board, board.turn, depth);
                 const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                                            std::chrono::steady_clock::now() - start)
                                            .count();
+                const PerfCounters::Sample sample = counters.stop();
                 const double elapsedSeconds =
                     std::max(0.001, static_cast<double>(elapsedMs) / 1000.0);
                 rows.push_back({std::format("{}:d{}", position.id, depth), position.name, depth,
-                                nodes, elapsedMs, static_cast<double>(nodes) / elapsedSeconds});
+                                nodes, elapsedMs, static_cast<double>(nodes) / elapsedSeconds,
+                                sample});
             }
         }
     }
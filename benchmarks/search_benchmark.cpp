@@ -1,5 +1,7 @@
 #include "benchmark_args.h"
+#include "benchmark_stats.h"
 #include "benchmark_suite.h"
+#include "perf_counters.h"
 #include "src/core/ChessBoard.h"
 #include "src/core/Move.h"
 #include "src/search/search.h"
@@ -11,6 +13,7 @@
 #include <cstddef>
 #include <format>
 #include <iostream>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -19,9 +22,12 @@ constexpr int kDefaultDepthLimit = 12;
 constexpr int kDefaultTimeMs = 2000;
 constexpr int kDefaultThreads = 1;
 constexpr int kDefaultRounds = 3;
+constexpr int kDefaultWarmupRounds = 1;
+constexpr double kPercentScale = 100.0;
 
 struct SearchRow {
     std::string id;
+    std::string caseId;
     std::string positionName;
     std::string fen;
     std::vector<std::string> tags;
@@ -31,17 +37,95 @@ struct SearchRow {
     int nodes = 0;
     long long elapsedMs = 0;
     long long nps = 0;
+    EvalCacheStats evalCache;
+    PerfCounters::Sample counters;
     Move bestMove{SearchConstants::kInvalidSquare, SearchConstants::kInvalidSquare};
 };
 
-void printTextReport(const std::vector<SearchRow>& rows, int rounds, int depthLimit, int timeMs,
-                     int threads) {
+// Per-position statistics over the measured rounds. Time to depth only counts rounds that finished
+// the requested depth inside the time limit.
+struct CaseStats {
+    std::string id;
+    std::string positionName;
+    BenchmarkStats::Summary nodes;
+    BenchmarkStats::Summary nps;
+    BenchmarkStats::Summary timeToDepthMs;
+    PerfCounters::Sample counters;
+};
+
+std::vector<CaseStats> summarizeCases(const std::vector<SearchRow>& rows,
+                                      std::span<const BenchmarkSuite::PositionCase> positions,
+                                      int depthLimit) {
+    std::vector<CaseStats> cases;
+    cases.reserve(positions.size());
+    for (const auto& position : positions) {
+        std::vector<double> nodes;
+        std::vector<double> nps;
+        std::vector<double> timeToDepthMs;
+        std::vector<PerfCounters::Sample> counters;
+        for (const auto& row : rows) {
+            if (row.caseId != position.id) {
+                continue;
+            }
+            nodes.push_back(static_cast<double>(row.nodes));
+            nps.push_back(static_cast<double>(row.nps));
+            counters.push_back(row.counters);
+            if (row.depthReached >= depthLimit) {
+                timeToDepthMs.push_back(static_cast<double>(row.elapsedMs));
+            }
+        }
+        cases.push_back({position.id, position.name, BenchmarkStats::summarize(nodes),
+                         BenchmarkStats::summarize(nps), BenchmarkStats::summarize(timeToDepthMs),
+                         PerfCounters::total(counters)});
+    }
+    return cases;
+}
+
+BenchmarkStats::Summary summarizeRoundNps(const std::vector<SearchRow>& rows, int rounds) {
+    std::vector<long long> nodes(static_cast<std::size_t>(rounds), 0);
+    std::vector<long long> elapsedMs(static_cast<std::size_t>(rounds), 0);
+    for (const auto& row : rows) {
+        const auto round = static_cast<std::size_t>(row.round - 1);
+        nodes[round] += row.nodes;
+        elapsedMs[round] += row.elapsedMs;
+    }
+    std::vector<double> nps;
+    nps.reserve(nodes.size());
+    for (std::size_t round = 0; round < nodes.size(); ++round) {
+        nps.push_back(static_cast<double>(nodes[round] * 1000LL) /
+                      static_cast<double>(std::max(1LL, elapsedMs[round])));
+    }
+    return BenchmarkStats::summarize(nps);
+}
+
+bool hasCounters(const std::vector<SearchRow>& rows) {
+    return std::ranges::any_of(rows, [](const SearchRow& row) { return row.counters.any(); });
+}
+
+double evalCacheHitRate(const EvalCacheStats& stats) {
+    if (stats.probes == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(stats.hits) / static_cast<double>(stats.probes);
+}
+
+EvalCacheStats totalEvalCacheStats(const std::vector<SearchRow>& rows) {
+    EvalCacheStats total;
+    for (const auto& row : rows) {
+        total.probes += row.evalCache.probes;
+        total.hits += row.evalCache.hits;
+    }
+    return total;
+}
+
+void printTextReport(const std::vector<SearchRow>& rows, const std::vector<CaseStats>& cases,
+                     int rounds, int warmup, int depthLimit, int timeMs, int threads) {
     long long totalNodes = 0;
     long long totalElapsedMs = 0;
 
     std::cout << "Search benchmark\n";
-    std::cout << "rounds=" << rounds << " depth=" << depthLimit << " time_ms=" << timeMs
-              << " threads=" << threads << "\n";
+    std::cout << "rounds=" << rounds << " warmup=" << warmup << " depth=" << depthLimit
+              << " time_ms=" << timeMs << " threads=" << threads << "\n";
     std::cout << "id\tdepth\tscore\tnodes\telapsed_ms\tnps\tbestmove\ttags\n";
 
     for (const auto& row : rows) {
@@ -54,12 +138,35 @@ void printTextReport(const std::vector<SearchRow>& rows, int rounds, int depthLi
     }
 
     const long long totalNps = (totalNodes * 1000LL) / std::max(1LL, totalElapsedMs);
+    const EvalCacheStats evalCache = totalEvalCacheStats(rows);
     std::cout << "TOTAL\tnodes=" << totalNodes << "\telapsed_ms=" << totalElapsedMs
               << "\tnps=" << totalNps << '\n';
+    std::cout << std::format("EVAL_CACHE\tprobes={}\thits={}\thit_rate={:.1f}%\n",
+                             evalCache.probes, evalCache.hits,
+                             evalCacheHitRate(evalCache) * kPercentScale);
+
+    std::cout << "case\tnps_median\tnps_mad\tnps_ci95\tttd_median_ms\tttd_ci95_ms\tcompleted\n";
+    for (const auto& stats : cases) {
+        std::cout << std::format(
+            "{}\t{:.0f}\t{:.0f}\t{}\t{:.0f}\t{}\t{}/{}\n", stats.id, stats.nps.median,
+            stats.nps.mad, BenchmarkStats::intervalText(stats.nps), stats.timeToDepthMs.median,
+            BenchmarkStats::intervalText(stats.timeToDepthMs), stats.timeToDepthMs.samples,
+            stats.nps.samples);
+    }
+
+    if (!hasCounters(rows)) {
+        std::cout << "COUNTERS\tunavailable\n";
+        return;
+    }
+    for (const auto& stats : cases) {
+        std::cout << "COUNTERS\t" << stats.id << '\t' << PerfCounters::toText(stats.counters)
+                  << '\n';
+    }
 }
 
-void printJsonReport(const std::vector<SearchRow>& rows, int rounds, int depthLimit, int timeMs,
-                     int threads) {
+void printJsonReport(const std::vector<SearchRow>& rows, const std::vector<CaseStats>& cases,
+                     const BenchmarkStats::Summary& roundNps, int rounds, int warmup,
+                     int depthLimit, int timeMs, int threads) {
     long long totalNodes = 0;
     long long totalElapsedMs = 0;
     for (const auto& row : rows) {
@@ -70,8 +177,10 @@ void printJsonReport(const std::vector<SearchRow>& rows, int rounds, int depthLi
 
     std::cout << "{\n";
     std::cout << "  \"benchmark\": \"search_benchmark\",\n";
-    std::cout << "  \"config\": {\"rounds\": " << rounds << ", \"depth\": " << depthLimit
-              << ", \"time_ms\": " << timeMs << ", \"threads\": " << threads << "},\n";
+    std::cout << "  \"config\": {\"rounds\": " << rounds << ", \"warmup\": " << warmup
+              << ", \"depth\": " << depthLimit << ", \"time_ms\": " << timeMs
+              << ", \"threads\": " << threads
+              << ", \"perf_counters\": " << (hasCounters(rows) ? "true" : "false") << "},\n";
     std::cout << "  \"results\": [\n";
     for (std::size_t i = 0; i < rows.size(); ++i) {
         const auto& row = rows[i];
@@ -80,6 +189,11 @@ void printJsonReport(const std::vector<SearchRow>& rows, int rounds, int depthLi
                   << "\", \"round\": " << row.round << ", \"depth_reached\": " << row.depthReached
                   << ", \"score\": " << row.score << ", \"nodes\": " << row.nodes
                   << ", \"elapsed_ms\": " << row.elapsedMs << ", \"nps\": " << row.nps
+                  << ", \"eval_cache_probes\": " << row.evalCache.probes
+                  << ", \"eval_cache_hits\": " << row.evalCache.hits
+                  << ", \"eval_cache_hit_rate\": "
+                  << std::format("{:.4f}", evalCacheHitRate(row.evalCache))
+                  << ", \"counters\": " << PerfCounters::toJson(row.counters)
                   << ", \"bestmove\": \""
                   << BenchmarkSuite::jsonEscape(chess::format::moveToUci(row.bestMove))
                   << "\", \"fen\": \"" << BenchmarkSuite::jsonEscape(row.fen) << "\", \"tags\": [";
@@ -96,8 +210,30 @@ void printJsonReport(const std::vector<SearchRow>& rows, int rounds, int depthLi
         std::cout << '\n';
     }
     std::cout << "  ],\n";
+    std::cout << "  \"cases\": [\n";
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        const auto& stats = cases[i];
+        std::cout << "    {\"id\": \"" << BenchmarkSuite::jsonEscape(stats.id)
+                  << "\", \"position_name\": \"" << BenchmarkSuite::jsonEscape(stats.positionName)
+                  << "\", \"nodes\": " << BenchmarkStats::toJson(stats.nodes)
+                  << ", \"nps\": " << BenchmarkStats::toJson(stats.nps)
+                  << ", \"time_to_depth_ms\": "
+                  << (stats.timeToDepthMs.samples > 0 ? BenchmarkStats::toJson(stats.timeToDepthMs)
+                                                      : "null")
+                  << ", \"counters\": " << PerfCounters::toJson(stats.counters) << "}";
+        if (i + 1 < cases.size()) {
+            std::cout << ',';
+        }
+        std::cout << '\n';
+    }
+    std::cout << "  ],\n";
+    const EvalCacheStats evalCache = totalEvalCacheStats(rows);
     std::cout << "  \"summary\": {\"nodes\": " << totalNodes
-              << ", \"elapsed_ms\": " << totalElapsedMs << ", \"nps\": " << totalNps << "}\n";
+              << ", \"elapsed_ms\": " << totalElapsedMs << ", \"nps\": " << totalNps
+              << ", \"eval_cache_probes\": " << evalCache.probes
+              << ", \"eval_cache_hits\": " << evalCache.hits << ", \"eval_cache_hit_rate\": "
+              << std::format("{:.4f}", evalCacheHitRate(evalCache))
+              << ", \"round_nps\": " << BenchmarkStats::toJson(roundNps) << "}\n";
     std::cout << "}\n";
 }
 } // namespace
@@ -108,6 +244,8 @@ int main(int argc, char** argv) { // NOLINT(bugprone-exception-escape)
     const int timeMs = BenchmarkArgs::parsePositiveIntArg(args, "--time_ms", kDefaultTimeMs);
     const int threads = BenchmarkArgs::parsePositiveIntArg(args, "--threads", kDefaultThreads);
     const int rounds = BenchmarkArgs::parsePositiveIntArg(args, "--rounds", kDefaultRounds);
+    const int warmup =
+        BenchmarkArgs::parseNonNegativeIntArg(args, "--warmup", kDefaultWarmupRounds);
     const BenchmarkSuite::OutputFormat format = BenchmarkSuite::parseOutputFormat(args);
     const std::vector<BenchmarkSuite::PositionCase> positions =
         BenchmarkSuite::selectPositions(args);
@@ -132,21 +270,35 @@ int main(int argc, char** argv) { // NOLINT(bugprone-exception-escape)
 
         SearchContext searchContext;
         searchContext.threads = threads;
+        PerfCounters::Group counters;
+
+        // Warm-up rounds fault in the search tables and let the CPU clock settle; their timings
+        // are discarded.
+        for (int round = 0; round < warmup; ++round) {
+            for (const auto& position : positions) {
+                Board board;
+                board.InitializeFromFEN(position.fen);
+                iterativeDeepeningParallel(board, config, searchContext);
+            }
+        }
 
         for (int round = 1; round <= rounds; ++round) {
             for (const auto& position : positions) {
                 Board board;
                 board.InitializeFromFEN(position.fen);
 
+                counters.start();
                 const auto start = std::chrono::steady_clock::now();
                 const SearchResult result =
                     iterativeDeepeningParallel(board, config, searchContext);
                 const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                                            std::chrono::steady_clock::now() - start)
                                            .count();
+                const PerfCounters::Sample sample = counters.stop();
 
                 SearchRow row;
                 row.id = std::format("round{}:{}", round, position.id);
+                row.caseId = position.id;
                 row.positionName = position.name;
                 row.fen = position.fen;
                 row.tags = position.tags;
@@ -157,15 +309,19 @@ int main(int argc, char** argv) { // NOLINT(bugprone-exception-escape)
                 row.elapsedMs = elapsedMs;
                 row.nps = (result.nodes * 1000LL) / std::max(1LL, elapsedMs);
                 row.bestMove = result.bestMove;
+                row.evalCache = result.evalCache;
+                row.counters = sample;
                 rows.push_back(row);
             }
         }
     }
 
+    const std::vector<CaseStats> cases = summarizeCases(rows, positions, depthLimit);
     if (format == BenchmarkSuite::OutputFormat::JSON) {
-        printJsonReport(rows, rounds, depthLimit, timeMs, threads);
+        printJsonReport(rows, cases, summarizeRoundNps(rows, rounds), rounds, warmup, depthLimit,
+                        timeMs, threads);
     } else {
-        printTextReport(rows, rounds, depthLimit, timeMs, threads);
+        printTextReport(rows, cases, rounds, warmup, depthLimit, timeMs, threads);
     }
 
     return 0;
@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 
+import argparse
 import json
 import sys
 
@@ -25,13 +26,106 @@ def result_rows(payload):
     return []
 
 
-def main() -> int:
-    if len(sys.argv) != 3:
-        print("usage: compare_bench.py old.json new.json", file=sys.stderr)
-        return 2
+# Repeated-run statistics compared per case, with whether a higher median is better.
+CASE_METRICS = (("nps", True), ("time_to_depth_ms", False))
+
+
+def is_summary(value):
+    return isinstance(value, dict) and {"median", "ci_low", "ci_high"} <= set(value)
+
+
+def has_interval(stats):
+    """Summaries of fewer than six samples carry null bounds: their range would cover the
+    median less than 95% of the time."""
+    return stats["ci_low"] is not None and stats["ci_high"] is not None
+
+
+def significant_change(old_stats, new_stats, min_change_pct):
+    """A change counts only when the 95% intervals of the two medians do not overlap
+    and the medians differ by at least min_change_pct percent."""
+    overlap = (
+        old_stats["ci_high"] >= new_stats["ci_low"]
+        and new_stats["ci_high"] >= old_stats["ci_low"]
+    )
+    if overlap:
+        return False
+    if old_stats["median"] == 0:
+        return new_stats["median"] != 0
+    pct = abs(new_stats["median"] - old_stats["median"]) / old_stats["median"] * 100.0
+    return pct >= min_change_pct
+
+
+def format_interval(stats):
+    return f"{stats['median']:.0f} [{stats['ci_low']:.0f}, {stats['ci_high']:.0f}]"
+
+
+def compare_cases(old, new, min_change_pct):
+    old_cases = {case["id"]: case for case in old.get("cases", []) if "id" in case}
+    new_cases = {case["id"]: case for case in new.get("cases", []) if "id" in case}
+    regressions = 0
+    flagged = 0
+    skipped = 0
+    for case_id in sorted(set(old_cases) & set(new_cases)):
+        for metric, higher_is_better in CASE_METRICS:
+            old_stats = old_cases[case_id].get(metric)
+            new_stats = new_cases[case_id].get(metric)
+            if not is_summary(old_stats) or not is_summary(new_stats):
+                continue
+            if not has_interval(old_stats) or not has_interval(new_stats):
+                skipped += 1
+                print(f"  SKIPPED   {case_id} {metric}: too few rounds for a 95% interval")
+                continue
+            if not significant_change(old_stats, new_stats, min_change_pct):
+                continue
+            old_median = old_stats["median"]
+            new_median = new_stats["median"]
+            improved = (new_median > old_median) == higher_is_better
+            delta = new_median - old_median
+            pct = 0.0 if old_median == 0 else (delta / old_median) * 100.0
+            flagged += 1
+            regressions += 0 if improved else 1
+            verdict = "IMPROVED " if improved else "REGRESSED"
+            print(
+                f"  {verdict} {case_id} {metric}: {format_interval(old_stats)} -> "
+                f"{format_interval(new_stats)} ({pct:+.2f}%)"
+            )
+    compared = len(set(old_cases) & set(new_cases))
+    print(
+        f"\n{flagged} significant change(s), {regressions} regression(s) across "
+        f"{compared} case(s); everything else is within run-to-run noise"
+    )
+    if skipped:
+        print(
+            f"warning: {skipped} comparison(s) skipped; rerun both reports with --rounds=6 "
+            "or more",
+            file=sys.stderr,
+        )
+    return regressions, skipped
 
-    old = load(sys.argv[1])
-    new = load(sys.argv[2])
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="Compare two benchmark JSON reports. Reports with repeated-run "
+        "case statistics are compared by confidence interval; others are diffed field "
+        "by field."
+    )
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument(
+        "--min-change",
+        type=float,
+        default=1.0,
+        help="smallest median change in percent worth flagging (default 1.0)",
+    )
+    parser.add_argument(
+        "--fail-on-regression",
+        action="store_true",
+        help="exit with status 1 when any case regresses significantly",
+    )
+    args = parser.parse_args()
+
+    old = load(args.old)
+    new = load(args.new)
 
     if old.get("benchmark") != new.get("benchmark"):
         print("benchmark names do not match", file=sys.stderr)
@@ -40,6 +134,16 @@ def main() -> int:
     benchmark = old.get("benchmark", "unknown")
     print(f"Benchmark: {benchmark}")
 
+    if old.get("cases") and new.get("cases"):
+        regressions, skipped = compare_cases(old, new, args.min_change)
+        if args.fail_on_regression and skipped:
+            print(
+                "cannot check for regressions without confidence intervals",
+                file=sys.stderr,
+            )
+            return 2
+        return 1 if regressions and args.fail_on_regression else 0
+
     old_rows = {row["id"]: row for row in result_rows(old) if "id" in row}
     new_rows = {row["id"]: row for row in result_rows(new) if "id" in row}
     row_ids = sorted(set(old_rows) & set(new_rows))
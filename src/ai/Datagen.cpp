@@ -0,0 +1,258 @@
+#include "Datagen.h"
+#include "../core/GameRules.h"
+#include "../search/ValidMoves.h"
+#include "../search/search.h"
+#include "../utils/ThreadPool.h"
+#include "ChessBoard.h"
+#include "PositionFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Datagen {
+
+namespace {
+constexpr const char* kStartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+// Search scores beyond this are mates, which say nothing about the evaluation.
+constexpr int kMateThreshold = 9000;
+constexpr int kFiftyMovePlies = 100;
+constexpr std::uint8_t kBlackWon = 0;
+constexpr std::uint8_t kDraw = 1;
+constexpr std::uint8_t kWhiteWon = 2;
+constexpr int kProgressReports = 20;
+
+struct GamePosition {
+    PositionFile::PackedPosition packed;
+    std::uint64_t key = 0;
+};
+
+struct GameRecord {
+    std::vector<GamePosition> positions;
+    std::size_t filtered = 0;
+};
+
+std::vector<Move> legalMoves(Board& board) {
+    std::vector<Move> moves;
+    for (const auto& move : GetAllMoves(board, board.turn)) {
+        if (IsMoveLegal(board, move.first, move.second)) {
+            moves.push_back(move);
+        }
+    }
+    return moves;
+}
+
+void playMove(Board& board, const Move& move) {
+    applySearchMove(board, move.first, move.second);
+    board.turn =
+        board.turn == ChessPieceColor::WHITE ? ChessPieceColor::BLACK : ChessPieceColor::WHITE;
+    board.updateBitboards();
+}
+
+bool isPromotion(const Board& board, const Move& move) {
+    const int row = move.second / 8;
+    return board.squares[move.first].piece.PieceType == ChessPieceType::PAWN &&
+           (row == 0 || row == 7);
+}
+
+std::optional<std::uint8_t> terminalResult(Board& board, const std::vector<std::uint64_t>& history,
+                                           std::uint64_t key) {
+    switch (checkGameState(board)) {
+        case GameState::CHECKMATE_WHITE_WINS:
+            return kWhiteWon;
+        case GameState::CHECKMATE_BLACK_WINS:
+            return kBlackWon;
+        case GameState::ONGOING:
+            break;
+        default:
+            return kDraw;
+    }
+    if (board.halfmoveClock >= kFiftyMovePlies || std::ranges::count(history, key) >= 2) {
+        return kDraw;
+    }
+    return std::nullopt;
+}
+
+// Plays one game into record, leaving it empty if the opening plies already ended the game.
+void playGame(const Config& config, const std::vector<std::string>& openings, int index,
+              ParallelSearchContext& context, GameRecord& record) {
+    record.positions.clear();
+    record.filtered = 0;
+    std::seed_seq seed{config.seed, static_cast<std::uint32_t>(index)};
+    std::mt19937 rng(seed);
+
+    Board board;
+    if (openings.empty()) {
+        board.InitializeFromFEN(kStartFen);
+    } else {
+        std::uniform_int_distribution<std::size_t> pick(0, openings.size() - 1);
+        board.InitializeFromFEN(openings[pick(rng)]);
+    }
+    for (int ply = 0; ply < config.randomPlies; ++ply) {
+        const std::vector<Move> moves = legalMoves(board);
+        if (moves.empty()) {
+            return;
+        }
+        std::uniform_int_distribution<std::size_t> pick(0, moves.size() - 1);
+        playMove(board, moves[pick(rng)]);
+    }
+
+    context.transTable.clear();
+    // ComputeZobrist leaves out white pawns, so repetitions and duplicates are judged on the full
+    // key with board.pawnKey folded in. The search keeps its own ComputeZobrist history.
+    std::vector<std::uint64_t> history;
+    std::vector<std::uint64_t> searchHistory;
+    std::uint8_t result = kDraw;
+    int winStreak = 0;
+    int lossStreak = 0;
+    int drawStreak = 0;
+    for (int ply = 0; ply < config.maxPlies; ++ply) {
+        const std::uint64_t searchKey = ComputeZobrist(board);
+        const std::uint64_t key = searchKey ^ board.pawnKey;
+        if (const auto terminal = terminalResult(board, history, key)) {
+            result = *terminal;
+            break;
+        }
+
+        context.repetitionHistory = searchHistory;
+        const SearchResult search =
+            searchFixedNodes(board, context, config.nodes, config.maxDepth);
+        if (!search.bestMove.isValid()) {
+            break;
+        }
+
+        const bool quiet = !isInCheck(board, board.turn) &&
+                           !isCapture(board, search.bestMove.first, search.bestMove.second) &&
+                           !isPromotion(board, search.bestMove) &&
+                           std::abs(search.score) < kMateThreshold;
+        GamePosition position;
+        if (quiet && PositionFile::PackedPosition::pack(board, search.score, 0.5F,
+                                                         position.packed)) {
+            position.key = key;
+            record.positions.push_back(position);
+        } else {
+            ++record.filtered;
+        }
+
+        winStreak = search.score >= config.winScore ? winStreak + 1 : 0;
+        lossStreak = search.score <= -config.winScore ? lossStreak + 1 : 0;
+        drawStreak = ply >= config.drawMinPly && std::abs(search.score) <= config.drawScore
+                         ? drawStreak + 1
+                         : 0;
+        if (winStreak >= config.winPlies) {
+            result = kWhiteWon;
+            break;
+        }
+        if (lossStreak >= config.winPlies) {
+            result = kBlackWon;
+            break;
+        }
+        if (drawStreak >= config.drawPlies) {
+            break;
+        }
+
+        history.push_back(key);
+        searchHistory.push_back(searchKey);
+        playMove(board, search.bestMove);
+    }
+
+    for (auto& position : record.positions) {
+        position.packed.result = result;
+    }
+}
+} // namespace
+
+std::vector<std::string> loadOpenings(const std::string& path) {
+    std::vector<std::string> openings;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string placement;
+        std::string side;
+        std::string castling;
+        std::string enPassant;
+        if (fields >> placement >> side >> castling >> enPassant) {
+            openings.push_back(placement + " " + side + " " + castling + " " + enPassant + " 0 1");
+        }
+    }
+    return openings;
+}
+
+std::optional<Stats> generate(const Config& config, const std::vector<std::string>& openings,
+                              const std::string& path) {
+    PositionFile::WriterOptions options;
+    options.compress = config.compress;
+    // Chunks are compressed inline on whichever worker fills one; the workers are busy searching.
+    options.threads = 1;
+    PositionFile::Writer writer(path, options);
+    if (!writer.isOpen()) {
+        return std::nullopt;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(config.threads);
+    std::cout << "Datagen workers: " << pool.size() << '\n';
+    const int reportInterval = std::max(1, config.games / kProgressReports);
+    std::atomic<int> nextGame{0};
+    std::mutex outputMutex;
+    std::unordered_set<std::uint64_t> seen;
+    Stats stats;
+    auto elapsedSeconds = [&start] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    pool.run(static_cast<std::size_t>(pool.size()), [&](std::size_t) {
+        auto context = std::make_unique<ParallelSearchContext>(1);
+        context->transTable.resize(static_cast<std::size_t>(std::max(1, config.hashMb)));
+        GameRecord record;
+        while (true) {
+            const int game = nextGame.fetch_add(1, std::memory_order_relaxed);
+            if (game >= config.games) {
+                break;
+            }
+            playGame(config, openings, game, *context, record);
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            for (const auto& position : record.positions) {
+                if (seen.insert(position.key).second) {
+                    writer.write(position.packed);
+                    ++stats.positions;
+                } else {
+                    ++stats.duplicates;
+                }
+            }
+            stats.filtered += record.filtered;
+            if (++stats.games % static_cast<std::size_t>(reportInterval) == 0) {
+                std::cout << "Games " << stats.games << "/" << config.games << ", "
+                          << stats.positions << " positions, "
+                          << static_cast<long long>(static_cast<double>(stats.positions) /
+                                                    elapsedSeconds())
+                          << " positions/sec" << '\n';
+            }
+        }
+    });
+
+    if (!writer.close()) {
+        return std::nullopt;
+    }
+    stats.seconds = elapsedSeconds();
+    stats.positionsPerSecond =
+        stats.seconds > 0.0 ? static_cast<double>(stats.positions) / stats.seconds : 0.0;
+    return stats;
+}
+
+} // namespace Datagen
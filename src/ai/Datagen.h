@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Self-play training data: games between fixed-node searches, started from random plies after a
+// book position, with quiet positions written to a PositionFile.
+namespace Datagen {
+
+struct Config {
+    int games = 1000;
+    // Each worker plays whole games on its own search context; 0 uses every core.
+    int threads = 0;
+    int nodes = 5000;
+    int maxDepth = 32;
+    int hashMb = 16;
+    // Uniformly random legal moves played from the book position before the searches start.
+    int randomPlies = 8;
+    int maxPlies = 400;
+    std::uint32_t seed = 1;
+    // A game is adjudicated as won once the score stays beyond winScore for winPlies plies in a
+    // row, and as drawn once it stays within drawScore for drawPlies plies after drawMinPly.
+    int winScore = 2000;
+    int winPlies = 4;
+    int drawScore = 10;
+    int drawPlies = 12;
+    int drawMinPly = 80;
+    bool compress = true;
+};
+
+struct Stats {
+    std::size_t games = 0;
+    std::size_t positions = 0;
+    // Positions dropped because an earlier game already wrote the same position.
+    std::size_t duplicates = 0;
+    // In-check positions, positions whose best move is a capture or promotion, and mate scores.
+    std::size_t filtered = 0;
+    double seconds = 0.0;
+    double positionsPerSecond = 0.0;
+};
+
+// The first four fields of every non-empty line of an EPD file, completed to a FEN.
+std::vector<std::string> loadOpenings(const std::string& path);
+
+// Plays config.games games from openings (the start position if empty) and writes the kept
+// positions to path. Returns nullopt if the output file could not be written.
+std::optional<Stats> generate(const Config& config, const std::vector<std::string>& openings,
+                              const std::string& path);
+
+} // namespace Datagen
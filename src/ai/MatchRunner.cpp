@@ -0,0 +1,372 @@
+#include "MatchRunner.h"
+#include "../core/GameRules.h"
+#include "../core/PackedScore.h"
+#include "../evaluation/Evaluation.h"
+#include "../search/ValidMoves.h"
+#include "../search/search.h"
+#include "../utils/ThreadPool.h"
+#include "../utils/TunableParams.h"
+#include "ChessBoard.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MatchRunner {
+
+namespace {
+constexpr const char* kStartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr int kFiftyMovePlies = 100;
+constexpr int kMovesToGo = 20;
+constexpr int kMoveOverheadMs = 5;
+constexpr double kWhiteWin = 1.0;
+constexpr double kDrawScore = 0.5;
+constexpr double kBlackWin = 0.0;
+constexpr double kConfidence95 = 1.959964;
+constexpr double kEloScale = 400.0;
+// Pair scores are clamped this far inside (0, 1) so a one-sided match still has a finite Elo.
+constexpr double kScoreEpsilon = 1e-6;
+
+// An engine as one worker plays it: the shared configuration, the piece-square table built from
+// its parameters, and the worker's own search context.
+struct Player {
+    const Engine* engine = nullptr;
+    const PsqTable::Table* table = nullptr;
+    std::unique_ptr<ParallelSearchContext> context;
+};
+
+// Points the calling thread's search and evaluation at one engine, restoring the previous
+// binding when destroyed.
+class ThreadBinding {
+public:
+    ThreadBinding()
+        : tunables(TunableRegistry::threadValues), params(ParamPack::current),
+          table(PsqTable::current) {}
+
+    ~ThreadBinding() {
+        TunableRegistry::threadValues = tunables;
+        ParamPack::current = params;
+        PsqTable::current = table;
+    }
+
+    ThreadBinding(const ThreadBinding&) = delete;
+    ThreadBinding& operator=(const ThreadBinding&) = delete;
+
+    static void bind(const Player& player) {
+        TunableRegistry::threadValues = &player.engine->tunables;
+        ParamPack::current = &player.engine->params;
+        PsqTable::current = player.table;
+    }
+
+private:
+    const std::vector<int>* tunables;
+    const ParamPack::Pack* params;
+    const PsqTable::Table* table;
+};
+
+double expectedScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / kEloScale));
+}
+
+double scoreToElo(double score) {
+    const double clamped = std::clamp(score, kScoreEpsilon, 1.0 - kScoreEpsilon);
+    return -kEloScale * std::log10((1.0 / clamped) - 1.0);
+}
+
+// Mean and variance of the per-game score over the pairs, each pair counting as one sample.
+std::pair<double, double> pairScoreMoments(const Stats& stats, int& count) {
+    count = 0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (std::size_t points = 0; points < stats.pairs.size(); ++points) {
+        const double score = static_cast<double>(points) / 4.0;
+        const auto n = static_cast<double>(stats.pairs[points]);
+        count += stats.pairs[points];
+        sum += n * score;
+        sumSquares += n * score * score;
+    }
+    if (count == 0) {
+        return {kDrawScore, 0.0};
+    }
+    const double mean = sum / count;
+    return {mean, std::max(0.0, (sumSquares / count) - (mean * mean))};
+}
+
+std::vector<Move> legalMoves(Board& board) {
+    std::vector<Move> moves;
+    for (const auto& move : GetAllMoves(board, board.turn)) {
+        if (IsMoveLegal(board, move.first, move.second)) {
+            moves.push_back(move);
+        }
+    }
+    return moves;
+}
+
+void playMove(Board& board, const Move& move) {
+    applySearchMove(board, move.first, move.second);
+    board.turn =
+        board.turn == ChessPieceColor::WHITE ? ChessPieceColor::BLACK : ChessPieceColor::WHITE;
+    board.updateBitboards();
+}
+
+std::optional<double> terminalScore(Board& board, const std::vector<std::uint64_t>& history,
+                                    std::uint64_t key) {
+    switch (checkGameState(board)) {
+        case GameState::CHECKMATE_WHITE_WINS:
+            return kWhiteWin;
+        case GameState::CHECKMATE_BLACK_WINS:
+            return kBlackWin;
+        case GameState::ONGOING:
+            break;
+        default:
+            return kDrawScore;
+    }
+    if (board.halfmoveClock >= kFiftyMovePlies || std::ranges::count(history, key) >= 2) {
+        return kDrawScore;
+    }
+    return std::nullopt;
+}
+
+// The position both games of a pair start from, or nullopt if the random plies ended the game.
+std::optional<std::string> pairOpening(const Config& config,
+                                       const std::vector<std::string>& openings, int pair) {
+    Board board;
+    board.InitializeFromFEN(openings.empty()
+                                ? std::string(kStartFen)
+                                : openings[static_cast<std::size_t>(pair) % openings.size()]);
+    std::seed_seq seed{config.seed, static_cast<std::uint32_t>(pair)};
+    std::mt19937 rng(seed);
+    for (int ply = 0; ply < config.randomPlies; ++ply) {
+        const std::vector<Move> moves = legalMoves(board);
+        if (moves.empty()) {
+            return std::nullopt;
+        }
+        std::uniform_int_distribution<std::size_t> pick(0, moves.size() - 1);
+        playMove(board, moves[pick(rng)]);
+    }
+    return board.toFEN();
+}
+
+// Cached evaluations belong to the engine that computed them, and a worker's context is rebound to
+// new engines between matches (SPSA perturbs them every iteration), so each game starts empty.
+void clearCaches(ParallelSearchContext& context) {
+    context.transTable.clear();
+    context.evalCache.clear();
+    context.pawnHash.clear();
+    context.materialHash.clear();
+}
+
+// Plays one game and returns white's score.
+double playGame(const Config& config, const std::string& fen, std::array<Player*, 2> players) {
+    Board board;
+    board.InitializeFromFEN(fen);
+    for (Player* player : players) {
+        clearCaches(*player->context);
+    }
+    std::array<int, 2> clocks = {config.baseMs, config.baseMs};
+    // ComputeZobrist leaves out white pawns, so repetitions are judged on the full key with
+    // board.pawnKey folded in. The search keeps its own ComputeZobrist history.
+    std::vector<std::uint64_t> history;
+    std::vector<std::uint64_t> searchHistory;
+    int winStreak = 0;
+    int lossStreak = 0;
+    int drawStreak = 0;
+    for (int ply = 0; ply < config.maxPlies; ++ply) {
+        const std::uint64_t searchKey = ComputeZobrist(board);
+        const std::uint64_t key = searchKey ^ board.pawnKey;
+        if (const auto terminal = terminalScore(board, history, key)) {
+            return *terminal;
+        }
+
+        const std::size_t side = board.turn == ChessPieceColor::WHITE ? 0 : 1;
+        Player& player = *players[side];
+        ThreadBinding::bind(player);
+        // The incremental score was kept with the other engine's table.
+        board.psqScore = computePsqScore(board);
+        player.context->repetitionHistory = searchHistory;
+
+        SearchResult search;
+        if (config.nodes > 0) {
+            search = searchFixedNodes(board, *player.context, config.nodes, config.maxDepth);
+        } else {
+            const int budget =
+                std::clamp((clocks[side] / kMovesToGo) + (config.incrementMs * 3 / 4), 1,
+                           std::max(1, clocks[side] - kMoveOverheadMs));
+            search = searchFixedNodes(board, *player.context, std::numeric_limits<int>::max(),
+                                      config.maxDepth, budget);
+            clocks[side] -= search.timeMs;
+            if (clocks[side] < 0) {
+                return side == 0 ? kBlackWin : kWhiteWin;
+            }
+            clocks[side] += config.incrementMs;
+        }
+        if (!search.bestMove.isValid()) {
+            return kDrawScore;
+        }
+
+        winStreak = search.score >= config.winScore ? winStreak + 1 : 0;
+        lossStreak = search.score <= -config.winScore ? lossStreak + 1 : 0;
+        drawStreak = ply >= config.drawMinPly && std::abs(search.score) <= config.drawScore
+                         ? drawStreak + 1
+                         : 0;
+        if (winStreak >= config.winPlies) {
+            return kWhiteWin;
+        }
+        if (lossStreak >= config.winPlies) {
+            return kBlackWin;
+        }
+        if (drawStreak >= config.drawPlies) {
+            return kDrawScore;
+        }
+
+        history.push_back(key);
+        searchHistory.push_back(searchKey);
+        playMove(board, search.bestMove);
+    }
+    return kDrawScore;
+}
+
+void addGame(Stats& stats, double score) {
+    if (score > kDrawScore) {
+        ++stats.wins;
+    } else if (score < kDrawScore) {
+        ++stats.losses;
+    } else {
+        ++stats.draws;
+    }
+}
+} // namespace
+
+Engine currentEngine(const std::string& name) {
+    return Engine{name, TunableRegistry::instance().values(), *ParamPack::current};
+}
+
+EloEstimate estimateElo(const Stats& stats) {
+    int count = 0;
+    const auto [mean, variance] = pairScoreMoments(stats, count);
+    if (count == 0) {
+        return {};
+    }
+    const double margin = kConfidence95 * std::sqrt(variance / count);
+    return {scoreToElo(mean), (scoreToElo(mean + margin) - scoreToElo(mean - margin)) / 2.0};
+}
+
+double logLikelihoodRatio(const Stats& stats, double elo0, double elo1) {
+    int count = 0;
+    const auto [mean, variance] = pairScoreMoments(stats, count);
+    if (count == 0 || variance <= 0.0) {
+        return 0.0;
+    }
+    const double score0 = expectedScore(elo0);
+    const double score1 = expectedScore(elo1);
+    return count * (score1 - score0) * ((2.0 * mean) - score0 - score1) / (2.0 * variance);
+}
+
+double sprtLowerBound(const Config& config) {
+    return std::log(config.beta / (1.0 - config.alpha));
+}
+
+double sprtUpperBound(const Config& config) {
+    return std::log((1.0 - config.beta) / config.alpha);
+}
+
+struct Runner::Worker {
+    std::array<Player, 2> players;
+};
+
+Runner::Runner(const Config& config)
+    : config(config), pool(std::make_unique<ThreadPool>(config.threads)) {
+    for (int i = 0; i < pool->size(); ++i) {
+        auto worker = std::make_unique<Worker>();
+        for (Player& player : worker->players) {
+            player.context = std::make_unique<ParallelSearchContext>(1);
+            player.context->transTable.resize(
+                static_cast<std::size_t>(std::max(1, config.hashMb)));
+        }
+        workers.push_back(std::move(worker));
+    }
+}
+
+Runner::~Runner() = default;
+
+Stats Runner::play(const Engine& first, const Engine& second,
+                   const std::vector<std::string>& openings, int games, int firstPair,
+                   const Report& report) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::array<const Engine*, 2> engines = {&first, &second};
+    std::array<PsqTable::Table, 2> tables{};
+    for (std::size_t i = 0; i < engines.size(); ++i) {
+        tables[i] = PsqTable::build(engines[i]->params);
+    }
+
+    const int pairCount = (games + 1) / 2;
+    std::atomic<int> nextPair{0};
+    std::atomic<bool> decided{false};
+    std::mutex statsMutex;
+    Stats stats;
+
+    pool->run(workers.size(), [&](std::size_t index) {
+        const ThreadBinding restore;
+        std::array<Player, 2>& players = workers[index]->players;
+        for (std::size_t i = 0; i < players.size(); ++i) {
+            players[i].engine = engines[i];
+            players[i].table = &tables[i];
+        }
+
+        while (!decided.load(std::memory_order_relaxed)) {
+            const int pair = nextPair.fetch_add(1, std::memory_order_relaxed);
+            if (pair >= pairCount) {
+                break;
+            }
+            const auto fen = pairOpening(config, openings, firstPair + pair);
+            if (!fen) {
+                continue;
+            }
+            const double firstAsWhite = playGame(config, *fen, {&players[0], &players[1]});
+            const double firstAsBlack = 1.0 - playGame(config, *fen, {&players[1], &players[0]});
+
+            std::lock_guard<std::mutex> lock(statsMutex);
+            if (decided.load(std::memory_order_relaxed)) {
+                break;
+            }
+            addGame(stats, firstAsWhite);
+            addGame(stats, firstAsBlack);
+            ++stats.pairs[static_cast<std::size_t>(std::lround((firstAsWhite + firstAsBlack) * 2))];
+            stats.seconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (config.sprt) {
+                const double llr = logLikelihoodRatio(stats, config.elo0, config.elo1);
+                if (llr <= sprtLowerBound(config) || llr >= sprtUpperBound(config)) {
+                    decided.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (report) {
+                report(stats);
+            }
+        }
+    });
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+Stats run(const Config& config, const Engine& first, const Engine& second,
+          const std::vector<std::string>& openings, const Report& report) {
+    Runner runner(config);
+    return runner.play(first, second, openings, config.games, 0, report);
+}
+
+} // namespace MatchRunner
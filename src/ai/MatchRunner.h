@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../evaluation/ParamPack.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef CHESS_ENGINE_THREAD_PARAMS
+#error "MatchRunner binds evaluation parameters per thread; build it as part of //:engine_match_lib"
+#endif
+
+class ThreadPool;
+
+// Engine-vs-engine matches played inside one process. Every worker thread keeps a search context
+// per engine and binds that engine's tunable values and evaluation parameters to the thread
+// before each of its moves; attack tables, magic bitboards and networks are shared read-only.
+namespace MatchRunner {
+
+struct Engine {
+    std::string name;
+    // Indexed like TunableRegistry::all(), as returned by TunableRegistry::values().
+    std::vector<int> tunables;
+    ParamPack::Pack params;
+};
+
+// An engine with the process's current tunable values and parameter pack.
+Engine currentEngine(const std::string& name);
+
+struct Config {
+    // Every opening is played twice with colours reversed, so an odd count is rounded up.
+    int games = 1000;
+    // Each worker plays whole game pairs; 0 uses every core.
+    int threads = 0;
+    // Fixed-node searches when positive, otherwise each side has baseMs on its clock and gains
+    // incrementMs after every move.
+    int nodes = 0;
+    int baseMs = 10000;
+    int incrementMs = 100;
+    int maxDepth = 64;
+    // Per engine and worker.
+    int hashMb = 16;
+    // Uniformly random legal moves played after the book position, the same for both games of
+    // a pair.
+    int randomPlies = 0;
+    int maxPlies = 400;
+    std::uint32_t seed = 1;
+    // Adjudication as in Datagen::Config; scores are from white's point of view.
+    int winScore = 1000;
+    int winPlies = 6;
+    int drawScore = 10;
+    int drawPlies = 10;
+    int drawMinPly = 80;
+    // SPRT of elo1 against elo0 for the first engine; the match stops once either is accepted.
+    bool sprt = true;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+struct Stats {
+    // Game results from the first engine's point of view.
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    // Game pairs by the first engine's score over the pair: 0, 0.5, 1, 1.5 and 2 points.
+    std::array<int, 5> pairs{};
+    double seconds = 0.0;
+
+    int games() const {
+        return wins + draws + losses;
+    }
+};
+
+struct EloEstimate {
+    double elo = 0.0;
+    // Half-width of the 95% confidence interval.
+    double margin = 0.0;
+};
+
+// Logistic Elo of the first engine from the pair scores.
+EloEstimate estimateElo(const Stats& stats);
+// Log-likelihood ratio of elo1 against elo0 under the normal approximation of the pentanomial
+// pair-score distribution, which accounts for the correlation within a pair.
+double logLikelihoodRatio(const Stats& stats, double elo0, double elo1);
+double sprtLowerBound(const Config& config);
+double sprtUpperBound(const Config& config);
+
+using Report = std::function<void(const Stats&)>;
+
+// Keeps the worker threads and their search contexts between matches, for callers such as the
+// SPSA tuner that play many short ones.
+class Runner {
+public:
+    explicit Runner(const Config& config);
+    ~Runner();
+    Runner(const Runner&) = delete;
+    Runner& operator=(const Runner&) = delete;
+
+    // Plays first against second from openings (the start position if empty) until games games
+    // are played or the SPRT is decided; config.games is not used. Pairs are numbered from
+    // firstPair, which selects the openings and random plies. report is called after every
+    // finished pair, one call at a time.
+    Stats play(const Engine& first, const Engine& second, const std::vector<std::string>& openings,
+               int games, int firstPair = 0, const Report& report = {});
+
+    // Game pairs played at once.
+    int workerCount() const {
+        return static_cast<int>(workers.size());
+    }
+
+private:
+    struct Worker;
+
+    Config config;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+// A Runner for a single match of config.games games.
+Stats run(const Config& config, const Engine& first, const Engine& second,
+          const std::vector<std::string>& openings, const Report& report = {});
+
+} // namespace MatchRunner
@@ -0,0 +1,538 @@
+#include "NNUETrainer.h"
+#include "../evaluation/NetworkFile.h"
+#include "../utils/ThreadPool.h"
+#include "ChessBoard.h"
+#include "ChessPiece.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace NNUETraining {
+
+namespace {
+constexpr std::size_t kInputs = NNUE::INPUT_DIMENSIONS;
+constexpr std::size_t kL1 = NNUE::L1_SIZE;
+constexpr std::size_t kL2 = NNUE::L2_SIZE;
+constexpr std::size_t kL3 = NNUE::L3_SIZE;
+
+// Flat parameter layout: weights first so weight decay can stop at kDecayEnd. Feature
+// transformer weights are feature-major, the dense layers row-major [out][in] as on disk.
+constexpr std::size_t kFtWeights = 0;
+constexpr std::size_t kHidden1Weights = kFtWeights + (kInputs * kL1);
+constexpr std::size_t kHidden2Weights = kHidden1Weights + (kL2 * 2 * kL1);
+constexpr std::size_t kOutputWeights = kHidden2Weights + (kL3 * kL2);
+constexpr std::size_t kFtBiases = kOutputWeights + kL3;
+constexpr std::size_t kHidden1Biases = kFtBiases + kL1;
+constexpr std::size_t kHidden2Biases = kHidden1Biases + kL2;
+constexpr std::size_t kOutputBias = kHidden2Biases + kL3;
+constexpr std::size_t kParamCount = kOutputBias + 1;
+constexpr std::size_t kDecayEnd = kFtBiases;
+// Everything after the feature transformer weights is updated densely.
+constexpr std::size_t kDenseBegin = kHidden1Weights;
+
+// Fixed-point scales of the integer evaluator: accumulators hold 127 * value, dense weights
+// 64 * value and pre-activations 127 * 64 * value, which ClippedReLU divides by 64.
+constexpr float kAccumulatorScale = 127.0F;
+constexpr float kWeightScale = static_cast<float>(NNUE::SCALE);
+constexpr float kActivationRange = kAccumulatorScale * kWeightScale;
+// Centipawns represented by an output of 1.0.
+constexpr float kOutputScale = 400.0F;
+// Added to dense biases on export so ClippedReLU's truncating division rounds to nearest.
+constexpr float kRoundingOffset = kWeightScale / 2.0F;
+constexpr float kInt16Limit = 32767.0F;
+constexpr float kInt32Limit = 1.0e9F;
+
+struct Segment {
+    std::size_t begin;
+    std::size_t end;
+    float scale;
+    float limit;
+};
+
+constexpr std::array<Segment, 8> kSegments = {{
+    {kFtWeights, kHidden1Weights, kAccumulatorScale, kInt16Limit},
+    {kHidden1Weights, kHidden2Weights, kWeightScale, kInt16Limit},
+    {kHidden2Weights, kOutputWeights, kWeightScale, kInt16Limit},
+    {kOutputWeights, kFtBiases, kOutputScale * kWeightScale / kAccumulatorScale, kInt16Limit},
+    // Feature biases are stored as int32 but clamped to int16 by the loader.
+    {kFtBiases, kHidden1Biases, kAccumulatorScale, kInt16Limit},
+    {kHidden1Biases, kHidden2Biases, kActivationRange, kInt32Limit},
+    {kHidden2Biases, kOutputBias, kActivationRange, kInt32Limit},
+    {kOutputBias, kParamCount, kOutputScale * kWeightScale, kInt32Limit},
+}};
+
+constexpr std::size_t kShardSize = 64;
+constexpr std::size_t kRowsPerTask = 16;
+constexpr std::size_t kUpdateChunk = 4096;
+constexpr std::size_t kMaxFenLength = 128;
+
+constexpr float kFtInitStd = 0.1F;
+
+float sigmoid(float x) {
+    return 1.0F / (1.0F + std::exp(-x));
+}
+
+struct Activations {
+    alignas(32) std::array<float, kL1> accumulator;
+    std::array<float, kL2> hidden1;
+    std::array<float, kL2> active1;
+    std::array<float, kL3> hidden2;
+    std::array<float, kL3> active2;
+};
+
+float activate(float value, bool truncate) {
+    const float clipped = std::clamp(value, 0.0F, kActivationRange) / kWeightScale;
+    return truncate ? std::floor(clipped) : clipped;
+}
+
+bool isLinear(float value) {
+    return value > 0.0F && value < kActivationRange;
+}
+
+// Runs the network in integer units and returns the output in centipawns. With truncate set
+// this is the integer evaluator's arithmetic, apart from float rounding in the sums.
+float forward(const Sample& sample, const float* quantized, const float* folded, bool truncate,
+              Activations& out) {
+    std::copy_n(quantized + kFtBiases, kL1, out.accumulator.begin());
+    for (int k = 0; k < sample.featureCount; ++k) {
+        const auto feature = static_cast<std::size_t>(sample.features[k]);
+        TrainingMath::axpy(1.0F, quantized + kFtWeights + (feature * kL1), out.accumulator.data(),
+                           kL1);
+    }
+    const float offset = truncate ? kRoundingOffset : 0.0F;
+    for (std::size_t j = 0; j < kL2; ++j) {
+        out.hidden1[j] = quantized[kHidden1Biases + j] + offset +
+                         TrainingMath::dot(folded + (j * kL1), out.accumulator.data(), kL1);
+        out.active1[j] = activate(out.hidden1[j], truncate);
+    }
+    for (std::size_t k = 0; k < kL3; ++k) {
+        out.hidden2[k] =
+            quantized[kHidden2Biases + k] + offset +
+            TrainingMath::dot(quantized + kHidden2Weights + (k * kL2), out.active1.data(), kL2);
+        out.active2[k] = activate(out.hidden2[k], truncate);
+    }
+    const float output = quantized[kOutputBias] +
+                         TrainingMath::dot(quantized + kOutputWeights, out.active2.data(), kL3);
+    return output / kWeightScale;
+}
+
+template <typename T> std::vector<T> exportSegment(const std::vector<float>& params,
+                                                  const Segment& segment, float offset = 0.0F) {
+    std::vector<T> values(segment.end - segment.begin);
+    for (std::size_t i = segment.begin; i < segment.end; ++i) {
+        const float scaled = std::round(params[i] * segment.scale) + offset;
+        values[i - segment.begin] = static_cast<T>(std::clamp(scaled, -segment.limit,
+                                                              segment.limit));
+    }
+    return values;
+}
+} // namespace
+
+bool makeSample(const Board& board, float score, float result, Sample& sample) {
+    int count = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        const Piece& piece = board.squares[sq].piece;
+        if (piece.PieceType == ChessPieceType::NONE) {
+            continue;
+        }
+        if (count == MAX_FEATURES) {
+            return false;
+        }
+        sample.features[static_cast<std::size_t>(count++)] = static_cast<int16_t>(
+            NNUE::FeatureIndex::index(sq, piece.PieceType, piece.PieceColor));
+    }
+    sample.featureCount = count;
+    sample.score = score;
+    sample.result = result;
+    return true;
+}
+
+bool makeSample(const PositionFile::PackedPosition& position, Sample& sample) {
+    int count = 0;
+    position.forEachPiece([&](int square, ChessPieceType type, ChessPieceColor color) {
+        sample.features[static_cast<std::size_t>(count++)] =
+            static_cast<int16_t>(NNUE::FeatureIndex::index(square, type, color));
+    });
+    sample.featureCount = count;
+    sample.score = position.score;
+    sample.result = position.gameResult();
+    return true;
+}
+
+Board sampleBoard(const Sample& sample) {
+    Board board;
+    for (int k = 0; k < sample.featureCount; ++k) {
+        const int feature = sample.features[static_cast<std::size_t>(k)];
+        const int slot = feature / 64;
+        board.squares[feature % 64].piece =
+            Piece(static_cast<ChessPieceColor>(slot / 6), static_cast<ChessPieceType>(slot % 6));
+    }
+    board.updateBitboards();
+    return board;
+}
+
+TrainingDataReader::TrainingDataReader(const std::string& path)
+    : file(path, std::ios::binary) {
+    if (file.is_open() && file.read(reinterpret_cast<char*>(&total), sizeof(total))) {
+        remaining = total;
+    } else {
+        total = 0;
+    }
+}
+
+bool TrainingDataReader::next(Sample& sample) {
+    while (remaining > 0) {
+        --remaining;
+        std::size_t fenLength = 0;
+        if (!file.read(reinterpret_cast<char*>(&fenLength), sizeof(fenLength)) ||
+            fenLength > kMaxFenLength) {
+            remaining = 0;
+            return false;
+        }
+        std::string fen(fenLength, '\0');
+        float score = 0.0F;
+        float result = 0.0F;
+        int gameLength = 0;
+        file.read(fen.data(), static_cast<std::streamsize>(fenLength));
+        file.read(reinterpret_cast<char*>(&score), sizeof(score));
+        file.read(reinterpret_cast<char*>(&result), sizeof(result));
+        file.read(reinterpret_cast<char*>(&gameLength), sizeof(gameLength));
+        if (!file) {
+            remaining = 0;
+            return false;
+        }
+        Board board;
+        board.InitializeFromFEN(fen);
+        if (makeSample(board, score, result, sample)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TrainingDataReader::rewind() {
+    if (!file.is_open()) {
+        return false;
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(sizeof(total)));
+    remaining = total;
+    return static_cast<bool>(file);
+}
+
+bool PackedSampleReader::next(Sample& sample) {
+    PositionFile::PackedPosition position;
+    if (!reader.next(position)) {
+        return false;
+    }
+    return makeSample(position, sample);
+}
+
+bool PackedSampleReader::rewind() {
+    if (!reader.isOpen()) {
+        return false;
+    }
+    reader.rewind();
+    return true;
+}
+
+std::unique_ptr<SampleReader> openSampleFile(const std::string& path) {
+    auto packed = std::make_unique<PackedSampleReader>(path);
+    if (packed->isOpen()) {
+        return packed;
+    }
+    auto legacy = std::make_unique<TrainingDataReader>(path);
+    if (legacy->isOpen()) {
+        return legacy;
+    }
+    return nullptr;
+}
+
+Trainer::Trainer(const TrainerConfig& config)
+    : config(config), params(kParamCount, 0.0F), quantized(kParamCount, 0.0F),
+      foldedHidden(kL2 * kL1, 0.0F), pool(std::make_unique<ThreadPool>(config.threads)),
+      rng(config.seed) {
+    const auto initialize = [&](std::size_t begin, std::size_t end, float stddev) {
+        std::normal_distribution<float> dist(0.0F, stddev);
+        for (std::size_t i = begin; i < end; ++i) {
+            params[i] = dist(rng);
+        }
+    };
+    initialize(kFtWeights, kHidden1Weights, kFtInitStd);
+    initialize(kHidden1Weights, kHidden2Weights, 1.0F / std::sqrt(2.0F * kL1));
+    initialize(kHidden2Weights, kOutputWeights, 1.0F / std::sqrt(static_cast<float>(kL2)));
+    initialize(kOutputWeights, kFtBiases, 1.0F / std::sqrt(static_cast<float>(kL3)));
+    optimizer.resize(kParamCount);
+    quantizeRange(0, kParamCount);
+    foldHiddenWeights();
+}
+
+Trainer::~Trainer() = default;
+
+float Trainer::target(const Sample& sample) const {
+    const float expected = sigmoid(sample.score / config.sigmoidScale);
+    return (config.lambda * expected) + ((1.0F - config.lambda) * sample.result);
+}
+
+// Adds one sample's loss gradient to the shard in natural units (integer values divided by
+// their scale) and returns its squared error. Rounding and truncation are passed straight
+// through, clamping is not.
+float Trainer::accumulate(const Sample& sample, Shard& shard) const {
+    Activations act;
+    const float predicted = forward(sample, quantized.data(), foldedHidden.data(),
+                                    config.quantizationAware, act);
+    const float probability = sigmoid(predicted / config.sigmoidScale);
+    const float error = probability - target(sample);
+    const float outputGrad =
+        2.0F * error * probability * (1.0F - probability) / config.sigmoidScale;
+
+    float* grad = shard.gradient.data();
+    const float outputDelta = outputGrad * kOutputScale;
+    grad[kOutputBias] += outputDelta;
+    TrainingMath::axpy(outputDelta / kAccumulatorScale, act.active2.data(), grad + kOutputWeights,
+                       kL3);
+
+    std::array<float, kL3> delta2{};
+    const float outputToHidden = outputGrad * kAccumulatorScale / kWeightScale;
+    for (std::size_t k = 0; k < kL3; ++k) {
+        if (isLinear(act.hidden2[k])) {
+            delta2[k] = outputToHidden * quantized[kOutputWeights + k];
+        }
+    }
+    std::array<float, kL2> delta1{};
+    for (std::size_t k = 0; k < kL3; ++k) {
+        if (delta2[k] == 0.0F) {
+            continue;
+        }
+        grad[kHidden2Biases + k] += delta2[k];
+        TrainingMath::axpy(delta2[k] / kAccumulatorScale, act.active1.data(),
+                           grad + kHidden2Weights + (k * kL2), kL2);
+        TrainingMath::axpy(delta2[k] / kWeightScale, quantized.data() + kHidden2Weights + (k * kL2),
+                           delta1.data(), kL2);
+    }
+
+    alignas(32) std::array<float, kL1> deltaAcc{};
+    for (std::size_t j = 0; j < kL2; ++j) {
+        if (delta1[j] == 0.0F || !isLinear(act.hidden1[j])) {
+            continue;
+        }
+        // Both halves of the hidden layer input are the same accumulator.
+        const float scale = delta1[j] / kAccumulatorScale;
+        float* row = grad + kHidden1Weights + (j * 2 * kL1);
+        grad[kHidden1Biases + j] += delta1[j];
+        TrainingMath::axpy(scale, act.accumulator.data(), row, kL1);
+        TrainingMath::axpy(scale, act.accumulator.data(), row + kL1, kL1);
+        TrainingMath::axpy(delta1[j] / kWeightScale, foldedHidden.data() + (j * kL1),
+                           deltaAcc.data(), kL1);
+    }
+
+    TrainingMath::axpy(1.0F, deltaAcc.data(), grad + kFtBiases, kL1);
+    for (int k = 0; k < sample.featureCount; ++k) {
+        const auto feature = static_cast<std::size_t>(sample.features[k]);
+        TrainingMath::axpy(1.0F, deltaAcc.data(), grad + kFtWeights + (feature * kL1), kL1);
+        shard.touched[feature] = 1;
+    }
+    return error * error;
+}
+
+float Trainer::trainBatch(std::span<const Sample> batch) {
+    const std::size_t count = batch.size();
+    if (count == 0) {
+        return 0.0F;
+    }
+    const std::size_t shardCount = (count + kShardSize - 1) / kShardSize;
+    while (shards.size() < shardCount) {
+        Shard& shard = shards.emplace_back();
+        shard.gradient.assign(kParamCount, 0.0F);
+        shard.touched.assign(kInputs, 0);
+    }
+    pool->run(shardCount, [&](std::size_t index) {
+        Shard& shard = shards[index];
+        const std::size_t end = std::min(count, (index + 1) * kShardSize);
+        float loss = 0.0F;
+        for (std::size_t i = index * kShardSize; i < end; ++i) {
+            loss += accumulate(batch[i], shard);
+        }
+        shard.loss = loss;
+    });
+    applyGradients(shardCount, count);
+
+    float loss = 0.0F;
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        loss += shards[i].loss;
+    }
+    return loss;
+}
+
+// Reduces the shard gradients in shard order, so results do not depend on the thread count,
+// and steps the optimizer. Feature transformer rows no sample in the batch touched keep their
+// weights and moments unchanged (lazy Adam); everything else is updated densely.
+void Trainer::applyGradients(std::size_t shardCount, std::size_t count) {
+    std::vector<std::size_t> rows;
+    for (std::size_t feature = 0; feature < kInputs; ++feature) {
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            if (shards[i].touched[feature] != 0) {
+                rows.push_back(feature);
+                break;
+            }
+        }
+    }
+
+    const TrainingMath::OptimizerConfig& settings = config.optimizer;
+    optimizer.beginStep(settings);
+    const float scale = 1.0F / static_cast<float>(count);
+    const auto step = [&](std::size_t begin, std::size_t end, std::size_t row) {
+        float* total = shards[0].gradient.data();
+        for (std::size_t i = 1; i < shardCount; ++i) {
+            if (row < kInputs && shards[i].touched[row] == 0) {
+                continue;
+            }
+            float* partial = shards[i].gradient.data();
+            TrainingMath::axpy(1.0F, partial + begin, total + begin, end - begin);
+            std::fill(partial + begin, partial + end, 0.0F);
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            total[i] *= scale;
+        }
+        optimizer.update(settings, params.data(), total, begin, end, kDecayEnd);
+        std::fill(total + begin, total + end, 0.0F);
+        quantizeRange(begin, end);
+    };
+
+    const std::size_t rowTasks = (rows.size() + kRowsPerTask - 1) / kRowsPerTask;
+    const std::size_t denseTasks = (kParamCount - kDenseBegin + kUpdateChunk - 1) / kUpdateChunk;
+    pool->run(rowTasks + denseTasks, [&](std::size_t task) {
+        if (task < rowTasks) {
+            const std::size_t last = std::min(rows.size(), (task + 1) * kRowsPerTask);
+            for (std::size_t r = task * kRowsPerTask; r < last; ++r) {
+                const std::size_t begin = kFtWeights + (rows[r] * kL1);
+                step(begin, begin + kL1, rows[r]);
+            }
+            return;
+        }
+        const std::size_t begin = kDenseBegin + ((task - rowTasks) * kUpdateChunk);
+        step(begin, std::min(kParamCount, begin + kUpdateChunk), kInputs);
+    });
+
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        std::ranges::fill(shards[i].touched, 0);
+    }
+    foldHiddenWeights();
+}
+
+// Clips params[begin, end) to what the integer network can store and refreshes quantized.
+void Trainer::quantizeRange(std::size_t begin, std::size_t end) {
+    for (const Segment& segment : kSegments) {
+        const std::size_t from = std::max(begin, segment.begin);
+        const std::size_t to = std::min(end, segment.end);
+        const float bound = segment.limit / segment.scale;
+        for (std::size_t i = from; i < to; ++i) {
+            params[i] = std::clamp(params[i], -bound, bound);
+            const float scaled = params[i] * segment.scale;
+            quantized[i] = config.quantizationAware ? std::round(scaled) : scaled;
+        }
+    }
+}
+
+void Trainer::foldHiddenWeights() {
+    for (std::size_t j = 0; j < kL2; ++j) {
+        const float* row = quantized.data() + kHidden1Weights + (j * 2 * kL1);
+        for (std::size_t i = 0; i < kL1; ++i) {
+            foldedHidden[(j * kL1) + i] = row[i] + row[kL1 + i];
+        }
+    }
+}
+
+EpochStats Trainer::trainEpoch(SampleReader& reader) {
+    EpochStats stats;
+    if (!reader.rewind()) {
+        return stats;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto batchSize = static_cast<std::size_t>(std::max(1, config.batchSize));
+    const std::size_t windowSize = std::max(config.shuffleWindow, batchSize);
+    std::vector<Sample> window;
+    window.reserve(windowSize);
+    double totalLoss = 0.0;
+    bool exhausted = false;
+    while (!exhausted) {
+        window.clear();
+        Sample sample;
+        while (window.size() < windowSize && reader.next(sample)) {
+            window.push_back(sample);
+        }
+        exhausted = window.size() < windowSize;
+        std::ranges::shuffle(window, rng);
+        for (std::size_t i = 0; i < window.size(); i += batchSize) {
+            const std::size_t count = std::min(batchSize, window.size() - i);
+            totalLoss += trainBatch(std::span<const Sample>(window).subspan(i, count));
+        }
+        stats.positions += window.size();
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.positionsPerSecond =
+        stats.seconds > 0.0 ? static_cast<double>(stats.positions) / stats.seconds : 0.0;
+    stats.averageLoss = stats.positions > 0
+                            ? static_cast<float>(totalLoss / static_cast<double>(stats.positions))
+                            : 0.0F;
+    return stats;
+}
+
+float Trainer::predict(const Sample& sample) const {
+    Activations act;
+    return forward(sample, quantized.data(), foldedHidden.data(), config.quantizationAware, act);
+}
+
+void Trainer::exportNetwork(std::ostream& out) const {
+    constexpr std::uint32_t kAlignedVersion = 2;
+    NetworkFile::Writer writer(out);
+    writer.writeHeader(kAlignedVersion);
+    const auto layer = [&](const Segment& weights, const Segment& biases, float offset) {
+        writer.write<int16_t>(exportSegment<int16_t>(params, weights));
+        writer.write<int32_t>(exportSegment<int32_t>(params, biases, offset));
+    };
+    layer(kSegments[0], kSegments[4], 0.0F);
+    layer(kSegments[1], kSegments[5], kRoundingOffset);
+    layer(kSegments[2], kSegments[6], kRoundingOffset);
+    layer(kSegments[3], kSegments[7], 0.0F);
+}
+
+bool Trainer::exportNetwork(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    exportNetwork(out);
+    return static_cast<bool>(out);
+}
+
+ValidationStats Trainer::validate(const NNUE::NNUEEvaluator& evaluator,
+                                  std::span<const Sample> samples) const {
+    ValidationStats stats;
+    double totalError = 0.0;
+    for (const Sample& sample : samples) {
+        const Board board = sampleBoard(sample);
+        const int score = evaluator.evaluate(board, ChessPieceColor::WHITE);
+        const double error = std::fabs(static_cast<double>(score) - predict(sample));
+        totalError += error;
+        stats.maxAbsError = std::max(stats.maxAbsError, error);
+        ++stats.positions;
+    }
+    stats.meanAbsError =
+        stats.positions > 0 ? totalError / static_cast<double>(stats.positions) : 0.0;
+    return stats;
+}
+
+} // namespace NNUETraining
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "../core/ChessBoard.h"
+#include "../evaluation/NNUE.h"
+#include "PositionFile.h"
+#include "TrainingMath.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Float trainer for the 768 -> 256x2 -> 32 -> 32 -> 1 network read by NNUE::NNUEEvaluator.
+// Every layer is trained in the units the integer evaluator uses after dividing out its fixed
+// scales, so export is a rounding step rather than a refit.
+namespace NNUETraining {
+
+inline constexpr int MAX_FEATURES = 32;
+
+// One training position: its active NNUE::FeatureIndex features, a white-POV search score in
+// centipawns and the game result from white's side (1 win, 0.5 draw, 0 loss).
+struct Sample {
+    std::array<int16_t, MAX_FEATURES> features{};
+    int featureCount = 0;
+    float score = 0.0F;
+    float result = 0.5F;
+};
+
+// Fails for boards with more than MAX_FEATURES pieces.
+bool makeSample(const Board& board, float score, float result, Sample& sample);
+bool makeSample(const PositionFile::PackedPosition& position, Sample& sample);
+Board sampleBoard(const Sample& sample);
+
+// Sequential source of samples. Trainers read it once per epoch and rewind in between, so
+// files never have to fit in memory.
+class SampleReader {
+public:
+    virtual ~SampleReader() = default;
+    virtual bool next(Sample& sample) = 0;
+    virtual bool rewind() = 0;
+};
+
+// Streams the files written by TrainingDataGenerator::saveTrainingData.
+class TrainingDataReader : public SampleReader {
+public:
+    explicit TrainingDataReader(const std::string& path);
+
+    bool isOpen() const {
+        return file.is_open() && total > 0;
+    }
+
+    std::size_t size() const {
+        return total;
+    }
+
+    bool next(Sample& sample) override;
+    bool rewind() override;
+
+private:
+    std::ifstream file;
+    std::size_t total = 0;
+    std::size_t remaining = 0;
+};
+
+// Streams PositionFile files without building boards.
+class PackedSampleReader : public SampleReader {
+public:
+    explicit PackedSampleReader(const std::string& path) {
+        reader.open(path);
+    }
+
+    bool isOpen() const {
+        return reader.isOpen();
+    }
+
+    std::size_t size() const {
+        return reader.size();
+    }
+
+    bool next(Sample& sample) override;
+    bool rewind() override;
+
+private:
+    PositionFile::Reader reader;
+};
+
+// Opens a PositionFile file, or else TrainingDataGenerator output; nullptr if neither loads.
+std::unique_ptr<SampleReader> openSampleFile(const std::string& path);
+
+struct TrainerConfig {
+    TrainingMath::OptimizerConfig optimizer{};
+    int batchSize = 1024;
+    int threads = 0;
+    // Samples shuffled together; the stream is consumed in windows of this size.
+    std::size_t shuffleWindow = 1U << 16;
+    // Target blend: lambda * sigmoid(score / K) + (1 - lambda) * result, with K = sigmoidScale.
+    float lambda = 1.0F;
+    float sigmoidScale = 400.0F;
+    // Train against the rounded weights and truncated activations of the integer network
+    // (straight-through gradients), so the exported file reproduces the float model.
+    bool quantizationAware = true;
+    std::uint32_t seed = 42U;
+};
+
+struct EpochStats {
+    std::size_t positions = 0;
+    double seconds = 0.0;
+    double positionsPerSecond = 0.0;
+    float averageLoss = 0.0F;
+};
+
+struct ValidationStats {
+    std::size_t positions = 0;
+    double meanAbsError = 0.0;
+    double maxAbsError = 0.0;
+};
+
+class Trainer {
+public:
+    explicit Trainer(const TrainerConfig& config);
+    ~Trainer();
+    Trainer(const Trainer&) = delete;
+    Trainer& operator=(const Trainer&) = delete;
+    Trainer(Trainer&&) = delete;
+    Trainer& operator=(Trainer&&) = delete;
+
+    // One optimizer step over the batch; returns the summed loss.
+    float trainBatch(std::span<const Sample> batch);
+    EpochStats trainEpoch(SampleReader& reader);
+
+    // Float model output in centipawns from white's point of view.
+    float predict(const Sample& sample) const;
+
+    // Writes the aligned version 2 layout accepted by NNUEEvaluator::loadNetwork.
+    void exportNetwork(std::ostream& out) const;
+    bool exportNetwork(const std::string& path) const;
+
+    // Compares the float model with the exported integer network on the given samples.
+    ValidationStats validate(const NNUE::NNUEEvaluator& evaluator,
+                             std::span<const Sample> samples) const;
+
+private:
+    struct Shard {
+        std::vector<float> gradient;
+        std::vector<std::uint8_t> touched;
+        float loss = 0.0F;
+    };
+
+    float target(const Sample& sample) const;
+    float accumulate(const Sample& sample, Shard& shard) const;
+    void applyGradients(std::size_t shardCount, std::size_t count);
+    void quantizeRange(std::size_t begin, std::size_t end);
+    void foldHiddenWeights();
+
+    TrainerConfig config;
+    std::vector<float> params;
+    // params in integer-network units, rounded unless quantizationAware is off.
+    std::vector<float> quantized;
+    // Hidden layer weights with both accumulator halves summed, in integer units.
+    std::vector<float> foldedHidden;
+    std::vector<Shard> shards;
+    TrainingMath::OptimizerState optimizer;
+    std::unique_ptr<ThreadPool> pool;
+    std::mt19937 rng;
+};
+
+} // namespace NNUETraining
@@ -1,8 +1,10 @@
 #include "NeuralNetwork.h"
 #include "../evaluation/Evaluation.h"
 #include "../search/ValidMoves.h"
+#include "../utils/ThreadPool.h"
 #include "ChessBoard.h"
 #include "ChessPiece.h"
+#include "PositionFile.h"
 
 #include <algorithm>
 #include <array>
@@ -28,6 +30,11 @@
 namespace {
 constexpr int kThreadFallback = 4;
 constexpr std::uint32_t kSelfPlaySeed = 42U;
+// Examples per gradient shard. Shards are reduced in index order, so trained weights do not
+// depend on how many threads computed them.
+constexpr std::size_t kShardSize = 32;
+constexpr std::size_t kUpdateChunk = 4096;
+constexpr std::size_t kReportInterval = 100;
 
 int getWorkerCount(std::size_t taskCount, int perTaskThreads = 1) {
     if (taskCount == 0U) {
@@ -54,10 +61,32 @@ public:
     NetworkConfig config;
     std::vector<Layer> layers;
     std::mt19937 rng;
+    QuantizedNetwork quantized;
+    QuantizedNetwork::Accumulator accumulator;
+
+    // Active input features of one position and its target in tanh space.
+    struct SparseExample {
+        QuantizedNetwork::FeatureList features{};
+        int featureCount{0};
+        float target{0.0F};
+    };
+
+    // Flat copy of the parameters while training: first-layer weights feature-major so every
+    // active feature is one contiguous column, then output weights, hidden biases and the
+    // output bias. Optimizer moments persist across epochs.
+    struct Trainer {
+        std::vector<float> params;
+        std::vector<std::vector<float>> shardGradients;
+        std::vector<float> shardLoss;
+        TrainingMath::OptimizerState optimizer;
+        std::unique_ptr<ThreadPool> pool;
+    };
+    Trainer trainer;
 
     Impl(const NetworkConfig& config)
         : config(config), rng(42) { // NOLINT(bugprone-random-generator-seed)
         initializeNetwork();
+        quantize();
     }
 
     ~Impl() = default;
@@ -91,31 +120,179 @@ public:
         }
     }
 
-    auto forwardPass(const std::vector<float>& input) -> float {
-        std::vector<float> currentInput = input;
+    void quantize() {
+        if (config.inputSize != QuantizedNetwork::INPUT_SIZE || layers.size() != 2U ||
+            layers[1].weights.empty()) {
+            quantized.clear();
+            return;
+        }
+        quantized.build(layers[0].weights, layers[0].biases, layers[1].weights[0],
+                        layers[1].biases[0]);
+    }
 
-        for (size_t i = 0; i < layers.size(); ++i) {
-            Layer& layer = layers[i];
+    bool isSparse() const {
+        return config.inputSize == QuantizedNetwork::INPUT_SIZE && layers.size() == 2U &&
+               !layers[1].weights.empty();
+    }
 
-            for (size_t j = 0; j < layer.weights.size(); ++j) {
-                float sum = layer.biases[j];
-                for (size_t k = 0; k < layer.weights[j].size(); ++k) {
-                    sum += layer.weights[j][k] * currentInput[k];
-                }
+    auto hiddenCount() const -> std::size_t {
+        return layers[0].biases.size();
+    }
 
-                if (i == layers.size() - 1) {
+    auto inferSparse(const QuantizedNetwork::FeatureList& features, int count) const -> float {
+        const Layer& hidden = layers[0];
+        const Layer& output = layers[1];
+        float sum = output.biases[0];
+        for (std::size_t j = 0; j < hidden.weights.size(); ++j) {
+            float value = hidden.biases[j];
+            for (int k = 0; k < count; ++k) {
+                value += hidden.weights[j][static_cast<std::size_t>(features[k])];
+            }
+            sum += output.weights[0][j] * std::max(0.0F, value);
+        }
+        return std::tanh(sum);
+    }
 
-                    layer.activations[j] = std::tanh(sum);
-                } else {
+    auto optimizerConfig() const -> TrainingMath::OptimizerConfig {
+        TrainingMath::OptimizerConfig result;
+        result.type = config.optimizer;
+        result.learningRate = config.learningRate;
+        result.weightDecay = config.weightDecay;
+        return result;
+    }
 
-                    layer.activations[j] = std::max(0.0F, sum);
-                }
+    auto pool() -> ThreadPool& {
+        const unsigned int hardware = std::max(1U, std::thread::hardware_concurrency());
+        const int wanted =
+            config.trainingThreads > 0 ? config.trainingThreads : static_cast<int>(hardware);
+        if (!trainer.pool || trainer.pool->size() != wanted) {
+            trainer.pool = std::make_unique<ThreadPool>(wanted);
+        }
+        return *trainer.pool;
+    }
+
+    void packParameters() {
+        const std::size_t hidden = hiddenCount();
+        const auto inputs = static_cast<std::size_t>(QuantizedNetwork::INPUT_SIZE);
+        auto& params = trainer.params;
+        params.resize(((inputs + 2) * hidden) + 1);
+        for (std::size_t h = 0; h < hidden; ++h) {
+            for (std::size_t f = 0; f < inputs; ++f) {
+                params[(f * hidden) + h] = layers[0].weights[h][f];
             }
+        }
+        std::ranges::copy(layers[1].weights[0], params.begin() + (inputs * hidden));
+        std::ranges::copy(layers[0].biases, params.begin() + ((inputs + 1) * hidden));
+        params.back() = layers[1].biases[0];
+        if (trainer.optimizer.size() != params.size()) {
+            trainer.optimizer.resize(params.size());
+        }
+    }
 
-            currentInput = layer.activations;
+    void unpackParameters() {
+        const std::size_t hidden = hiddenCount();
+        const auto inputs = static_cast<std::size_t>(QuantizedNetwork::INPUT_SIZE);
+        const auto& params = trainer.params;
+        for (std::size_t h = 0; h < hidden; ++h) {
+            for (std::size_t f = 0; f < inputs; ++f) {
+                layers[0].weights[h][f] = params[(f * hidden) + h];
+            }
         }
+        const auto outputWeights = params.begin() + static_cast<std::ptrdiff_t>(inputs * hidden);
+        std::copy_n(outputWeights, hidden, layers[1].weights[0].begin());
+        std::copy_n(outputWeights + static_cast<std::ptrdiff_t>(hidden), hidden,
+                    layers[0].biases.begin());
+        layers[1].biases[0] = params.back();
+    }
+
+    // Adds one example's gradient to grad and returns its squared error. hidden and scratch
+    // hold hiddenCount() floats each.
+    auto accumulateGradient(const SparseExample& example, float* grad, float* hidden,
+                            float* scratch) const -> float {
+        const std::size_t count = hiddenCount();
+        const auto inputs = static_cast<std::size_t>(QuantizedNetwork::INPUT_SIZE);
+        const float* featureWeights = trainer.params.data();
+        const float* outputWeights = featureWeights + (inputs * count);
+        const float* hiddenBiases = outputWeights + count;
+        const float outputBias = hiddenBiases[count];
+
+        std::copy_n(hiddenBiases, count, hidden);
+        for (int k = 0; k < example.featureCount; ++k) {
+            const auto feature = static_cast<std::size_t>(example.features[k]);
+            TrainingMath::axpy(1.0F, featureWeights + (feature * count), hidden, count);
+        }
+        for (std::size_t h = 0; h < count; ++h) {
+            scratch[h] = std::max(0.0F, hidden[h]);
+        }
+        const float predicted =
+            std::tanh(TrainingMath::dot(outputWeights, scratch, count) + outputBias);
+        const float error = predicted - example.target;
+        const float delta = error * (1.0F - (predicted * predicted));
+
+        float* featureGrad = grad;
+        float* outputGrad = featureGrad + (inputs * count);
+        float* hiddenBiasGrad = outputGrad + count;
+        TrainingMath::axpy(delta, scratch, outputGrad, count);
+        hiddenBiasGrad[count] += delta;
+        for (std::size_t h = 0; h < count; ++h) {
+            scratch[h] = hidden[h] > 0.0F ? delta * outputWeights[h] : 0.0F;
+        }
+        TrainingMath::axpy(1.0F, scratch, hiddenBiasGrad, count);
+        for (int k = 0; k < example.featureCount; ++k) {
+            const auto feature = static_cast<std::size_t>(example.features[k]);
+            TrainingMath::axpy(1.0F, scratch, featureGrad + (feature * count), count);
+        }
+        return error * error;
+    }
 
-        return layers.back().activations[0];
+    // One optimizer step on batch[0, count); returns the summed squared error.
+    auto trainBatch(const std::vector<SparseExample>& batch, std::size_t count) -> float {
+        ThreadPool& workers = pool();
+        const std::size_t paramCount = trainer.params.size();
+        const std::size_t shards = (count + kShardSize - 1) / kShardSize;
+        if (trainer.shardGradients.size() < shards) {
+            trainer.shardGradients.resize(shards);
+        }
+        trainer.shardLoss.assign(shards, 0.0F);
+        workers.run(shards, [&](std::size_t shard) {
+            auto& grad = trainer.shardGradients[shard];
+            grad.assign(paramCount, 0.0F);
+            std::vector<float> hidden(hiddenCount());
+            std::vector<float> scratch(hiddenCount());
+            const std::size_t end = std::min(count, (shard + 1) * kShardSize);
+            float loss = 0.0F;
+            for (std::size_t i = shard * kShardSize; i < end; ++i) {
+                loss += accumulateGradient(batch[i], grad.data(), hidden.data(), scratch.data());
+            }
+            trainer.shardLoss[shard] = loss;
+        });
+
+        const TrainingMath::OptimizerConfig optimizer = optimizerConfig();
+        trainer.optimizer.beginStep(optimizer);
+        const float scale = 1.0F / static_cast<float>(count);
+        const std::size_t decayEnd = (static_cast<std::size_t>(QuantizedNetwork::INPUT_SIZE) + 1) *
+                                     hiddenCount();
+        const std::size_t chunks = (paramCount + kUpdateChunk - 1) / kUpdateChunk;
+        workers.run(chunks, [&](std::size_t chunk) {
+            const std::size_t begin = chunk * kUpdateChunk;
+            const std::size_t end = std::min(paramCount, begin + kUpdateChunk);
+            float* total = trainer.shardGradients[0].data();
+            for (std::size_t shard = 1; shard < shards; ++shard) {
+                TrainingMath::axpy(1.0F, trainer.shardGradients[shard].data() + begin,
+                                   total + begin, end - begin);
+            }
+            for (std::size_t i = begin; i < end; ++i) {
+                total[i] *= scale;
+            }
+            trainer.optimizer.update(optimizer, trainer.params.data(), total, begin, end,
+                                     decayEnd);
+        });
+
+        float loss = 0.0F;
+        for (const float shardLoss : trainer.shardLoss) {
+            loss += shardLoss;
+        }
+        return loss;
     }
 
     auto infer(const std::vector<float>& input) const -> float {
@@ -139,64 +316,6 @@ public:
         return currentInput.empty() ? 0.0F : currentInput[0];
     }
 
-    void backwardPass(const std::vector<float>& input, float target, float predicted) {
-
-        float lossGradient = predicted - target;
-        std::vector<float> nextGradient = {lossGradient};
-
-        for (int i = static_cast<int>(layers.size()) - 1; i >= 0; --i) {
-            Layer& layer = layers[i];
-            std::vector<float> currentGradient(layer.weights.size());
-
-            for (size_t j = 0; j < layer.weights.size(); ++j) {
-                float activationGradient = nextGradient[j];
-
-                if (static_cast<size_t>(i) == layers.size() - 1) {
-
-                    activationGradient *= (1.0F - (layer.activations[j] * layer.activations[j]));
-                } else {
-
-                    if (layer.activations[j] <= 0) {
-                        activationGradient = 0.0F;
-                    }
-                }
-
-                layer.gradients[j] = activationGradient;
-                currentGradient[j] = activationGradient;
-            }
-
-            if (i > 0) {
-                std::vector<float> prevInput = (i == 0) ? input : layers[i - 1].activations;
-                nextGradient.resize(prevInput.size(), 0.0F);
-
-                for (size_t j = 0; j < layer.weights.size(); ++j) {
-                    for (size_t k = 0; k < layer.weights[j].size(); ++k) {
-                        nextGradient[k] += layer.weights[j][k] * currentGradient[j];
-                    }
-                }
-            }
-        }
-    }
-
-    void updateWeights(const std::vector<float>& input, float learningRate) {
-        std::vector<float> currentInput = input;
-
-        for (size_t i = 0; i < layers.size(); ++i) {
-            Layer& layer = layers[i];
-
-            for (size_t j = 0; j < layer.weights.size(); ++j) {
-                for (size_t k = 0; k < layer.weights[j].size(); ++k) {
-                    layer.weights[j][k] -= learningRate * layer.gradients[j] * currentInput[k];
-                }
-                layer.biases[j] -= learningRate * layer.gradients[j];
-            }
-
-            if (i < layers.size() - 1) {
-                currentInput = layer.activations;
-            }
-        }
-    }
-
     void saveModel(const std::string& path) {
         std::ofstream file(path, std::ios::binary);
         if (!file.is_open()) {
@@ -295,6 +414,8 @@ public:
         }
 
         file.close();
+        quantize();
+        trainer.optimizer.resize(0);
         std::cout << "Model loaded from: " << path << '\n';
     }
 };
@@ -307,63 +428,86 @@ NeuralNetworkEvaluator::NeuralNetworkEvaluator(const NetworkConfig& config)
 NeuralNetworkEvaluator::~NeuralNetworkEvaluator() = default;
 
 auto NeuralNetworkEvaluator::evaluatePosition(const Board& board) -> float {
+    if (m_pImpl->isSparse()) {
+        QuantizedNetwork::FeatureList features{};
+        const int count = QuantizedNetwork::activeFeatures(board, features);
+        return m_pImpl->inferSparse(features, count) * 1000.0F;
+    }
     std::vector<float> input = encodePosition(board);
     float evaluation = m_pImpl->infer(input);
     return evaluation * 1000.0F;
 }
 
-auto NeuralNetworkEvaluator::encodePosition(const Board& board) -> std::vector<float> {
-    std::vector<float> encoding(768, 0.0F);
-
-    for (int square = 0; square < 64; ++square) {
-        const Piece& piece = board.squares[square].piece;
-        if (piece.PieceType != ChessPieceType::NONE) {
-            int pieceIndex = static_cast<int>(piece.PieceType) - 1;
-            if (piece.PieceColor == ChessPieceColor::BLACK) {
-                pieceIndex += 6;
-            }
-            encoding[(square * 12) + pieceIndex] = 1.0F;
-        }
+auto NeuralNetworkEvaluator::evaluateQuantized(const Board& board,
+                                               QuantizedNetwork::Accumulator& acc) const
+    -> float {
+    if (m_pImpl->quantized.empty()) {
+        return m_pImpl->infer(encodePosition(board)) * 1000.0F;
     }
+    return m_pImpl->quantized.evaluate(board, acc) * 1000.0F;
+}
+
+auto NeuralNetworkEvaluator::evaluateQuantized(const Board& board) -> float {
+    return evaluateQuantized(board, m_pImpl->accumulator);
+}
 
+auto NeuralNetworkEvaluator::encodePosition(const Board& board) const -> std::vector<float> {
+    std::vector<float> encoding(QuantizedNetwork::INPUT_SIZE, 0.0F);
+    QuantizedNetwork::FeatureList features{};
+    const int count = QuantizedNetwork::activeFeatures(board, features);
+    for (int i = 0; i < count; ++i) {
+        encoding[static_cast<std::size_t>(features[i])] = 1.0F;
+    }
     return encoding;
 }
 
-void NeuralNetworkEvaluator::train(const std::vector<std::pair<Board, float>>& trainingData) {
+auto NeuralNetworkEvaluator::train(const std::vector<std::pair<Board, float>>& trainingData)
+    -> TrainingStats {
+    TrainingStats stats;
     if (trainingData.empty()) {
         std::cerr << "Warning: No training data provided" << '\n';
-        return;
+        return stats;
+    }
+    if (!m_pImpl->isSparse()) {
+        std::cerr << "Warning: Training needs a 768-input network with one hidden layer" << '\n';
+        return stats;
     }
 
     std::cout << "Training neural network with " << trainingData.size() << " positions..." << '\n';
-    float totalLoss = 0.0F;
-    int batchSize = std::min(32, static_cast<int>(trainingData.size()));
-
-    for (size_t i = 0; i < trainingData.size(); i += batchSize) {
-        float batchLoss = 0.0F;
-
-        for (int j = 0; j < batchSize && i + j < trainingData.size(); ++j) {
+    const auto start = std::chrono::steady_clock::now();
+    m_pImpl->packParameters();
+
+    const auto batchSize = static_cast<std::size_t>(std::max(1, m_pImpl->config.batchSize));
+    std::vector<Impl::SparseExample> batch(batchSize);
+    double totalLoss = 0.0;
+    std::size_t batchIndex = 0;
+    for (std::size_t i = 0; i < trainingData.size(); i += batchSize, ++batchIndex) {
+        const std::size_t count = std::min(batchSize, trainingData.size() - i);
+        for (std::size_t j = 0; j < count; ++j) {
             const auto& [board, target] = trainingData[i + j];
-            std::vector<float> input = encodePosition(board);
-            float predicted = m_pImpl->forwardPass(input);
-            float normalizedTarget = std::tanh(target / 1000.0F);
-            m_pImpl->backwardPass(input, normalizedTarget, predicted);
-            m_pImpl->updateWeights(input, m_pImpl->config.learningRate);
-            batchLoss += (predicted - normalizedTarget) * (predicted - normalizedTarget);
+            batch[j].featureCount = QuantizedNetwork::activeFeatures(board, batch[j].features);
+            batch[j].target = std::tanh(target / 1000.0F);
         }
-
-        totalLoss += batchLoss / static_cast<float>(batchSize);
-
-        if ((i / batchSize) % 100 == 0) {
-            std::cout << "Batch " << (i / batchSize)
-                      << ", Loss: " << (batchLoss / static_cast<float>(batchSize)) << '\n';
+        const float batchLoss = m_pImpl->trainBatch(batch, count);
+        totalLoss += batchLoss;
+        if (batchIndex % kReportInterval == 0) {
+            std::cout << "Batch " << batchIndex
+                      << ", Loss: " << (batchLoss / static_cast<float>(count)) << '\n';
         }
     }
 
-    std::cout << "Training completed. Average loss: "
-              << (totalLoss /
-                  (static_cast<float>(trainingData.size()) / static_cast<float>(batchSize)))
+    m_pImpl->unpackParameters();
+    m_pImpl->quantize();
+    stats.positions = trainingData.size();
+    stats.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.positionsPerSecond =
+        stats.seconds > 0.0 ? static_cast<double>(stats.positions) / stats.seconds : 0.0;
+    stats.averageLoss = static_cast<float>(totalLoss / static_cast<double>(stats.positions));
+    std::cout << "Training completed. Average loss: " << stats.averageLoss << " ("
+              << static_cast<std::uint64_t>(stats.positionsPerSecond) << " positions/sec)"
               << '\n';
+    return stats;
 }
 
 void NeuralNetworkEvaluator::saveModel(const std::string& path) {
@@ -396,11 +540,7 @@ auto NeuralNetworkEvaluator::pieceToVector(const Piece& piece, int square) -> st
     (void)square;
     std::vector<float> vec(12, 0.0F);
     if (piece.PieceType != ChessPieceType::NONE) {
-        int index = static_cast<int>(piece.PieceType) - 1;
-        if (piece.PieceColor == ChessPieceColor::BLACK) {
-            index += 6;
-        }
-        vec[index] = 1.0F;
+        vec[static_cast<std::size_t>(QuantizedNetwork::featureIndex(0, piece))] = 1.0F;
     }
     return vec;
 }
@@ -803,6 +943,35 @@ void TrainingDataGenerator::saveTrainingData(const std::vector<TrainingExample>&
     std::cout << "Training data saved to: " << path << '\n';
 }
 
+void TrainingDataGenerator::savePackedTrainingData(const std::vector<TrainingExample>& data,
+                                                   const std::string& path) {
+    std::filesystem::path filePath(path);
+    std::filesystem::create_directories(filePath.parent_path());
+    PositionFile::Writer writer(path);
+    if (!writer.isOpen()) {
+        std::cerr << "Error: Could not open file for writing: " << path << '\n';
+        return;
+    }
+
+    std::size_t skipped = 0;
+    for (const auto& example : data) {
+        PositionFile::PackedPosition packed;
+        if (PositionFile::PackedPosition::pack(example.position,
+                                               static_cast<int>(std::lround(example.targetScore)),
+                                               example.gameResult, packed)) {
+            writer.write(packed);
+        } else {
+            ++skipped;
+        }
+    }
+    if (!writer.close()) {
+        std::cerr << "Error: Failed writing training data: " << path << '\n';
+        return;
+    }
+    std::cout << "Training data saved to: " << path << " (" << writer.positions()
+              << " positions, " << skipped << " skipped)" << '\n';
+}
+
 auto TrainingDataGenerator::loadTrainingData(const std::string& path)
     -> std::vector<TrainingDataGenerator::TrainingExample> {
     std::vector<TrainingExample> data;
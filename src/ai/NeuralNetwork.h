@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../core/ChessBoard.h"
+#include "QuantizedNetwork.h"
+#include "TrainingMath.h"
 
 #include <array>
+#include <cstddef>
 #include <memory>
 #include <random>
 #include <string>
@@ -16,8 +19,19 @@ public:
         int outputSize{1};
         float learningRate{0.001F};
         std::string modelPath{"models/chess_nn.bin"};
+        TrainingMath::Optimizer optimizer{TrainingMath::Optimizer::ADAMW};
+        float weightDecay{0.01F};
+        int batchSize{256};
+        // 0 uses every hardware thread. Results do not depend on the thread count.
+        int trainingThreads{0};
         NetworkConfig() = default;
     };
+    struct TrainingStats {
+        std::size_t positions{0};
+        double seconds{0.0};
+        double positionsPerSecond{0.0};
+        float averageLoss{0.0F};
+    };
     NeuralNetworkEvaluator();
     NeuralNetworkEvaluator(const NetworkConfig& config);
     ~NeuralNetworkEvaluator();
@@ -26,8 +40,14 @@ public:
     NeuralNetworkEvaluator(NeuralNetworkEvaluator&&) = delete;
     auto operator=(NeuralNetworkEvaluator&&) -> NeuralNetworkEvaluator& = delete;
     auto evaluatePosition(const Board& board) -> float;
-    auto encodePosition(const Board& board) -> std::vector<float>;
-    void train(const std::vector<std::pair<Board, float>>& trainingData);
+    // Same scale as evaluatePosition, computed from an integer copy of the weights that is
+    // rebuilt whenever they change. acc carries the hidden layer between calls, so nearby
+    // positions cost only their piece differences; use one per thread.
+    auto evaluateQuantized(const Board& board, QuantizedNetwork::Accumulator& acc) const -> float;
+    auto evaluateQuantized(const Board& board) -> float;
+    auto encodePosition(const Board& board) const -> std::vector<float>;
+    // One epoch of minibatch training over trainingData, in order.
+    auto train(const std::vector<std::pair<Board, float>>& trainingData) -> TrainingStats;
     void saveModel(const std::string& path);
     void loadModel(const std::string& path);
 
@@ -72,6 +92,10 @@ public:
         -> std::vector<std::pair<Board, float>>;
 
     void saveTrainingData(const std::vector<TrainingExample>& data, const std::string& path);
+    // Writes a compressed PositionFile; scores are rounded to centipawns and results to
+    // win/draw/loss.
+    void savePackedTrainingData(const std::vector<TrainingExample>& data,
+                                const std::string& path);
     auto loadTrainingData(const std::string& path) -> std::vector<TrainingExample>;
 
 private:
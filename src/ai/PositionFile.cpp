@@ -0,0 +1,345 @@
+#include "PositionFile.h"
+#include "../utils/ThreadPool.h"
+#include "ChessBoard.h"
+#include "ChessPiece.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace PositionFile {
+
+namespace {
+constexpr std::size_t kRecordSize = sizeof(PackedPosition);
+// Payloads are padded so every chunk, and so every raw record, starts 32-byte aligned.
+constexpr std::size_t kPayloadAlignment = 32;
+constexpr std::size_t kMaxRun = 128;
+constexpr std::uint8_t kZeroRunFlag = 0x80;
+constexpr int kMaxResult = 2;
+
+struct FileHeader {
+    std::uint32_t magic = MAGIC;
+    std::uint32_t version = VERSION;
+    std::uint64_t reserved = 0;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+struct ChunkHeader {
+    std::uint32_t positions = 0;
+    Codec codec = Codec::RAW;
+    std::uint64_t bytes = 0;
+};
+static_assert(sizeof(ChunkHeader) == 16);
+
+std::size_t paddedSize(std::size_t bytes) {
+    return (bytes + kPayloadAlignment - 1) & ~(kPayloadAlignment - 1);
+}
+} // namespace
+
+bool PackedPosition::pack(const Board& board, int score, float gameResult, PackedPosition& out) {
+    out = PackedPosition{};
+    int count = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        const Piece& piece = board.squares[sq].piece;
+        if (piece.PieceType == ChessPieceType::NONE) {
+            continue;
+        }
+        if (count == MAX_PIECES) {
+            return false;
+        }
+        const int code = static_cast<int>(piece.PieceType) +
+                         (piece.PieceColor == ChessPieceColor::BLACK ? 6 : 0);
+        out.occupancy |= std::uint64_t{1} << sq;
+        out.pieces[static_cast<std::size_t>(count / 2)] |=
+            static_cast<std::uint8_t>(code << ((count % 2) * 4));
+        ++count;
+    }
+
+    const bool black = board.turn == ChessPieceColor::BLACK;
+    out.flags = static_cast<std::uint8_t>((board.castlingRights() & CASTLING_MASK) |
+                                          (black ? BLACK_TO_MOVE : 0));
+    if (const auto& target = board.enPassantSquare.target(); target.has_value()) {
+        out.enPassant = static_cast<std::uint8_t>(target->value);
+    }
+    out.rule50 = static_cast<std::uint8_t>(std::clamp(board.halfmoveClock, 0, 255));
+    const int ply = ((std::max(board.fullmoveNumber, 1) - 1) * 2) + (black ? 1 : 0);
+    out.ply = static_cast<std::uint16_t>(
+        std::min(ply, static_cast<int>(std::numeric_limits<std::uint16_t>::max())));
+    out.score = static_cast<std::int16_t>(std::clamp(score, -32767, 32767));
+    out.result = static_cast<std::uint8_t>(
+        std::clamp(static_cast<int>(std::lround(gameResult * 2.0F)), 0, kMaxResult));
+    return true;
+}
+
+void PackedPosition::unpack(Board& board) const {
+    board = Board();
+    forEachPiece([&](int square, ChessPieceType type, ChessPieceColor color) {
+        board.squares[square].piece = Piece(color, type);
+    });
+    board.turn = sideToMove();
+    board.clearCastlingRights(CastlingConstants::kAllCastlingRightsMask);
+    board.setCastlingRight(static_cast<std::uint8_t>(flags & CASTLING_MASK));
+    if (enPassant < NO_EN_PASSANT) {
+        board.enPassantSquare = static_cast<int>(enPassant);
+    } else {
+        board.enPassantSquare = std::nullopt;
+    }
+    board.halfmoveClock = rule50;
+    board.fullmoveNumber = (ply / 2) + 1;
+    board.updateBitboards();
+}
+
+void encodeChunk(std::span<const PackedPosition> positions, std::vector<std::uint8_t>& out) {
+    const std::size_t count = positions.size();
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(positions.data());
+    std::vector<std::uint8_t> planes(count * kRecordSize);
+    std::array<std::uint8_t, kRecordSize> previous{};
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint8_t* record = bytes + (i * kRecordSize);
+        for (std::size_t b = 0; b < kRecordSize; ++b) {
+            planes[(b * count) + i] = record[b] ^ previous[b];
+            previous[b] = record[b];
+        }
+    }
+
+    // Tokens: 0x80 | (n - 1) is a run of n zero bytes, n - 1 is followed by n literal bytes.
+    const std::size_t size = planes.size();
+    out.resize(size + (size / kMaxRun) + 1);
+    std::uint8_t* cursor = out.data();
+    std::size_t i = 0;
+    while (i < size) {
+        std::size_t run = 0;
+        while (i + run < size && run < kMaxRun && planes[i + run] == 0) {
+            ++run;
+        }
+        if (run >= 2 || (run == 1 && i + 1 == size)) {
+            *cursor++ = static_cast<std::uint8_t>(kZeroRunFlag | (run - 1));
+            i += run;
+            continue;
+        }
+        std::size_t literal = 1;
+        while (i + literal < size && literal < kMaxRun &&
+               !(planes[i + literal] == 0 && i + literal + 1 < size &&
+                 planes[i + literal + 1] == 0)) {
+            ++literal;
+        }
+        *cursor++ = static_cast<std::uint8_t>(literal - 1);
+        std::memcpy(cursor, planes.data() + i, literal);
+        cursor += literal;
+        i += literal;
+    }
+    out.resize(static_cast<std::size_t>(cursor - out.data()));
+}
+
+bool decodeChunk(std::span<const std::uint8_t> bytes, std::size_t count,
+                 std::vector<PackedPosition>& out) {
+    const std::size_t size = count * kRecordSize;
+    std::vector<std::uint8_t> planes(size);
+    std::size_t written = 0;
+    std::size_t i = 0;
+    while (i < bytes.size()) {
+        const std::uint8_t token = bytes[i++];
+        const std::size_t length = static_cast<std::size_t>(token & ~kZeroRunFlag) + 1;
+        if (length > size - written) {
+            return false;
+        }
+        if ((token & kZeroRunFlag) != 0) {
+            std::fill_n(planes.begin() + static_cast<std::ptrdiff_t>(written), length, 0);
+        } else {
+            if (length > bytes.size() - i) {
+                return false;
+            }
+            std::memcpy(planes.data() + written, bytes.data() + i, length);
+            i += length;
+        }
+        written += length;
+    }
+    if (written != size) {
+        return false;
+    }
+
+    out.resize(count);
+    auto* records = reinterpret_cast<std::uint8_t*>(out.data());
+    std::array<std::uint8_t, kRecordSize> value{};
+    for (std::size_t r = 0; r < count; ++r) {
+        std::uint8_t* record = records + (r * kRecordSize);
+        for (std::size_t b = 0; b < kRecordSize; ++b) {
+            value[b] ^= planes[(b * count) + r];
+            record[b] = value[b];
+        }
+    }
+    return true;
+}
+
+bool Reader::open(const std::string& path) {
+    mapping = NetworkFile::Mapping::open(path);
+    total = 0;
+    if (!mapping) {
+        return false;
+    }
+    const std::span<const std::byte> bytes = mapping->bytes();
+    FileHeader header;
+    if (bytes.size() < sizeof(header)) {
+        mapping.reset();
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION) {
+        mapping.reset();
+        return false;
+    }
+    rewind();
+    std::size_t position = sizeof(FileHeader);
+    while (bytes.size() - position >= sizeof(ChunkHeader)) {
+        ChunkHeader chunk;
+        std::memcpy(&chunk, bytes.data() + position, sizeof(chunk));
+        position += sizeof(chunk);
+        if (chunk.bytes > bytes.size() - position) {
+            break;
+        }
+        total += chunk.positions;
+        position += std::min(paddedSize(chunk.bytes), bytes.size() - position);
+    }
+    return true;
+}
+
+void Reader::rewind() {
+    offset = sizeof(FileHeader);
+    current = {};
+    index = 0;
+}
+
+bool Reader::nextChunk(std::span<const PackedPosition>& positions) {
+    if (!mapping) {
+        return false;
+    }
+    const std::span<const std::byte> bytes = mapping->bytes();
+    while (bytes.size() - offset >= sizeof(ChunkHeader)) {
+        ChunkHeader chunk;
+        std::memcpy(&chunk, bytes.data() + offset, sizeof(chunk));
+        const std::size_t payload = offset + sizeof(chunk);
+        if (chunk.bytes > bytes.size() - payload) {
+            break;
+        }
+        offset = payload + std::min(paddedSize(chunk.bytes), bytes.size() - payload);
+        const std::byte* data = bytes.data() + payload;
+        if (chunk.codec == Codec::RAW) {
+            const auto address = reinterpret_cast<std::uintptr_t>(data);
+            if (chunk.bytes != std::uint64_t{chunk.positions} * kRecordSize ||
+                address % alignof(PackedPosition) != 0) {
+                break;
+            }
+            positions = {reinterpret_cast<const PackedPosition*>(data), chunk.positions};
+        } else if (chunk.codec == Codec::DELTA_RLE) {
+            const std::span<const std::uint8_t> encoded(
+                reinterpret_cast<const std::uint8_t*>(data), chunk.bytes);
+            if (!decodeChunk(encoded, chunk.positions, buffer)) {
+                break;
+            }
+            positions = buffer;
+        } else {
+            break;
+        }
+        if (!positions.empty()) {
+            return true;
+        }
+    }
+    offset = bytes.size();
+    return false;
+}
+
+bool Reader::next(PackedPosition& position) {
+    while (index == current.size()) {
+        if (!nextChunk(current)) {
+            current = {};
+            index = 0;
+            return false;
+        }
+        index = 0;
+    }
+    position = current[index++];
+    return true;
+}
+
+Writer::Writer(const std::string& path, const WriterOptions& options)
+    : out(path, std::ios::binary | std::ios::trunc), options(options),
+      pool(std::make_unique<ThreadPool>(options.threads)) {
+    this->options.chunkPositions = std::clamp<std::size_t>(
+        options.chunkPositions, 1, std::numeric_limits<std::uint32_t>::max());
+    if (out) {
+        const FileHeader header;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+}
+
+Writer::~Writer() {
+    close();
+}
+
+void Writer::write(const PackedPosition& position) {
+    write(std::span<const PackedPosition>(&position, 1));
+}
+
+void Writer::write(std::span<const PackedPosition> positions) {
+    while (!positions.empty()) {
+        if (pending.empty() || pending.back().size() == options.chunkPositions) {
+            if (pending.size() == static_cast<std::size_t>(pool->size())) {
+                flush();
+            }
+            pending.emplace_back().reserve(options.chunkPositions);
+        }
+        auto& chunk = pending.back();
+        const std::size_t take = std::min(positions.size(), options.chunkPositions - chunk.size());
+        chunk.insert(chunk.end(), positions.begin(),
+                     positions.begin() + static_cast<std::ptrdiff_t>(take));
+        positions = positions.subspan(take);
+        written += take;
+    }
+}
+
+void Writer::flush() {
+    if (pending.empty()) {
+        return;
+    }
+    encoded.resize(pending.size());
+    if (options.compress) {
+        pool->run(pending.size(),
+                  [&](std::size_t i) { encodeChunk(pending[i], encoded[i]); });
+    }
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        const auto& chunk = pending[i];
+        // Keep whichever is smaller; random positions may not compress at all.
+        const bool raw = !options.compress || encoded[i].size() >= chunk.size() * kRecordSize;
+        ChunkHeader header;
+        header.positions = static_cast<std::uint32_t>(chunk.size());
+        header.codec = raw ? Codec::RAW : Codec::DELTA_RLE;
+        header.bytes = raw ? chunk.size() * kRecordSize : encoded[i].size();
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const char* payload = raw ? reinterpret_cast<const char*>(chunk.data())
+                                  : reinterpret_cast<const char*>(encoded[i].data());
+        out.write(payload, static_cast<std::streamsize>(header.bytes));
+        static constexpr char kPadding[kPayloadAlignment] = {};
+        out.write(kPadding, static_cast<std::streamsize>(paddedSize(header.bytes) - header.bytes));
+    }
+    pending.clear();
+}
+
+bool Writer::close() {
+    if (!out.is_open()) {
+        return false;
+    }
+    flush();
+    out.close();
+    return !out.fail();
+}
+
+} // namespace PositionFile
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "../core/ChessBoard.h"
+#include "../evaluation/NetworkFile.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Training positions on disk: 32-byte records grouped into chunks that are either stored raw,
+// so readers can use them straight from the mapped file, or compressed.
+namespace PositionFile {
+
+inline constexpr std::uint32_t MAGIC = 0x504F5346;
+inline constexpr std::uint32_t VERSION = 1;
+inline constexpr int MAX_PIECES = 32;
+inline constexpr std::uint8_t NO_EN_PASSANT = 64;
+
+// One position with its label. Pieces are stored as 4-bit codes (type + 6 for black) in the
+// order of the occupied squares, low nibble first. Score and result are from white's side.
+struct PackedPosition {
+    std::uint64_t occupancy = 0;
+    std::array<std::uint8_t, MAX_PIECES / 2> pieces{};
+    std::int16_t score = 0;
+    std::uint16_t ply = 0;
+    // Castling rights in the low four bits, side to move in the top bit.
+    std::uint8_t flags = 0;
+    std::uint8_t enPassant = NO_EN_PASSANT;
+    std::uint8_t rule50 = 0;
+    // 0 black won, 1 draw, 2 white won.
+    std::uint8_t result = 1;
+
+    static constexpr std::uint8_t BLACK_TO_MOVE = 0x80;
+    static constexpr std::uint8_t CASTLING_MASK = 0x0F;
+
+    // Fails for boards with more than MAX_PIECES pieces. Scores are clamped to int16 and the
+    // result is rounded to the nearest of loss, draw and win.
+    static bool pack(const Board& board, int score, float gameResult, PackedPosition& out);
+    void unpack(Board& board) const;
+
+    ChessPieceColor sideToMove() const {
+        return (flags & BLACK_TO_MOVE) != 0 ? ChessPieceColor::BLACK : ChessPieceColor::WHITE;
+    }
+
+    float gameResult() const {
+        return static_cast<float>(result) * 0.5F;
+    }
+
+    // Calls visit(square, type, color) for every piece in ascending square order. Squares past
+    // the first MAX_PIECES, which only a corrupt record can have, are ignored.
+    template <typename Visitor> void forEachPiece(Visitor&& visit) const {
+        std::uint64_t remaining = occupancy;
+        for (int i = 0; remaining != 0 && i < MAX_PIECES; ++i) {
+            const int square = std::countr_zero(remaining);
+            remaining &= remaining - 1;
+            const int code = (pieces[static_cast<std::size_t>(i / 2)] >> ((i % 2) * 4)) & 0xF;
+            visit(square, static_cast<ChessPieceType>(code % 6),
+                  static_cast<ChessPieceColor>(code / 6));
+        }
+    }
+};
+static_assert(sizeof(PackedPosition) == 32);
+
+enum class Codec : std::uint32_t { RAW = 0, DELTA_RLE = 1 };
+
+// Compressed chunks XOR each record with the one before it, split the result into byte planes
+// and run-length encode the zero bytes. Consecutive positions of a game mostly cancel out.
+void encodeChunk(std::span<const PackedPosition> positions, std::vector<std::uint8_t>& out);
+bool decodeChunk(std::span<const std::uint8_t> bytes, std::size_t count,
+                 std::vector<PackedPosition>& out);
+
+// Sequential reader. Raw chunks are returned in place from the mapped file; compressed ones are
+// decoded one at a time into a buffer.
+class Reader {
+public:
+    bool open(const std::string& path);
+
+    bool isOpen() const {
+        return mapping != nullptr;
+    }
+
+    // Positions in the file, counted from the chunk headers when it was opened.
+    std::size_t size() const {
+        return total;
+    }
+
+    // The next chunk's positions, valid until the following call.
+    bool nextChunk(std::span<const PackedPosition>& positions);
+    bool next(PackedPosition& position);
+    void rewind();
+
+private:
+    std::shared_ptr<const NetworkFile::Mapping> mapping;
+    std::size_t offset = 0;
+    std::size_t total = 0;
+    std::vector<PackedPosition> buffer;
+    std::span<const PackedPosition> current;
+    std::size_t index = 0;
+};
+
+struct WriterOptions {
+    bool compress = true;
+    std::size_t chunkPositions = 1U << 16;
+    // Chunks compressed in parallel; 0 uses every core.
+    int threads = 0;
+};
+
+// Buffers positions into chunks and compresses a full set of chunks across threads before
+// writing them in order.
+class Writer {
+public:
+    explicit Writer(const std::string& path, const WriterOptions& options = {});
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+    Writer(Writer&&) = delete;
+    Writer& operator=(Writer&&) = delete;
+
+    bool isOpen() const {
+        return out.is_open();
+    }
+
+    std::size_t positions() const {
+        return written;
+    }
+
+    void write(const PackedPosition& position);
+    void write(std::span<const PackedPosition> positions);
+    // Writes the buffered chunks; returns false if any write failed.
+    bool close();
+
+private:
+    void flush();
+
+    std::ofstream out;
+    WriterOptions options;
+    std::vector<std::vector<PackedPosition>> pending;
+    std::vector<std::vector<std::uint8_t>> encoded;
+    std::unique_ptr<ThreadPool> pool;
+    std::size_t written = 0;
+};
+
+} // namespace PositionFile
@@ -0,0 +1,241 @@
+#include "QuantizedNetwork.h"
+#include "ChessBoard.h"
+#include "ChessPiece.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QUANTIZED_ARM_NEON 1
+#else
+#define QUANTIZED_ARM_NEON 0
+#endif
+
+namespace {
+constexpr int kSquareCount = 64;
+constexpr int kSlotsPerSquare = 12;
+constexpr int kBlackSlotOffset = 6;
+constexpr int kLaneMultiple = 16;
+// Hidden weights are scaled so that biases plus a full set of 32 pieces fit in int16.
+constexpr int kMaxPieces = 32;
+constexpr float kAccumulatorLimit = 32000.0F;
+constexpr float kOutputWeightLimit = 127.0F;
+
+std::atomic<std::uint64_t> gNextGeneration{1};
+
+int16_t quantize(float value, float scale) {
+    const float scaled = std::round(value * scale);
+    return static_cast<int16_t>(std::clamp(scaled, -32767.0F, 32767.0F));
+}
+
+float maxAbs(const std::vector<float>& values) {
+    float result = 0.0F;
+    for (const float value : values) {
+        result = std::max(result, std::fabs(value));
+    }
+    return result;
+}
+} // namespace
+
+int QuantizedNetwork::featureIndex(int square, const Piece& piece) {
+    const int slot = static_cast<int>(piece.PieceType) +
+                     (piece.PieceColor == ChessPieceColor::BLACK ? kBlackSlotOffset : 0);
+    return (square * kSlotsPerSquare) + slot;
+}
+
+int QuantizedNetwork::activeFeatures(const Board& board, FeatureList& features) {
+    int count = 0;
+    for (int square = 0; square < kSquareCount; ++square) {
+        const Piece& piece = board.squares[square].piece;
+        if (piece.PieceType != ChessPieceType::NONE) {
+            features[static_cast<std::size_t>(count++)] =
+                static_cast<int16_t>(featureIndex(square, piece));
+        }
+    }
+    return count;
+}
+
+void QuantizedNetwork::build(const std::vector<std::vector<float>>& hiddenWeights,
+                             const std::vector<float>& hiddenLayerBiases,
+                             const std::vector<float>& outputLayerWeights,
+                             float outputLayerBias) {
+    clear();
+    const std::size_t hidden = hiddenLayerBiases.size();
+    if (hidden == 0 || hiddenWeights.size() != hidden || outputLayerWeights.size() != hidden) {
+        return;
+    }
+    float maxWeight = 0.0F;
+    for (const auto& row : hiddenWeights) {
+        if (row.size() != static_cast<std::size_t>(INPUT_SIZE)) {
+            return;
+        }
+        maxWeight = std::max(maxWeight, maxAbs(row));
+    }
+
+    const float bound = maxAbs(hiddenLayerBiases) + (static_cast<float>(kMaxPieces) * maxWeight);
+    const float hiddenScale = bound > 0.0F ? kAccumulatorLimit / bound : 1.0F;
+    const float maxOutput = maxAbs(outputLayerWeights);
+    const float weightScale = maxOutput > 0.0F ? kOutputWeightLimit / maxOutput : 1.0F;
+
+    hiddenSize = static_cast<int>(hidden);
+    paddedSize = ((hiddenSize + kLaneMultiple - 1) / kLaneMultiple) * kLaneMultiple;
+    const auto padded = static_cast<std::size_t>(paddedSize);
+    featureWeights.assign(static_cast<std::size_t>(INPUT_SIZE) * padded, 0);
+    hiddenBiases.assign(padded, 0);
+    outputWeights.assign(padded, 0);
+    for (std::size_t h = 0; h < hidden; ++h) {
+        for (std::size_t f = 0; f < static_cast<std::size_t>(INPUT_SIZE); ++f) {
+            featureWeights[(f * padded) + h] = quantize(hiddenWeights[h][f], hiddenScale);
+        }
+        hiddenBiases[h] = quantize(hiddenLayerBiases[h], hiddenScale);
+        outputWeights[h] = quantize(outputLayerWeights[h], weightScale);
+    }
+    outputBias = outputLayerBias;
+    outputScale = 1.0F / (hiddenScale * weightScale);
+    generation = gNextGeneration.fetch_add(1);
+}
+
+void QuantizedNetwork::clear() {
+    hiddenSize = 0;
+    paddedSize = 0;
+    featureWeights.clear();
+    hiddenBiases.clear();
+    outputWeights.clear();
+    generation = 0;
+}
+
+float QuantizedNetwork::evaluate(const Board& board, Accumulator& acc) const {
+    if (empty()) {
+        return 0.0F;
+    }
+
+    FeatureList features{};
+    const int count = activeFeatures(board, features);
+    if (acc.generation != generation) {
+        refresh(acc, features, count);
+    } else {
+        FeatureList added{};
+        FeatureList removed{};
+        int addedCount = 0;
+        int removedCount = 0;
+        int i = 0;
+        int j = 0;
+        while (i < acc.featureCount || j < count) {
+            if (j == count || (i < acc.featureCount && acc.features[i] < features[j])) {
+                removed[removedCount++] = acc.features[i++];
+            } else if (i == acc.featureCount || features[j] < acc.features[i]) {
+                added[addedCount++] = features[j++];
+            } else {
+                ++i;
+                ++j;
+            }
+        }
+        if (addedCount + removedCount > count) {
+            refresh(acc, features, count);
+        } else {
+            for (int k = 0; k < removedCount; ++k) {
+                removeFeature(acc.values.data(), removed[k]);
+            }
+            for (int k = 0; k < addedCount; ++k) {
+                addFeature(acc.values.data(), added[k]);
+            }
+        }
+    }
+    acc.features = features;
+    acc.featureCount = count;
+    acc.generation = generation;
+
+    return std::tanh((static_cast<float>(output(acc.values.data())) * outputScale) + outputBias);
+}
+
+void QuantizedNetwork::refresh(Accumulator& acc, const FeatureList& features, int count) const {
+    acc.values = hiddenBiases;
+    for (int k = 0; k < count; ++k) {
+        addFeature(acc.values.data(), features[k]);
+    }
+}
+
+void QuantizedNetwork::addFeature(int16_t* values, int feature) const {
+    const int16_t* row =
+        featureWeights.data() + (static_cast<std::size_t>(feature) * paddedSize);
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 16 <= paddedSize; i += 16) {
+        auto* target = reinterpret_cast<__m256i*>(values + i);
+        const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_storeu_si256(target, _mm256_add_epi16(_mm256_loadu_si256(target), weights));
+    }
+#elif QUANTIZED_ARM_NEON
+    for (; i + 8 <= paddedSize; i += 8) {
+        vst1q_s16(values + i, vaddq_s16(vld1q_s16(values + i), vld1q_s16(row + i)));
+    }
+#endif
+    for (; i < paddedSize; ++i) {
+        values[i] = static_cast<int16_t>(values[i] + row[i]);
+    }
+}
+
+void QuantizedNetwork::removeFeature(int16_t* values, int feature) const {
+    const int16_t* row =
+        featureWeights.data() + (static_cast<std::size_t>(feature) * paddedSize);
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 16 <= paddedSize; i += 16) {
+        auto* target = reinterpret_cast<__m256i*>(values + i);
+        const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_storeu_si256(target, _mm256_sub_epi16(_mm256_loadu_si256(target), weights));
+    }
+#elif QUANTIZED_ARM_NEON
+    for (; i + 8 <= paddedSize; i += 8) {
+        vst1q_s16(values + i, vsubq_s16(vld1q_s16(values + i), vld1q_s16(row + i)));
+    }
+#endif
+    for (; i < paddedSize; ++i) {
+        values[i] = static_cast<int16_t>(values[i] - row[i]);
+    }
+}
+
+int32_t QuantizedNetwork::output(const int16_t* values) const {
+    int32_t sum = 0;
+    int i = 0;
+#ifdef __AVX2__
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = _mm256_setzero_si256();
+    for (; i + 16 <= paddedSize; i += 16) {
+        const __m256i active =
+            _mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                             zero);
+        const __m256i weights =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(outputWeights.data() + i));
+        total = _mm256_add_epi32(total, _mm256_madd_epi16(active, weights));
+    }
+    __m128i sum128 =
+        _mm_add_epi32(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    sum128 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+    sum128 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 4));
+    sum += _mm_cvtsi128_si32(sum128);
+#elif QUANTIZED_ARM_NEON
+    int32x4_t total = vdupq_n_s32(0);
+    for (; i + 8 <= paddedSize; i += 8) {
+        const int16x8_t active = vmaxq_s16(vld1q_s16(values + i), vdupq_n_s16(0));
+        const int16x8_t weights = vld1q_s16(outputWeights.data() + i);
+        total = vmlal_s16(total, vget_low_s16(active), vget_low_s16(weights));
+        total = vmlal_s16(total, vget_high_s16(active), vget_high_s16(weights));
+    }
+    sum += vaddvq_s32(total);
+#endif
+    for (; i < paddedSize; ++i) {
+        sum += static_cast<int32_t>(std::max<int16_t>(values[i], 0)) *
+               static_cast<int32_t>(outputWeights[static_cast<std::size_t>(i)]);
+    }
+    return sum;
+}
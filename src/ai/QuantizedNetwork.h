@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../core/ChessBoard.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Integer copy of a trained 768 -> N -> 1 float network for inference. Hidden weights are stored
+// per input feature so the hidden layer is an accumulator that follows the pieces; the output
+// layer uses int8-range weights over the ReLU of that accumulator.
+class QuantizedNetwork {
+public:
+    static constexpr int INPUT_SIZE = 768;
+    static constexpr int MAX_FEATURES = 64;
+
+    using FeatureList = std::array<int16_t, MAX_FEATURES>;
+
+    // Hidden layer of the last position evaluated with it. Keep one per thread; evaluating a
+    // position close to the previous one only applies the differing features.
+    class Accumulator {
+    private:
+        friend class QuantizedNetwork;
+        std::vector<int16_t> values;
+        FeatureList features{};
+        int featureCount = 0;
+        std::uint64_t generation = 0;
+    };
+
+    // Twelve slots per square: white pawn..king, then black pawn..king.
+    static int featureIndex(int square, const Piece& piece);
+    // Writes the active features in ascending order and returns how many there are.
+    static int activeFeatures(const Board& board, FeatureList& features);
+
+    // hiddenWeights is [hidden][INPUT_SIZE] as trained; the output layer has one neuron.
+    void build(const std::vector<std::vector<float>>& hiddenWeights,
+               const std::vector<float>& hiddenLayerBiases,
+               const std::vector<float>& outputLayerWeights, float outputLayerBias);
+    void clear();
+
+    bool empty() const {
+        return hiddenSize == 0;
+    }
+
+    // The float network's tanh output for board, computed in integers.
+    float evaluate(const Board& board, Accumulator& acc) const;
+
+private:
+    void refresh(Accumulator& acc, const FeatureList& features, int count) const;
+    void addFeature(int16_t* values, int feature) const;
+    void removeFeature(int16_t* values, int feature) const;
+    int32_t output(const int16_t* values) const;
+
+    int hiddenSize = 0;
+    int paddedSize = 0;
+    std::vector<int16_t> featureWeights;
+    std::vector<int16_t> hiddenBiases;
+    std::vector<int16_t> outputWeights;
+    float outputBias = 0.0F;
+    float outputScale = 0.0F;
+    std::uint64_t generation = 0;
+};
@@ -0,0 +1,270 @@
+#include "Spsa.h"
+#include "../utils/TunableParams.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace Spsa {
+
+namespace {
+constexpr const char* kCheckpointHeader = "spsa-checkpoint 1";
+constexpr double kTenthOfIterations = 0.1;
+
+double stabilityConstant(const Config& config) {
+    return config.bigA >= 0.0 ? config.bigA : kTenthOfIterations * config.iterations;
+}
+
+double clampValue(const Param& param, double value) {
+    return std::clamp(value, static_cast<double>(param.minValue),
+                      static_cast<double>(param.maxValue));
+}
+
+MatchRunner::Engine shiftedEngine(const std::string& name, const std::vector<Param>& params,
+                                  const std::vector<int>& directions, double shift) {
+    MatchRunner::Engine engine = MatchRunner::currentEngine(name);
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        const Param& param = params[i];
+        engine.tunables[param.index] = static_cast<int>(std::lround(
+            clampValue(param, param.value + (shift * param.step * directions[i]))));
+    }
+    return engine;
+}
+
+Sample sample(const State& state) {
+    Sample result{state.iteration, {}};
+    for (const Param& param : state.params) {
+        result.values.push_back(param.value);
+    }
+    return result;
+}
+
+MatchRunner::Config matchConfig(const Config& config) {
+    MatchRunner::Config match = config.match;
+    match.sprt = false;
+    return match;
+}
+} // namespace
+
+const std::vector<std::string>& defaultParamNames() {
+    static const std::vector<std::string> names = {
+        "LMR_BASE",      "LMR_DIVISOR", "FUTILITY_BASE",
+        "FUTILITY_MULT", "NULL_MOVE_R", "ASPIRATION_WINDOW",
+    };
+    return names;
+}
+
+std::optional<std::vector<Param>> registeredParams(const std::vector<std::string>& names) {
+    const TunableRegistry& registry = TunableRegistry::instance();
+    const auto& all = registry.all();
+    std::vector<std::size_t> indices;
+    for (const auto& name : names.empty() ? defaultParamNames() : names) {
+        const auto index = registry.indexOf(name);
+        if (!index) {
+            return std::nullopt;
+        }
+        indices.push_back(*index);
+    }
+
+    std::vector<Param> params;
+    for (const std::size_t index : indices) {
+        const TunableParam& tunable = all[index];
+        params.push_back(Param{tunable.name, index, static_cast<double>(tunable.value.get()),
+                               tunable.defaultValue, tunable.minValue, tunable.maxValue,
+                               static_cast<double>(std::max(1, tunable.step))});
+    }
+    return params;
+}
+
+Tuner::Tuner(const Config& config, State state)
+    : config(config), current(std::move(state)), runner(matchConfig(config)) {
+    if (current.trajectory.empty()) {
+        current.trajectory.push_back(sample(current));
+    }
+}
+
+int Tuner::pairsPerIteration() const {
+    return config.pairsPerIteration > 0 ? config.pairsPerIteration : runner.workerCount();
+}
+
+void Tuner::iterate(const std::vector<std::string>& openings) {
+    const int k = current.iteration + 1;
+    const double ck = config.c / std::pow(k, config.gamma);
+    const double ak = config.a / std::pow(stabilityConstant(config) + k, config.alpha);
+
+    std::seed_seq seed{config.seed, static_cast<std::uint32_t>(k)};
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution flip(0.5);
+    std::vector<int> directions;
+    for (std::size_t i = 0; i < current.params.size(); ++i) {
+        directions.push_back(flip(rng) ? 1 : -1);
+    }
+
+    const MatchRunner::Engine plus = shiftedEngine("plus", current.params, directions, ck);
+    const MatchRunner::Engine minus = shiftedEngine("minus", current.params, directions, -ck);
+    const int pairs = pairsPerIteration();
+    const MatchRunner::Stats stats =
+        runner.play(plus, minus, openings, 2 * pairs, current.iteration * pairs);
+
+    current.wins += stats.wins;
+    current.draws += stats.draws;
+    current.losses += stats.losses;
+    current.seconds += stats.seconds;
+    if (stats.games() > 0) {
+        // Score of plus minus score of minus, over twice the perturbation.
+        const double gradient =
+            static_cast<double>(stats.wins - stats.losses) / stats.games() / (2.0 * ck);
+        for (std::size_t i = 0; i < current.params.size(); ++i) {
+            Param& param = current.params[i];
+            param.value = clampValue(param, param.value + (ak * gradient * directions[i] *
+                                                           param.step));
+        }
+    }
+
+    current.iteration = k;
+    if (k % std::max(1, config.trajectoryInterval) == 0) {
+        current.trajectory.push_back(sample(current));
+    }
+}
+
+bool saveCheckpoint(const State& state, const std::string& path) {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << kCheckpointHeader << '\n'
+            << "iteration " << state.iteration << '\n'
+            << "games " << state.wins << ' ' << state.draws << ' ' << state.losses << ' '
+            << std::format("{:.3f}", state.seconds) << '\n';
+        for (const Param& param : state.params) {
+            out << "param " << param.name << ' ' << std::format("{:.6f}", param.value) << '\n';
+        }
+        for (const Sample& entry : state.trajectory) {
+            out << "sample " << entry.iteration;
+            for (const double value : entry.values) {
+                out << ' ' << std::format("{:.6f}", value);
+            }
+            out << '\n';
+        }
+        if (!out) {
+            return false;
+        }
+    }
+    // Renamed into place so an interrupted write never replaces a good checkpoint.
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+std::optional<State> loadCheckpoint(const std::string& path, const std::vector<Param>& params) {
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != kCheckpointHeader) {
+        return std::nullopt;
+    }
+
+    State state;
+    state.params = params;
+    std::size_t nextParam = 0;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "iteration") {
+            fields >> state.iteration;
+        } else if (kind == "games") {
+            fields >> state.wins >> state.draws >> state.losses >> state.seconds;
+        } else if (kind == "param") {
+            std::string name;
+            double value = 0.0;
+            if (!(fields >> name >> value) || nextParam >= params.size() ||
+                params[nextParam].name != name) {
+                return std::nullopt;
+            }
+            state.params[nextParam].value = clampValue(params[nextParam], value);
+            ++nextParam;
+        } else if (kind == "sample") {
+            Sample entry;
+            fields >> entry.iteration;
+            double value = 0.0;
+            while (fields >> value) {
+                entry.values.push_back(value);
+            }
+            if (entry.values.size() != params.size()) {
+                return std::nullopt;
+            }
+            state.trajectory.push_back(std::move(entry));
+        } else {
+            return std::nullopt;
+        }
+        if (fields.fail() && !fields.eof()) {
+            return std::nullopt;
+        }
+    }
+    if (nextParam != params.size()) {
+        return std::nullopt;
+    }
+    return state;
+}
+
+bool writeJson(const Config& config, const State& state, const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    const long long games = state.wins + state.draws + state.losses;
+    out << "{\n";
+    out << "  \"benchmark\": \"spsa_tune\",\n";
+    out << "  \"config\": {\"iterations\": " << config.iterations << ", \"a\": " << config.a
+        << ", \"c\": " << config.c << ", \"A\": " << stabilityConstant(config)
+        << ", \"alpha\": " << config.alpha << ", \"gamma\": " << config.gamma
+        << ", \"nodes\": " << config.match.nodes << ", \"base_ms\": " << config.match.baseMs
+        << ", \"increment_ms\": " << config.match.incrementMs << "},\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < state.params.size(); ++i) {
+        const Param& param = state.params[i];
+        out << "    {\"id\": \"" << param.name << "\", \"value\": " << std::lround(param.value)
+            << ", \"raw_value\": " << std::format("{:.4f}", param.value)
+            << ", \"start\": " << std::format("{:.4f}", state.trajectory.front().values[i])
+            << ", \"default\": " << param.defaultValue << ", \"min\": " << param.minValue
+            << ", \"max\": " << param.maxValue << '}';
+        if (i + 1 < state.params.size()) {
+            out << ',';
+        }
+        out << '\n';
+    }
+    out << "  ],\n";
+    out << "  \"trajectory\": [\n";
+    for (std::size_t i = 0; i < state.trajectory.size(); ++i) {
+        const Sample& entry = state.trajectory[i];
+        out << "    {\"iteration\": " << entry.iteration;
+        for (std::size_t p = 0; p < state.params.size(); ++p) {
+            out << ", \"" << state.params[p].name
+                << "\": " << std::format("{:.4f}", entry.values[p]);
+        }
+        out << '}';
+        if (i + 1 < state.trajectory.size()) {
+            out << ',';
+        }
+        out << '\n';
+    }
+    out << "  ],\n";
+    const double gamesPerHour =
+        state.seconds > 0.0 ? static_cast<double>(games) * 3600.0 / state.seconds : 0.0;
+    out << "  \"summary\": {\"iterations\": " << state.iteration << ", \"games\": " << games
+        << ", \"wins\": " << state.wins << ", \"draws\": " << state.draws
+        << ", \"losses\": " << state.losses << ", \"seconds\": "
+        << std::format("{:.1f}", state.seconds) << ", \"games_per_hour\": "
+        << std::format("{:.0f}", gamesPerHour) << "}\n";
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace Spsa
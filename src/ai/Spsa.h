@@ -0,0 +1,98 @@
+#pragma once
+
+#include "MatchRunner.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// SPSA over TunableRegistry parameters. Every iteration moves all parameters up and down along
+// one random +-1 direction and plays the two settings against each other on the in-process
+// match runner; the score difference estimates the gradient along that direction.
+namespace Spsa {
+
+struct Param {
+    std::string name;
+    // Index into TunableRegistry::all().
+    std::size_t index = 0;
+    double value = 0.0;
+    int defaultValue = 0;
+    int minValue = 0;
+    int maxValue = 0;
+    // The registered step, the unit of the perturbation and of the update.
+    double step = 1.0;
+};
+
+struct Config {
+    int iterations = 10000;
+    // Game pairs per iteration, all with the same perturbation; 0 plays one per worker.
+    int pairsPerIteration = 0;
+    // Spall's schedules, in units of each parameter's step: iteration k perturbs by
+    // c / k^gamma and moves by a / (A + k)^alpha times the gradient estimate. A negative A uses
+    // a tenth of the iterations.
+    double a = 2.0;
+    double c = 2.0;
+    double bigA = -1.0;
+    double alpha = 0.602;
+    double gamma = 0.101;
+    std::uint32_t seed = 1;
+    // Parameter values are recorded every trajectoryInterval iterations.
+    int trajectoryInterval = 10;
+    MatchRunner::Config match;
+};
+
+struct Sample {
+    int iteration = 0;
+    std::vector<double> values;
+};
+
+struct State {
+    int iteration = 0;
+    std::vector<Param> params;
+    // Games between the two settings, from the upward-shifted side's point of view.
+    long long wins = 0;
+    long long draws = 0;
+    long long losses = 0;
+    double seconds = 0.0;
+    std::vector<Sample> trajectory;
+};
+
+// The tunables the search reads through SearchTuning. Registered parameters outside this list have
+// no effect on play, so tuning them would only add noise to every gradient estimate.
+const std::vector<std::string>& defaultParamNames();
+
+// The named registered parameters with their current values, defaulting to defaultParamNames().
+// Returns nullopt if a name is not registered.
+std::optional<std::vector<Param>> registeredParams(const std::vector<std::string>& names = {});
+
+class Tuner {
+public:
+    Tuner(const Config& config, State state);
+
+    // Plays one iteration and applies its update.
+    void iterate(const std::vector<std::string>& openings);
+
+    const State& state() const {
+        return current;
+    }
+
+    int pairsPerIteration() const;
+
+private:
+    Config config;
+    State current;
+    MatchRunner::Runner runner;
+};
+
+// Plain-text state written after every few iterations, so a long run can be resumed. load
+// returns nullopt unless the file holds exactly the parameters in params, in that order.
+bool saveCheckpoint(const State& state, const std::string& path);
+std::optional<State> loadCheckpoint(const std::string& path, const std::vector<Param>& params);
+
+// Start and final values per parameter as "results" rows that scripts/compare_bench.py can diff,
+// with the recorded trajectory and the game totals.
+bool writeJson(const Config& config, const State& state, const std::string& path);
+
+} // namespace Spsa
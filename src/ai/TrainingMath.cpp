@@ -0,0 +1,163 @@
+#include "TrainingMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TRAINING_ARM_NEON 1
+#else
+#define TRAINING_ARM_NEON 0
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+#define TRAINING_AVX2_FMA 1
+#else
+#define TRAINING_AVX2_FMA 0
+#endif
+
+namespace TrainingMath {
+
+void axpy(float a, const float* x, float* y, std::size_t n) {
+    std::size_t i = 0;
+#if TRAINING_AVX2_FMA
+    const __m256 scale = _mm256_set1_ps(a);
+    for (; i + 32 <= n; i += 32) {
+        for (std::size_t k = 0; k < 32; k += 8) {
+            _mm256_storeu_ps(y + i + k, _mm256_fmadd_ps(scale, _mm256_loadu_ps(x + i + k),
+                                                        _mm256_loadu_ps(y + i + k)));
+        }
+    }
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i,
+                         _mm256_fmadd_ps(scale, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+#elif TRAINING_ARM_NEON
+    const float32x4_t scale = vdupq_n_f32(a);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(y + i, vfmaq_f32(vld1q_f32(y + i), scale, vld1q_f32(x + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+float dot(const float* x, const float* y, std::size_t n) {
+    float sum = 0.0F;
+    std::size_t i = 0;
+#if TRAINING_AVX2_FMA
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+    }
+    const __m256 total = _mm256_add_ps(sum0, sum1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(total), _mm256_extractf128_ps(total, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    sum = _mm_cvtss_f32(half);
+#elif TRAINING_ARM_NEON
+    float32x4_t total = vdupq_n_f32(0.0F);
+    for (; i + 4 <= n; i += 4) {
+        total = vfmaq_f32(total, vld1q_f32(x + i), vld1q_f32(y + i));
+    }
+    sum = vaddvq_f32(total);
+#endif
+    for (; i < n; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+void OptimizerState::resize(std::size_t count) {
+    firstMoment.assign(count, 0.0F);
+    secondMoment.assign(count, 0.0F);
+    reset();
+}
+
+void OptimizerState::reset() {
+    std::fill(firstMoment.begin(), firstMoment.end(), 0.0F);
+    std::fill(secondMoment.begin(), secondMoment.end(), 0.0F);
+    step = 0;
+    firstCorrection = 1.0F;
+    secondCorrection = 1.0F;
+}
+
+void OptimizerState::beginStep(const OptimizerConfig& config) {
+    ++step;
+    const auto t = static_cast<float>(step);
+    firstCorrection = 1.0F - std::pow(config.beta1, t);
+    secondCorrection = 1.0F - std::pow(config.beta2, t);
+}
+
+void OptimizerState::update(const OptimizerConfig& config, float* params, const float* grads,
+                            std::size_t begin, std::size_t end, std::size_t decayEnd) {
+    const float lr = config.learningRate;
+    if (config.type == Optimizer::SGD) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const float decay = i < decayEnd ? config.weightDecay * params[i] : 0.0F;
+            params[i] -= lr * (grads[i] + decay);
+        }
+        return;
+    }
+
+    const bool decoupled = config.type == Optimizer::ADAMW;
+    const float b1 = config.beta1;
+    const float b2 = config.beta2;
+    const float stepSize = lr / firstCorrection;
+    const float secondScale = 1.0F / std::sqrt(secondCorrection);
+    float* m = firstMoment.data();
+    float* v = secondMoment.data();
+
+    // Two passes over [begin, end): the decayed prefix, then the rest.
+    const std::size_t split = std::clamp(decayEnd, begin, end);
+    for (int pass = 0; pass < 2; ++pass) {
+        const std::size_t from = pass == 0 ? begin : split;
+        const std::size_t to = pass == 0 ? split : end;
+        const float weightDecay = pass == 0 ? config.weightDecay : 0.0F;
+        const float coupledDecay = decoupled ? 0.0F : weightDecay;
+        const float shrink = decoupled ? 1.0F - (lr * weightDecay) : 1.0F;
+        std::size_t i = from;
+#if TRAINING_AVX2_FMA
+        const __m256 b1v = _mm256_set1_ps(b1);
+        const __m256 b1c = _mm256_set1_ps(1.0F - b1);
+        const __m256 b2v = _mm256_set1_ps(b2);
+        const __m256 b2c = _mm256_set1_ps(1.0F - b2);
+        const __m256 coupled = _mm256_set1_ps(coupledDecay);
+        const __m256 shrinkv = _mm256_set1_ps(shrink);
+        const __m256 stepv = _mm256_set1_ps(stepSize);
+        const __m256 scalev = _mm256_set1_ps(secondScale);
+        const __m256 eps = _mm256_set1_ps(config.epsilon);
+        for (; i + 8 <= to; i += 8) {
+            const __m256 p = _mm256_loadu_ps(params + i);
+            const __m256 g = _mm256_fmadd_ps(coupled, p, _mm256_loadu_ps(grads + i));
+            const __m256 mv =
+                _mm256_fmadd_ps(b1v, _mm256_loadu_ps(m + i), _mm256_mul_ps(b1c, g));
+            const __m256 vv = _mm256_fmadd_ps(b2v, _mm256_loadu_ps(v + i),
+                                              _mm256_mul_ps(b2c, _mm256_mul_ps(g, g)));
+            _mm256_storeu_ps(m + i, mv);
+            _mm256_storeu_ps(v + i, vv);
+            const __m256 denom = _mm256_add_ps(_mm256_mul_ps(_mm256_sqrt_ps(vv), scalev), eps);
+            const __m256 delta = _mm256_div_ps(_mm256_mul_ps(stepv, mv), denom);
+            _mm256_storeu_ps(params + i, _mm256_sub_ps(_mm256_mul_ps(p, shrinkv), delta));
+        }
+#endif
+        for (; i < to; ++i) {
+            const float g = grads[i] + (coupledDecay * params[i]);
+            m[i] = (b1 * m[i]) + ((1.0F - b1) * g);
+            v[i] = (b2 * v[i]) + ((1.0F - b2) * g * g);
+            const float denom = (std::sqrt(v[i]) * secondScale) + config.epsilon;
+            params[i] = (params[i] * shrink) - ((stepSize * m[i]) / denom);
+        }
+    }
+}
+
+} // namespace TrainingMath
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Float kernels shared by the CPU trainers. Vectorised with AVX2/FMA or NEON when available.
+namespace TrainingMath {
+
+// y += a * x
+void axpy(float a, const float* x, float* y, std::size_t n);
+float dot(const float* x, const float* y, std::size_t n);
+
+enum class Optimizer : std::uint8_t { SGD, ADAM, ADAMW };
+
+struct OptimizerConfig {
+    Optimizer type{Optimizer::ADAMW};
+    float learningRate{0.001F};
+    float beta1{0.9F};
+    float beta2{0.999F};
+    float epsilon{1e-8F};
+    // L2 penalty folded into the gradient for SGD and ADAM, decoupled for ADAMW.
+    float weightDecay{0.0F};
+};
+
+// Moment estimates for one flat parameter vector. beginStep() advances the step count once per
+// batch; update() may then run on disjoint ranges from several threads.
+class OptimizerState {
+public:
+    void resize(std::size_t count);
+    void reset();
+
+    std::size_t size() const {
+        return firstMoment.size();
+    }
+
+    void beginStep(const OptimizerConfig& config);
+    // Applies one step to params[begin, end) from grads[begin, end). Weight decay only affects
+    // indices below decayEnd, so biases can be laid out after the weights and left undecayed.
+    void update(const OptimizerConfig& config, float* params, const float* grads,
+                std::size_t begin, std::size_t end, std::size_t decayEnd);
+
+private:
+    std::vector<float> firstMoment;
+    std::vector<float> secondMoment;
+    std::uint64_t step = 0;
+    float firstCorrection = 1.0F;
+    float secondCorrection = 1.0F;
+};
+
+} // namespace TrainingMath
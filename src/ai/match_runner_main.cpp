@@ -0,0 +1,171 @@
+#include "ai/Datagen.h"
+#include "ai/MatchRunner.h"
+#include "core/BitboardMoves.h"
+#include "evaluation/ParamPack.h"
+#include "search/search.h"
+#include "utils/CommandLine.h"
+#include "utils/TunableParams.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CommandLine;
+
+namespace {
+constexpr int kDefaultReportGames = 20;
+// Random plies per pair opening when no --epd is given, as for datagen.
+constexpr int kDefaultRandomPlies = 8;
+constexpr double kMsPerSecond = 1000.0;
+constexpr double kSecondsPerHour = 3600.0;
+
+// The current engine with --<side>-params and every --<side>-option=NAME=VALUE applied.
+bool configureEngine(const std::vector<std::string>& args, const std::string& side,
+                     MatchRunner::Engine& engine) {
+    engine = MatchRunner::currentEngine(side);
+    if (const std::string path = option(args, side + "-params", ""); !path.empty()) {
+        const auto pack = ParamPack::load(path);
+        if (!pack) {
+            std::cerr << "Error: Could not load evaluation parameters: " << path << '\n';
+            return false;
+        }
+        engine.params = *pack;
+    }
+    for (const std::string& setting : repeatedOption(args, side + "-option")) {
+        const auto separator = setting.find('=');
+        if (separator == std::string::npos ||
+            !TunableRegistry::instance().set(engine.tunables, setting.substr(0, separator),
+                                             std::stoi(setting.substr(separator + 1)))) {
+            std::cerr << "Error: Invalid " << side << " option: " << setting << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cout << "Usage: match_runner [options]\n"
+              << "  --games=N            games, played in pairs per opening (default 1000)\n"
+              << "  --threads=N          concurrent game pairs, 0 for all cores (default 0)\n"
+              << "  --nodes=N            fixed nodes per move instead of a clock\n"
+              << "  --tc=S+I             seconds per game plus increment (default 10+0.1)\n"
+              << "  --epd=FILE           opening positions, played in order\n"
+              << "  --random-plies=N     random moves after each opening (default 0, or "
+              << kDefaultRandomPlies << " without --epd)\n"
+              << "  --hash=MB            hash per engine and thread (default 16)\n"
+              << "  --test-params=FILE   evaluation parameter pack of the engine under test\n"
+              << "  --test-option=N=V    tunable search parameter of the engine under test\n"
+              << "  --base-params=FILE   evaluation parameter pack of the baseline\n"
+              << "  --base-option=N=V    tunable search parameter of the baseline\n"
+              << "  --elo0=E --elo1=E    SPRT hypotheses (default 0 and 5)\n"
+              << "  --alpha=P --beta=P   SPRT error rates (default 0.05)\n"
+              << "  --no-sprt            play every game instead of stopping at a decision\n"
+              << "  --report=N           print the standings every N games (default "
+              << kDefaultReportGames << ")\n";
+}
+
+void printStandings(const MatchRunner::Config& config, const MatchRunner::Stats& stats) {
+    const MatchRunner::EloEstimate elo = MatchRunner::estimateElo(stats);
+    std::cout << std::format("Games {}: +{} ={} -{}  Elo {:.1f} +/- {:.1f}", stats.games(),
+                             stats.wins, stats.draws, stats.losses, elo.elo, elo.margin);
+    if (config.sprt) {
+        std::cout << std::format(
+            "  LLR {:.2f} ({:.2f}, {:.2f})",
+            MatchRunner::logLikelihoodRatio(stats, config.elo0, config.elo1),
+            MatchRunner::sprtLowerBound(config), MatchRunner::sprtUpperBound(config));
+    }
+    const double gamesPerHour =
+        stats.seconds > 0.0 ? stats.games() * kSecondsPerHour / stats.seconds : 0.0;
+    std::cout << std::format("  {:.0f} games/hour", gamesPerHour) << '\n';
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const std::vector<std::string> args(argv + 1, argv + argc);
+        if (hasFlag(args, "help")) {
+            printUsage();
+            return 0;
+        }
+        initKnightAttacks();
+        initKingAttacks();
+        InitZobrist();
+
+        MatchRunner::Config config;
+        config.games = std::stoi(option(args, "games", std::to_string(config.games)));
+        config.threads = std::stoi(option(args, "threads", "0"));
+        config.nodes = std::stoi(option(args, "nodes", "0"));
+        const std::string tc = option(args, "tc", "10+0.1");
+        const auto plus = tc.find('+');
+        config.baseMs = static_cast<int>(std::stod(tc.substr(0, plus)) * kMsPerSecond);
+        config.incrementMs =
+            plus == std::string::npos
+                ? 0
+                : static_cast<int>(std::stod(tc.substr(plus + 1)) * kMsPerSecond);
+        const std::string epd = option(args, "epd", "");
+        config.randomPlies = std::stoi(option(
+            args, "random-plies", epd.empty() ? std::to_string(kDefaultRandomPlies) : "0"));
+        config.hashMb = std::stoi(option(args, "hash", std::to_string(config.hashMb)));
+        config.seed = static_cast<std::uint32_t>(std::stoul(option(args, "seed", "1")));
+        config.sprt = !hasFlag(args, "no-sprt");
+        config.elo0 = std::stod(option(args, "elo0", "0"));
+        config.elo1 = std::stod(option(args, "elo1", "5"));
+        config.alpha = std::stod(option(args, "alpha", "0.05"));
+        config.beta = std::stod(option(args, "beta", "0.05"));
+        const int reportGames =
+            std::max(1, std::stoi(option(args, "report", std::to_string(kDefaultReportGames))));
+
+        MatchRunner::Engine test;
+        MatchRunner::Engine base;
+        if (!configureEngine(args, "test", test) || !configureEngine(args, "base", base)) {
+            return 1;
+        }
+
+        // A fixed-node search is deterministic, so every pair from one start position would
+        // replay the same two games and the SPRT would see a single sample.
+        if (epd.empty() && config.randomPlies == 0 && config.nodes > 0) {
+            std::cerr << "Error: --nodes needs --epd or --random-plies above 0\n";
+            return 1;
+        }
+
+        std::vector<std::string> openings;
+        if (!epd.empty()) {
+            openings = Datagen::loadOpenings(epd);
+            if (openings.empty()) {
+                std::cerr << "Error: No openings in " << epd << '\n';
+                return 1;
+            }
+            std::cout << "Loaded " << openings.size() << " openings from " << epd << '\n';
+        }
+
+        int nextReport = reportGames;
+        const MatchRunner::Stats stats =
+            MatchRunner::run(config, test, base, openings, [&](const MatchRunner::Stats& current) {
+                if (current.games() >= nextReport) {
+                    printStandings(config, current);
+                    nextReport = current.games() + reportGames;
+                }
+            });
+
+        std::cout << "Final: ";
+        printStandings(config, stats);
+        if (config.sprt) {
+            const double llr = MatchRunner::logLikelihoodRatio(stats, config.elo0, config.elo1);
+            if (llr >= MatchRunner::sprtUpperBound(config)) {
+                std::cout << "H1 accepted: test is stronger by at least elo1\n";
+            } else if (llr <= MatchRunner::sprtLowerBound(config)) {
+                std::cout << "H0 accepted: test is not stronger by elo1\n";
+            } else {
+                std::cout << "SPRT inconclusive\n";
+            }
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << '\n';
+        return 1;
+    }
+}
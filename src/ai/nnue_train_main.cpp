@@ -0,0 +1,125 @@
+#include "ai/NNUETrainer.h"
+#include "evaluation/NNUE.h"
+#include "utils/CommandLine.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace CommandLine;
+
+namespace {
+constexpr int kDefaultEpochs = 10;
+constexpr std::size_t kDefaultValidationPositions = 4096;
+constexpr double kDefaultMaxError = 2.0;
+
+// Skips the samples held out for validation at the start of every pass.
+class HoldoutReader : public NNUETraining::SampleReader {
+public:
+    HoldoutReader(NNUETraining::SampleReader& source, std::size_t skip)
+        : source(source), skip(skip) {}
+
+    bool next(NNUETraining::Sample& sample) override {
+        return source.next(sample);
+    }
+
+    bool rewind() override {
+        if (!source.rewind()) {
+            return false;
+        }
+        NNUETraining::Sample discarded;
+        for (std::size_t i = 0; i < skip; ++i) {
+            if (!source.next(discarded)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    NNUETraining::SampleReader& source;
+    std::size_t skip;
+};
+
+void printUsage() {
+    std::cout << "Usage: nnue_train <training-data> <output.nnue> [options]\n"
+              << "  --epochs=N        passes over the data (default " << kDefaultEpochs << ")\n"
+              << "  --batch=N         positions per optimizer step (default 1024)\n"
+              << "  --threads=N       worker threads, 0 for all cores (default 0)\n"
+              << "  --lr=F            learning rate (default 0.001)\n"
+              << "  --lambda=F        weight of the search score against the game result\n"
+              << "  --validation=N    leading positions held out for validation (default "
+              << kDefaultValidationPositions << ")\n"
+              << "  --max-error=F     fail if the exported net's mean error exceeds F cp\n"
+              << "  --no-qat          train plain float weights, only rounding on export\n";
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const std::vector<std::string> args(argv + 1, argv + argc);
+        if (args.size() < 2 || args[0].starts_with("--") || args[1].starts_with("--")) {
+            printUsage();
+            return 1;
+        }
+        const std::string& dataPath = args[0];
+        const std::string& outputPath = args[1];
+
+        NNUETraining::TrainerConfig config;
+        config.batchSize = std::stoi(option(args, "batch", std::to_string(config.batchSize)));
+        config.threads = std::stoi(option(args, "threads", "0"));
+        config.optimizer.learningRate =
+            std::stof(option(args, "lr", std::to_string(config.optimizer.learningRate)));
+        config.lambda = std::stof(option(args, "lambda", std::to_string(config.lambda)));
+        config.quantizationAware = !hasFlag(args, "no-qat");
+        const int epochs = std::stoi(option(args, "epochs", std::to_string(kDefaultEpochs)));
+        const auto holdout = static_cast<std::size_t>(
+            std::stoul(option(args, "validation", std::to_string(kDefaultValidationPositions))));
+        const double maxError =
+            std::stod(option(args, "max-error", std::to_string(kDefaultMaxError)));
+
+        const auto reader = NNUETraining::openSampleFile(dataPath);
+        if (!reader) {
+            std::cerr << "Error: Could not read training data: " << dataPath << '\n';
+            return 1;
+        }
+        std::vector<NNUETraining::Sample> validation;
+        NNUETraining::Sample sample;
+        while (validation.size() < holdout && reader->next(sample)) {
+            validation.push_back(sample);
+        }
+        HoldoutReader training(*reader, validation.size());
+        std::cout << "Training on " << dataPath << " (" << validation.size()
+                  << " positions held out)" << '\n';
+
+        NNUETraining::Trainer trainer(config);
+        for (int epoch = 1; epoch <= epochs; ++epoch) {
+            const NNUETraining::EpochStats stats = trainer.trainEpoch(training);
+            std::cout << "Epoch " << epoch << ": loss " << stats.averageLoss << ", "
+                      << stats.positions << " positions, "
+                      << static_cast<long long>(stats.positionsPerSecond) << " positions/sec"
+                      << '\n';
+        }
+
+        if (!trainer.exportNetwork(outputPath)) {
+            std::cerr << "Error: Could not write network: " << outputPath << '\n';
+            return 1;
+        }
+        NNUE::NNUEEvaluator evaluator;
+        if (!evaluator.loadNetwork(outputPath)) {
+            std::cerr << "Error: Exported network failed to load: " << outputPath << '\n';
+            return 1;
+        }
+        const NNUETraining::ValidationStats check = trainer.validate(evaluator, validation);
+        std::cout << "Exported " << outputPath << ": mean error " << check.meanAbsError
+                  << " cp, max " << check.maxAbsError << " cp over " << check.positions
+                  << " positions" << '\n';
+        return check.meanAbsError <= maxError ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,170 @@
+#include "ai/Datagen.h"
+#include "ai/MatchRunner.h"
+#include "ai/Spsa.h"
+#include "core/BitboardMoves.h"
+#include "search/search.h"
+#include "utils/CommandLine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace CommandLine;
+
+namespace {
+constexpr int kDefaultCheckpointInterval = 10;
+constexpr double kMsPerSecond = 1000.0;
+constexpr double kSecondsPerHour = 3600.0;
+
+std::vector<std::string> splitNames(const std::string& list) {
+    std::vector<std::string> names;
+    std::istringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        if (!name.empty()) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+void printUsage() {
+    std::cout << "Usage: spsa_tune [options]\n"
+              << "  --iterations=N       SPSA iterations (default 10000)\n"
+              << "  --pairs=N            game pairs per iteration, 0 for one per thread "
+                 "(default 0)\n"
+              << "  --params=A,B         tunable parameters to tune (default the ones the search "
+                 "reads)\n"
+              << "  --a=X --c=X          step and perturbation sizes in parameter steps "
+                 "(default 2 and 2)\n"
+              << "  --A=X                step stability constant, negative for iterations/10\n"
+              << "  --alpha=X --gamma=X  schedule exponents (default 0.602 and 0.101)\n"
+              << "  --threads=N          concurrent game pairs, 0 for all cores (default 0)\n"
+              << "  --nodes=N            fixed nodes per move instead of a clock\n"
+              << "  --tc=S+I             seconds per game plus increment (default 5+0.05)\n"
+              << "  --epd=FILE           opening positions, played in order\n"
+              << "  --random-plies=N     random moves after each opening (default 0)\n"
+              << "  --hash=MB            hash per engine and thread (default 16)\n"
+              << "  --checkpoint=FILE    state file, resumed from if present "
+                 "(default spsa.checkpoint)\n"
+              << "  --checkpoint-interval=N  iterations between checkpoints (default "
+              << kDefaultCheckpointInterval << ")\n"
+              << "  --output=FILE        final values and trajectory as JSON "
+                 "(default spsa.json)\n";
+}
+
+void printProgress(const Spsa::State& state) {
+    const long long games = state.wins + state.draws + state.losses;
+    const double gamesPerHour =
+        state.seconds > 0.0 ? static_cast<double>(games) * kSecondsPerHour / state.seconds : 0.0;
+    std::cout << std::format("Iteration {}  games {}  {:.0f} games/hour ", state.iteration, games,
+                             gamesPerHour);
+    for (const Spsa::Param& param : state.params) {
+        std::cout << ' ' << param.name << '=' << std::lround(param.value);
+    }
+    std::cout << '\n';
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const std::vector<std::string> args(argv + 1, argv + argc);
+        if (hasFlag(args, "help")) {
+            printUsage();
+            return 0;
+        }
+        initKnightAttacks();
+        initKingAttacks();
+        InitZobrist();
+
+        Spsa::Config config;
+        config.iterations =
+            std::stoi(option(args, "iterations", std::to_string(config.iterations)));
+        config.pairsPerIteration = std::stoi(option(args, "pairs", "0"));
+        config.a = std::stod(option(args, "a", "2"));
+        config.c = std::stod(option(args, "c", "2"));
+        config.bigA = std::stod(option(args, "A", "-1"));
+        config.alpha = std::stod(option(args, "alpha", "0.602"));
+        config.gamma = std::stod(option(args, "gamma", "0.101"));
+        config.seed = static_cast<std::uint32_t>(std::stoul(option(args, "seed", "1")));
+        config.match.threads = std::stoi(option(args, "threads", "0"));
+        config.match.nodes = std::stoi(option(args, "nodes", "0"));
+        const std::string tc = option(args, "tc", "5+0.05");
+        const auto plus = tc.find('+');
+        config.match.baseMs = static_cast<int>(std::stod(tc.substr(0, plus)) * kMsPerSecond);
+        config.match.incrementMs =
+            plus == std::string::npos
+                ? 0
+                : static_cast<int>(std::stod(tc.substr(plus + 1)) * kMsPerSecond);
+        config.match.randomPlies = std::stoi(option(args, "random-plies", "0"));
+        config.match.hashMb = std::stoi(option(args, "hash", std::to_string(config.match.hashMb)));
+        config.match.seed = config.seed;
+        const std::string checkpoint = option(args, "checkpoint", "spsa.checkpoint");
+        const int checkpointInterval = std::max(
+            1, std::stoi(option(args, "checkpoint-interval",
+                                std::to_string(kDefaultCheckpointInterval))));
+        const std::string output = option(args, "output", "spsa.json");
+
+        const std::string names = option(args, "params", "");
+        const auto params = Spsa::registeredParams(splitNames(names));
+        if (!params || params->empty()) {
+            std::cerr << "Error: Unknown tunable parameter in: " << names << '\n';
+            return 1;
+        }
+
+        Spsa::State state;
+        state.params = *params;
+        if (std::filesystem::exists(checkpoint)) {
+            const auto loaded = Spsa::loadCheckpoint(checkpoint, *params);
+            if (!loaded) {
+                std::cerr << "Error: Checkpoint does not match the tuned parameters: " << checkpoint
+                          << '\n';
+                return 1;
+            }
+            state = *loaded;
+            std::cout << "Resumed " << checkpoint << " at iteration " << state.iteration << '\n';
+        }
+
+        std::vector<std::string> openings;
+        if (const std::string epd = option(args, "epd", ""); !epd.empty()) {
+            openings = Datagen::loadOpenings(epd);
+            if (openings.empty()) {
+                std::cerr << "Error: No openings in " << epd << '\n';
+                return 1;
+            }
+            std::cout << "Loaded " << openings.size() << " openings from " << epd << '\n';
+        }
+
+        Spsa::Tuner tuner(config, state);
+        std::cout << "Tuning " << params->size() << " parameters with "
+                  << tuner.pairsPerIteration() << " game pairs per iteration\n";
+        while (tuner.state().iteration < config.iterations) {
+            tuner.iterate(openings);
+            if (tuner.state().iteration % checkpointInterval == 0 ||
+                tuner.state().iteration == config.iterations) {
+                printProgress(tuner.state());
+                if (!Spsa::saveCheckpoint(tuner.state(), checkpoint)) {
+                    std::cerr << "Error: Could not write checkpoint: " << checkpoint << '\n';
+                    return 1;
+                }
+            }
+        }
+
+        if (!Spsa::writeJson(config, tuner.state(), output)) {
+            std::cerr << "Error: Could not write " << output << '\n';
+            return 1;
+        }
+        std::cout << "Wrote " << output << '\n';
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -3,6 +3,7 @@
 #include "CastlingConstants.h"
 #include "ChessPiece.h"
 #include "Move.h"
+#include "PawnKeys.h"
 #include "utils/ChessFormat.h"
 
 #include <algorithm>
@@ -18,6 +19,8 @@ void Board::clearBitboards() {
     whitePawns = whiteKnights = whiteBishops = whiteRooks = whiteQueens = whiteKings = 0;
     blackPawns = blackKnights = blackBishops = blackRooks = blackQueens = blackKings = 0;
     whitePieces = blackPieces = allPieces = 0;
+    pawnKey = 0;
+    psqScore = ZERO_SCORE;
 }
 
 void Board::updateBitboards() {
@@ -75,6 +78,10 @@ void Board::updateBitboards() {
         }
     }
     updateOccupancy();
+    pawnKey = PawnKeys::computePawnKey(whitePawns, blackPawns);
+    for (int i = 0; i < NUM_SQUARES; i++) {
+        psqScore += PsqTable::value(squares[i].piece, i);
+    }
 }
 
 void Board::updateOccupancy() {
@@ -137,6 +144,7 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
         switch (fromPiece.PieceType) {
             case ChessPieceType::PAWN:
                 clear_bit(whitePawns, from);
+                pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::WHITE, from);
                 break;
             case ChessPieceType::KNIGHT:
                 clear_bit(whiteKnights, from);
@@ -160,6 +168,7 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
         switch (fromPiece.PieceType) {
             case ChessPieceType::PAWN:
                 clear_bit(blackPawns, from);
+                pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::BLACK, from);
                 break;
             case ChessPieceType::KNIGHT:
                 clear_bit(blackKnights, from);
@@ -186,6 +195,7 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
             switch (toPiece.PieceType) {
                 case ChessPieceType::PAWN:
                     clear_bit(whitePawns, to);
+                    pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::WHITE, to);
                     break;
                 case ChessPieceType::KNIGHT:
                     clear_bit(whiteKnights, to);
@@ -209,6 +219,7 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
             switch (toPiece.PieceType) {
                 case ChessPieceType::PAWN:
                     clear_bit(blackPawns, to);
+                    pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::BLACK, to);
                     break;
                 case ChessPieceType::KNIGHT:
                     clear_bit(blackKnights, to);
@@ -231,6 +242,9 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
         }
     }
 
+    psqScore += PsqTable::value(movingPieceBefore, to) - PsqTable::value(movingPieceBefore, from) -
+                PsqTable::value(capturedPieceBefore, to);
+
     toPiece = fromPiece;
     fromPiece = Piece();
     toPiece.moved = true;
@@ -241,6 +255,7 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
         switch (toPiece.PieceType) {
             case ChessPieceType::PAWN:
                 set_bit(whitePawns, to);
+                pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::WHITE, to);
                 break;
             case ChessPieceType::KNIGHT:
                 set_bit(whiteKnights, to);
@@ -264,6 +279,7 @@ bool Board::movePiece(SquareIndex from, SquareIndex to) {
         switch (toPiece.PieceType) {
             case ChessPieceType::PAWN:
                 set_bit(blackPawns, to);
+                pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::BLACK, to);
                 break;
             case ChessPieceType::KNIGHT:
                 set_bit(blackKnights, to);
@@ -4,6 +4,7 @@
 #include "CastlingConstants.h"
 #include "ChessPiece.h"
 #include "Move.h"
+#include "PackedScore.h"
 #include "SquareSentinel.h"
 
 #include <array>
@@ -57,6 +58,8 @@ struct Position {
     Bitboard whitePieces = EMPTY;
     Bitboard blackPieces = EMPTY;
     Bitboard allPieces = EMPTY;
+    std::uint64_t pawnKey = 0;
+    PackedScore psqScore = ZERO_SCORE;
 };
 
 struct StateInfo {
@@ -125,6 +128,8 @@ struct Board {
     Bitboard& whitePieces;
     Bitboard& blackPieces;
     Bitboard& allPieces;
+    std::uint64_t& pawnKey;
+    PackedScore& psqScore;
     ChessTimePoint& lastMoveTime;
     CastlingSideProxy whiteCanCastle;
     CastlingSideProxy blackCanCastle;
@@ -142,7 +147,8 @@ private:
           blackBishops(position.blackBishops), blackRooks(position.blackRooks),
           blackQueens(position.blackQueens), blackKings(position.blackKings),
           whitePieces(position.whitePieces), blackPieces(position.blackPieces),
-          allPieces(position.allPieces), lastMoveTime(state.lastMoveTime),
+          allPieces(position.allPieces), pawnKey(position.pawnKey),
+          psqScore(position.psqScore), lastMoveTime(state.lastMoveTime),
           whiteCanCastle(state, CastlingConstants::kWhiteCastlingRightsMask),
           blackCanCastle(state, CastlingConstants::kBlackCastlingRightsMask) {}
 
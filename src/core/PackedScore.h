@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "ChessPiece.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+using PackedScore = std::int32_t;
+
+inline constexpr PackedScore ZERO_SCORE = 0;
+
+constexpr PackedScore makeScore(int mg, int eg) {
+    return static_cast<PackedScore>(static_cast<std::uint32_t>(eg) << 16U) + mg;
+}
+
+constexpr int mgValue(PackedScore score) {
+    return static_cast<std::int16_t>(static_cast<std::uint16_t>(static_cast<std::uint32_t>(score)));
+}
+
+constexpr int egValue(PackedScore score) {
+    return static_cast<std::int16_t>(
+        static_cast<std::uint16_t>((static_cast<std::uint32_t>(score) + 0x8000U) >> 16U));
+}
+
+namespace ParamPack {
+struct Pack;
+} // namespace ParamPack
+
+namespace PsqTable {
+
+inline constexpr int kPieceTypeCount = 6;
+inline constexpr int kPieceCount = 2 * kPieceTypeCount;
+
+using Table = std::array<std::array<PackedScore, NUM_SQUARES>, kPieceCount>;
+
+// Material plus piece-square value for every (piece, square), signed from white's point of
+// view. Filled from the active ParamPack; see EvaluationTuning.cpp.
+extern Table table;
+#ifdef CHESS_ENGINE_THREAD_PARAMS
+// The table the calling thread reads, which follows ParamPack::current.
+inline thread_local const Table* current = &table;
+#endif
+
+inline PackedScore value(const Piece& piece, int square) {
+    if (piece.PieceType == ChessPieceType::NONE) {
+        return ZERO_SCORE;
+    }
+    const int index = (static_cast<int>(piece.PieceColor) * kPieceTypeCount) +
+                      static_cast<int>(piece.PieceType);
+#ifdef CHESS_ENGINE_THREAD_PARAMS
+    return (*current)[static_cast<std::size_t>(index)][static_cast<std::size_t>(square)];
+#else
+    return table[static_cast<std::size_t>(index)][static_cast<std::size_t>(square)];
+#endif
+}
+
+Table build(const ParamPack::Pack& pack);
+// Rebuilds table from ParamPack::active.
+void refresh();
+
+} // namespace PsqTable
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Bitboard.h"
+#include "ChessPiece.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace PawnKeys {
+
+inline constexpr std::uint64_t kPawnKeySeed = 0x50A3C1E5D2F4B687ULL;
+inline constexpr int kColorCount = 2;
+
+consteval std::array<std::array<std::uint64_t, NUM_SQUARES>, kColorCount> makePawnKeys() {
+    std::array<std::array<std::uint64_t, NUM_SQUARES>, kColorCount> keys{};
+    std::uint64_t state = kPawnKeySeed;
+    for (auto& colorKeys : keys) {
+        for (auto& key : colorKeys) {
+            state += 0x9E3779B97F4A7C15ULL;
+            std::uint64_t z = state;
+            z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31U);
+        }
+    }
+    return keys;
+}
+
+inline constexpr auto kPawnKeys = makePawnKeys();
+
+constexpr std::uint64_t pawnKey(ChessPieceColor color, int square) {
+    return kPawnKeys[static_cast<std::size_t>(color)][static_cast<std::size_t>(square)];
+}
+
+constexpr std::uint64_t computePawnKey(Bitboard whitePawns, Bitboard blackPawns) {
+    std::uint64_t key = 0;
+    while (whitePawns != EMPTY) {
+        key ^= pawnKey(ChessPieceColor::WHITE, std::countr_zero(whitePawns));
+        whitePawns &= whitePawns - 1;
+    }
+    while (blackPawns != EMPTY) {
+        key ^= pawnKey(ChessPieceColor::BLACK, std::countr_zero(blackPawns));
+        blackPawns &= blackPawns - 1;
+    }
+    return key;
+}
+
+} // namespace PawnKeys
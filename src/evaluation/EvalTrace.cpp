@@ -0,0 +1,69 @@
+#include "EvalTrace.h"
+#include "ChessPiece.h"
+#include "EvaluationTuning.h"
+
+#include <array>
+#include <cstddef>
+
+namespace EvalTrace {
+
+namespace {
+constexpr std::array<const char*, PARAM_COUNT - BISHOP_PAIR> kScalarNames = {
+    "BISHOP_PAIR_BONUS",
+    "DOUBLED_PAWN_PENALTY",
+    "ISOLATED_PAWN_PENALTY",
+    "PASSED_PAWN_RANK_SCALE",
+    "PASSED_PAWN_BASE_BONUS",
+    "ROOK_OPEN_FILE_BONUS",
+    "ROOK_SEMI_OPEN_FILE_BONUS",
+    "KNIGHT_MOBILITY_WEIGHT",
+    "BISHOP_MOBILITY_WEIGHT",
+    "ROOK_MOBILITY_WEIGHT",
+    "QUEEN_MOBILITY_WEIGHT",
+    "KING_SAFETY_PAWN_SHIELD_BONUS",
+    "KING_SAFETY_OPEN_FILE_PENALTY",
+    "KING_SAFETY_SEMI_OPEN_FILE_PENALTY",
+    "KING_CENTRALIZATION_SCALE",
+    "TEMPO_BONUS",
+};
+} // namespace
+
+const char* scalarName(std::size_t param) {
+    return kScalarNames[param - BISHOP_PAIR];
+}
+
+void Recorder::addPieceSquares(const Board& board) {
+    for (std::size_t square = 0; square < kSquares; ++square) {
+        const Piece& piece = board.squares[square].piece;
+        if (piece.PieceType == ChessPieceType::NONE) {
+            continue;
+        }
+        const auto type = static_cast<std::size_t>(piece.PieceType);
+        const bool white = piece.PieceColor == ChessPieceColor::WHITE;
+        const float sign = white ? 1.0F : -1.0F;
+        // Kings' material cancels out, so it is left out of the parameter set.
+        if (type < PST_MG - MATERIAL) {
+            mg[MATERIAL + type] += sign;
+            eg[MATERIAL + type] += sign;
+        }
+        const std::size_t offset = (type * kSquares) + (white ? square : (kSquares - 1) - square);
+        mg[PST_MG + offset] += sign;
+        eg[PST_EG + offset] += sign;
+    }
+}
+
+float Recorder::blend(float mgValue, float egValue) const {
+    const auto total = static_cast<float>(EvaluationParams::TOTAL_PHASE);
+    const auto mgPhase = static_cast<float>(phase);
+    return ((mgValue * mgPhase) + (egValue * endgameFactor * (total - mgPhase))) / total;
+}
+
+float Recorder::coefficient(std::size_t param) const {
+    return blend(mg[param], eg[param]);
+}
+
+float Recorder::residual() const {
+    return blend(static_cast<float>(residualMg), static_cast<float>(residualEg));
+}
+
+} // namespace EvalTrace
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../core/ChessBoard.h"
+
+#include <array>
+#include <cstddef>
+
+// Linear decomposition of the hand-written evaluation for tuning. evaluateTiered() is a template
+// over its tracer: with NoTrace every hook is an empty inline call, so the search evaluates
+// exactly as before, while Recorder collects how much each tunable parameter contributes to the
+// middlegame and endgame score.
+namespace EvalTrace {
+
+inline constexpr std::size_t kPieceTypes = 6;
+inline constexpr std::size_t kSquares = 64;
+inline constexpr std::size_t kTableSize = kPieceTypes * kSquares;
+
+// Material for pawn to queen, the middlegame and endgame piece-square tables by piece type, then
+// the scalar parameters. Penalties are stored as the positive constant with a negative count.
+enum Param : std::size_t {
+    MATERIAL = 0,
+    PST_MG = MATERIAL + 5,
+    PST_EG = PST_MG + kTableSize,
+    BISHOP_PAIR = PST_EG + kTableSize,
+    DOUBLED_PAWN,
+    ISOLATED_PAWN,
+    PASSED_PAWN_RANK,
+    PASSED_PAWN_BASE,
+    ROOK_OPEN_FILE,
+    ROOK_SEMI_OPEN_FILE,
+    KNIGHT_MOBILITY,
+    BISHOP_MOBILITY,
+    ROOK_MOBILITY,
+    QUEEN_MOBILITY,
+    KING_PAWN_SHIELD,
+    KING_OPEN_FILE,
+    KING_SEMI_OPEN_FILE,
+    KING_CENTRALIZATION,
+    TEMPO,
+    PARAM_COUNT
+};
+
+// Declared name of a parameter from BISHOP_PAIR on, e.g. "BISHOP_PAIR_BONUS".
+const char* scalarName(std::size_t param);
+
+struct NoTrace {
+    static constexpr bool kEnabled = false;
+
+    void setPhase(int /*phase*/) {}
+    void setScale(float /*mg*/, float /*eg*/) {}
+    void scaleEndgame(float /*factor*/) {}
+    void add(std::size_t /*param*/, int /*count*/) {}
+    void addPieceSquares(const Board& /*board*/) {}
+    void addResidual(int /*mg*/, int /*eg*/) {}
+};
+
+class Recorder {
+public:
+    static constexpr bool kEnabled = true;
+
+    void setPhase(int value) {
+        phase = value;
+    }
+
+    // Middlegame and endgame weight of the counts added until the next call.
+    void setScale(float mg, float eg) {
+        mgScale = mg;
+        egScale = eg;
+    }
+
+    void scaleEndgame(float factor) {
+        endgameFactor = factor;
+    }
+
+    // count is white's count minus black's.
+    void add(std::size_t param, int count) {
+        mg[param] += static_cast<float>(count) * mgScale;
+        eg[param] += static_cast<float>(count) * egScale;
+    }
+
+    void addPieceSquares(const Board& board);
+
+    // Score from terms that are not tuned, such as the specialised endgames.
+    void addResidual(int mgScore, int egScore) {
+        residualMg += mgScore;
+        residualEg += egScore;
+    }
+
+    // The traced evaluation is residual() plus the sum of coefficient(p) * value of p.
+    float coefficient(std::size_t param) const;
+    float residual() const;
+
+private:
+    float blend(float mgValue, float egValue) const;
+
+    std::array<float, PARAM_COUNT> mg{};
+    std::array<float, PARAM_COUNT> eg{};
+    float mgScale = 1.0F;
+    float egScale = 1.0F;
+    float endgameFactor = 1.0F;
+    int residualMg = 0;
+    int residualEg = 0;
+    int phase = 0;
+};
+
+} // namespace EvalTrace
@@ -3,23 +3,192 @@
 #include "../core/BitboardMoves.h"
 #include "../core/ChessBoard.h"
 #include "../core/ChessPiece.h"
+#include "../core/PawnKeys.h"
 #include "Bitboard.h"
+#include "EvalTrace.h"
 #include "EvaluationTuning.h"
 #include "NNUE.h"
+#include "NNUEBitboard.h"
+#include "ParamPack.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <iostream>
 
 using namespace EvaluationParams;
 
 static std::atomic<bool> useNNUE{false};
-thread_local bool useFastEval = false;
 
 namespace {
 constexpr int kPieceTypeCount = 6;
-constexpr int kMirrorSquareOffset = NUM_SQUARES - 1;
+constexpr Bitboard kFileABitboard = 0x0101010101010101ULL;
+constexpr Bitboard kFileHBitboard = kFileABitboard << (BOARD_SIZE - 1);
+constexpr Bitboard kRank1Bitboard = 0xFFULL;
+constexpr Bitboard kRank8Bitboard = kRank1Bitboard << (BOARD_SIZE * (BOARD_SIZE - 1));
+constexpr Bitboard kEdgeSquares = kFileABitboard | kFileHBitboard | kRank1Bitboard | kRank8Bitboard;
+constexpr Bitboard kCornerSquares =
+    (kFileABitboard | kFileHBitboard) & (kRank1Bitboard | kRank8Bitboard);
+constexpr Bitboard kCenterSquares = (1ULL << 27) | (1ULL << 28) | (1ULL << 35) | (1ULL << 36);
+
+int weight(EvalTrace::Param param) {
+#ifdef CHESS_ENGINE_THREAD_PARAMS
+    return (*ParamPack::current)[param];
+#else
+    return ParamPack::active[param];
+#endif
+}
+
+consteval std::array<Bitboard, BOARD_SIZE> makeAdjacentFileMasks() {
+    std::array<Bitboard, BOARD_SIZE> masks{};
+    for (int file = 0; file < BOARD_SIZE; ++file) {
+        if (file > 0) {
+            masks[file] |= kFileABitboard << (file - 1);
+        }
+        if (file < BOARD_SIZE - 1) {
+            masks[file] |= kFileABitboard << (file + 1);
+        }
+    }
+    return masks;
+}
+
+consteval std::array<Bitboard, NUM_SQUARES> makeSquareZones(int radius) {
+    std::array<Bitboard, NUM_SQUARES> zones{};
+    for (int square = 0; square < NUM_SQUARES; ++square) {
+        const int row = square / BOARD_SIZE;
+        const int col = square % BOARD_SIZE;
+        for (int checkRow = std::max(0, row - radius);
+             checkRow <= std::min(BOARD_SIZE - 1, row + radius); ++checkRow) {
+            for (int checkCol = std::max(0, col - radius);
+                 checkCol <= std::min(BOARD_SIZE - 1, col + radius); ++checkCol) {
+                zones[square] |= 1ULL << ((checkRow * BOARD_SIZE) + checkCol);
+            }
+        }
+    }
+    return zones;
+}
+
+consteval std::array<std::array<Bitboard, NUM_SQUARES>, 2> makePassedPawnSpans() {
+    std::array<std::array<Bitboard, NUM_SQUARES>, 2> spans{};
+    for (int square = 0; square < NUM_SQUARES; ++square) {
+        const int row = square / BOARD_SIZE;
+        const int col = square % BOARD_SIZE;
+        for (int checkCol = std::max(0, col - 1); checkCol <= std::min(BOARD_SIZE - 1, col + 1);
+             ++checkCol) {
+            for (int checkRow = row + 1; checkRow < BOARD_SIZE; ++checkRow) {
+                spans[0][square] |= 1ULL << ((checkRow * BOARD_SIZE) + checkCol);
+            }
+            for (int checkRow = row - 1; checkRow >= 0; --checkRow) {
+                spans[1][square] |= 1ULL << ((checkRow * BOARD_SIZE) + checkCol);
+            }
+        }
+    }
+    return spans;
+}
+
+constexpr auto kPassedPawnSpans = makePassedPawnSpans();
+constexpr auto kAdjacentFileMasks = makeAdjacentFileMasks();
+constexpr auto kKingShieldZones = makeSquareZones(1);
+constexpr auto kNearbyEnemyZones = makeSquareZones(NEARBY_ENEMY_RADIUS);
+constexpr auto kQueenEscapeZones = makeSquareZones(QUEEN_ESCAPE_SEARCH_RADIUS);
+constexpr auto kNearEnemyKingZones = makeSquareZones(NEAR_ENEMY_KING_DISTANCE);
+
+Bitboard passedPawnMask(Bitboard ownPawns, Bitboard enemyPawns, ChessPieceColor color) {
+    const auto& spans = kPassedPawnSpans[static_cast<std::size_t>(color)];
+    Bitboard passed = EMPTY;
+    while (ownPawns != EMPTY) {
+        const int square = std::countr_zero(ownPawns);
+        ownPawns &= ownPawns - 1;
+        if ((spans[square] & enemyPawns) == EMPTY) {
+            set_bit(passed, square);
+        }
+    }
+    return passed;
+}
+
+template <typename Tracer>
+int passedPawnBonus(Bitboard passed, ChessPieceColor color, Tracer& tracer) {
+    const int sign = color == ChessPieceColor::WHITE ? 1 : -1;
+    int score = 0;
+    while (passed != EMPTY) {
+        const int row = std::countr_zero(passed) / BOARD_SIZE;
+        passed &= passed - 1;
+        const int advancement = color == ChessPieceColor::WHITE ? row - 1 : (BOARD_SIZE - 2) - row;
+        score += (advancement * weight(EvalTrace::PASSED_PAWN_RANK)) +
+                 weight(EvalTrace::PASSED_PAWN_BASE);
+        tracer.add(EvalTrace::PASSED_PAWN_RANK, sign * advancement);
+        tracer.add(EvalTrace::PASSED_PAWN_BASE, sign);
+    }
+    return score;
+}
+
+Bitboard fileMask(int square) {
+    return kFileABitboard << (square % BOARD_SIZE);
+}
+
+Bitboard colorPieces(const Board& board, ChessPieceColor color) {
+    return color == ChessPieceColor::WHITE ? board.whitePieces : board.blackPieces;
+}
+
+ChessPieceColor opposite(ChessPieceColor color) {
+    return color == ChessPieceColor::WHITE ? ChessPieceColor::BLACK : ChessPieceColor::WHITE;
+}
+
+int whiteRelative(ChessPieceColor color, int score) {
+    return color == ChessPieceColor::WHITE ? score : -score;
+}
+
+Bitboard pawnAttackSet(Bitboard pawns, ChessPieceColor color) {
+    if (color == ChessPieceColor::WHITE) {
+        return ((pawns & ~kFileABitboard) << (BOARD_SIZE - 1)) |
+               ((pawns & ~kFileHBitboard) << (BOARD_SIZE + 1));
+    }
+    return ((pawns & ~kFileABitboard) >> (BOARD_SIZE + 1)) |
+           ((pawns & ~kFileHBitboard) >> (BOARD_SIZE - 1));
+}
+
+Bitboard attackersTo(const Board& board, int square) {
+    const Bitboard occupancy = board.allPieces;
+    const Bitboard diagonalSliders =
+        board.whiteBishops | board.blackBishops | board.whiteQueens | board.blackQueens;
+    const Bitboard straightSliders =
+        board.whiteRooks | board.blackRooks | board.whiteQueens | board.blackQueens;
+    return (pawnAttacks(ChessPieceColor::BLACK, square) & board.whitePawns) |
+           (pawnAttacks(ChessPieceColor::WHITE, square) & board.blackPawns) |
+           (KnightAttacks[square] & (board.whiteKnights | board.blackKnights)) |
+           (KingAttacks[square] & (board.whiteKings | board.blackKings)) |
+           (bishopAttacks(square, occupancy) & diagonalSliders) |
+           (rookAttacks(square, occupancy) & straightSliders);
+}
+
+Bitboard attackedBy(const Board& board, ChessPieceColor color) {
+    const Bitboard occupancy = board.allPieces;
+    Bitboard attacks =
+        pawnAttackSet(board.getPieceBitboard(ChessPieceType::PAWN, color), color);
+    for (Bitboard knights = board.getPieceBitboard(ChessPieceType::KNIGHT, color);
+         knights != EMPTY; knights &= knights - 1) {
+        attacks |= KnightAttacks[std::countr_zero(knights)];
+    }
+    for (Bitboard kings = board.getPieceBitboard(ChessPieceType::KING, color); kings != EMPTY;
+         kings &= kings - 1) {
+        attacks |= KingAttacks[std::countr_zero(kings)];
+    }
+    const Bitboard queens = board.getPieceBitboard(ChessPieceType::QUEEN, color);
+    for (Bitboard diagonal = board.getPieceBitboard(ChessPieceType::BISHOP, color) | queens;
+         diagonal != EMPTY; diagonal &= diagonal - 1) {
+        attacks |= bishopAttacks(std::countr_zero(diagonal), occupancy);
+    }
+    for (Bitboard straight = board.getPieceBitboard(ChessPieceType::ROOK, color) | queens;
+         straight != EMPTY; straight &= straight - 1) {
+        attacks |= rookAttacks(std::countr_zero(straight), occupancy);
+    }
+    return attacks;
+}
+
 } // namespace
 
 namespace PieceSquareTables {
@@ -50,268 +219,152 @@ int getPieceSquareValue(ChessPieceType pieceType, int position, ChessPieceColor
     return value;
 }
 
-int evaluatePawnStructure(const Board& board) {
+namespace {
+
+template <typename Tracer> int pawnStructureScore(const Board& board, Tracer& tracer) {
     int score = 0;
-    for (int col = 0; col < BOARD_SIZE; col++) {
-        int whitePawns = 0;
-        int blackPawns = 0;
-        for (int row = 0; row < BOARD_SIZE; row++) {
-            int pos = (row * BOARD_SIZE) + col;
-            if (board.squares[pos].piece.PieceType == ChessPieceType::PAWN) {
-                if (board.squares[pos].piece.PieceColor == ChessPieceColor::WHITE) {
-                    whitePawns++;
-                } else {
-                    blackPawns++;
-                }
-            }
-        }
+    for (int file = 0; file < BOARD_SIZE; file++) {
+        const Bitboard mask = kFileABitboard << file;
+        const int whitePawns = popcount(board.whitePawns & mask);
+        const int blackPawns = popcount(board.blackPawns & mask);
         if (whitePawns > 1) {
-            score -= DOUBLED_PAWN_PENALTY * (whitePawns - 1);
+            score -= weight(EvalTrace::DOUBLED_PAWN) * (whitePawns - 1);
+            tracer.add(EvalTrace::DOUBLED_PAWN, -(whitePawns - 1));
         }
         if (blackPawns > 1) {
-            score += DOUBLED_PAWN_PENALTY * (blackPawns - 1);
-        }
-    }
-    for (int col = 0; col < BOARD_SIZE; col++) {
-        for (int row = 0; row < BOARD_SIZE; row++) {
-            int pos = (row * BOARD_SIZE) + col;
-            if (board.squares[pos].piece.PieceType == ChessPieceType::PAWN) {
-                bool isolated = true;
-                for (int adjCol = std::max(0, col - 1); adjCol <= std::min(BOARD_SIZE - 1, col + 1);
-                     adjCol++) {
-                    if (adjCol == col) {
-                        continue;
-                    }
-                    for (int adjRow = 0; adjRow < BOARD_SIZE; adjRow++) {
-                        int adjPos = (adjRow * BOARD_SIZE) + adjCol;
-                        if (board.squares[adjPos].piece.PieceType == ChessPieceType::PAWN &&
-                            board.squares[adjPos].piece.PieceColor == ChessPieceColor::WHITE) {
-                            isolated = false;
-                            break;
-                        }
-                    }
-                    if (!isolated) {
-                        break;
-                    }
-                }
-                if (isolated) {
-                    if (board.squares[pos].piece.PieceColor == ChessPieceColor::WHITE) {
-                        score -= ISOLATED_PAWN_PENALTY;
-                    } else {
-                        score += ISOLATED_PAWN_PENALTY;
-                    }
-                }
-            }
+            score += weight(EvalTrace::DOUBLED_PAWN) * (blackPawns - 1);
+            tracer.add(EvalTrace::DOUBLED_PAWN, blackPawns - 1);
+        }
+        if ((board.whitePawns & kAdjacentFileMasks[file]) == EMPTY) {
+            score -= weight(EvalTrace::ISOLATED_PAWN) * whitePawns;
+            score += weight(EvalTrace::ISOLATED_PAWN) * blackPawns;
+            tracer.add(EvalTrace::ISOLATED_PAWN, blackPawns - whitePawns);
         }
     }
     return score;
 }
 
-int evaluateMobility(const Board& board) {
-    int mobilityScore = 0;
+template <typename Tracer> int mobilityScore(const Board& board, Tracer& tracer) {
+    int score = 0;
     const Bitboard occupancy = board.allPieces;
 
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        const Piece& piece = board.squares[i].piece;
-        if (piece.PieceType == ChessPieceType::NONE) {
-            continue;
-        }
-
-        const Bitboard ownPieces =
-            piece.PieceColor == ChessPieceColor::WHITE ? board.whitePieces : board.blackPieces;
-        int mobility = 0;
-        int weight = 0;
+    for (const ChessPieceColor color : {ChessPieceColor::WHITE, ChessPieceColor::BLACK}) {
+        const Bitboard ownPieces = colorPieces(board, color);
+        int knightSquares = 0;
+        int bishopSquares = 0;
+        int rookSquares = 0;
+        int queenSquares = 0;
+        for (Bitboard knights = board.getPieceBitboard(ChessPieceType::KNIGHT, color);
+             knights != EMPTY; knights &= knights - 1) {
+            knightSquares += popcount(KnightAttacks[std::countr_zero(knights)] & ~ownPieces);
+        }
+        for (Bitboard bishops = board.getPieceBitboard(ChessPieceType::BISHOP, color);
+             bishops != EMPTY; bishops &= bishops - 1) {
+            bishopSquares +=
+                popcount(bishopAttacks(std::countr_zero(bishops), occupancy) & ~ownPieces);
+        }
+        for (Bitboard rooks = board.getPieceBitboard(ChessPieceType::ROOK, color); rooks != EMPTY;
+             rooks &= rooks - 1) {
+            rookSquares += popcount(rookAttacks(std::countr_zero(rooks), occupancy) & ~ownPieces);
+        }
+        for (Bitboard queens = board.getPieceBitboard(ChessPieceType::QUEEN, color);
+             queens != EMPTY; queens &= queens - 1) {
+            queenSquares +=
+                popcount(queenAttacks(std::countr_zero(queens), occupancy) & ~ownPieces);
+        }
+        score += whiteRelative(color, (knightSquares * weight(EvalTrace::KNIGHT_MOBILITY)) +
+                                          (bishopSquares * weight(EvalTrace::BISHOP_MOBILITY)) +
+                                          (rookSquares * weight(EvalTrace::ROOK_MOBILITY)) +
+                                          (queenSquares * weight(EvalTrace::QUEEN_MOBILITY)));
+        tracer.add(EvalTrace::KNIGHT_MOBILITY, whiteRelative(color, knightSquares));
+        tracer.add(EvalTrace::BISHOP_MOBILITY, whiteRelative(color, bishopSquares));
+        tracer.add(EvalTrace::ROOK_MOBILITY, whiteRelative(color, rookSquares));
+        tracer.add(EvalTrace::QUEEN_MOBILITY, whiteRelative(color, queenSquares));
+    }
 
-        switch (piece.PieceType) {
-            case ChessPieceType::KNIGHT:
-                mobility = popcount(KnightAttacks[i] & ~ownPieces);
-                weight = 4;
-                break;
-            case ChessPieceType::BISHOP:
-                mobility = popcount(bishopAttacks(i, occupancy) & ~ownPieces);
-                weight = 3;
-                break;
-            case ChessPieceType::ROOK:
-                mobility = popcount(rookAttacks(i, occupancy) & ~ownPieces);
-                weight = 2;
-                break;
-            case ChessPieceType::QUEEN:
-                mobility = popcount(queenAttacks(i, occupancy) & ~ownPieces);
-                weight = 1;
-                break;
-            default:
-                continue;
-        }
+    return score;
+}
 
-        mobilityScore +=
-            piece.PieceColor == ChessPieceColor::WHITE ? mobility * weight : -mobility * weight;
+template <typename Tracer>
+int kingShelterScore(const Board& board, int kingPos, ChessPieceColor color, Tracer& tracer) {
+    const Bitboard ownPawns = board.getPieceBitboard(ChessPieceType::PAWN, color);
+    const Bitboard kingFile = fileMask(kingPos);
+    const int shieldPawns = popcount(kKingShieldZones[kingPos] & ownPawns);
+    int score = shieldPawns * weight(EvalTrace::KING_PAWN_SHIELD);
+    tracer.add(EvalTrace::KING_PAWN_SHIELD, whiteRelative(color, shieldPawns));
+    if (((board.whitePawns | board.blackPawns) & kingFile) == EMPTY) {
+        score -= weight(EvalTrace::KING_OPEN_FILE);
+        tracer.add(EvalTrace::KING_OPEN_FILE, whiteRelative(color, -1));
+    }
+    if ((ownPawns & kingFile) == EMPTY) {
+        score -= weight(EvalTrace::KING_SEMI_OPEN_FILE);
+        tracer.add(EvalTrace::KING_SEMI_OPEN_FILE, whiteRelative(color, -1));
     }
-
-    return mobilityScore;
+    return score;
 }
 
-int evaluateCenterControl(const Board& board, ChessPieceColor color) {
+template <typename Tracer> int rookFileScore(const Board& board, Tracer& tracer) {
     int score = 0;
-    int centerSquares[] = {27, 28, 35, 36};
-    for (int square : centerSquares) {
-        if (board.squares[square].piece.PieceType != ChessPieceType::NONE &&
-            board.squares[square].piece.PieceColor == color) {
-            score += CENTER_CONTROL_BONUS;
+    const Bitboard allPawns = board.whitePawns | board.blackPawns;
+
+    for (const ChessPieceColor color : {ChessPieceColor::WHITE, ChessPieceColor::BLACK}) {
+        const Bitboard ownPawns = board.getPieceBitboard(ChessPieceType::PAWN, color);
+        for (Bitboard rooks = board.getPieceBitboard(ChessPieceType::ROOK, color); rooks != EMPTY;
+             rooks &= rooks - 1) {
+            const Bitboard file = fileMask(std::countr_zero(rooks));
+            if ((allPawns & file) == EMPTY) {
+                score += whiteRelative(color, weight(EvalTrace::ROOK_OPEN_FILE));
+                tracer.add(EvalTrace::ROOK_OPEN_FILE, whiteRelative(color, 1));
+            } else if ((ownPawns & file) == EMPTY) {
+                score += whiteRelative(color, weight(EvalTrace::ROOK_SEMI_OPEN_FILE));
+                tracer.add(EvalTrace::ROOK_SEMI_OPEN_FILE, whiteRelative(color, 1));
+            }
         }
     }
+
     return score;
 }
 
-int evaluateCenterControl(const Board& board) {
-    return evaluateCenterControl(board, ChessPieceColor::WHITE) -
-           evaluateCenterControl(board, ChessPieceColor::BLACK);
+} // namespace
+
+int evaluatePawnStructure(const Board& board) {
+    EvalTrace::NoTrace tracer;
+    return pawnStructureScore(board, tracer);
 }
 
-int evaluateKingSafety(const Board& board) {
-    int safetyScore = 0;
-    int whiteKingPos = -1;
-    int blackKingPos = -1;
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        if (board.squares[i].piece.PieceType == ChessPieceType::KING) {
-            if (board.squares[i].piece.PieceColor == ChessPieceColor::WHITE) {
-                whiteKingPos = i;
-            } else {
-                blackKingPos = i;
-            }
-        }
-    }
+int evaluateMobility(const Board& board) {
+    EvalTrace::NoTrace tracer;
+    return mobilityScore(board, tracer);
+}
 
-    if (whiteKingPos != -1) {
-        safetyScore += evaluateKingSafetyForColor(board, whiteKingPos, ChessPieceColor::WHITE);
-    }
-    if (blackKingPos != -1) {
-        safetyScore -= evaluateKingSafetyForColor(board, blackKingPos, ChessPieceColor::BLACK);
-    }
+int evaluateCenterControl(const Board& board, ChessPieceColor color) {
+    return popcount(colorPieces(board, color) & kCenterSquares) * CENTER_CONTROL_BONUS;
+}
 
-    return safetyScore;
+int evaluateCenterControl(const Board& board) {
+    return evaluateCenterControl(board, ChessPieceColor::WHITE) -
+           evaluateCenterControl(board, ChessPieceColor::BLACK);
 }
 
 int evaluateKingSafety(const Board& board, ChessPieceColor color) {
-    int kingPos = -1;
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        if (board.squares[i].piece.PieceType == ChessPieceType::KING &&
-            board.squares[i].piece.PieceColor == color) {
-            kingPos = i;
-            break;
-        }
-    }
-
-    if (kingPos == -1) {
+    const Bitboard kings = board.getPieceBitboard(ChessPieceType::KING, color);
+    if (kings == EMPTY) {
         return 0;
     }
 
-    return evaluateKingSafetyForColor(board, kingPos, color);
+    return evaluateKingSafetyForColor(board, std::countr_zero(kings), color);
 }
 
 int evaluateKingSafetyForColor(const Board& board, int kingPos, ChessPieceColor color) {
-    int score = 0;
-    int kingRow = kingPos / BOARD_SIZE;
-    int kingCol = kingPos % BOARD_SIZE;
-    int pawnShield = 0;
-    for (int dr = -1; dr <= 1; dr++) {
-        for (int dc = -1; dc <= 1; dc++) {
-            int checkRow = kingRow + dr;
-            int checkCol = kingCol + dc;
-            if (checkRow >= 0 && checkRow < BOARD_SIZE && checkCol >= 0 && checkCol < BOARD_SIZE) {
-                int checkSquare = (checkRow * BOARD_SIZE) + checkCol;
-                const Piece& piece = board.squares[checkSquare].piece;
-                if (piece.PieceType == ChessPieceType::PAWN && piece.PieceColor == color) {
-                    pawnShield++;
-                }
-            }
-        }
-    }
-    score += pawnShield * KING_SAFETY_PAWN_SHIELD_BONUS;
-    bool isOnOpenFile = true;
-    for (int rank = 0; rank < BOARD_SIZE; rank++) {
-        int square = (rank * BOARD_SIZE) + kingCol;
-        const Piece& piece = board.squares[square].piece;
-        if (piece.PieceType == ChessPieceType::PAWN) {
-            isOnOpenFile = false;
-            break;
-        }
-    }
-    if (isOnOpenFile) {
-        score -= KING_SAFETY_OPEN_FILE_PENALTY;
-    }
-
-    bool isOnSemiOpenFile = true;
-    for (int rank = 0; rank < BOARD_SIZE; rank++) {
-        int square = (rank * BOARD_SIZE) + kingCol;
-        const Piece& piece = board.squares[square].piece;
-        if (piece.PieceType == ChessPieceType::PAWN && piece.PieceColor == color) {
-            isOnSemiOpenFile = false;
-            break;
-        }
-    }
-    if (isOnSemiOpenFile) {
-        score -= KING_SAFETY_SEMI_OPEN_FILE_PENALTY;
-    }
-
-    return score;
+    EvalTrace::NoTrace tracer;
+    return kingShelterScore(board, kingPos, color, tracer);
 }
 
 int evaluatePassedPawns(const Board& board, ChessPieceColor color) {
-    int score = 0;
-
-    for (int col = 0; col < BOARD_SIZE; col++) {
-        for (int row = 0; row < BOARD_SIZE; row++) {
-            int pos = (row * BOARD_SIZE) + col;
-            const Piece& piece = board.squares[pos].piece;
-
-            if (piece.PieceType != ChessPieceType::PAWN || piece.PieceColor != color) {
-                continue;
-            }
-
-            bool isPassed = true;
-
-            if (color == ChessPieceColor::WHITE) {
-                for (int checkCol = std::max(0, col - 1); checkCol <= std::min(7, col + 1);
-                     checkCol++) {
-                    for (int checkRow = row + 1; checkRow < BOARD_SIZE; checkRow++) {
-                        int checkPos = (checkRow * BOARD_SIZE) + checkCol;
-                        if (board.squares[checkPos].piece.PieceType == ChessPieceType::PAWN &&
-                            board.squares[checkPos].piece.PieceColor == ChessPieceColor::BLACK) {
-                            isPassed = false;
-                            break;
-                        }
-                    }
-                    if (!isPassed) {
-                        break;
-                    }
-                }
-                if (isPassed) {
-                    score += ((row - 1) * PASSED_PAWN_RANK_SCALE) + PASSED_PAWN_BASE_BONUS;
-                }
-            } else {
-                for (int checkCol = std::max(0, col - 1);
-                     checkCol <= std::min(BOARD_SIZE - 1, col + 1); checkCol++) {
-                    for (int checkRow = row - 1; checkRow >= 0; checkRow--) {
-                        int checkPos = (checkRow * BOARD_SIZE) + checkCol;
-                        if (board.squares[checkPos].piece.PieceType == ChessPieceType::PAWN &&
-                            board.squares[checkPos].piece.PieceColor == ChessPieceColor::WHITE) {
-                            isPassed = false;
-                            break;
-                        }
-                    }
-                    if (!isPassed) {
-                        break;
-                    }
-                }
-                if (isPassed) {
-                    score += (((BOARD_SIZE - 2) - row) * PASSED_PAWN_RANK_SCALE) +
-                             PASSED_PAWN_BASE_BONUS;
-                }
-            }
-        }
-    }
-
-    return score;
+    const Bitboard ownPawns = board.getPieceBitboard(ChessPieceType::PAWN, color);
+    const Bitboard enemyPawns = board.getPieceBitboard(ChessPieceType::PAWN, opposite(color));
+    EvalTrace::NoTrace tracer;
+    return passedPawnBonus(passedPawnMask(ownPawns, enemyPawns, color), color, tracer);
 }
 
 int evaluatePassedPawns(const Board& board) {
@@ -320,358 +373,484 @@ int evaluatePassedPawns(const Board& board) {
 }
 
 int evaluateBishopPair(const Board& board) {
-    int whiteBishops = 0;
-    int blackBishops = 0;
-
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        if (board.squares[i].piece.PieceType == ChessPieceType::BISHOP) {
-            if (board.squares[i].piece.PieceColor == ChessPieceColor::WHITE) {
-                whiteBishops++;
-            } else {
-                blackBishops++;
-            }
-        }
-    }
-
     int score = 0;
-    if (whiteBishops >= 2) {
-        score += BISHOP_PAIR_BONUS;
+    if (popcount(board.whiteBishops) >= 2) {
+        score += weight(EvalTrace::BISHOP_PAIR);
     }
-    if (blackBishops >= 2) {
-        score -= BISHOP_PAIR_BONUS;
+    if (popcount(board.blackBishops) >= 2) {
+        score -= weight(EvalTrace::BISHOP_PAIR);
     }
     return score;
 }
 
 int evaluateRooksOnOpenFiles(const Board& board) {
-    int score = 0;
+    EvalTrace::NoTrace tracer;
+    return rookFileScore(board, tracer);
+}
 
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        if (board.squares[i].piece.PieceType == ChessPieceType::ROOK) {
-            int col = i % BOARD_SIZE;
-            bool isOpenFile = true;
-            bool isSemiOpen = true;
-
-            for (int row = 0; row < BOARD_SIZE; row++) {
-                int pos = (row * BOARD_SIZE) + col;
-                if (board.squares[pos].piece.PieceType == ChessPieceType::PAWN) {
-                    isOpenFile = false;
-                    if (board.squares[pos].piece.PieceColor == board.squares[i].piece.PieceColor) {
-                        isSemiOpen = false;
-                    }
-                }
-            }
+namespace {
 
-            if (isOpenFile) {
-                if (board.squares[i].piece.PieceColor == ChessPieceColor::WHITE) {
-                    score += ROOK_OPEN_FILE_BONUS;
-                } else {
-                    score -= ROOK_OPEN_FILE_BONUS;
-                }
-            } else if (isSemiOpen) {
-                if (board.squares[i].piece.PieceColor == ChessPieceColor::WHITE) {
-                    score += ROOK_SEMI_OPEN_FILE_BONUS;
-                } else {
-                    score -= ROOK_SEMI_OPEN_FILE_BONUS;
-                }
-            }
-        }
+template <typename Tracer>
+int kingCentralizationScore(Bitboard kings, ChessPieceColor color, Tracer& tracer) {
+    int score = 0;
+    while (kings != EMPTY) {
+        const int square = std::countr_zero(kings);
+        kings &= kings - 1;
+        const int file = square % BOARD_SIZE;
+        const int rank = square / BOARD_SIZE;
+        const int centerDistance =
+            static_cast<int>(std::max(std::abs(file - 3.5), std::abs(rank - 3.5)));
+        score += (KING_CENTER_DISTANCE_TARGET - centerDistance) *
+                 weight(EvalTrace::KING_CENTRALIZATION);
+        tracer.add(EvalTrace::KING_CENTRALIZATION,
+                   whiteRelative(color, KING_CENTER_DISTANCE_TARGET - centerDistance));
     }
-
     return score;
 }
 
+template <typename Tracer> int kingCentralization(const Board& board, Tracer& tracer) {
+    return kingCentralizationScore(board.whiteKings, ChessPieceColor::WHITE, tracer) -
+           kingCentralizationScore(board.blackKings, ChessPieceColor::BLACK, tracer);
+}
+
+} // namespace
+
 int evaluateEndgame(const Board& board) {
     int totalMaterial = 0;
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        const Piece& piece = board.squares[i].piece;
-        if (piece.PieceType != ChessPieceType::NONE && piece.PieceType != ChessPieceType::KING) {
-            totalMaterial += piece.PieceValue;
+    for (int type = 0; type < kPieceTypeCount; ++type) {
+        const auto pieceType = static_cast<ChessPieceType>(type);
+        if (pieceType == ChessPieceType::KING) {
+            continue;
         }
+        totalMaterial += Piece::getPieceValue(pieceType) *
+                         (popcount(board.getPieceBitboard(pieceType, ChessPieceColor::WHITE)) +
+                          popcount(board.getPieceBitboard(pieceType, ChessPieceColor::BLACK)));
     }
 
-    int score = 0;
     if (totalMaterial < ENDGAME_MATERIAL_THRESHOLD) {
-        for (int i = 0; i < NUM_SQUARES; i++) {
-            if (board.squares[i].piece.PieceType == ChessPieceType::KING) {
-                int file = i % BOARD_SIZE;
-                int rank = i / BOARD_SIZE;
-                const int centerDistance =
-                    static_cast<int>(std::max(std::abs(file - 3.5), std::abs(rank - 3.5)));
-
-                if (board.squares[i].piece.PieceColor == ChessPieceColor::WHITE) {
-                    score +=
-                        (KING_CENTER_DISTANCE_TARGET - centerDistance) * KING_CENTRALIZATION_SCALE;
-                } else {
-                    score -=
-                        (KING_CENTER_DISTANCE_TARGET - centerDistance) * KING_CENTRALIZATION_SCALE;
-                }
-            }
-        }
+        EvalTrace::NoTrace tracer;
+        return kingCentralization(board, tracer);
     }
+    return 0;
+}
 
-    return score;
+void PawnHashTable::resize(int sizeMb) {
+    constexpr std::size_t kBytesPerMb = 1024ULL * 1024ULL;
+    const auto clampedMb = static_cast<std::size_t>(std::clamp(sizeMb, 1, MAX_PAWN_HASH_MB));
+    const std::size_t count =
+        std::bit_floor(std::max<std::size_t>(1, (clampedMb * kBytesPerMb) / sizeof(PawnHashEntry)));
+    if (count == entries.size()) {
+        return;
+    }
+    entries.assign(count, PawnHashEntry{});
+    mask = static_cast<std::uint64_t>(count - 1);
 }
 
-thread_local PawnHashTable pawnHashTable;
+void PawnHashTable::clear() {
+    std::fill(entries.begin(), entries.end(), PawnHashEntry{});
+}
+
+PackedScore computePsqScore(const Board& board) {
+    PackedScore score = ZERO_SCORE;
+    for (int square = 0; square < NUM_SQUARES; ++square) {
+        score += PsqTable::value(board.squares[square].piece, square);
+    }
+    return score;
+}
 
 std::uint64_t computePawnHash(const Board& board) {
-    std::uint64_t h = 1469598103934665603ULL;
-    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
-        const Piece& p = board.squares[sq].piece;
-        if (p.PieceType == ChessPieceType::PAWN) {
-            const std::uint64_t pawnKey =
-                (static_cast<std::uint64_t>(sq + 1)) |
-                (static_cast<std::uint64_t>(p.PieceColor == ChessPieceColor::BLACK) << 8);
-            h ^= pawnKey;
-            h *= 1099511628211ULL;
+    return PawnKeys::computePawnKey(board.whitePawns, board.blackPawns);
+}
+
+namespace {
+
+template <typename Tracer>
+void fillPawnEntry(const Board& board, PawnHashEntry& entry, Tracer& tracer) {
+    entry = PawnHashEntry{};
+    entry.key = board.pawnKey;
+    entry.passedPawns[0] =
+        passedPawnMask(board.whitePawns, board.blackPawns, ChessPieceColor::WHITE);
+    entry.passedPawns[1] =
+        passedPawnMask(board.blackPawns, board.whitePawns, ChessPieceColor::BLACK);
+
+    tracer.setScale(1.0F, PAWN_EG_SCALE);
+    const int pawnScore = pawnStructureScore(board, tracer);
+    tracer.setScale(PAWN_MG_PASSED_SCALE, PASSED_PAWN_EG_SCALE);
+    const int passedPawnScore =
+        passedPawnBonus(entry.passedPawns[0], ChessPieceColor::WHITE, tracer) -
+        passedPawnBonus(entry.passedPawns[1], ChessPieceColor::BLACK, tracer);
+    entry.mgScore =
+        pawnScore + static_cast<int>(static_cast<float>(passedPawnScore) * PAWN_MG_PASSED_SCALE);
+    entry.egScore = static_cast<int>(static_cast<float>(pawnScore) * PAWN_EG_SCALE) +
+                    static_cast<int>(static_cast<float>(passedPawnScore) * PASSED_PAWN_EG_SCALE);
+}
+
+template <typename Tracer>
+int cachedKingShelter(const Board& board, PawnHashEntry& entry, ChessPieceColor color,
+                      Tracer& tracer) {
+    const Bitboard kings = color == ChessPieceColor::WHITE ? board.whiteKings : board.blackKings;
+    if (kings == EMPTY) {
+        return 0;
+    }
+    const int kingSquare = lsb(kings);
+    const auto index = static_cast<std::size_t>(color);
+    if (entry.shelterKingSquare[index] != kingSquare) {
+        entry.shelterScore[index] = kingShelterScore(board, kingSquare, color, tracer);
+        entry.shelterKingSquare[index] = kingSquare;
+    }
+    return entry.shelterScore[index];
+}
+
+} // namespace
+
+namespace {
+
+constexpr int kMaterialPieceTypes = 5;
+constexpr int kMaterialCountBits = 4;
+constexpr std::uint64_t kMaterialIndexMultiplier = 0x9E3779B97F4A7C15ULL;
+constexpr int kMaterialIndexShift = 64 - std::countr_zero(MaterialHashTable::SIZE);
+
+using MaterialCounts = std::array<int, kMaterialPieceTypes>;
+
+constexpr MaterialCounts kBareKing{};
+
+struct SpecializedEndgame {
+    MaterialCounts strongSide;
+    EndgameEvaluator evaluator;
+};
+
+constexpr std::array<SpecializedEndgame, 5> kSpecializedEndgames = {{
+    {{1, 0, 0, 0, 0}, &EndgameKnowledge::evaluateKPK},
+    {{0, 0, 0, 1, 0}, &EndgameKnowledge::evaluateKRK},
+    {{0, 0, 0, 0, 1}, &EndgameKnowledge::evaluateKQK},
+    {{0, 1, 1, 0, 0}, &EndgameKnowledge::evaluateKBNK},
+    {{0, 0, 2, 0, 0}, &EndgameKnowledge::evaluateKBBK},
+}};
+
+MaterialCounts countMaterial(const Board& board, ChessPieceColor color) {
+    MaterialCounts counts{};
+    for (int type = 0; type < kMaterialPieceTypes; ++type) {
+        counts[static_cast<std::size_t>(type)] =
+            popcount(board.getPieceBitboard(static_cast<ChessPieceType>(type), color));
+    }
+    return counts;
+}
+
+std::uint64_t packMaterialKey(const MaterialCounts& white, const MaterialCounts& black) {
+    std::uint64_t key = 0;
+    for (int type = 0; type < kMaterialPieceTypes; ++type) {
+        key = (key << kMaterialCountBits) | static_cast<std::uint64_t>(white[type]);
+        key = (key << kMaterialCountBits) | static_cast<std::uint64_t>(black[type]);
+    }
+    return key;
+}
+
+int nonKingMaterial(const MaterialCounts& counts) {
+    int material = 0;
+    for (int type = 0; type < kMaterialPieceTypes; ++type) {
+        material += counts[static_cast<std::size_t>(type)] *
+                    Piece::getPieceValue(static_cast<ChessPieceType>(type));
+    }
+    return material;
+}
+
+EndgameEvaluator findSpecializedEndgame(const MaterialCounts& white, const MaterialCounts& black) {
+    for (const auto& endgame : kSpecializedEndgames) {
+        if ((white == endgame.strongSide && black == kBareKing) ||
+            (black == endgame.strongSide && white == kBareKing)) {
+            return endgame.evaluator;
         }
     }
-    return h;
+    return nullptr;
+}
+
+bool hasMatingMaterial(const MaterialCounts& counts) {
+    const int pawns = counts[static_cast<std::size_t>(ChessPieceType::PAWN)];
+    const int knights = counts[static_cast<std::size_t>(ChessPieceType::KNIGHT)];
+    const int bishops = counts[static_cast<std::size_t>(ChessPieceType::BISHOP)];
+    const int majors = counts[static_cast<std::size_t>(ChessPieceType::ROOK)] +
+                       counts[static_cast<std::size_t>(ChessPieceType::QUEEN)];
+    return pawns > 0 || majors > 0 || bishops > 1 || (bishops > 0 && knights > 0) || knights > 2;
 }
 
-int evaluatePosition(const Board& board, int contempt) {
+int scaleInsufficientMaterial(const Board& /*board*/) {
+    return SCALE_FACTOR_DRAW;
+}
+
+template <typename Tracer>
+MaterialHashEntry fillMaterialEntry(const Board& board, std::uint64_t key, Tracer& tracer) {
+    const MaterialCounts white = countMaterial(board, ChessPieceColor::WHITE);
+    const MaterialCounts black = countMaterial(board, ChessPieceColor::BLACK);
+
+    MaterialHashEntry entry;
+    entry.key = key;
+
+    const auto countBoth = [&](ChessPieceType type) {
+        const auto index = static_cast<std::size_t>(type);
+        return white[index] + black[index];
+    };
+    const int phase = countBoth(ChessPieceType::KNIGHT) + countBoth(ChessPieceType::BISHOP) +
+                      (2 * countBoth(ChessPieceType::ROOK)) +
+                      (QUEEN_GAME_PHASE_INCREMENT * countBoth(ChessPieceType::QUEEN));
+    entry.gamePhase = std::min(phase, TOTAL_PHASE);
+
+    const auto bishopIndex = static_cast<std::size_t>(ChessPieceType::BISHOP);
+    const int bishopPairs = (white[bishopIndex] >= 2 ? 1 : 0) - (black[bishopIndex] >= 2 ? 1 : 0);
+    const int bishopPairScore = bishopPairs * weight(EvalTrace::BISHOP_PAIR);
+    tracer.setScale(1.0F, BISHOP_PAIR_EG_SCALE);
+    tracer.add(EvalTrace::BISHOP_PAIR, bishopPairs);
+    entry.imbalanceMg = bishopPairScore;
+    entry.imbalanceEg =
+        static_cast<int>(static_cast<float>(bishopPairScore) * BISHOP_PAIR_EG_SCALE);
+
+    entry.genericEndgame =
+        nonKingMaterial(white) + nonKingMaterial(black) < ENDGAME_MATERIAL_THRESHOLD;
+    entry.endgameEvaluator = findSpecializedEndgame(white, black);
+    if (!hasMatingMaterial(white) && !hasMatingMaterial(black)) {
+        entry.scaleFunction = &scaleInsufficientMaterial;
+    }
+    return entry;
+}
+
+} // namespace
+
+std::uint64_t computeMaterialKey(const Board& board) {
+    return packMaterialKey(countMaterial(board, ChessPieceColor::WHITE),
+                           countMaterial(board, ChessPieceColor::BLACK));
+}
+
+MaterialHashEntry computeMaterialEntry(const Board& board) {
+    EvalTrace::NoTrace tracer;
+    return fillMaterialEntry(board, computeMaterialKey(board), tracer);
+}
 
-    if (useNNUE.load(std::memory_order_relaxed) && NNUE::globalEvaluator) {
-        return NNUE::evaluate(board);
+const MaterialHashEntry& MaterialHashTable::probe(const Board& board) {
+    const std::uint64_t key = computeMaterialKey(board);
+    auto& entry = entries[static_cast<std::size_t>((key * kMaterialIndexMultiplier) >>
+                                                   kMaterialIndexShift)];
+    if (entry.key != key) {
+        EvalTrace::NoTrace tracer;
+        entry = fillMaterialEntry(board, key, tracer);
     }
+    return entry;
+}
 
-    int mgScore = 0;
-    int egScore = 0;
-    int gamePhase = 0;
-    for (int square = 0; square < NUM_SQUARES; ++square) {
-        const Piece& piece = board.squares[square].piece;
-        if (piece.PieceType == ChessPieceType::NONE) {
-            continue;
+void MaterialHashTable::clear() {
+    std::fill(entries.begin(), entries.end(), MaterialHashEntry{});
+}
+
+void EvalCache::clear() {
+    std::fill(entries.begin(), entries.end(), 0);
+    counters = EvalCacheStats{};
+}
+
+namespace {
+
+template <typename Tracer>
+TieredEval evaluateTieredImpl(const Board& board, const EvalWindow& window, int contempt,
+                              PawnHashTable* pawnTable, MaterialHashTable* materialTable,
+                              Tracer& tracer) {
+
+    if constexpr (!Tracer::kEnabled) {
+        if (isNNUEEnabled()) {
+            if (NNUEBitboard::globalEvaluator) {
+                return {whiteRelative(board.turn, NNUEBitboard::evaluate(board)),
+                        EvalTier::TACTICAL};
+            }
+            return {NNUE::evaluate(board), EvalTier::TACTICAL};
         }
-        switch (piece.PieceType) {
-            case ChessPieceType::KNIGHT:
-            case ChessPieceType::BISHOP:
-                gamePhase += 1;
-                break;
-            case ChessPieceType::ROOK:
-                gamePhase += 2;
-                break;
-            case ChessPieceType::QUEEN:
-                gamePhase += QUEEN_GAME_PHASE_INCREMENT;
-                break;
-            default:
-                break;
-        }
-        int materialValue = piece.PieceValue;
-        int adjustedSquare =
-            (piece.PieceColor == ChessPieceColor::WHITE) ? square : kMirrorSquareOffset - square;
-
-        int newMgPST = getTunedPST(piece.PieceType, adjustedSquare, false);
-        int newEgPST = getTunedPST(piece.PieceType, adjustedSquare, true);
-
-        if (piece.PieceColor == ChessPieceColor::WHITE) {
-            mgScore += materialValue + newMgPST;
-            egScore += materialValue + newEgPST;
-        } else {
-            mgScore -= materialValue + newMgPST;
-            egScore -= materialValue + newEgPST;
+    }
+
+    MaterialHashEntry localMaterialEntry;
+    if (!materialTable) {
+        localMaterialEntry = fillMaterialEntry(board, computeMaterialKey(board), tracer);
+    }
+    const MaterialHashEntry& materialEntry =
+        materialTable ? materialTable->probe(board) : localMaterialEntry;
+    const int gamePhase = materialEntry.gamePhase;
+    tracer.setPhase(gamePhase);
+    tracer.setScale(1.0F, 0.5F);
+    tracer.add(EvalTrace::TEMPO, whiteRelative(board.turn, 1));
+    if constexpr (Tracer::kEnabled) {
+        if (materialEntry.scaleFunction) {
+            tracer.scaleEndgame(static_cast<float>(materialEntry.scaleFunction(board)) /
+                                static_cast<float>(SCALE_FACTOR_NORMAL));
         }
     }
-    gamePhase = std::min(gamePhase, TOTAL_PHASE);
 
-    if (ENABLE_PAWN_STRUCTURE) {
-        std::uint64_t pawnKey = computePawnHash(board);
-        int pawnMg = 0;
-        int pawnEg = 0;
-        if (const auto cachedPawnScore = pawnHashTable.probe(pawnKey)) {
-            pawnMg = cachedPawnScore->mgScore;
-            pawnEg = cachedPawnScore->egScore;
-            mgScore += pawnMg;
-            egScore += pawnEg;
+    const auto finalScore = [&](int mgScore, int egScore) {
+        if (board.turn == ChessPieceColor::WHITE) {
+            mgScore += weight(EvalTrace::TEMPO);
+            egScore += weight(EvalTrace::TEMPO) / 2;
         } else {
-            int pawnScore = evaluatePawnStructure(board);
-            int passedPawnScore = evaluatePassedPawns(board);
-            pawnMg = pawnScore +
-                     static_cast<int>(static_cast<float>(passedPawnScore) * PAWN_MG_PASSED_SCALE);
-            pawnEg = static_cast<int>(static_cast<float>(pawnScore) * PAWN_EG_SCALE) +
-                     static_cast<int>(static_cast<float>(passedPawnScore) * PASSED_PAWN_EG_SCALE);
-            pawnHashTable.store(pawnKey, pawnMg, pawnEg);
-            mgScore += pawnMg;
-            egScore += pawnEg;
+            mgScore -= weight(EvalTrace::TEMPO);
+            egScore -= weight(EvalTrace::TEMPO) / 2;
+        }
+        if (materialEntry.scaleFunction) {
+            egScore = egScore * materialEntry.scaleFunction(board) / SCALE_FACTOR_NORMAL;
+        }
+        int score = interpolatePhase(mgScore, egScore, gamePhase);
+        if (contempt != 0) {
+            score += (board.turn == ChessPieceColor::WHITE) ? contempt : -contempt;
+        }
+        return score;
+    };
+
+    // Each tier not yet evaluated is assumed to move the score by at most window.margin.
+    const auto outsideWindow = [&](int score, EvalTier tier) {
+        const int remaining = static_cast<int>(EvalTier::TACTICAL) - static_cast<int>(tier);
+        const int bound = window.margin * remaining;
+        return score + bound <= window.alpha || score - bound >= window.beta;
+    };
+
+    PackedScore psqScore = board.psqScore;
+#ifdef EVALUATION_DEBUG
+    if (const PackedScore recomputed = computePsqScore(board); recomputed != psqScore) {
+        std::cerr << "Incremental PSQ mismatch: mg " << mgValue(psqScore) << " vs "
+                  << mgValue(recomputed) << ", eg " << egValue(psqScore) << " vs "
+                  << egValue(recomputed) << " in " << board.toFEN() << '\n';
+        psqScore = recomputed;
+    }
+#endif
+    tracer.addPieceSquares(board);
+    int mgScore = mgValue(psqScore) + materialEntry.imbalanceMg;
+    int egScore = egValue(psqScore) + materialEntry.imbalanceEg;
+    if (gamePhase < OPENING_ENDGAME_BOUNDARY_PHASE) {
+        if (materialEntry.genericEndgame) {
+            tracer.setScale(0.0F, 1.0F);
+            egScore += kingCentralization(board, tracer);
+        }
+        if (materialEntry.endgameEvaluator) {
+            const int endgameScore = materialEntry.endgameEvaluator(board);
+            egScore += endgameScore;
+            tracer.addResidual(0, endgameScore);
         }
     }
 
+    int score = finalScore(mgScore, egScore);
+    if (window.maxTier == EvalTier::MATERIAL || outsideWindow(score, EvalTier::MATERIAL)) {
+        return {score, EvalTier::MATERIAL};
+    }
+
+    PawnHashEntry localPawnEntry;
+    PawnHashEntry& pawnEntry = pawnTable ? pawnTable->entry(board.pawnKey) : localPawnEntry;
+    if (!pawnTable || pawnEntry.key != board.pawnKey) {
+        fillPawnEntry(board, pawnEntry, tracer);
+    }
+
+    if (ENABLE_PAWN_STRUCTURE) {
+        mgScore += pawnEntry.mgScore;
+        egScore += pawnEntry.egScore;
+    }
+    tracer.setScale(1.0F, 1.0F);
+    const int rookScore = rookFileScore(board, tracer);
+    mgScore += rookScore;
+    egScore += rookScore;
+
+    score = finalScore(mgScore, egScore);
+    if (window.maxTier == EvalTier::PAWNS || outsideWindow(score, EvalTier::PAWNS)) {
+        return {score, EvalTier::PAWNS};
+    }
+
     if (ENABLE_PIECE_MOBILITY) {
-        int mobilityScore = evaluateMobility(board);
-        mgScore += mobilityScore;
-        egScore += static_cast<int>(static_cast<float>(mobilityScore) * MOBILITY_EG_SCALE);
+        tracer.setScale(1.0F, MOBILITY_EG_SCALE);
+        const int mobility = mobilityScore(board, tracer);
+        mgScore += mobility;
+        egScore += static_cast<int>(static_cast<float>(mobility) * MOBILITY_EG_SCALE);
     }
 
     if (ENABLE_KING_SAFETY) {
-        int kingSafetyScore = evaluateKingSafety(board);
+        tracer.setScale(1.0F, KING_SAFETY_EG_SCALE);
+        int kingSafetyScore =
+            cachedKingShelter(board, pawnEntry, ChessPieceColor::WHITE, tracer) -
+            cachedKingShelter(board, pawnEntry, ChessPieceColor::BLACK, tracer);
         mgScore += kingSafetyScore;
         egScore += static_cast<int>(static_cast<float>(kingSafetyScore) * KING_SAFETY_EG_SCALE);
     }
 
-    const bool fastEval = useFastEval;
-
-    int bishopPairScore = evaluateBishopPair(board);
-    mgScore += bishopPairScore;
-    egScore += static_cast<int>(static_cast<float>(bishopPairScore) * BISHOP_PAIR_EG_SCALE);
-    int rookFileScore = evaluateRooksOnOpenFiles(board);
-    mgScore += rookFileScore;
-    egScore += rookFileScore;
-    int tacticalSafetyScore = 0;
-    if (!fastEval) {
-        tacticalSafetyScore = evaluateTacticalSafety(board);
-        mgScore += tacticalSafetyScore;
-    }
-    int endgameScore = 0;
-    if (gamePhase < OPENING_ENDGAME_BOUNDARY_PHASE) {
-        endgameScore = evaluateEndgame(board);
-        egScore += endgameScore;
-        int endgameKnowledgeScore = EndgameKnowledge::evaluateEndgame(board);
-        egScore += endgameKnowledgeScore;
+    score = finalScore(mgScore, egScore);
+    if (window.maxTier == EvalTier::POSITIONAL || outsideWindow(score, EvalTier::POSITIONAL)) {
+        return {score, EvalTier::POSITIONAL};
     }
+
+    const int tacticalMg = mgScore;
+    const int tacticalEg = egScore;
+    int tacticalSafetyScore = evaluateTacticalSafety(board);
+    mgScore += tacticalSafetyScore;
     egScore += static_cast<int>(static_cast<float>(tacticalSafetyScore) * TACTICAL_SAFETY_EG_SCALE);
-    if (!fastEval) {
-        int hangingPiecesScore = evaluateHangingPieces(board);
-        mgScore += hangingPiecesScore;
-        egScore += hangingPiecesScore;
-        int queenTrapScore = evaluateQueenTrapDanger(board);
-        mgScore += queenTrapScore;
-        egScore += static_cast<int>(static_cast<float>(queenTrapScore) * QUEEN_TRAP_EG_SCALE);
-    }
+    int hangingPiecesScore = evaluateHangingPieces(board);
+    mgScore += hangingPiecesScore;
+    egScore += hangingPiecesScore;
+    int queenTrapScore = evaluateQueenTrapDanger(board);
+    mgScore += queenTrapScore;
+    egScore += static_cast<int>(static_cast<float>(queenTrapScore) * QUEEN_TRAP_EG_SCALE);
+    tracer.addResidual(mgScore - tacticalMg, egScore - tacticalEg);
+
+    score = finalScore(mgScore, egScore);
+    logEvaluationComponents("Final Enhanced Score", score);
+    return {score, EvalTier::TACTICAL};
+}
 
-    if (board.turn == ChessPieceColor::WHITE) {
-        mgScore += TEMPO_BONUS;
-        egScore += TEMPO_BONUS / 2;
-    } else {
-        mgScore -= TEMPO_BONUS;
-        egScore -= TEMPO_BONUS / 2;
-    }
+} // namespace
 
-    int finalScore = interpolatePhase(mgScore, egScore, gamePhase);
+TieredEval evaluateTiered(const Board& board, const EvalWindow& window, int contempt,
+                          PawnHashTable* pawnTable, MaterialHashTable* materialTable) {
+    EvalTrace::NoTrace tracer;
+    return evaluateTieredImpl(board, window, contempt, pawnTable, materialTable, tracer);
+}
 
-    if (contempt != 0) {
-        finalScore += (board.turn == ChessPieceColor::WHITE) ? contempt : -contempt;
-    }
+int evaluatePosition(const Board& board, int contempt, PawnHashTable* pawnTable,
+                     MaterialHashTable* materialTable) {
+    return evaluateTiered(board, EvalWindow{}, contempt, pawnTable, materialTable).score;
+}
 
-    if (!fastEval) {
-        logEvaluationComponents("Final Enhanced Score", finalScore);
-    }
-    return finalScore;
+int traceEvaluation(const Board& board, EvalTrace::Recorder& trace) {
+    return evaluateTieredImpl(board, EvalWindow{}, 0, nullptr, nullptr, trace).score;
 }
 
 int evaluateHangingPieces(const Board& board, ChessPieceColor color) {
     int penalty = 0;
+    const ChessPieceColor enemyColor = opposite(color);
+    const Bitboard ownPieces = colorPieces(board, color);
+    const Bitboard enemyPieces = colorPieces(board, enemyColor);
+    const Bitboard ownPawns = board.getPieceBitboard(ChessPieceType::PAWN, color);
+    const Bitboard ownKings = board.getPieceBitboard(ChessPieceType::KING, color);
+
+    for (Bitboard pieces = ownPieces & ~(ownPawns | ownKings); pieces != EMPTY;
+         pieces &= pieces - 1) {
+        const int square = std::countr_zero(pieces);
+        const Piece& piece = board.squares[square].piece;
+        const Bitboard attackers = attackersTo(board, square);
 
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        const Piece& piece = board.squares[i].piece;
-        if (piece.PieceType == ChessPieceType::NONE || piece.PieceColor != color) {
-            continue;
-        }
-        if (piece.PieceType == ChessPieceType::PAWN || piece.PieceType == ChessPieceType::KING) {
-            continue;
-        }
-        bool isUnderAttack = false;
-        bool isDefended = false;
-
-        ChessPieceColor enemyColor =
-            (color == ChessPieceColor::WHITE) ? ChessPieceColor::BLACK : ChessPieceColor::WHITE;
-
-        for (int j = 0; j < NUM_SQUARES; j++) {
-            const Piece& enemyPiece = board.squares[j].piece;
-            if (enemyPiece.PieceType == ChessPieceType::NONE ||
-                enemyPiece.PieceColor != enemyColor) {
-                continue;
-            }
-            if (canPieceAttackSquare(board, j, i)) {
-                isUnderAttack = true;
-                break;
+        if ((attackers & enemyPieces) != EMPTY && (attackers & ownPieces) == EMPTY) {
+            penalty +=
+                static_cast<int>(static_cast<float>(piece.PieceValue) * HANGING_PENALTY_RATIO);
+            if (piece.PieceType == ChessPieceType::QUEEN) {
+                penalty += HANGING_QUEEN_PENALTY;
             }
         }
 
-        if (isUnderAttack) {
-            for (int j = 0; j < NUM_SQUARES; j++) {
-                const Piece& friendlyPiece = board.squares[j].piece;
-                if (friendlyPiece.PieceType == ChessPieceType::NONE ||
-                    friendlyPiece.PieceColor != color || j == i) {
-                    continue;
-                }
-                if (canPieceAttackSquare(board, j, i)) {
-                    isDefended = true;
-                    break;
-                }
-            }
-
-            if (!isDefended) {
-                penalty +=
-                    static_cast<int>(static_cast<float>(piece.PieceValue) * HANGING_PENALTY_RATIO);
-
-                if (piece.PieceType == ChessPieceType::QUEEN) {
-                    penalty += HANGING_QUEEN_PENALTY;
-                }
-            }
+        if (piece.PieceType != ChessPieceType::QUEEN) {
+            continue;
         }
 
-        if (piece.PieceType == ChessPieceType::QUEEN) {
-            int row = i / BOARD_SIZE;
-            int col = i % BOARD_SIZE;
-
-            bool inEnemyTerritory =
-                (color == ChessPieceColor::WHITE && row >= QUEEN_ENEMY_TERRITORY_WHITE_ROW) ||
-                (color == ChessPieceColor::BLACK && row <= QUEEN_ENEMY_TERRITORY_BLACK_ROW);
-
-            if (inEnemyTerritory) {
-                int supportCount = 0;
-                for (int j = 0; j < NUM_SQUARES; j++) {
-                    const Piece& friendlyPiece = board.squares[j].piece;
-                    if (friendlyPiece.PieceType == ChessPieceType::NONE ||
-                        friendlyPiece.PieceColor != color || j == i ||
-                        friendlyPiece.PieceType == ChessPieceType::PAWN) {
-                        continue;
-                    }
-                    if (canPieceAttackSquare(board, j, i)) {
-                        supportCount++;
-                    }
-                }
-
-                if (supportCount == 0) {
-                    penalty += QUEEN_UNSUPPORTED_PENALTY;
-                }
-
-                int nearbyEnemies = 0;
-                for (int dr = -NEARBY_ENEMY_RADIUS; dr <= NEARBY_ENEMY_RADIUS; dr++) {
-                    for (int dc = -NEARBY_ENEMY_RADIUS; dc <= NEARBY_ENEMY_RADIUS; dc++) {
-                        int checkRow = row + dr;
-                        int checkCol = col + dc;
-                        if (checkRow >= 0 && checkRow < BOARD_SIZE && checkCol >= 0 &&
-                            checkCol < BOARD_SIZE) {
-                            int checkPos = (checkRow * BOARD_SIZE) + checkCol;
-                            if (board.squares[checkPos].piece.PieceType != ChessPieceType::NONE &&
-                                board.squares[checkPos].piece.PieceColor == enemyColor) {
-                                nearbyEnemies++;
-                            }
-                        }
-                    }
-                }
-
-                if (nearbyEnemies >= NEARBY_ENEMY_THRESHOLD) {
-                    penalty += QUEEN_CROWDED_PENALTY;
-                }
+        const int row = square / BOARD_SIZE;
+        const bool inEnemyTerritory =
+            (color == ChessPieceColor::WHITE && row >= QUEEN_ENEMY_TERRITORY_WHITE_ROW) ||
+            (color == ChessPieceColor::BLACK && row <= QUEEN_ENEMY_TERRITORY_BLACK_ROW);
+        if (inEnemyTerritory) {
+            if ((attackers & ownPieces & ~ownPawns) == EMPTY) {
+                penalty += QUEEN_UNSUPPORTED_PENALTY;
+            }
+            if (popcount(kNearbyEnemyZones[square] & enemyPieces) >= NEARBY_ENEMY_THRESHOLD) {
+                penalty += QUEEN_CROWDED_PENALTY;
             }
         }
 
-        if (piece.PieceType == ChessPieceType::QUEEN || piece.PieceType == ChessPieceType::ROOK ||
-            piece.PieceType == ChessPieceType::BISHOP) {
-
-            int row = i / BOARD_SIZE;
-            int col = i % BOARD_SIZE;
-            bool isOnEdge = (row == 0 || row == 7 || col == 0 || col == 7);
-            bool isInCorner = ((row == 0 || row == 7) && (col == 0 || col == 7));
-
-            if (isInCorner && piece.PieceType == ChessPieceType::QUEEN) {
-                penalty += QUEEN_CORNER_TRAP_PENALTY;
-            } else if (isOnEdge && piece.PieceType == ChessPieceType::QUEEN) {
-                penalty += QUEEN_EDGE_TRAP_PENALTY;
-            }
+        if (get_bit(kCornerSquares, square)) {
+            penalty += QUEEN_CORNER_TRAP_PENALTY;
+        } else if (get_bit(kEdgeSquares, square)) {
+            penalty += QUEEN_EDGE_TRAP_PENALTY;
         }
     }
 
@@ -722,102 +901,35 @@ bool canPieceAttackSquare(const Board& board, int piecePos, int targetPos) {
 
 int evaluateQueenTrapDanger(const Board& board) {
     int score = 0;
+    const Bitboard queens = board.whiteQueens | board.blackQueens;
+    if (queens == EMPTY) {
+        return 0;
+    }
+    const std::array<Bitboard, 2> attacks = {attackedBy(board, ChessPieceColor::WHITE),
+                                             attackedBy(board, ChessPieceColor::BLACK)};
 
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        const Piece& piece = board.squares[i].piece;
-        if (piece.PieceType != ChessPieceType::QUEEN) {
-            continue;
-        }
-        int row = i / BOARD_SIZE;
-        int col = i % BOARD_SIZE;
-        int escapeSquares = 0;
-
-        int directions[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
-                                {0, 1},   {1, -1}, {1, 0},  {1, 1}};
-
-        for (auto& direction : directions) {
-            int newRow = row + direction[0];
-            int newCol = col + direction[1];
-
-            while (newRow >= 0 && newRow < BOARD_SIZE && newCol >= 0 && newCol < BOARD_SIZE) {
-                int newPos = (newRow * BOARD_SIZE) + newCol;
-
-                if (board.squares[newPos].piece.PieceType != ChessPieceType::NONE &&
-                    board.squares[newPos].piece.PieceColor == piece.PieceColor) {
-                    break;
-                }
-
-                bool squareIsSafe = true;
-                ChessPieceColor enemyColor = (piece.PieceColor == ChessPieceColor::WHITE)
-                                                 ? ChessPieceColor::BLACK
-                                                 : ChessPieceColor::WHITE;
-
-                for (int j = 0; j < NUM_SQUARES; j++) {
-                    const Piece& enemyPiece = board.squares[j].piece;
-                    if (enemyPiece.PieceType == ChessPieceType::NONE ||
-                        enemyPiece.PieceColor != enemyColor) {
-                        continue;
-                    }
-                    if (canPieceAttackSquare(board, j, newPos)) {
-                        squareIsSafe = false;
-                        break;
-                    }
-                }
-
-                if (squareIsSafe) {
-                    escapeSquares++;
-                }
-
-                if (board.squares[newPos].piece.PieceType != ChessPieceType::NONE &&
-                    board.squares[newPos].piece.PieceColor != piece.PieceColor) {
-                    break;
-                }
-
-                newRow += direction[0];
-                newCol += direction[1];
-
-                if (abs(newRow - row) > QUEEN_ESCAPE_SEARCH_RADIUS ||
-                    abs(newCol - col) > QUEEN_ESCAPE_SEARCH_RADIUS) {
-                    break;
-                }
-            }
-        }
+    for (Bitboard remaining = queens; remaining != EMPTY; remaining &= remaining - 1) {
+        const int square = std::countr_zero(remaining);
+        const ChessPieceColor color = board.squares[square].piece.PieceColor;
+        const Bitboard enemyAttacks = attacks[static_cast<std::size_t>(opposite(color))];
+        const Bitboard reachable = queenAttacks(square, board.allPieces) &
+                                   ~colorPieces(board, color) & kQueenEscapeZones[square];
+        const int escapeSquares = popcount(reachable & ~enemyAttacks);
 
         if (escapeSquares == 0) {
-            if (piece.PieceColor == ChessPieceColor::WHITE) {
-                score -= QUEEN_TRAP_NO_ESCAPE_PENALTY;
-            } else {
-                score += QUEEN_TRAP_NO_ESCAPE_PENALTY;
-            }
+            score -= whiteRelative(color, QUEEN_TRAP_NO_ESCAPE_PENALTY);
         } else if (escapeSquares <= QUEEN_TRAP_LOW_ESCAPE_THRESHOLD) {
-            if (piece.PieceColor == ChessPieceColor::WHITE) {
-                score -= QUEEN_TRAP_LOW_ESCAPE_PENALTY;
-            } else {
-                score += QUEEN_TRAP_LOW_ESCAPE_PENALTY;
-            }
+            score -= whiteRelative(color, QUEEN_TRAP_LOW_ESCAPE_PENALTY);
         } else if (escapeSquares <= QUEEN_TRAP_MEDIUM_ESCAPE_THRESHOLD) {
-            if (piece.PieceColor == ChessPieceColor::WHITE) {
-                score -= QUEEN_TRAP_MEDIUM_ESCAPE_PENALTY;
-            } else {
-                score += QUEEN_TRAP_MEDIUM_ESCAPE_PENALTY;
-            }
+            score -= whiteRelative(color, QUEEN_TRAP_MEDIUM_ESCAPE_PENALTY);
         }
 
-        bool isOnEdge = (row == 0 || row == 7 || col == 0 || col == 7);
-        bool isInCorner = ((row == 0 || row == 7) && (col == 0 || col == 7));
-
-        if (isInCorner && escapeSquares <= QUEEN_TRAP_CORNER_ESCAPE_THRESHOLD) {
-            if (piece.PieceColor == ChessPieceColor::WHITE) {
-                score -= QUEEN_TRAP_CORNER_PENALTY;
-            } else {
-                score += QUEEN_TRAP_CORNER_PENALTY;
-            }
-        } else if (isOnEdge && escapeSquares <= QUEEN_TRAP_EDGE_ESCAPE_THRESHOLD) {
-            if (piece.PieceColor == ChessPieceColor::WHITE) {
-                score -= QUEEN_TRAP_EDGE_PENALTY;
-            } else {
-                score += QUEEN_TRAP_EDGE_PENALTY;
-            }
+        if (get_bit(kCornerSquares, square) &&
+            escapeSquares <= QUEEN_TRAP_CORNER_ESCAPE_THRESHOLD) {
+            score -= whiteRelative(color, QUEEN_TRAP_CORNER_PENALTY);
+        } else if (get_bit(kEdgeSquares, square) &&
+                   escapeSquares <= QUEEN_TRAP_EDGE_ESCAPE_THRESHOLD) {
+            score -= whiteRelative(color, QUEEN_TRAP_EDGE_PENALTY);
         }
     }
 
@@ -826,117 +938,44 @@ int evaluateQueenTrapDanger(const Board& board) {
 
 int evaluateTacticalSafety(const Board& board) {
     int score = 0;
+    const Bitboard minorAndRookAttackers = board.whitePawns | board.blackPawns |
+                                           board.whiteKnights | board.blackKnights |
+                                           board.whiteBishops | board.blackBishops |
+                                           board.whiteRooks | board.blackRooks;
 
-    for (int i = 0; i < NUM_SQUARES; i++) {
-        const Piece& piece = board.squares[i].piece;
-        if (piece.PieceType == ChessPieceType::NONE) {
+    for (Bitboard pieces = board.allPieces; pieces != EMPTY; pieces &= pieces - 1) {
+        const int square = std::countr_zero(pieces);
+        const Piece& piece = board.squares[square].piece;
+        const bool isQueen = piece.PieceType == ChessPieceType::QUEEN;
+        if (!isQueen && piece.PieceValue < HIGH_VALUE_PIECE_THRESHOLD) {
             continue;
         }
-        if (piece.PieceType == ChessPieceType::QUEEN) {
-            int row = i / BOARD_SIZE;
-            int col = i % BOARD_SIZE;
-            int attackers = 0;
-            int defenders = 0;
-
-            ChessPieceColor enemyColor = (piece.PieceColor == ChessPieceColor::WHITE)
-                                             ? ChessPieceColor::BLACK
-                                             : ChessPieceColor::WHITE;
-
-            for (int j = 0; j < NUM_SQUARES; j++) {
-                const Piece& otherPiece = board.squares[j].piece;
-                if (otherPiece.PieceType == ChessPieceType::NONE || j == i) {
-                    continue;
-                }
-                if (canPieceAttackSquare(board, j, i)) {
-                    if (otherPiece.PieceColor == enemyColor) {
-                        attackers++;
-                    } else {
-                        defenders++;
-                    }
-                }
-            }
-
-            if (attackers > defenders) {
-                int dangerLevel = (attackers - defenders) * DANGER_LEVEL_SCALE;
-                if (piece.PieceColor == ChessPieceColor::WHITE) {
-                    score -= dangerLevel;
-                } else {
-                    score += dangerLevel;
-                }
-
-                if (attackers > 0) {
-                    int weakestAttacker = 10000;
-                    for (int j = 0; j < NUM_SQUARES; j++) {
-                        const Piece& attacker = board.squares[j].piece;
-                        if (attacker.PieceColor == enemyColor &&
-                            canPieceAttackSquare(board, j, i)) {
-                            weakestAttacker = std::min<int>(attacker.PieceValue, weakestAttacker);
-                        }
-                    }
-
-                    if (weakestAttacker < piece.PieceValue) {
-                        if (piece.PieceColor == ChessPieceColor::WHITE) {
-                            score -= QUEEN_TACTICAL_PENALTY;
-                        } else {
-                            score += QUEEN_TACTICAL_PENALTY;
-                        }
-                    }
-                }
-            }
 
-            bool nearEnemyKing = false;
-            for (int j = 0; j < NUM_SQUARES; j++) {
-                if (board.squares[j].piece.PieceType == ChessPieceType::KING &&
-                    board.squares[j].piece.PieceColor == enemyColor) {
-                    int kingRow = j / BOARD_SIZE;
-                    int kingCol = j % BOARD_SIZE;
-                    int distance = (abs(row - kingRow) > abs(col - kingCol)) ? abs(row - kingRow)
-                                                                             : abs(col - kingCol);
-                    if (distance <= NEAR_ENEMY_KING_DISTANCE) {
-                        nearEnemyKing = true;
-                        break;
-                    }
-                }
-            }
+        const ChessPieceColor enemyColor = opposite(piece.PieceColor);
+        const Bitboard attackerSet = attackersTo(board, square);
+        const Bitboard enemyAttackers = attackerSet & colorPieces(board, enemyColor);
+        const int attackers = popcount(enemyAttackers);
+        const int defenders = popcount(attackerSet & colorPieces(board, piece.PieceColor));
 
-            if (nearEnemyKing && defenders < NEAR_ENEMY_KING_LOW_DEFENDER_THRESHOLD) {
-                if (piece.PieceColor == ChessPieceColor::WHITE) {
-                    score -= NEAR_ENEMY_KING_PENALTY;
-                } else {
-                    score += NEAR_ENEMY_KING_PENALTY;
-                }
+        if (!isQueen) {
+            if (attackers > defenders) {
+                const int penalty = (attackers - defenders) * piece.PieceValue / PENALTY_DIVISOR;
+                score -= whiteRelative(piece.PieceColor, penalty);
             }
+            continue;
         }
 
-        else if (piece.PieceValue >= HIGH_VALUE_PIECE_THRESHOLD) {
-            int attackers = 0;
-            int defenders = 0;
-            ChessPieceColor enemyColor = (piece.PieceColor == ChessPieceColor::WHITE)
-                                             ? ChessPieceColor::BLACK
-                                             : ChessPieceColor::WHITE;
-
-            for (int j = 0; j < NUM_SQUARES; j++) {
-                const Piece& otherPiece = board.squares[j].piece;
-                if (otherPiece.PieceType == ChessPieceType::NONE || j == i) {
-                    continue;
-                }
-                if (canPieceAttackSquare(board, j, i)) {
-                    if (otherPiece.PieceColor == enemyColor) {
-                        attackers++;
-                    } else {
-                        defenders++;
-                    }
-                }
+        if (attackers > defenders) {
+            score -= whiteRelative(piece.PieceColor, (attackers - defenders) * DANGER_LEVEL_SCALE);
+            if ((enemyAttackers & minorAndRookAttackers) != EMPTY) {
+                score -= whiteRelative(piece.PieceColor, QUEEN_TACTICAL_PENALTY);
             }
+        }
 
-            if (attackers > defenders) {
-                int penalty = (attackers - defenders) * piece.PieceValue / PENALTY_DIVISOR;
-                if (piece.PieceColor == ChessPieceColor::WHITE) {
-                    score -= penalty;
-                } else {
-                    score += penalty;
-                }
-            }
+        const Bitboard enemyKings = board.getPieceBitboard(ChessPieceType::KING, enemyColor);
+        const bool nearEnemyKing = (kNearEnemyKingZones[square] & enemyKings) != EMPTY;
+        if (nearEnemyKing && defenders < NEAR_ENEMY_KING_LOW_DEFENDER_THRESHOLD) {
+            score -= whiteRelative(piece.PieceColor, NEAR_ENEMY_KING_PENALTY);
         }
     }
 
@@ -947,10 +986,8 @@ void setNNUEEnabled(bool enabled) {
     useNNUE.store(enabled, std::memory_order_relaxed);
 }
 
-void setFastEvaluationMode(bool enabled) {
-    useFastEval = enabled;
+bool isNNUEEnabled() {
+    return useNNUE.load(std::memory_order_relaxed) &&
+           (NNUE::globalEvaluator || NNUEBitboard::globalEvaluator);
 }
 
-bool isFastEvaluationMode() {
-    return useFastEval;
-}
@@ -8,6 +8,11 @@
 #include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <vector>
+
+namespace EvalTrace {
+class Recorder;
+} // namespace EvalTrace
 
 inline constexpr int KING_SAFETY_PAWN_SHIELD_BONUS = 10;
 inline constexpr int KING_SAFETY_OPEN_FILE_PENALTY = 20;
@@ -60,7 +65,6 @@ int evaluateHangingPieces(const Board& board, ChessPieceColor color);
 int evaluateQueenTrapDanger(const Board& board);
 int evaluateTacticalSafety(const Board& board);
 bool canPieceAttackSquare(const Board& board, int piecePos, int targetPos);
-int evaluatePosition(const Board& board, int contempt = 0);
 int evaluateKingSafetyForColor(const Board& board, int kingPos, ChessPieceColor color);
 int evaluatePassedPawns(const Board& board);
 int evaluatePassedPawns(const Board& board, ChessPieceColor color);
@@ -68,10 +72,17 @@ int evaluateBishopPair(const Board& board);
 int evaluateRooksOnOpenFiles(const Board& board);
 int evaluateEndgame(const Board& board);
 
+inline constexpr int DEFAULT_PAWN_HASH_MB = 1;
+inline constexpr int MAX_PAWN_HASH_MB = 256;
+inline constexpr int PAWN_HASH_NO_KING_SQUARE = -1;
+
 struct PawnHashEntry {
     std::uint64_t key = 0;
+    std::array<Bitboard, 2> passedPawns{};
     int mgScore = 0;
     int egScore = 0;
+    std::array<int, 2> shelterKingSquare{PAWN_HASH_NO_KING_SQUARE, PAWN_HASH_NO_KING_SQUARE};
+    std::array<int, 2> shelterScore{};
 };
 
 struct PawnHashScore {
@@ -79,19 +90,25 @@ struct PawnHashScore {
     int egScore = 0;
 };
 
-struct PawnHashTable {
-    static constexpr std::size_t SIZE = 16384;
-    std::array<PawnHashEntry, SIZE> entries{};
+class PawnHashTable {
+public:
+    explicit PawnHashTable(int sizeMb = DEFAULT_PAWN_HASH_MB) {
+        resize(sizeMb);
+    }
 
-    PawnHashTable() {
-        clear();
+    void resize(int sizeMb);
+    void clear();
+
+    std::size_t size() const {
+        return entries.size();
     }
-    void clear() {
-        entries.fill({});
+
+    PawnHashEntry& entry(std::uint64_t key) {
+        return entries[static_cast<std::size_t>(key & mask)];
     }
 
     std::optional<PawnHashScore> probe(std::uint64_t key) const {
-        const auto& e = entries[key % SIZE];
+        const auto& e = entries[static_cast<std::size_t>(key & mask)];
         if (e.key == key) {
             return PawnHashScore{e.mgScore, e.egScore};
         }
@@ -99,15 +116,126 @@ struct PawnHashTable {
     }
 
     void store(std::uint64_t key, int mg, int eg) {
-        auto& e = entries[key % SIZE];
+        auto& e = entry(key);
+        e = PawnHashEntry{};
         e.key = key;
         e.mgScore = mg;
         e.egScore = eg;
     }
+
+private:
+    std::vector<PawnHashEntry> entries;
+    std::uint64_t mask = 0;
+};
+
+using EndgameEvaluator = int (*)(const Board&);
+using EndgameScaleFunction = int (*)(const Board&);
+
+inline constexpr int SCALE_FACTOR_DRAW = 0;
+inline constexpr int SCALE_FACTOR_NORMAL = 64;
+inline constexpr std::uint64_t NO_MATERIAL_KEY = ~0ULL;
+
+struct MaterialHashEntry {
+    std::uint64_t key = NO_MATERIAL_KEY;
+    int gamePhase = 0;
+    int imbalanceMg = 0;
+    int imbalanceEg = 0;
+    bool genericEndgame = false;
+    EndgameEvaluator endgameEvaluator = nullptr;
+    EndgameScaleFunction scaleFunction = nullptr;
+};
+
+class MaterialHashTable {
+public:
+    static constexpr std::size_t SIZE = 8192;
+
+    MaterialHashTable() : entries(SIZE) {}
+
+    const MaterialHashEntry& probe(const Board& board);
+    void clear();
+
+private:
+    std::vector<MaterialHashEntry> entries;
+};
+
+struct EvalCacheStats {
+    std::uint64_t probes = 0;
+    std::uint64_t hits = 0;
+};
+
+class EvalCache {
+public:
+    static constexpr std::size_t SIZE = 1U << 16U;
+
+    EvalCache() : entries(SIZE) {}
+
+    std::optional<int> probe(std::uint64_t key) {
+        ++counters.probes;
+        const std::uint64_t e = entries[static_cast<std::size_t>(key & (SIZE - 1))];
+        if (((e ^ key) & KEY_MASK) != 0 || (e & ~KEY_MASK) == 0) {
+            return std::nullopt;
+        }
+        ++counters.hits;
+        return static_cast<int>(e & ~KEY_MASK) + EVAL_BIAS;
+    }
+
+    void store(std::uint64_t key, int eval) {
+        if (eval <= EVAL_BIAS || eval > -EVAL_BIAS - 1) {
+            return;
+        }
+        entries[static_cast<std::size_t>(key & (SIZE - 1))] =
+            (key & KEY_MASK) | static_cast<std::uint64_t>(eval - EVAL_BIAS);
+    }
+
+    void clear();
+
+    const EvalCacheStats& stats() const {
+        return counters;
+    }
+
+    void mergeStats(const EvalCacheStats& other) {
+        counters.probes += other.probes;
+        counters.hits += other.hits;
+    }
+
+private:
+    static constexpr std::uint64_t KEY_MASK = ~0xFFFFULL;
+    static constexpr int EVAL_BIAS = -32768;
+
+    std::vector<std::uint64_t> entries;
+    EvalCacheStats counters;
+};
+
+enum class EvalTier : std::uint8_t { MATERIAL, PAWNS, POSITIONAL, TACTICAL };
+
+inline constexpr int EVAL_WINDOW_UNBOUNDED = 1000000;
+
+// Bounds for lazy evaluation, in white's point of view. Evaluation stops after the first tier
+// whose score lies outside [alpha, beta] by more than margin per tier still to be evaluated.
+struct EvalWindow {
+    int alpha = -EVAL_WINDOW_UNBOUNDED;
+    int beta = EVAL_WINDOW_UNBOUNDED;
+    int margin = 0;
+    EvalTier maxTier = EvalTier::TACTICAL;
+};
+
+struct TieredEval {
+    int score = 0;
+    EvalTier tier = EvalTier::MATERIAL;
 };
 
+TieredEval evaluateTiered(const Board& board, const EvalWindow& window, int contempt = 0,
+                          PawnHashTable* pawnTable = nullptr,
+                          MaterialHashTable* materialTable = nullptr);
+int evaluatePosition(const Board& board, int contempt = 0, PawnHashTable* pawnTable = nullptr,
+                     MaterialHashTable* materialTable = nullptr);
+// The hand-written evaluation without NNUE or contempt, recording the coefficient of every
+// tunable parameter in trace.
+int traceEvaluation(const Board& board, EvalTrace::Recorder& trace);
 std::uint64_t computePawnHash(const Board& board);
+PackedScore computePsqScore(const Board& board);
+std::uint64_t computeMaterialKey(const Board& board);
+MaterialHashEntry computeMaterialEntry(const Board& board);
 
 void setNNUEEnabled(bool enabled);
-void setFastEvaluationMode(bool enabled);
-bool isFastEvaluationMode();
+bool isNNUEEnabled();
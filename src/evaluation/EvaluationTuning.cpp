@@ -1,82 +1,96 @@
 #include "EvaluationTuning.h"
+#include "../ai/TrainingMath.h"
+#include "../utils/ThreadPool.h"
 #include "ChessBoard.h"
 #include "ChessPiece.h"
+#include "EvalTrace.h"
+#include "Evaluation.h"
+#include "PackedScore.h"
+#include "ParamPack.h"
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
 #include <cstddef>
-#include <future>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <numbers>
+#include <optional>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace EvaluationParams {
 
-const PieceSquareTable TUNED_PAWN_MG = {
+constexpr PieceSquareTable TUNED_PAWN_MG = {
     0,   0,  0,  0,   0,   0,   0,  0,   78,  83, 86, 73,  102, 82, 85, 90,
     7,   29, 21, 44,  40,  31,  44, 7,   -17, 16, -2, 15,  14,  0,  15, -13,
     -26, 3,  10, 20,  16,  2,   0,  -23, -22, 9,  5,  -11, -10, -2, 3,  -19,
     -31, 8,  -7, -37, -36, -14, 3,  -31, 0,   0,  0,  0,   0,   0,  0,  0};
 
-const PieceSquareTable TUNED_PAWN_EG = {
+constexpr PieceSquareTable TUNED_PAWN_EG = {
     0,  0,  0,  0,  0,  0, 0,  0,  178, 173, 158, 134, 147, 132, 165, 187, 94, 100, 85, 67, 56, 53,
     82, 84, 32, 24, 13, 5, -2, 4,  17,  17,  13,  9,   -3,  -7,  -7,  -8,  3,  -1,  4,  7,  -6, 1,
     0,  -5, -1, -8, 13, 8, 8,  10, 13,  0,   2,   -7,  0,   0,   0,   0,   0,  0,   0,  0};
 
-const PieceSquareTable TUNED_KNIGHT_MG = {
+constexpr PieceSquareTable TUNED_KNIGHT_MG = {
     -167, -89, -34, -49, 61, -97, -15, -107, -73,  -41, 72,  36,  23,  62,  7,   -17,
     -47,  60,  37,  65,  84, 129, 73,  44,   -9,   17,  19,  53,  37,  69,  18,  22,
     -13,  4,   16,  13,  28, 19,  21,  -8,   -23,  -9,  12,  10,  19,  17,  25,  -16,
     -29,  -53, -12, -3,  -1, 18,  -14, -19,  -105, -21, -58, -33, -17, -28, -19, -23};
 
-const PieceSquareTable TUNED_KNIGHT_EG = {
+constexpr PieceSquareTable TUNED_KNIGHT_EG = {
     -58, -38, -13, -28, -31, -27, -63, -99, -25, -8,  -25, -2,  -9,  -25, -24, -52,
     -24, -20, 10,  9,   -1,  -9,  -19, -41, -17, 3,   22,  22,  22,  11,  8,   -18,
     -18, -6,  16,  25,  16,  17,  4,   -18, -23, -3,  -1,  15,  10,  -3,  -20, -22,
     -42, -20, -10, -5,  -2,  -20, -23, -44, -29, -51, -23, -15, -22, -18, -50, -64};
 
-const PieceSquareTable TUNED_BISHOP_MG = {
+constexpr PieceSquareTable TUNED_BISHOP_MG = {
     -29, 4,  -82, -37, -25, -42, 7,  -8, -26, 16, -18, -13, 30,  59,  18,  -47,
     -16, 37, 43,  40,  35,  50,  37, -2, -4,  5,  19,  50,  37,  37,  7,   -2,
     -6,  13, 13,  26,  34,  12,  10, 4,  0,   15, 15,  15,  14,  27,  18,  10,
     4,   15, 16,  0,   7,   21,  33, 1,  -33, -3, -14, -21, -13, -12, -39, -21};
 
-const PieceSquareTable TUNED_BISHOP_EG = {
+constexpr PieceSquareTable TUNED_BISHOP_EG = {
     -14, -21, -11, -8, -7, -9, -17, -24, -8,  -4, 7,   -12, -3, -13, -4, -14,
     2,   -8,  0,   -1, -2, 6,  0,   4,   -3,  9,  12,  9,   14, 10,  3,  2,
     -6,  3,   13,  19, 7,  10, -3,  -9,  -12, -3, 8,   10,  13, 3,   -7, -15,
     -14, -18, -7,  -1, 4,  -9, -15, -27, -23, -9, -23, -5,  -9, -16, -5, -17};
 
-const PieceSquareTable TUNED_ROOK_MG = {
+constexpr PieceSquareTable TUNED_ROOK_MG = {
     32,  42,  32,  51, 63, 9,  31, 43,  27,  32,  58,  62,  80, 67, 26,  44,
     -5,  19,  26,  36, 17, 45, 61, 16,  -24, -11, 7,   26,  24, 35, -8,  -20,
     -36, -26, -12, -1, 9,  -7, 6,  -23, -45, -25, -16, -17, 3,  0,  -5,  -33,
     -44, -16, -20, -9, -1, 11, -6, -71, -19, -13, 1,   17,  16, 7,  -37, -26};
 
-const PieceSquareTable TUNED_ROOK_EG = {
+constexpr PieceSquareTable TUNED_ROOK_EG = {
     13, 10,  18, 15,  12, 12, 8, 5, 11, 13, 13,  11, -3, 3, 8,  3,  7,  7,   7,  5,  4,  -3,
     -5, -3,  4,  3,   13, 1,  2, 1, -1, 2,  3,   5,  8,  4, -5, -6, -8, -11, -4, 0,  -5, -1,
     -7, -12, -8, -16, -6, -6, 0, 2, -9, -9, -11, -3, -9, 2, 3,  -1, -5, -13, 4,  -20};
 
-const PieceSquareTable TUNED_QUEEN_MG = {
+constexpr PieceSquareTable TUNED_QUEEN_MG = {
     -28, 0,   29, 12,  59, 44, 43, 45, -24, -39, -5,  1,   -16, 57,  28,  54,
     -13, -17, 7,  8,   29, 56, 47, 57, -27, -27, -16, -16, -1,  17,  -2,  1,
     -9,  -26, -9, -10, -2, -4, 3,  -3, -14, 2,   -11, -2,  -5,  2,   14,  5,
     -35, -8,  11, 2,   8,  15, -3, 1,  -1,  -18, -9,  10,  -15, -25, -31, -50};
 
-const PieceSquareTable TUNED_QUEEN_EG = {
+constexpr PieceSquareTable TUNED_QUEEN_EG = {
     -9,  22,  22,  27,  27,  19,  10,  20,  -17, 20,  32,  41,  58, 25,  30,  0,
     -20, 6,   9,   49,  47,  35,  19,  9,   3,   22,  24,  45,  57, 40,  57,  36,
     -18, 28,  19,  47,  31,  34,  39,  23,  -16, -27, 15,  6,   9,  17,  10,  5,
     -22, -23, -30, -16, -16, -23, -36, -32, -33, -28, -22, -43, -5, -32, -20, -41};
 
-const PieceSquareTable TUNED_KING_MG = {
+constexpr PieceSquareTable TUNED_KING_MG = {
     -65, 23, 16,  -15, -56, -34, 2,   13,  29,  -1,  -20, -7,  -8,  -4,  -38, -29,
     -9,  24, 2,   -16, -20, 6,   22,  -22, -17, -20, -12, -27, -30, -25, -14, -36,
     -49, -1, -27, -39, -46, -44, -33, -51, -14, -14, -22, -46, -44, -30, -15, -27,
     1,   7,  -8,  -64, -43, -16, 9,   8,   -15, 36,  12,  -54, 8,   -28, 24,  14};
 
-const PieceSquareTable TUNED_KING_EG = {
+constexpr PieceSquareTable TUNED_KING_EG = {
     -74, -35, -18, -18, -11, 15, 4,  -17, -12, 17,  14,  17,  17,  38,  23,  11,
     10,  17,  23,  15,  20,  45, 44, 13,  -8,  22,  24,  27,  26,  33,  26,  3,
     -18, -4,  21,  24,  27,  23, 9,  -11, -19, -3,  11,  21,  23,  16,  7,   -9,
@@ -122,109 +136,289 @@ void logEvaluationComponents(const char* component, int value) {
 
 } // namespace EvaluationParams
 
-#include <cmath>
-#include <fstream>
+namespace ParamPack {
+
+namespace {
+constexpr Pack makeDefaults() {
+    using namespace EvaluationParams;
+    constexpr std::array<const PieceSquareTable*, EvalTrace::kPieceTypes> mgTables = {
+        &TUNED_PAWN_MG, &TUNED_KNIGHT_MG, &TUNED_BISHOP_MG,
+        &TUNED_ROOK_MG, &TUNED_QUEEN_MG,  &TUNED_KING_MG};
+    constexpr std::array<const PieceSquareTable*, EvalTrace::kPieceTypes> egTables = {
+        &TUNED_PAWN_EG, &TUNED_KNIGHT_EG, &TUNED_BISHOP_EG,
+        &TUNED_ROOK_EG, &TUNED_QUEEN_EG,  &TUNED_KING_EG};
+
+    Pack pack;
+    pack[EvalTrace::MATERIAL + 0] = PAWN_VALUE;
+    pack[EvalTrace::MATERIAL + 1] = KNIGHT_VALUE;
+    pack[EvalTrace::MATERIAL + 2] = BISHOP_VALUE;
+    pack[EvalTrace::MATERIAL + 3] = ROOK_VALUE;
+    pack[EvalTrace::MATERIAL + 4] = QUEEN_VALUE;
+    for (std::size_t type = 0; type < EvalTrace::kPieceTypes; ++type) {
+        for (std::size_t square = 0; square < EvalTrace::kSquares; ++square) {
+            const std::size_t offset = (type * EvalTrace::kSquares) + square;
+            pack[EvalTrace::PST_MG + offset] = (*mgTables[type])[square];
+            pack[EvalTrace::PST_EG + offset] = (*egTables[type])[square];
+        }
+    }
+    pack[EvalTrace::BISHOP_PAIR] = BISHOP_PAIR_BONUS;
+    pack[EvalTrace::DOUBLED_PAWN] = DOUBLED_PAWN_PENALTY;
+    pack[EvalTrace::ISOLATED_PAWN] = ISOLATED_PAWN_PENALTY;
+    pack[EvalTrace::PASSED_PAWN_RANK] = PASSED_PAWN_RANK_SCALE;
+    pack[EvalTrace::PASSED_PAWN_BASE] = PASSED_PAWN_BASE_BONUS;
+    pack[EvalTrace::ROOK_OPEN_FILE] = ROOK_OPEN_FILE_BONUS;
+    pack[EvalTrace::ROOK_SEMI_OPEN_FILE] = ROOK_SEMI_OPEN_FILE_BONUS;
+    pack[EvalTrace::KNIGHT_MOBILITY] = KNIGHT_MOBILITY_WEIGHT;
+    pack[EvalTrace::BISHOP_MOBILITY] = BISHOP_MOBILITY_WEIGHT;
+    pack[EvalTrace::ROOK_MOBILITY] = ROOK_MOBILITY_WEIGHT;
+    pack[EvalTrace::QUEEN_MOBILITY] = QUEEN_MOBILITY_WEIGHT;
+    pack[EvalTrace::KING_PAWN_SHIELD] = KING_SAFETY_PAWN_SHIELD_BONUS;
+    pack[EvalTrace::KING_OPEN_FILE] = KING_SAFETY_OPEN_FILE_PENALTY;
+    pack[EvalTrace::KING_SEMI_OPEN_FILE] = KING_SAFETY_SEMI_OPEN_FILE_PENALTY;
+    pack[EvalTrace::KING_CENTRALIZATION] = KING_CENTRALIZATION_SCALE;
+    pack[EvalTrace::TEMPO] = TEMPO_BONUS;
+    return pack;
+}
+} // namespace
+
+constexpr Pack defaults = makeDefaults();
+constinit Pack active = makeDefaults();
+
+} // namespace ParamPack
+
+namespace PsqTable {
+
+Table build(const ParamPack::Pack& params) {
+    Table scores{};
+    for (int color = 0; color < 2; ++color) {
+        for (int type = 0; type < kPieceTypeCount; ++type) {
+            const auto pieceType = static_cast<ChessPieceType>(type);
+            // Kings keep their nominal value, which cancels out.
+            const int material = pieceType == ChessPieceType::KING
+                                     ? Piece::getPieceValue(pieceType)
+                                     : params[EvalTrace::MATERIAL + static_cast<std::size_t>(type)];
+            auto& squares = scores[static_cast<std::size_t>((color * kPieceTypeCount) + type)];
+            for (int square = 0; square < NUM_SQUARES; ++square) {
+                const int adjustedSquare = (color == 0) ? square : (NUM_SQUARES - 1) - square;
+                const int mg = material + params.pieceSquare(pieceType, adjustedSquare, false);
+                const int eg = material + params.pieceSquare(pieceType, adjustedSquare, true);
+                squares[static_cast<std::size_t>(square)] =
+                    (color == 0) ? makeScore(mg, eg) : makeScore(-mg, -eg);
+            }
+        }
+    }
+    return scores;
+}
+
+Table table = build(ParamPack::active);
+
+void refresh() {
+    table = build(ParamPack::active);
+}
+
+} // namespace PsqTable
 
 namespace {
-int getWorkerCount(std::size_t taskCount) {
-    if (taskCount == 0U) {
-        return 1;
+// Positions per gradient chunk. Chunks are summed in order, so the result does not depend on
+// how many threads computed them.
+constexpr std::size_t kChunkPositions = std::size_t{1} << 14;
+constexpr std::size_t kLoadBatchLines = std::size_t{1} << 16;
+constexpr std::array<const char*, EvalTrace::kPieceTypes> kPieceNames = {
+    "PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING"};
+constexpr std::array<const char*, EvalTrace::PST_MG - EvalTrace::MATERIAL> kMaterialNames = {
+    "kPawnValue", "kKnightValue", "kBishopValue", "kRookValue", "kQueenValue"};
+
+std::optional<double> parseResult(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    if (text == "1-0") {
+        return 1.0;
+    }
+    if (text == "0-1") {
+        return 0.0;
+    }
+    if (text == "1/2-1/2") {
+        return 0.5;
+    }
+    double value = 0.0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
     }
-    const unsigned int hardware = std::thread::hardware_concurrency();
-    const int fallback = 4;
-    const int available = (hardware == 0U) ? fallback : static_cast<int>(hardware);
-    return std::max(1, std::min(static_cast<int>(taskCount), available));
+    return value;
 }
 } // namespace
 
+TexelTuner::TexelTuner(int threads) : pool(std::make_unique<ThreadPool>(threads)) {
+    initParams();
+}
+
+TexelTuner::~TexelTuner() = default;
+
 double TexelTuner::sigmoid(double eval) const {
     return 1.0 / (1.0 + std::pow(10.0, -scalingK * eval / 400.0));
 }
 
-int TexelTuner::evaluateWithParams(const Board& board, const std::vector<int>& p) const {
-    int score = 0;
-    int paramIdx = 0;
-
-    for (int sq = 0; sq < 64; ++sq) {
-        const Piece& piece = board.squares[sq].piece;
-        if (piece.PieceType == ChessPieceType::NONE) {
-            continue;
+void TexelTuner::appendTrace(const Board& board, double result, std::vector<TraceEntry>& entries,
+                             std::vector<Trace>& out) {
+    EvalTrace::Recorder recorder;
+    traceEvaluation(board, recorder);
+    Trace trace{
+        .begin = entries.size(), .count = 0, .residual = recorder.residual(), .result = result};
+    for (std::size_t param = 0; param < EvalTrace::PARAM_COUNT; ++param) {
+        const float coefficient = recorder.coefficient(param);
+        if (coefficient != 0.0F) {
+            entries.push_back({static_cast<std::uint16_t>(param), coefficient});
+            ++trace.count;
         }
+    }
+    out.push_back(trace);
+}
 
-        int matVal = 0;
-        int ptIdx = static_cast<int>(piece.PieceType) - 1;
-        if (ptIdx >= 0 && ptIdx < 5 && ptIdx < static_cast<int>(p.size())) {
-            matVal = p[ptIdx];
-        }
+void TexelTuner::addPosition(const Board& board, double result) {
+    appendTrace(board, result, entries, traces);
+}
+
+bool TexelTuner::loadPositions(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
 
-        int pstVal = 0;
-        int pstBase = 5;
-        int pstIdx = pstBase + (ptIdx * 64) + sq;
-        if (pstIdx < static_cast<int>(p.size())) {
-            pstVal = p[pstIdx];
+    struct Batch {
+        std::vector<TraceEntry> entries;
+        std::vector<Trace> traces;
+    };
+    const auto workers = static_cast<std::size_t>(pool->size());
+    std::vector<std::string> lines;
+    std::vector<Batch> batches(workers);
+    std::string line;
+    while (file) {
+        lines.clear();
+        while (lines.size() < kLoadBatchLines && std::getline(file, line)) {
+            if (!line.empty()) {
+                lines.push_back(std::move(line));
+            }
         }
 
-        int total = matVal + pstVal;
-        if (piece.PieceColor == ChessPieceColor::WHITE) {
-            score += total;
-        } else {
-            score -= total;
+        const std::size_t perWorker = (lines.size() + workers - 1) / workers;
+        pool->run(workers, [&](std::size_t worker) {
+            Batch& batch = batches[worker];
+            batch.entries.clear();
+            batch.traces.clear();
+            const std::size_t end = std::min(lines.size(), (worker + 1) * perWorker);
+            for (std::size_t i = worker * perWorker; i < end; ++i) {
+                const std::string_view text = lines[i];
+                auto sep = text.rfind(';');
+                if (sep == std::string_view::npos) {
+                    sep = text.rfind(',');
+                }
+                if (sep == std::string_view::npos) {
+                    continue;
+                }
+                const auto result = parseResult(text.substr(sep + 1));
+                Board board;
+                if (!result || !board.fromFEN(text.substr(0, sep))) {
+                    continue;
+                }
+                appendTrace(board, *result, batch.entries, batch.traces);
+            }
+        });
+
+        for (const Batch& batch : batches) {
+            const std::size_t offset = entries.size();
+            entries.insert(entries.end(), batch.entries.begin(), batch.entries.end());
+            for (Trace trace : batch.traces) {
+                trace.begin += offset;
+                traces.push_back(trace);
+            }
         }
     }
 
-    (void)paramIdx;
-    return (board.turn == ChessPieceColor::WHITE) ? score : -score;
+    return !traces.empty();
 }
 
-double TexelTuner::computeError(const std::vector<int>& p) const {
-    if (positions.empty()) {
-        return 0.0;
+void TexelTuner::initParams() {
+    weights.assign(ParamPack::active.values.begin(), ParamPack::active.values.end());
+}
+
+ParamPack::Pack TexelTuner::pack() const {
+    ParamPack::Pack pack;
+    for (std::size_t param = 0; param < EvalTrace::PARAM_COUNT; ++param) {
+        pack[param] = static_cast<int>(std::lround(weights[param]));
     }
+    return pack;
+}
 
-    const int workerCount = getWorkerCount(positions.size());
-    if (workerCount == 1) {
-        double totalError = 0.0;
-        for (const auto& pos : positions) {
-            Board board;
-            board.InitializeFromFEN(pos.fen);
-            int eval = evaluateWithParams(board, p);
-            double predicted = sigmoid(eval);
-            double diff = pos.result - predicted;
-            totalError += diff * diff;
-        }
-        return totalError / static_cast<double>(positions.size());
+double TexelTuner::traceEval(const Trace& trace) const {
+    double score = trace.residual;
+    const TraceEntry* entry = entries.data() + trace.begin;
+    for (std::uint32_t i = 0; i < trace.count; ++i) {
+        score += static_cast<double>(entry[i].coefficient) * weights[entry[i].param];
     }
+    return score;
+}
 
-    std::vector<std::future<double>> futures;
-    futures.reserve(static_cast<std::size_t>(workerCount));
-    const std::size_t chunkSize = (positions.size() + static_cast<std::size_t>(workerCount) - 1U) /
-                                  static_cast<std::size_t>(workerCount);
-    for (int worker = 0; worker < workerCount; ++worker) {
-        const std::size_t begin = static_cast<std::size_t>(worker) * chunkSize;
-        if (begin >= positions.size()) {
-            break;
-        }
-        const std::size_t end = std::min(begin + chunkSize, positions.size());
-        futures.emplace_back(std::async(std::launch::async, [this, &p, begin, end]() {
-            double partialError = 0.0;
-            for (std::size_t idx = begin; idx < end; ++idx) {
-                Board board;
-                board.InitializeFromFEN(positions[idx].fen);
-                int eval = evaluateWithParams(board, p);
-                double predicted = sigmoid(eval);
-                double diff = positions[idx].result - predicted;
-                partialError += diff * diff;
-            }
-            return partialError;
-        }));
+double TexelTuner::evaluate(std::size_t position) const {
+    return traceEval(traces[position]);
+}
+
+double TexelTuner::errorAndGradient(std::vector<float>* grads) const {
+    if (traces.empty()) {
+        return 0.0;
     }
+    const std::size_t chunks = (traces.size() + kChunkPositions - 1) / kChunkPositions;
+    const std::size_t gradSize = grads == nullptr ? 0 : weights.size();
+    std::vector<double> chunkErrors(chunks, 0.0);
+    std::vector<double> chunkGrads(chunks * gradSize, 0.0);
+    const double count = static_cast<double>(traces.size());
+    // d(sigmoid)/d(eval) = s * (1 - s) * K * ln(10) / 400.
+    const double slope = scalingK * std::numbers::ln10 / 400.0;
+
+    pool->run(chunks, [&](std::size_t chunk) {
+        double error = 0.0;
+        double* grad = chunkGrads.data() + (chunk * gradSize);
+        const std::size_t end = std::min(traces.size(), (chunk + 1) * kChunkPositions);
+        for (std::size_t i = chunk * kChunkPositions; i < end; ++i) {
+            const Trace& trace = traces[i];
+            const double predicted = sigmoid(traceEval(trace));
+            const double diff = predicted - trace.result;
+            error += diff * diff;
+            if (gradSize == 0) {
+                continue;
+            }
+            const double g = 2.0 * diff * predicted * (1.0 - predicted) * slope / count;
+            const TraceEntry* entry = entries.data() + trace.begin;
+            for (std::uint32_t k = 0; k < trace.count; ++k) {
+                grad[entry[k].param] += g * entry[k].coefficient;
+            }
+        }
+        chunkErrors[chunk] = error;
+    });
 
-    double totalError = 0.0;
-    for (auto& future : futures) {
-        totalError += future.get();
+    double error = 0.0;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        error += chunkErrors[chunk];
     }
+    if (grads != nullptr) {
+        grads->assign(gradSize, 0.0F);
+        for (std::size_t param = 0; param < gradSize; ++param) {
+            double sum = 0.0;
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+                sum += chunkGrads[(chunk * gradSize) + param];
+            }
+            (*grads)[param] = static_cast<float>(sum);
+        }
+    }
+    return error / count;
+}
 
-    return totalError / static_cast<double>(positions.size());
+double TexelTuner::computeError() const {
+    return errorAndGradient(nullptr);
 }
 
 void TexelTuner::findOptimalK() {
@@ -233,7 +427,7 @@ void TexelTuner::findOptimalK() {
     for (int kCenti = 50; kCenti <= 200; ++kCenti) {
         double k = static_cast<double>(kCenti) / 100.0;
         scalingK = k;
-        double err{computeError(params)};
+        double err{computeError()};
         if (err < bestError) {
             bestError = err;
             bestK = k;
@@ -247,13 +441,13 @@ void TexelTuner::findOptimalK() {
         while (improved) {
             improved = false;
             scalingK += delta;
-            double err{computeError(params)};
+            double err{computeError()};
             if (err < bestError) {
                 bestError = err;
                 improved = true;
             } else {
                 scalingK -= 2 * delta;
-                err = computeError(params);
+                err = computeError();
                 if (err < bestError) {
                     bestError = err;
                     improved = true;
@@ -266,116 +460,29 @@ void TexelTuner::findOptimalK() {
     }
 }
 
-bool TexelTuner::loadPositions(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file) {
-        return false;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        auto sep = line.rfind(';');
-        if (sep == std::string::npos) {
-            sep = line.rfind(',');
-        }
-        if (sep == std::string::npos) {
-            continue;
-        }
-
-        TuningPosition pos;
-        pos.fen = line.substr(0, sep);
-        std::string resultStr = line.substr(sep + 1);
-
-        while (!resultStr.empty() && resultStr[0] == ' ') {
-            resultStr.erase(resultStr.begin());
-        }
-
-        if (resultStr == "1-0" || resultStr == "1.0") {
-            pos.result = 1.0;
-        } else if (resultStr == "0-1" || resultStr == "0.0") {
-            pos.result = 0.0;
-        } else if (resultStr == "1/2-1/2" || resultStr == "0.5") {
-            pos.result = 0.5;
-        } else {
-            try {
-                pos.result = std::stod(resultStr);
-            } catch (...) {
-                continue;
-            }
-        }
-
-        positions.push_back(pos);
-    }
-
-    return !positions.empty();
-}
-
-void TexelTuner::initParams() {
-    params.clear();
-    params.push_back(EvaluationParams::PAWN_VALUE);
-    params.push_back(EvaluationParams::KNIGHT_VALUE);
-    params.push_back(EvaluationParams::BISHOP_VALUE);
-    params.push_back(EvaluationParams::ROOK_VALUE);
-    params.push_back(EvaluationParams::QUEEN_VALUE);
-
-    for (int sq : EvaluationParams::TUNED_PAWN_MG) {
-        params.push_back(sq);
-    }
-    for (int sq : EvaluationParams::TUNED_KNIGHT_MG) {
-        params.push_back(sq);
-    }
-    for (int sq : EvaluationParams::TUNED_BISHOP_MG) {
-        params.push_back(sq);
-    }
-    for (int sq : EvaluationParams::TUNED_ROOK_MG) {
-        params.push_back(sq);
-    }
-    for (int sq : EvaluationParams::TUNED_QUEEN_MG) {
-        params.push_back(sq);
-    }
-    for (int sq : EvaluationParams::TUNED_KING_MG) {
-        params.push_back(sq);
-    }
-}
-
-void TexelTuner::optimize(int iterations) {
+void TexelTuner::optimize(int iterations, float learningRate) {
     initParams();
     findOptimalK();
+    std::cout << "Positions: " << traces.size() << ", trace entries: " << entries.size() << '\n';
     std::cout << "Optimal K: " << scalingK << '\n';
-    std::cout << "Initial error: " << computeError(params) << '\n';
-
+    std::cout << "Initial error: " << computeError() << '\n';
+
+    TrainingMath::OptimizerConfig config;
+    config.type = TrainingMath::Optimizer::ADAM;
+    config.learningRate = learningRate;
+    TrainingMath::OptimizerState state;
+    state.resize(weights.size());
+    std::vector<float> grads;
+    const int reportInterval = std::max(1, iterations / 20);
     for (int iter = 0; iter < iterations; ++iter) {
-        bool anyImproved = false;
-        for (int& param : params) {
-            double bestError = computeError(params);
-            param += 1;
-            double errorUp = computeError(params);
-            if (errorUp < bestError) {
-                anyImproved = true;
-                continue;
-            }
-
-            param -= 2;
-            double errorDown = computeError(params);
-            if (errorDown < bestError) {
-                anyImproved = true;
-                continue;
-            }
-
-            param += 1;
-        }
-
-        double currentError{computeError(params)};
-        std::cout << "Iteration " << (iter + 1) << " error: " << currentError << '\n';
-
-        if (!anyImproved) {
-            std::cout << "Converged at iteration " << (iter + 1) << '\n';
-            break;
+        const double error = errorAndGradient(&grads);
+        state.beginStep(config);
+        state.update(config, weights.data(), grads.data(), 0, weights.size(), 0);
+        if ((iter + 1) % reportInterval == 0 || iter + 1 == iterations) {
+            std::cout << "Iteration " << (iter + 1) << " error: " << error << '\n';
         }
     }
+    std::cout << "Final error: " << computeError() << '\n';
 }
 
 void TexelTuner::exportParams(const std::string& filename) const {
@@ -384,26 +491,32 @@ void TexelTuner::exportParams(const std::string& filename) const {
         return;
     }
 
-    file << "constexpr int PAWN_VALUE = " << params[0] << ";\n";
-    file << "constexpr int KNIGHT_VALUE = " << params[1] << ";\n";
-    file << "constexpr int BISHOP_VALUE = " << params[2] << ";\n";
-    file << "constexpr int ROOK_VALUE = " << params[3] << ";\n";
-    file << "constexpr int QUEEN_VALUE = " << params[4] << ";\n";
-    const char* names[] = {"PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING"};
-    int base = 5;
-    int p = 0;
-    for (const char* name : names) {
-        file << "\nconst int TUNED_" << name << "_MG[64] = {\n    ";
-        for (int sq = 0; sq < 64; ++sq) {
-            file << params[base + (p * 64) + sq];
-            if (sq < 63) {
-                file << ", ";
-            }
-            if ((sq + 1) % 8 == 0 && sq < 63) {
-                file << "\n    ";
+    auto rounded = [this](std::size_t index) {
+        return static_cast<int>(std::lround(weights[index]));
+    };
+    file << "// MaterialValues.h\n";
+    for (std::size_t type = 0; type < kMaterialNames.size(); ++type) {
+        file << "inline constexpr int " << kMaterialNames[type] << " = "
+             << rounded(EvalTrace::MATERIAL + type) << ";\n";
+    }
+    file << "\n// EvaluationTuning.h and Evaluation.h\n";
+    for (std::size_t param = EvalTrace::BISHOP_PAIR; param < EvalTrace::PARAM_COUNT; ++param) {
+        file << "constexpr int " << EvalTrace::scalarName(param) << " = " << rounded(param)
+             << ";\n";
+    }
+    file << "\n// EvaluationTuning.cpp\n";
+    for (std::size_t type = 0; type < EvalTrace::kPieceTypes; ++type) {
+        for (const bool endgame : {false, true}) {
+            file << "constexpr PieceSquareTable TUNED_" << kPieceNames[type]
+                 << (endgame ? "_EG" : "_MG") << " = {\n    ";
+            const std::size_t table = endgame ? EvalTrace::PST_EG : EvalTrace::PST_MG;
+            for (std::size_t square = 0; square < EvalTrace::kSquares; ++square) {
+                file << rounded(table + (type * EvalTrace::kSquares) + square);
+                if (square + 1 < EvalTrace::kSquares) {
+                    file << (((square + 1) % 8 == 0) ? ",\n    " : ", ");
+                }
             }
+            file << "};\n\n";
         }
-        file << "\n};\n";
-        ++p;
     }
 }
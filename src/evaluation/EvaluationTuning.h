@@ -5,6 +5,9 @@
 #include "../core/MaterialValues.h"
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -45,6 +48,11 @@ constexpr int KING_OPEN_FILE_PENALTY = 25;
 
 // Positional
 constexpr int PIECE_MOBILITY_WEIGHT = 4;
+// Per attacked square that is not occupied by an own piece.
+constexpr int KNIGHT_MOBILITY_WEIGHT = 4;
+constexpr int BISHOP_MOBILITY_WEIGHT = 3;
+constexpr int ROOK_MOBILITY_WEIGHT = 2;
+constexpr int QUEEN_MOBILITY_WEIGHT = 1;
 constexpr int CENTER_CONTROL_BONUS = 8;
 constexpr int PIECE_COORDINATION_BONUS = 5;
 constexpr int TACTICAL_MOTIFS_BONUS = 10;
@@ -148,23 +156,75 @@ constexpr bool ENABLE_TACTICAL_BONUSES = true;
 
 } // namespace EvaluationParams
 
-struct TuningPosition {
-    std::string fen;
-    double result;
-};
+class ThreadPool;
 
-class TexelTuner {
-    std::vector<TuningPosition> positions;
-    std::vector<int> params;
-    double scalingK = 1.13;
-    double sigmoid(double eval) const;
-    double computeError(const std::vector<int>& p) const;
-    int evaluateWithParams(const Board& board, const std::vector<int>& p) const;
-    void findOptimalK();
+namespace ParamPack {
+struct Pack;
+} // namespace ParamPack
 
+// Texel tuning of the evaluation parameters listed in EvalTrace.h. Each position is evaluated
+// once with a trace of the parameters it uses, so an error or gradient pass is a sparse dot
+// product per position instead of a FEN parse and a full evaluation.
+class TexelTuner {
 public:
+    // threads = 0 uses every core.
+    explicit TexelTuner(int threads = 0);
+    ~TexelTuner();
+    TexelTuner(const TexelTuner&) = delete;
+    TexelTuner& operator=(const TexelTuner&) = delete;
+    TexelTuner(TexelTuner&&) = delete;
+    TexelTuner& operator=(TexelTuner&&) = delete;
+
+    // Lines of "<fen>;<result>" or "<fen>,<result>" with results as 1-0, 1/2-1/2, 0-1 or a
+    // number from white's side.
     bool loadPositions(const std::string& filename);
-    void optimize(int iterations);
-    void exportParams(const std::string& filename) const;
+    void addPosition(const Board& board, double result);
     void initParams();
+    // Runs the given number of full-batch Adam steps from the active ParamPack.
+    void optimize(int iterations, float learningRate = 1.0F);
+    // Writes the parameters as declarations to paste over the ones the engine is built with.
+    void exportParams(const std::string& filename) const;
+    // The parameters rounded for ParamPack::save().
+    ParamPack::Pack pack() const;
+
+    std::size_t size() const {
+        return traces.size();
+    }
+
+    // White's score in centipawns under the current parameters.
+    double evaluate(std::size_t position) const;
+    double computeError() const;
+
+    double param(std::size_t index) const {
+        return weights[index];
+    }
+
+private:
+    // Phase-blended coefficient of one parameter in one position.
+    struct TraceEntry {
+        std::uint16_t param;
+        float coefficient;
+    };
+
+    struct Trace {
+        std::size_t begin;
+        std::uint32_t count;
+        // Untuned part of the score, such as the specialised endgames and tactical penalties.
+        float residual;
+        double result;
+    };
+
+    static void appendTrace(const Board& board, double result, std::vector<TraceEntry>& entries,
+                            std::vector<Trace>& out);
+    double sigmoid(double eval) const;
+    double traceEval(const Trace& trace) const;
+    // Mean squared error; fills the error's gradient by weight when grads is not null.
+    double errorAndGradient(std::vector<float>* grads) const;
+    void findOptimalK();
+
+    std::vector<TraceEntry> entries;
+    std::vector<Trace> traces;
+    std::vector<float> weights;
+    double scalingK = 1.13;
+    std::unique_ptr<ThreadPool> pool;
 };
@@ -115,7 +115,7 @@ float HybridEvaluator::getNeuralNetworkEvaluation(const Board& board) {
         return kNoEvalFloat;
     }
 
-    return neuralNetwork->evaluatePosition(board);
+    return neuralNetwork->evaluateQuantized(board);
 }
 
 float HybridEvaluator::getHybridEvaluation(const Board& board) {
@@ -3,13 +3,16 @@
 #include "ChessPiece.h"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <fstream>
-#include <ios>
+#include <future>
 #include <memory>
+#include <span>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #if defined(__ARM_NEON) || defined(__ARM_NEON__)
@@ -21,6 +24,272 @@
 
 namespace NNUE {
 
+namespace {
+constexpr std::size_t kInitialStackDepth = 128;
+constexpr uint32_t kPackedVersion = 1;
+constexpr uint32_t kAlignedVersion = 2;
+constexpr int kMaxActiveFeatures = 64;
+constexpr std::array<int16_t, L1_SIZE> kZeroAccumulator{};
+constexpr int kDotLanes = 4;
+constexpr std::size_t kBatchBlock = 64;
+constexpr std::size_t kMinPositionsPerWorker = 1024;
+constexpr int kThreadFallback = 4;
+
+#if defined(__AVX512BW__)
+constexpr int kUpdateLanes = 32;
+constexpr int kUpdateTileRegs = 8;
+#elif defined(__AVX2__)
+constexpr int kUpdateLanes = 16;
+constexpr int kUpdateTileRegs = 8;
+#elif NNUE_ARM_NEON
+constexpr int kUpdateLanes = 8;
+constexpr int kUpdateTileRegs = 16;
+#else
+constexpr int kUpdateLanes = 1;
+constexpr int kUpdateTileRegs = 1;
+#endif
+constexpr int kUpdateTile = kUpdateLanes * kUpdateTileRegs;
+static_assert(L1_SIZE % kUpdateTile == 0);
+
+// out = in + sum(adds) - sum(subs). Each tile of the accumulator stays in registers while all
+// feature rows are applied, so it is loaded and stored once regardless of the feature count.
+void applyFeatures(int16_t* out, const int16_t* in, const int16_t* const* adds, int addCount,
+                   const int16_t* const* subs, int subCount) {
+    for (int base = 0; base < L1_SIZE; base += kUpdateTile) {
+#if defined(__AVX512BW__)
+        __m512i tile[kUpdateTileRegs];
+        for (int r = 0; r < kUpdateTileRegs; ++r) {
+            tile[r] = _mm512_loadu_si512(in + base + (r * kUpdateLanes));
+        }
+        for (int a = 0; a < addCount; ++a) {
+            for (int r = 0; r < kUpdateTileRegs; ++r) {
+                tile[r] = _mm512_add_epi16(
+                    tile[r], _mm512_loadu_si512(adds[a] + base + (r * kUpdateLanes)));
+            }
+        }
+        for (int s = 0; s < subCount; ++s) {
+            for (int r = 0; r < kUpdateTileRegs; ++r) {
+                tile[r] = _mm512_sub_epi16(
+                    tile[r], _mm512_loadu_si512(subs[s] + base + (r * kUpdateLanes)));
+            }
+        }
+        for (int r = 0; r < kUpdateTileRegs; ++r) {
+            _mm512_storeu_si512(out + base + (r * kUpdateLanes), tile[r]);
+        }
+#elif defined(__AVX2__)
+        __m256i tile[kUpdateTileRegs];
+        for (int r = 0; r < kUpdateTileRegs; ++r) {
+            tile[r] = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(in + base + (r * kUpdateLanes)));
+        }
+        for (int a = 0; a < addCount; ++a) {
+            for (int r = 0; r < kUpdateTileRegs; ++r) {
+                tile[r] = _mm256_add_epi16(tile[r],
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                               adds[a] + base + (r * kUpdateLanes))));
+            }
+        }
+        for (int s = 0; s < subCount; ++s) {
+            for (int r = 0; r < kUpdateTileRegs; ++r) {
+                tile[r] = _mm256_sub_epi16(tile[r],
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                               subs[s] + base + (r * kUpdateLanes))));
+            }
+        }
+        for (int r = 0; r < kUpdateTileRegs; ++r) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + base + (r * kUpdateLanes)),
+                                tile[r]);
+        }
+#elif NNUE_ARM_NEON
+        int16x8_t tile[kUpdateTileRegs];
+        for (int r = 0; r < kUpdateTileRegs; ++r) {
+            tile[r] = vld1q_s16(in + base + (r * kUpdateLanes));
+        }
+        for (int a = 0; a < addCount; ++a) {
+            for (int r = 0; r < kUpdateTileRegs; ++r) {
+                tile[r] = vaddq_s16(tile[r], vld1q_s16(adds[a] + base + (r * kUpdateLanes)));
+            }
+        }
+        for (int s = 0; s < subCount; ++s) {
+            for (int r = 0; r < kUpdateTileRegs; ++r) {
+                tile[r] = vsubq_s16(tile[r], vld1q_s16(subs[s] + base + (r * kUpdateLanes)));
+            }
+        }
+        for (int r = 0; r < kUpdateTileRegs; ++r) {
+            vst1q_s16(out + base + (r * kUpdateLanes), tile[r]);
+        }
+#else
+        int32_t sum = in[base];
+        for (int a = 0; a < addCount; ++a) {
+            sum += adds[a][base];
+        }
+        for (int s = 0; s < subCount; ++s) {
+            sum -= subs[s][base];
+        }
+        out[base] = static_cast<int16_t>(sum);
+#endif
+    }
+}
+
+#if defined(__AVX512BW__)
+int32_t horizontalSum(__m512i v) {
+    alignas(64) std::array<int32_t, 16> lanes{};
+    _mm512_store_si512(lanes.data(), v);
+    int32_t sum = 0;
+    for (const int32_t lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+#endif
+
+#ifdef __AVX2__
+int32_t horizontalSum(__m256i v) {
+    __m128i sum_high = _mm256_extracti128_si256(v, 1);
+    __m128i sum_low = _mm256_castsi256_si128(v);
+    __m128i sum_128 = _mm_add_epi32(sum_high, sum_low);
+    __m128i sum_64 = _mm_add_epi32(sum_128, _mm_srli_si128(sum_128, 8));
+    __m128i sum_32 = _mm_add_epi32(sum_64, _mm_srli_si128(sum_64, 4));
+    return _mm_cvtsi128_si32(sum_32);
+}
+#endif
+
+int32_t dotProduct(const int16_t* w, const int16_t* x, int size) {
+    int32_t sum = 0;
+    int j = 0;
+#if defined(__AVX512BW__)
+    __m512i sum512 = _mm512_setzero_si512();
+    for (; j + 32 <= size; j += 32) {
+        sum512 = _mm512_add_epi32(
+            sum512, _mm512_madd_epi16(_mm512_loadu_si512(w + j), _mm512_loadu_si512(x + j)));
+    }
+    sum += horizontalSum(sum512);
+#endif
+#ifdef __AVX2__
+    __m256i sum256 = _mm256_setzero_si256();
+    for (; j + 16 <= size; j += 16) {
+        __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&w[j]));
+        __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&x[j]));
+        sum256 = _mm256_add_epi32(sum256, _mm256_madd_epi16(wv, xv));
+    }
+    sum += horizontalSum(sum256);
+#elif NNUE_ARM_NEON
+    int32x4_t sumNeon = vdupq_n_s32(0);
+    for (; j + 8 <= size; j += 8) {
+        const int16x8_t wVec = vld1q_s16(&w[static_cast<std::size_t>(j)]);
+        const int16x8_t xVec = vld1q_s16(&x[static_cast<std::size_t>(j)]);
+        sumNeon = vaddq_s32(sumNeon, vmull_s16(vget_low_s16(wVec), vget_low_s16(xVec)));
+        sumNeon = vaddq_s32(sumNeon, vmull_s16(vget_high_s16(wVec), vget_high_s16(xVec)));
+    }
+    sum += vaddvq_s32(sumNeon);
+#endif
+    for (; j < size; ++j) {
+        sum += static_cast<int32_t>(w[j]) * static_cast<int32_t>(x[j]);
+    }
+    return sum;
+}
+
+// kDotLanes dot products against one weight row, so each weight vector is loaded once for all
+// of the inputs. The lane sums are reduced together rather than one by one.
+void dotProductLanes(const int16_t* w, const int16_t* const* x, int size, int32_t* out) {
+    std::array<int32_t, kDotLanes> sums{};
+    int j = 0;
+#ifdef __AVX2__
+    __m256i sum256[kDotLanes];
+    for (auto& lane : sum256) {
+        lane = _mm256_setzero_si256();
+    }
+#if defined(__AVX512BW__)
+    __m512i sum512[kDotLanes];
+    for (auto& lane : sum512) {
+        lane = _mm512_setzero_si512();
+    }
+    for (; j + 32 <= size; j += 32) {
+        const __m512i wv = _mm512_loadu_si512(w + j);
+        for (int k = 0; k < kDotLanes; ++k) {
+            sum512[k] =
+                _mm512_add_epi32(sum512[k], _mm512_madd_epi16(wv, _mm512_loadu_si512(x[k] + j)));
+        }
+    }
+    for (int k = 0; k < kDotLanes; ++k) {
+        sum256[k] = _mm256_add_epi32(_mm512_castsi512_si256(sum512[k]),
+                                     _mm512_extracti64x4_epi64(sum512[k], 1));
+    }
+#endif
+    for (; j + 16 <= size; j += 16) {
+        const __m256i wv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&w[j]));
+        for (int k = 0; k < kDotLanes; ++k) {
+            const __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&x[k][j]));
+            sum256[k] = _mm256_add_epi32(sum256[k], _mm256_madd_epi16(wv, xv));
+        }
+    }
+    const __m256i sum01 = _mm256_hadd_epi32(sum256[0], sum256[1]);
+    const __m256i sum23 = _mm256_hadd_epi32(sum256[2], sum256[3]);
+    const __m256i sum0123 = _mm256_hadd_epi32(sum01, sum23);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data()),
+                     _mm_add_epi32(_mm256_castsi256_si128(sum0123),
+                                   _mm256_extracti128_si256(sum0123, 1)));
+#elif NNUE_ARM_NEON
+    int32x4_t sumNeon[kDotLanes];
+    for (auto& lane : sumNeon) {
+        lane = vdupq_n_s32(0);
+    }
+    for (; j + 8 <= size; j += 8) {
+        const int16x8_t wVec = vld1q_s16(&w[static_cast<std::size_t>(j)]);
+        for (int k = 0; k < kDotLanes; ++k) {
+            const int16x8_t xVec = vld1q_s16(&x[k][static_cast<std::size_t>(j)]);
+            sumNeon[k] = vaddq_s32(sumNeon[k], vmull_s16(vget_low_s16(wVec), vget_low_s16(xVec)));
+            sumNeon[k] =
+                vaddq_s32(sumNeon[k], vmull_s16(vget_high_s16(wVec), vget_high_s16(xVec)));
+        }
+    }
+    vst1q_s32(sums.data(), vpaddq_s32(vpaddq_s32(sumNeon[0], sumNeon[1]),
+                                      vpaddq_s32(sumNeon[2], sumNeon[3])));
+#endif
+    for (; j < size; ++j) {
+        for (int k = 0; k < kDotLanes; ++k) {
+            sums[k] += static_cast<int32_t>(w[j]) * static_cast<int32_t>(x[k][j]);
+        }
+    }
+    std::copy(sums.begin(), sums.end(), out);
+}
+
+int gatherFeatureRows(const Board& board, const int16_t* weights,
+                      std::array<const int16_t*, kMaxActiveFeatures>& rows) {
+    int count = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        const Piece& piece = board.squares[sq].piece;
+        if (piece.PieceType != ChessPieceType::NONE) {
+            const int feature = FeatureIndex::index(sq, piece.PieceType, piece.PieceColor);
+            rows[static_cast<std::size_t>(count++)] =
+                weights + (static_cast<std::size_t>(feature) * L1_SIZE);
+        }
+    }
+    return count;
+}
+
+int getWorkerCount(std::size_t taskCount, int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    const int available = (hardware == 0U) ? kThreadFallback : static_cast<int>(hardware);
+    const std::size_t byWork = (taskCount + kMinPositionsPerWorker - 1) / kMinPositionsPerWorker;
+    return std::max(1, std::min(available, static_cast<int>(byWork)));
+}
+
+bool loadLayer(NetworkFile::Reader& reader, LinearLayer& layer, int in, int out) {
+    const auto* weights =
+        reader.take<int16_t>(static_cast<std::size_t>(in) * static_cast<std::size_t>(out));
+    const auto* biases = reader.take<int32_t>(static_cast<std::size_t>(out));
+    if (!weights || !biases) {
+        return false;
+    }
+    layer.loadWeights(weights, biases);
+    return true;
+}
+} // namespace
+
 std::unique_ptr<NNUEEvaluator> globalEvaluator;
 
 void Accumulator::init(const int16_t* weights, const int16_t* biases) {
@@ -39,15 +308,16 @@ void Accumulator::reset() {
 }
 
 void Accumulator::refresh(const Board& board) {
-    reset();
-
-    for (int sq = 0; sq < 64; ++sq) {
-        const Piece& piece = board.squares[sq].piece;
-        if (piece.PieceType != ChessPieceType::NONE) {
-            int feature = FeatureIndex::index(sq, piece.PieceType, piece.PieceColor);
-            addFeature(feature);
-        }
+    if (!featureWeights) {
+        reset();
+        return;
     }
+
+    std::array<const int16_t*, kMaxActiveFeatures> rows{};
+    const int count = gatherFeatureRows(board, featureWeights, rows);
+    const int16_t* base = featureBiases ? featureBiases : kZeroAccumulator.data();
+    applyFeatures(white.data(), base, rows.data(), count, nullptr, 0);
+    applyFeatures(black.data(), base, rows.data(), count, nullptr, 0);
 }
 
 void Accumulator::addFeature(int feature) {
@@ -58,72 +328,136 @@ void Accumulator::addFeature(int feature) {
         return;
     }
 
-    const auto featureOffset =
-        static_cast<std::size_t>(feature) * static_cast<std::size_t>(L1_SIZE);
-    const int16_t* w = featureWeights + featureOffset;
+    const int16_t* w = featureWeights + (static_cast<std::size_t>(feature) * L1_SIZE);
+    applyFeatures(white.data(), white.data(), &w, 1, nullptr, 0);
+    applyFeatures(black.data(), black.data(), &w, 1, nullptr, 0);
+}
 
-#ifdef __AVX2__
-    for (int i = 0; i < L1_SIZE; i += 16) {
-        __m256i acc_w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&white[i]));
-        __m256i acc_b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&black[i]));
-        __m256i wt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&w[i]));
-        acc_w = _mm256_add_epi16(acc_w, wt);
-        acc_b = _mm256_add_epi16(acc_b, wt);
-        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&white[i]), acc_w);
-        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&black[i]), acc_b);
-    }
-#elif NNUE_ARM_NEON
-    for (int i = 0; i < L1_SIZE; i += 8) {
-        int16x8_t acc_w = vld1q_s16(&white[static_cast<std::size_t>(i)]);
-        int16x8_t acc_b = vld1q_s16(&black[static_cast<std::size_t>(i)]);
-        int16x8_t wt = vld1q_s16(&w[static_cast<std::size_t>(i)]);
-        vst1q_s16(&white[static_cast<std::size_t>(i)], vaddq_s16(acc_w, wt));
-        vst1q_s16(&black[static_cast<std::size_t>(i)], vaddq_s16(acc_b, wt));
+void Accumulator::removeFeature(int feature) {
+    if (!featureWeights) {
+        return;
     }
-#else
-    for (int i = 0; i < L1_SIZE; ++i) {
-        white[i] = static_cast<int16_t>(white[i] + w[i]);
-        black[i] = static_cast<int16_t>(black[i] + w[i]);
+    if (feature < 0 || feature >= INPUT_DIMENSIONS) {
+        return;
     }
-#endif
+
+    const int16_t* w = featureWeights + (static_cast<std::size_t>(feature) * L1_SIZE);
+    applyFeatures(white.data(), white.data(), nullptr, 0, &w, 1);
+    applyFeatures(black.data(), black.data(), nullptr, 0, &w, 1);
 }
 
-void Accumulator::removeFeature(int feature) {
+void Accumulator::update(const Accumulator& parent, const int* added, int addedCount,
+                         const int* removed, int removedCount) {
+    featureWeights = parent.featureWeights;
+    featureBiases = parent.featureBiases;
     if (!featureWeights) {
+        white = parent.white;
+        black = parent.black;
         return;
     }
-    if (feature < 0 || feature >= INPUT_DIMENSIONS) {
+
+    std::array<const int16_t*, MAX_DIRTY_PIECES> adds{};
+    std::array<const int16_t*, MAX_DIRTY_PIECES> subs{};
+    int addCount = 0;
+    int subCount = 0;
+    for (int i = 0; i < addedCount && addCount < MAX_DIRTY_PIECES; ++i) {
+        if (added[i] >= 0 && added[i] < INPUT_DIMENSIONS) {
+            adds[static_cast<std::size_t>(addCount++)] =
+                featureWeights + (static_cast<std::size_t>(added[i]) * L1_SIZE);
+        }
+    }
+    for (int i = 0; i < removedCount && subCount < MAX_DIRTY_PIECES; ++i) {
+        if (removed[i] >= 0 && removed[i] < INPUT_DIMENSIONS) {
+            subs[static_cast<std::size_t>(subCount++)] =
+                featureWeights + (static_cast<std::size_t>(removed[i]) * L1_SIZE);
+        }
+    }
+
+    applyFeatures(white.data(), parent.white.data(), adds.data(), addCount, subs.data(),
+                  subCount);
+    applyFeatures(black.data(), parent.black.data(), adds.data(), addCount, subs.data(),
+                  subCount);
+}
+
+void DirtyPiece::remove(int square, const Piece& piece) {
+    if (piece.PieceType == ChessPieceType::NONE) {
+        return;
+    }
+    if (removedCount >= MAX_DIRTY_PIECES) {
+        overflow = true;
         return;
     }
+    removed[static_cast<std::size_t>(removedCount++)] = {square, piece.PieceType, piece.PieceColor};
+}
+
+void DirtyPiece::add(int square, const Piece& piece) {
+    if (piece.PieceType == ChessPieceType::NONE) {
+        return;
+    }
+    if (addedCount >= MAX_DIRTY_PIECES) {
+        overflow = true;
+        return;
+    }
+    added[static_cast<std::size_t>(addedCount++)] = {square, piece.PieceType, piece.PieceColor};
+}
 
-    const auto featureOffset =
-        static_cast<std::size_t>(feature) * static_cast<std::size_t>(L1_SIZE);
-    const int16_t* w = featureWeights + featureOffset;
+AccumulatorStack::AccumulatorStack() : entries(kInitialStackDepth) {}
 
-#ifdef __AVX2__
-    for (int i = 0; i < L1_SIZE; i += 16) {
-        __m256i acc_w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&white[i]));
-        __m256i acc_b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&black[i]));
-        __m256i wt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&w[i]));
-        acc_w = _mm256_sub_epi16(acc_w, wt);
-        acc_b = _mm256_sub_epi16(acc_b, wt);
-        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&white[i]), acc_w);
-        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&black[i]), acc_b);
+void AccumulatorStack::clear() {
+    top = 0;
+    entries[0].computed = false;
+}
+
+void AccumulatorStack::push(const DirtyPiece& dirty) {
+    if (++top == entries.size()) {
+        entries.emplace_back();
     }
-#elif NNUE_ARM_NEON
-    for (int i = 0; i < L1_SIZE; i += 8) {
-        int16x8_t acc_w = vld1q_s16(&white[static_cast<std::size_t>(i)]);
-        int16x8_t acc_b = vld1q_s16(&black[static_cast<std::size_t>(i)]);
-        int16x8_t wt = vld1q_s16(&w[static_cast<std::size_t>(i)]);
-        vst1q_s16(&white[static_cast<std::size_t>(i)], vsubq_s16(acc_w, wt));
-        vst1q_s16(&black[static_cast<std::size_t>(i)], vsubq_s16(acc_b, wt));
+    entries[top].dirty = dirty;
+    entries[top].computed = false;
+}
+
+void AccumulatorStack::pop() {
+    if (top > 0) {
+        --top;
     }
-#else
-    for (int i = 0; i < L1_SIZE; ++i) {
-        white[i] = static_cast<int16_t>(white[i] - w[i]);
-        black[i] = static_cast<int16_t>(black[i] - w[i]);
+}
+
+const Accumulator& AccumulatorStack::current(const Board& board,
+                                             const NNUEEvaluator& evaluator) {
+    std::size_t base = top;
+    while (!entries[base].computed && base > 0 && !entries[base].dirty.overflow) {
+        --base;
     }
-#endif
+
+    if (!entries[base].computed) {
+        Entry& entry = entries[top];
+        evaluator.initAccumulator(entry.accumulator);
+        entry.accumulator.refresh(board);
+        entry.computed = true;
+        ++refreshCount;
+        return entry.accumulator;
+    }
+
+    for (std::size_t i = base + 1; i <= top; ++i) {
+        Entry& entry = entries[i];
+        std::array<int, MAX_DIRTY_PIECES> added{};
+        std::array<int, MAX_DIRTY_PIECES> removed{};
+        for (int j = 0; j < entry.dirty.addedCount; ++j) {
+            const PieceChange& change = entry.dirty.added[static_cast<std::size_t>(j)];
+            added[static_cast<std::size_t>(j)] =
+                FeatureIndex::index(change.square, change.type, change.color);
+        }
+        for (int j = 0; j < entry.dirty.removedCount; ++j) {
+            const PieceChange& change = entry.dirty.removed[static_cast<std::size_t>(j)];
+            removed[static_cast<std::size_t>(j)] =
+                FeatureIndex::index(change.square, change.type, change.color);
+        }
+        entry.accumulator.update(entries[i - 1].accumulator, added.data(),
+                                 entry.dirty.addedCount, removed.data(),
+                                 entry.dirty.removedCount);
+        entry.computed = true;
+    }
+    return entries[top].accumulator;
 }
 
 LinearLayer::LinearLayer(int in, int out)
@@ -136,50 +470,45 @@ void LinearLayer::forward(const void* input, void* output) const {
     auto* out = static_cast<int32_t*>(output);
 
     for (int i = 0; i < outputSize; ++i) {
-#ifdef __AVX2__
-        __m256i sum = _mm256_setzero_si256();
         const auto rowOffset = static_cast<std::size_t>(i) * static_cast<std::size_t>(inputSize);
-        const int16_t* wRow = weights.data() + rowOffset;
+        out[i] = dotProduct(weights.data() + rowOffset, in, inputSize) +
+                 biases[static_cast<std::size_t>(i)];
+    }
+}
 
-        for (int j = 0; j < inputSize; j += 16) {
-            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&wRow[j]));
-            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&in[j]));
-            __m256i prod = _mm256_madd_epi16(w, x);
-            sum = _mm256_add_epi32(sum, prod);
-        }
+void LinearLayer::forwardConcat(const int16_t* first, const int16_t* second,
+                                int32_t* output) const {
+    const int half = inputSize / 2;
+    for (int i = 0; i < outputSize; ++i) {
+        const int16_t* row =
+            weights.data() + (static_cast<std::size_t>(i) * static_cast<std::size_t>(inputSize));
+        output[i] = dotProduct(row, first, half) + dotProduct(row + half, second, half) +
+                    biases[static_cast<std::size_t>(i)];
+    }
+}
 
-        __m128i sum_high = _mm256_extracti128_si256(sum, 1);
-        __m128i sum_low = _mm256_castsi256_si128(sum);
-        __m128i sum_128 = _mm_add_epi32(sum_high, sum_low);
-        __m128i sum_64 = _mm_add_epi32(sum_128, _mm_srli_si128(sum_128, 8));
-        __m128i sum_32 = _mm_add_epi32(sum_64, _mm_srli_si128(sum_64, 4));
-        out[i] = _mm_cvtsi128_si32(sum_32) + biases[i];
-#elif NNUE_ARM_NEON
-        const auto rowOffset = static_cast<std::size_t>(i) * static_cast<std::size_t>(inputSize);
-        const int16_t* wRow = weights.data() + rowOffset;
-        int32x4_t sumNeon = vdupq_n_s32(0);
-        int j = 0;
-        for (; j + 8 <= inputSize; j += 8) {
-            const int16x8_t wVec = vld1q_s16(&wRow[static_cast<std::size_t>(j)]);
-            const int16x8_t xVec = vld1q_s16(&in[static_cast<std::size_t>(j)]);
-            sumNeon = vaddq_s32(sumNeon, vmull_s16(vget_low_s16(wVec), vget_low_s16(xVec)));
-            sumNeon = vaddq_s32(sumNeon, vmull_s16(vget_high_s16(wVec), vget_high_s16(xVec)));
+void LinearLayer::forwardBatch(const int16_t* input, int count, int32_t* output) const {
+    const auto inStride = static_cast<std::size_t>(inputSize);
+    const auto outStride = static_cast<std::size_t>(outputSize);
+    int b = 0;
+    for (; b + kDotLanes <= count; b += kDotLanes) {
+        std::array<const int16_t*, kDotLanes> inputs{};
+        for (int k = 0; k < kDotLanes; ++k) {
+            inputs[k] = input + (static_cast<std::size_t>(b + k) * inStride);
         }
-        int32_t sum = vaddvq_s32(sumNeon);
-        for (; j < inputSize; ++j) {
-            sum += static_cast<int32_t>(wRow[static_cast<std::size_t>(j)]) *
-                   static_cast<int32_t>(in[static_cast<std::size_t>(j)]);
-        }
-        out[i] = sum + biases[static_cast<std::size_t>(i)];
-#else
-        int32_t sum = 0;
-        const auto rowOffset = static_cast<std::size_t>(i) * static_cast<std::size_t>(inputSize);
-        const int16_t* w{weights.data() + rowOffset};
-        for (int j = 0; j < inputSize; ++j) {
-            sum += static_cast<int32_t>(w[j]) * static_cast<int32_t>(in[j]);
+        for (int i = 0; i < outputSize; ++i) {
+            std::array<int32_t, kDotLanes> sums{};
+            dotProductLanes(weights.data() + (static_cast<std::size_t>(i) * inStride),
+                            inputs.data(), inputSize, sums.data());
+            for (int k = 0; k < kDotLanes; ++k) {
+                output[(static_cast<std::size_t>(b + k) * outStride) + i] =
+                    sums[k] + biases[static_cast<std::size_t>(i)];
+            }
         }
-        out[i] = sum + biases[i];
-#endif
+    }
+    for (; b < count; ++b) {
+        forward(input + (static_cast<std::size_t>(b) * inStride),
+                output + (static_cast<std::size_t>(b) * outStride));
     }
 }
 
@@ -212,97 +541,58 @@ NNUEEvaluator::NNUEEvaluator() {
 NNUEEvaluator::~NNUEEvaluator() = default;
 
 bool NNUEEvaluator::loadNetwork(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
+    auto mapping = NetworkFile::Mapping::open(filename);
+    return mapping && loadNetwork(std::move(mapping));
+}
+
+bool NNUEEvaluator::loadNetwork(std::shared_ptr<const NetworkFile::Mapping> mapping) {
+    NetworkFile::Reader reader(mapping->bytes());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!reader.readHeader(magic, version) || magic != NetworkFile::MAGIC ||
+        (version != kPackedVersion && version != kAlignedVersion)) {
         return false;
     }
-
-    int32_t magic = 0;
-    int32_t version = 0;
-    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    file.read(reinterpret_cast<char*>(&version), sizeof(version));
-
-    if (magic != 0x4E4E5545 || version != 1) {
+    reader.setAligned(version == kAlignedVersion);
+
+    const auto* weights = reader.take<int16_t>(static_cast<std::size_t>(INPUT_DIMENSIONS) *
+                                               static_cast<std::size_t>(L1_SIZE));
+    const auto* biases = reader.take<int32_t>(L1_SIZE);
+    if (!weights || !biases || !loadLayer(reader, *hidden1, 2 * L1_SIZE, L2_SIZE) ||
+        !loadLayer(reader, *hidden2, L2_SIZE, L3_SIZE) ||
+        !loadLayer(reader, *outputLayer, L3_SIZE, OUTPUT_SIZE)) {
         return false;
     }
 
-    ftWeights.resize(static_cast<std::size_t>(INPUT_DIMENSIONS) *
-                     static_cast<std::size_t>(L1_SIZE));
-    const auto ftWeightsBytes = static_cast<std::streamsize>(ftWeights.size() * sizeof(int16_t));
-    file.read(reinterpret_cast<char*>(ftWeights.data()), ftWeightsBytes);
-    std::vector<int32_t> ftBiases32(L1_SIZE);
-    const auto ftBiasesBytes = static_cast<std::streamsize>(ftBiases32.size() * sizeof(int32_t));
-    file.read(reinterpret_cast<char*>(ftBiases32.data()), ftBiasesBytes);
     ftBiases.resize(L1_SIZE);
     for (int i = 0; i < L1_SIZE; ++i) {
-        ftBiases[i] = static_cast<int16_t>(std::clamp(ftBiases32[i], -32768, 32767));
-    }
-
-    {
-        std::vector<int16_t> w(static_cast<std::size_t>(2) * static_cast<std::size_t>(L1_SIZE) *
-                               static_cast<std::size_t>(L2_SIZE));
-        std::vector<int32_t> b(L2_SIZE);
-        const auto wBytes = static_cast<std::streamsize>(w.size() * sizeof(int16_t));
-        const auto bBytes = static_cast<std::streamsize>(b.size() * sizeof(int32_t));
-        file.read(reinterpret_cast<char*>(w.data()), wBytes);
-        file.read(reinterpret_cast<char*>(b.data()), bBytes);
-        hidden1->loadWeights(w.data(), b.data());
-    }
-
-    {
-        std::vector<int16_t> w(static_cast<std::size_t>(L2_SIZE) *
-                               static_cast<std::size_t>(L3_SIZE));
-        std::vector<int32_t> b(L3_SIZE);
-        const auto wBytes = static_cast<std::streamsize>(w.size() * sizeof(int16_t));
-        const auto bBytes = static_cast<std::streamsize>(b.size() * sizeof(int32_t));
-        file.read(reinterpret_cast<char*>(w.data()), wBytes);
-        file.read(reinterpret_cast<char*>(b.data()), bBytes);
-        hidden2->loadWeights(w.data(), b.data());
-    }
-
-    {
-        std::vector<int16_t> w(static_cast<std::size_t>(L3_SIZE) *
-                               static_cast<std::size_t>(OUTPUT_SIZE));
-        std::vector<int32_t> b(OUTPUT_SIZE);
-        const auto wBytes = static_cast<std::streamsize>(w.size() * sizeof(int16_t));
-        const auto bBytes = static_cast<std::streamsize>(b.size() * sizeof(int32_t));
-        file.read(reinterpret_cast<char*>(w.data()), wBytes);
-        file.read(reinterpret_cast<char*>(b.data()), bBytes);
-        outputLayer->loadWeights(w.data(), b.data());
-    }
-
-    if (!file) {
-        return false;
+        ftBiases[i] = static_cast<int16_t>(std::clamp(biases[i], -32768, 32767));
     }
-
-    accumulator[0].init(ftWeights.data(), ftBiases.data());
-    accumulator[1].init(ftWeights.data(), ftBiases.data());
-    return file.good();
+    ftWeights = weights;
+    network = std::move(mapping);
+    return true;
 }
 
-void NNUEEvaluator::transformFeatures(const Board& board, ChessPieceColor perspective,
-                                      int16_t* output) const {
-    (void)board;
-    const Accumulator& acc = accumulator[static_cast<int>(perspective)];
-
-    if (perspective == ChessPieceColor::WHITE) {
-        std::copy(acc.white.begin(), acc.white.end(), output);
-        std::copy(acc.black.begin(), acc.black.end(), output + L1_SIZE);
-    } else {
-        std::copy(acc.black.begin(), acc.black.end(), output);
-        std::copy(acc.white.begin(), acc.white.end(), output + L1_SIZE);
-    }
+void NNUEEvaluator::initAccumulator(Accumulator& acc) const {
+    acc.init(ftWeights, ftBiases.data());
 }
 
 int NNUEEvaluator::evaluate(const Board& board, ChessPieceColor sideToMove) const {
-    alignas(32) int16_t input[2 * L1_SIZE];
+    Accumulator acc;
+    initAccumulator(acc);
+    acc.refresh(board);
+    return evaluate(acc, sideToMove);
+}
+
+int NNUEEvaluator::evaluate(const Accumulator& acc, ChessPieceColor sideToMove) const {
     alignas(32) int32_t hidden1_out[L2_SIZE];
     alignas(32) int16_t hidden1_relu[L2_SIZE];
     alignas(32) int32_t hidden2_out[L3_SIZE];
     alignas(32) int16_t hidden2_relu[L3_SIZE];
     alignas(32) int32_t output[OUTPUT_SIZE];
-    transformFeatures(board, sideToMove, input);
-    hidden1->forward(input, hidden1_out);
+    const bool white = sideToMove == ChessPieceColor::WHITE;
+    hidden1->forwardConcat(white ? acc.white.data() : acc.black.data(),
+                           white ? acc.black.data() : acc.white.data(), hidden1_out);
     activation1->forward(hidden1_out, hidden1_relu);
     hidden2->forward(hidden1_relu, hidden2_out);
     activation2->forward(hidden2_out, hidden2_relu);
@@ -310,22 +600,49 @@ int NNUEEvaluator::evaluate(const Board& board, ChessPieceColor sideToMove) cons
     return output[0] / SCALE;
 }
 
-void NNUEEvaluator::updateAccumulator(const Board& board, int from, int to) {
-
-    const Piece& movingPiece = board.squares[to].piece;
-    if (movingPiece.PieceType != ChessPieceType::NONE) {
-        int feature = FeatureIndex::index(from, movingPiece.PieceType, movingPiece.PieceColor);
-        accumulator[0].removeFeature(feature);
-        accumulator[1].removeFeature(feature);
-        feature = FeatureIndex::index(to, movingPiece.PieceType, movingPiece.PieceColor);
-        accumulator[0].addFeature(feature);
-        accumulator[1].addFeature(feature);
+void NNUEEvaluator::evaluateBatch(std::span<const Board> boards, std::span<int> scores) const {
+    const std::size_t total = std::min(boards.size(), scores.size());
+    if (!ftWeights) {
+        std::fill_n(scores.begin(), total, 0);
+        return;
     }
-}
 
-void NNUEEvaluator::resetAccumulator(const Board& board) {
-    accumulator[0].refresh(board);
-    accumulator[1].refresh(board);
+    constexpr std::size_t kInputWidth = 2 * L1_SIZE;
+    std::vector<int16_t> inputs(kBatchBlock * kInputWidth);
+    std::vector<int32_t> hidden1Out(kBatchBlock * L2_SIZE);
+    std::vector<int16_t> hidden1Relu(kBatchBlock * L2_SIZE);
+    std::vector<int32_t> hidden2Out(kBatchBlock * L3_SIZE);
+    std::vector<int16_t> hidden2Relu(kBatchBlock * L3_SIZE);
+    std::vector<int32_t> output(kBatchBlock * OUTPUT_SIZE);
+    std::array<const int16_t*, kMaxActiveFeatures> rows{};
+
+    for (std::size_t begin = 0; begin < total; begin += kBatchBlock) {
+        const std::size_t count = std::min(kBatchBlock, total - begin);
+        // Features are not relative to a perspective, so both halves of an input are the same
+        // accumulator and it is built once.
+        for (std::size_t b = 0; b < count; ++b) {
+            int16_t* row = inputs.data() + (b * kInputWidth);
+            const int features = gatherFeatureRows(boards[begin + b], ftWeights, rows);
+            applyFeatures(row, ftBiases.data(), rows.data(), features, nullptr, 0);
+            std::copy_n(row, L1_SIZE, row + L1_SIZE);
+        }
+
+        const int n = static_cast<int>(count);
+        hidden1->forwardBatch(inputs.data(), n, hidden1Out.data());
+        for (std::size_t b = 0; b < count; ++b) {
+            activation1->forward(hidden1Out.data() + (b * L2_SIZE),
+                                 hidden1Relu.data() + (b * L2_SIZE));
+        }
+        hidden2->forwardBatch(hidden1Relu.data(), n, hidden2Out.data());
+        for (std::size_t b = 0; b < count; ++b) {
+            activation2->forward(hidden2Out.data() + (b * L3_SIZE),
+                                 hidden2Relu.data() + (b * L3_SIZE));
+        }
+        outputLayer->forwardBatch(hidden2Relu.data(), n, output.data());
+        for (std::size_t b = 0; b < count; ++b) {
+            scores[begin + b] = output[b * OUTPUT_SIZE] / SCALE;
+        }
+    }
 }
 
 bool init(const std::string& networkPath) {
@@ -337,6 +654,19 @@ bool init(const std::string& networkPath) {
     return true;
 }
 
+bool initEmbedded() {
+    if (NetworkFile::embeddedNetwork().empty()) {
+        return false;
+    }
+    auto mapping = NetworkFile::Mapping::wrap(NetworkFile::embeddedNetwork());
+    auto evaluator = std::make_unique<NNUEEvaluator>();
+    if (!mapping || !evaluator->loadNetwork(std::move(mapping))) {
+        return false;
+    }
+    globalEvaluator = std::move(evaluator);
+    return true;
+}
+
 int evaluate(const Board& board) {
     if (!globalEvaluator) {
         return 0;
@@ -346,4 +676,40 @@ int evaluate(const Board& board) {
     return globalEvaluator->evaluate(board, stm);
 }
 
+int evaluate(const Board& board, AccumulatorStack& stack) {
+    if (!globalEvaluator) {
+        return 0;
+    }
+
+    return globalEvaluator->evaluate(stack.current(board, *globalEvaluator), board.turn);
+}
+
+void evaluateBatch(std::span<const Board> boards, std::span<int> scores, int threads) {
+    const std::size_t total = std::min(boards.size(), scores.size());
+    if (!globalEvaluator) {
+        std::fill_n(scores.begin(), total, 0);
+        return;
+    }
+
+    const auto workerCount = static_cast<std::size_t>(getWorkerCount(total, threads));
+    if (workerCount <= 1) {
+        globalEvaluator->evaluateBatch(boards.first(total), scores.first(total));
+        return;
+    }
+
+    const std::size_t chunkSize = (total + workerCount - 1) / workerCount;
+    std::vector<std::future<void>> futures;
+    futures.reserve(workerCount);
+    for (std::size_t begin = 0; begin < total; begin += chunkSize) {
+        const std::size_t count = std::min(chunkSize, total - begin);
+        futures.emplace_back(std::async(std::launch::async, [boards, scores, begin, count]() {
+            globalEvaluator->evaluateBatch(boards.subspan(begin, count),
+                                           scores.subspan(begin, count));
+        }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 } // namespace NNUE
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "NetworkFile.h"
 #include "core/ChessBoard.h"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
@@ -37,6 +41,65 @@ struct Accumulator {
     void refresh(const Board& board);
     void addFeature(int feature);
     void removeFeature(int feature);
+    // Sets this accumulator to parent plus the added features minus the removed ones, applying
+    // every feature to one register tile before moving to the next.
+    void update(const Accumulator& parent, const int* added, int addedCount, const int* removed,
+                int removedCount);
+};
+
+inline constexpr int MAX_DIRTY_PIECES = 4;
+
+struct PieceChange {
+    int square = 0;
+    ChessPieceType type = ChessPieceType::NONE;
+    ChessPieceColor color = ChessPieceColor::WHITE;
+};
+
+// Pieces removed and added by one move. Castling, captures, promotions and en passant each touch
+// at most two squares on either side.
+struct DirtyPiece {
+    std::array<PieceChange, MAX_DIRTY_PIECES> removed{};
+    std::array<PieceChange, MAX_DIRTY_PIECES> added{};
+    int removedCount = 0;
+    int addedCount = 0;
+    bool overflow = false;
+
+    void remove(int square, const Piece& piece);
+    void add(int square, const Piece& piece);
+};
+
+class NNUEEvaluator;
+
+// Per-thread accumulators indexed by ply. push() only records the move's dirty pieces; the
+// accumulator is brought up to date from the nearest computed ancestor when a node is
+// evaluated, and refreshed from the board when no such ancestor exists.
+class AccumulatorStack {
+public:
+    AccumulatorStack();
+
+    void clear();
+    void push(const DirtyPiece& dirty);
+    void pop();
+    const Accumulator& current(const Board& board, const NNUEEvaluator& evaluator);
+
+    std::size_t ply() const {
+        return top;
+    }
+
+    std::uint64_t refreshes() const {
+        return refreshCount;
+    }
+
+private:
+    struct Entry {
+        Accumulator accumulator;
+        DirtyPiece dirty;
+        bool computed = false;
+    };
+
+    std::vector<Entry> entries;
+    std::size_t top = 0;
+    std::uint64_t refreshCount = 0;
 };
 
 class Layer {
@@ -55,6 +118,11 @@ private:
 public:
     LinearLayer(int in, int out);
     void forward(const void* input, void* output) const override;
+    // Same as forward() with the input split into two equal halves stored apart.
+    void forwardConcat(const int16_t* first, const int16_t* second, int32_t* output) const;
+    // Applies the layer to count inputs stored back to back; several inputs share each pass
+    // over a weight row.
+    void forwardBatch(const int16_t* input, int count, int32_t* output) const;
     void loadWeights(const int16_t* w, const int32_t* b);
 };
 
@@ -75,24 +143,31 @@ private:
     std::unique_ptr<ClippedReLU> activation2;
     std::unique_ptr<LinearLayer> hidden2;
     std::unique_ptr<LinearLayer> outputLayer;
-    std::vector<int16_t> ftWeights;
+    std::shared_ptr<const NetworkFile::Mapping> network;
+    const int16_t* ftWeights = nullptr;
     std::vector<int16_t> ftBiases;
-    mutable Accumulator accumulator[2];
-    void transformFeatures(const Board& board, ChessPieceColor perspective, int16_t* output) const;
 
 public:
     NNUEEvaluator();
     ~NNUEEvaluator();
     bool loadNetwork(const std::string& filename);
+    bool loadNetwork(std::shared_ptr<const NetworkFile::Mapping> mapping);
+    void initAccumulator(Accumulator& acc) const;
     int evaluate(const Board& board, ChessPieceColor sideToMove) const;
-    void updateAccumulator(const Board& board, int from, int to);
-    void resetAccumulator(const Board& board);
+    int evaluate(const Accumulator& acc, ChessPieceColor sideToMove) const;
+    // Scores each board from its side to move, as evaluate(board) would, a block at a time.
+    void evaluateBatch(std::span<const Board> boards, std::span<int> scores) const;
 };
 
 extern std::unique_ptr<NNUEEvaluator> globalEvaluator;
 
 bool init(const std::string& networkPath);
+bool initEmbedded();
 
 int evaluate(const Board& board);
+int evaluate(const Board& board, AccumulatorStack& stack);
+// Offline labelling: splits the boards across threads (0 picks a count from the batch size and
+// hardware) and writes one score per board.
+void evaluateBatch(std::span<const Board> boards, std::span<int> scores, int threads = 0);
 
 } // namespace NNUE
@@ -4,14 +4,14 @@
 #include "ChessPiece.h"
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <fstream>
-#include <ios>
 #include <memory>
 #include <string>
+#include <utility>
 
 #if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
 #define NNUEBITBOARD_X86_SIMD 1
@@ -103,11 +103,30 @@ constexpr int kNeonFeatureStride = 8;
 constexpr int kNeonDotProductStride = 16;
 constexpr int kNeonReluStride = 8;
 #endif
+constexpr int kAvx512InputMultiple = 64;
+constexpr int kSparseBlockBytes = 4;
+constexpr int kMaxSparseBlocks = COLOR_COUNT * L1_SIZE / kSparseBlockBytes;
+#if NNUEBITBOARD_X86_SIMD
+constexpr int kAvx2SparseBlocks = 8;
+constexpr int kAvx2SparseOutputs = 8;
+#ifdef __AVX512F__
+constexpr int kAvx512SparseBlocks = 16;
+#endif
+#ifdef __AVX512VNNI__
+constexpr int kAvx512SparseOutputs = 16;
+#endif
+#endif
+#if NNUEBITBOARD_ARM_NEON
+constexpr int kNeonSparseBlocks = 4;
+constexpr int kNeonSparseOutputs = 4;
+#endif
 constexpr int kActivationShiftBits = 6;
 constexpr int kMaxOutputActivation = 127;
 constexpr int kScoreScale = 100;
-constexpr uint32_t kNetworkMagic = 0x4E4E5545;
-constexpr uint32_t kNetworkVersion = 2;
+constexpr uint32_t kPackedVersion = 3;
+constexpr uint32_t kAlignedVersion = 4;
+constexpr int kNoKingSquare = 0;
+constexpr std::size_t kInitialStackDepth = 128;
 
 int32_t dotProductScalar(const int8_t* input, const int8_t* weights, int size) {
 #if NNUEBITBOARD_ARM_NEON
@@ -178,6 +197,107 @@ void applyClippedReluScalar(const int32_t* input, int8_t* output, int size) {
 #endif
 }
 #endif
+
+void addWeights(int16_t* acc, const int16_t* featureWeights) {
+#if NNUEBITBOARD_X86_SIMD
+    for (int i = NO_INDEX; i < L1_SIZE; i += kAvx2FeatureStride) {
+        __m256i acc_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i weight_vec =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(featureWeights + i));
+        __m256i sum = _mm256_add_epi16(acc_vec, weight_vec);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), sum);
+    }
+#elif NNUEBITBOARD_ARM_NEON
+    for (int i = NO_INDEX; i < L1_SIZE; i += kNeonFeatureStride) {
+        int16x8_t accVec = vld1q_s16(acc + static_cast<std::ptrdiff_t>(i));
+        int16x8_t weightVec = vld1q_s16(featureWeights + static_cast<std::ptrdiff_t>(i));
+        vst1q_s16(acc + static_cast<std::ptrdiff_t>(i), vaddq_s16(accVec, weightVec));
+    }
+#else
+    for (int i = NO_INDEX; i < L1_SIZE; ++i) {
+        acc[i] = static_cast<int16_t>(acc[i] + featureWeights[i]);
+    }
+#endif
+}
+
+void subWeights(int16_t* acc, const int16_t* featureWeights) {
+#if NNUEBITBOARD_X86_SIMD
+    for (int i = NO_INDEX; i < L1_SIZE; i += kAvx2FeatureStride) {
+        __m256i acc_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i weight_vec =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(featureWeights + i));
+        __m256i diff = _mm256_sub_epi16(acc_vec, weight_vec);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), diff);
+    }
+#elif NNUEBITBOARD_ARM_NEON
+    for (int i = NO_INDEX; i < L1_SIZE; i += kNeonFeatureStride) {
+        int16x8_t accVec = vld1q_s16(acc + static_cast<std::ptrdiff_t>(i));
+        int16x8_t weightVec = vld1q_s16(featureWeights + static_cast<std::ptrdiff_t>(i));
+        vst1q_s16(acc + static_cast<std::ptrdiff_t>(i), vsubq_s16(accVec, weightVec));
+    }
+#else
+    for (int i = NO_INDEX; i < L1_SIZE; ++i) {
+        acc[i] = static_cast<int16_t>(acc[i] - featureWeights[i]);
+    }
+#endif
+}
+
+const int16_t* featureRow(const int16_t* weights, int featureIdx) {
+    return weights +
+           (static_cast<std::ptrdiff_t>(featureIdx) * static_cast<std::ptrdiff_t>(L1_SIZE));
+}
+
+ChessPieceColor colorOf(int perspective) {
+    return perspective == WHITE_PERSPECTIVE ? ChessPieceColor::WHITE : ChessPieceColor::BLACK;
+}
+
+int kingSquareOf(const BitboardPosition& pos, int perspective) {
+    const Bitboard kingBB = pos.getPieceBitboard(ChessPieceType::KING, colorOf(perspective));
+    return kingBB ? std::countr_zero(kingBB) : kNoKingSquare;
+}
+
+int kingSquareOf(const Board& board, int perspective) {
+    const Bitboard kingBB = perspective == WHITE_PERSPECTIVE ? board.whiteKings : board.blackKings;
+    return kingBB ? std::countr_zero(kingBB) : kNoKingSquare;
+}
+
+int changeIndex(int perspective, int kingSquare, const NNUE::PieceChange& change) {
+    const int color =
+        change.color == ChessPieceColor::WHITE ? WHITE_PERSPECTIVE : BLACK_PERSPECTIVE;
+    return FeatureTransformer::featureIndex(perspective, kingSquare, change.square,
+                                            static_cast<int>(change.type), color);
+}
+
+// A king move that keeps the bucket and mirror state leaves every other feature index intact,
+// so only the king's own features change.
+bool needsRefresh(int perspective, const NNUE::DirtyPiece& dirty) {
+    if (dirty.overflow) {
+        return true;
+    }
+    const ChessPieceColor color = colorOf(perspective);
+    int from = -ONE;
+    int to = -ONE;
+    for (int i = NO_INDEX; i < dirty.removedCount; ++i) {
+        const NNUE::PieceChange& change = dirty.removed[static_cast<std::size_t>(i)];
+        if (change.type == ChessPieceType::KING && change.color == color) {
+            from = change.square;
+        }
+    }
+    for (int i = NO_INDEX; i < dirty.addedCount; ++i) {
+        const NNUE::PieceChange& change = dirty.added[static_cast<std::size_t>(i)];
+        if (change.type == ChessPieceType::KING && change.color == color) {
+            to = change.square;
+        }
+    }
+    if (from < NO_INDEX && to < NO_INDEX) {
+        return false;
+    }
+    if (from < NO_INDEX || to < NO_INDEX) {
+        return true;
+    }
+    return FeatureTransformer::refreshSlot(perspective, from) !=
+           FeatureTransformer::refreshSlot(perspective, to);
+}
 } // namespace
 
 #if NNUEBITBOARD_X86_SIMD
@@ -195,8 +315,9 @@ inline __m256i dpbusd_epi32(__m256i acc, __m256i a, __m256i b) {
 #else
     __m256i a_lo = _mm256_unpacklo_epi8(a, _mm256_setzero_si256());
     __m256i a_hi = _mm256_unpackhi_epi8(a, _mm256_setzero_si256());
-    __m256i b_lo = _mm256_unpacklo_epi8(b, _mm256_setzero_si256());
-    __m256i b_hi = _mm256_unpackhi_epi8(b, _mm256_setzero_si256());
+    __m256i b_sign = _mm256_cmpgt_epi8(_mm256_setzero_si256(), b);
+    __m256i b_lo = _mm256_unpacklo_epi8(b, b_sign);
+    __m256i b_hi = _mm256_unpackhi_epi8(b, b_sign);
     __m256i prod_lo = _mm256_madd_epi16(a_lo, b_lo);
     __m256i prod_hi = _mm256_madd_epi16(a_hi, b_hi);
     return _mm256_add_epi32(acc, _mm256_add_epi32(prod_lo, prod_hi));
@@ -277,94 +398,46 @@ bool hasArmI8MM() {
 #endif
 
 void Accumulator::refresh(const BitboardPosition& pos) {
-    reset();
-
-    for (int color = WHITE_PERSPECTIVE; color < COLOR_COUNT; ++color) {
-        ChessPieceColor c =
-            color == WHITE_PERSPECTIVE ? ChessPieceColor::WHITE : ChessPieceColor::BLACK;
+    refreshPerspective(pos, WHITE_PERSPECTIVE);
+    refreshPerspective(pos, BLACK_PERSPECTIVE);
+}
 
-        Bitboard kingBB = pos.getPieceBitboard(ChessPieceType::KING, c);
-        int kingSquare = std::countr_zero(kingBB);
-        int kingBucket = FeatureTransformer::getKingBucket(kingSquare);
+void Accumulator::refreshPerspective(const BitboardPosition& pos, int color) {
+    auto& acc = perspective[color];
+    if (biases) {
+        std::copy(biases, biases + L1_SIZE, acc.begin());
+    } else {
+        std::fill(acc.begin(), acc.end(), NO_INDEX);
+    }
 
+    const int kingSquare = kingSquareOf(pos, color);
+    for (int pieceColor = WHITE_PERSPECTIVE; pieceColor < COLOR_COUNT; ++pieceColor) {
         for (int pt = NO_INDEX; pt < FeatureTransformer::PIECE_TYPES; ++pt) {
-            auto pieceType = static_cast<ChessPieceType>(pt);
-            Bitboard pieceBB = pos.getPieceBitboard(pieceType, c);
-
+            Bitboard pieceBB =
+                pos.getPieceBitboard(static_cast<ChessPieceType>(pt), colorOf(pieceColor));
             while (pieceBB) {
-                int square = std::countr_zero(pieceBB);
-                int featureIdx = FeatureTransformer::makeIndex(square, pt, color, kingBucket);
-                addFeature(WHITE_PERSPECTIVE, featureIdx);
-                addFeature(BLACK_PERSPECTIVE, featureIdx);
+                const int square = std::countr_zero(pieceBB);
+                addFeature(color, FeatureTransformer::featureIndex(color, kingSquare, square, pt,
+                                                                   pieceColor));
                 pieceBB &= pieceBB - ONE;
             }
         }
     }
 
-    computed[WHITE_PERSPECTIVE] = computed[BLACK_PERSPECTIVE] = true;
+    computed[color] = true;
 }
 
 void Accumulator::addFeature(int color, int featureIdx) {
-    const auto* featureWeights =
-        weights + (static_cast<std::ptrdiff_t>(featureIdx) * static_cast<std::ptrdiff_t>(L1_SIZE));
-    auto* acc = perspective[color].data();
-
-#if NNUEBITBOARD_X86_SIMD
-    for (int i = NO_INDEX; i < L1_SIZE; i += kAvx2FeatureStride) {
-        __m256i acc_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
-        __m256i weight_vec =
-            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(featureWeights + i));
-        __m256i sum = _mm256_add_epi16(acc_vec, weight_vec);
-        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), sum);
-    }
-#elif NNUEBITBOARD_ARM_NEON
-    for (int i = NO_INDEX; i < L1_SIZE; i += kNeonFeatureStride) {
-        int16x8_t accVec = vld1q_s16(acc + static_cast<std::ptrdiff_t>(i));
-        int16x8_t weightVec = vld1q_s16(featureWeights + static_cast<std::ptrdiff_t>(i));
-        vst1q_s16(acc + static_cast<std::ptrdiff_t>(i), vaddq_s16(accVec, weightVec));
-    }
-#else
-    for (int i = NO_INDEX; i < L1_SIZE; ++i) {
-        acc[i] = static_cast<int16_t>(acc[i] + featureWeights[i]);
-    }
-#endif
-
-    computed[color] = false;
+    addWeights(perspective[color].data(), featureRow(weights, featureIdx));
 }
 
 void Accumulator::removeFeature(int color, int featureIdx) {
-    const auto* featureWeights =
-        weights + (static_cast<std::ptrdiff_t>(featureIdx) * static_cast<std::ptrdiff_t>(L1_SIZE));
-    auto* acc = perspective[color].data();
-
-#if NNUEBITBOARD_X86_SIMD
-    for (int i = NO_INDEX; i < L1_SIZE; i += kAvx2FeatureStride) {
-        __m256i acc_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
-        __m256i weight_vec =
-            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(featureWeights + i));
-        __m256i diff = _mm256_sub_epi16(acc_vec, weight_vec);
-        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), diff);
-    }
-#elif NNUEBITBOARD_ARM_NEON
-    for (int i = NO_INDEX; i < L1_SIZE; i += kNeonFeatureStride) {
-        int16x8_t accVec = vld1q_s16(acc + static_cast<std::ptrdiff_t>(i));
-        int16x8_t weightVec = vld1q_s16(featureWeights + static_cast<std::ptrdiff_t>(i));
-        vst1q_s16(acc + static_cast<std::ptrdiff_t>(i), vsubq_s16(accVec, weightVec));
-    }
-#else
-    for (int i = NO_INDEX; i < L1_SIZE; ++i) {
-        acc[i] = static_cast<int16_t>(acc[i] - featureWeights[i]);
-    }
-#endif
-
-    computed[color] = false;
+    subWeights(perspective[color].data(), featureRow(weights, featureIdx));
 }
 
 void Accumulator::moveFeature(int color, int fromIdx, int toIdx) {
-    const auto* fromWeights =
-        weights + (static_cast<std::ptrdiff_t>(fromIdx) * static_cast<std::ptrdiff_t>(L1_SIZE));
-    const auto* toWeights =
-        weights + (static_cast<std::ptrdiff_t>(toIdx) * static_cast<std::ptrdiff_t>(L1_SIZE));
+    const auto* fromWeights = featureRow(weights, fromIdx);
+    const auto* toWeights = featureRow(weights, toIdx);
     auto* acc = perspective[color].data();
 
 #if NNUEBITBOARD_X86_SIMD
@@ -390,8 +463,136 @@ void Accumulator::moveFeature(int color, int fromIdx, int toIdx) {
         acc[i] = static_cast<int16_t>((acc[i] - fromWeights[i]) + toWeights[i]);
     }
 #endif
+}
+
+RefreshCache::RefreshCache()
+    : entries(static_cast<std::size_t>(COLOR_COUNT) *
+              static_cast<std::size_t>(FeatureTransformer::REFRESH_SLOTS)) {}
+
+void RefreshCache::clear() {
+    for (Entry& entry : entries) {
+        entry.valid = false;
+    }
+    owner = nullptr;
+}
+
+void RefreshCache::refresh(Accumulator& acc, int perspective, const BitboardPosition& pos,
+                           const NNUEEvaluator& evaluator) {
+    if (owner != &evaluator) {
+        clear();
+        owner = &evaluator;
+    }
+
+    const int kingSquare = kingSquareOf(pos, perspective);
+    const auto slot = static_cast<std::size_t>(
+        (perspective * FeatureTransformer::REFRESH_SLOTS) +
+        FeatureTransformer::refreshSlot(perspective, kingSquare));
+    Entry& entry = entries[slot];
+    if (!entry.valid) {
+        std::copy(evaluator.biases(), evaluator.biases() + L1_SIZE, entry.accumulation.begin());
+        for (auto& colorPieces : entry.pieces) {
+            std::fill(std::begin(colorPieces), std::end(colorPieces), Bitboard{0});
+        }
+        entry.valid = true;
+    }
+
+    for (int pieceColor = WHITE_PERSPECTIVE; pieceColor < COLOR_COUNT; ++pieceColor) {
+        for (int pt = NO_INDEX; pt < FeatureTransformer::PIECE_TYPES; ++pt) {
+            const Bitboard current =
+                pos.getPieceBitboard(static_cast<ChessPieceType>(pt), colorOf(pieceColor));
+            Bitboard& cached = entry.pieces[pieceColor][pt];
+            Bitboard removed = cached & ~current;
+            Bitboard added = current & ~cached;
+            while (removed) {
+                const int square = std::countr_zero(removed);
+                subWeights(entry.accumulation.data(),
+                           featureRow(evaluator.weights(),
+                                      FeatureTransformer::featureIndex(perspective, kingSquare,
+                                                                       square, pt, pieceColor)));
+                removed &= removed - ONE;
+            }
+            while (added) {
+                const int square = std::countr_zero(added);
+                addWeights(entry.accumulation.data(),
+                           featureRow(evaluator.weights(),
+                                      FeatureTransformer::featureIndex(perspective, kingSquare,
+                                                                       square, pt, pieceColor)));
+                added &= added - ONE;
+            }
+            cached = current;
+        }
+    }
 
-    computed[color] = false;
+    std::copy(entry.accumulation.begin(), entry.accumulation.end(),
+              acc.getAccumulation(perspective));
+    acc.setComputed(perspective, true);
+}
+
+AccumulatorStack::AccumulatorStack() : entries(kInitialStackDepth) {}
+
+void AccumulatorStack::clear() {
+    top = 0;
+    entries[0].accumulator.reset();
+}
+
+void AccumulatorStack::push(const NNUE::DirtyPiece& dirty) {
+    if (++top == entries.size()) {
+        entries.emplace_back();
+    }
+    entries[top].dirty = dirty;
+    entries[top].accumulator.setComputed(WHITE_PERSPECTIVE, false);
+    entries[top].accumulator.setComputed(BLACK_PERSPECTIVE, false);
+}
+
+void AccumulatorStack::pop() {
+    if (top > 0) {
+        --top;
+    }
+}
+
+const Accumulator& AccumulatorStack::current(const Board& board, const NNUEEvaluator& evaluator,
+                                             RefreshCache& cache) {
+    Accumulator& result = entries[top].accumulator;
+    result.init(evaluator.weights(), evaluator.biases(), false);
+
+    for (int perspective = WHITE_PERSPECTIVE; perspective < COLOR_COUNT; ++perspective) {
+        if (result.isComputed(perspective)) {
+            continue;
+        }
+
+        std::size_t base = top;
+        while (!entries[base].accumulator.isComputed(perspective) && base > 0 &&
+               !needsRefresh(perspective, entries[base].dirty)) {
+            --base;
+        }
+
+        if (!entries[base].accumulator.isComputed(perspective)) {
+            cache.refresh(result, perspective, BitboardPosition::fromBoard(board), evaluator);
+            ++refreshCount;
+            continue;
+        }
+
+        const int kingSquare = kingSquareOf(board, perspective);
+        for (std::size_t i = base + 1; i <= top; ++i) {
+            Accumulator& acc = entries[i].accumulator;
+            const NNUE::DirtyPiece& dirty = entries[i].dirty;
+            acc.init(evaluator.weights(), evaluator.biases(), false);
+            std::copy(entries[i - 1].accumulator.getAccumulation(perspective),
+                      entries[i - 1].accumulator.getAccumulation(perspective) + L1_SIZE,
+                      acc.getAccumulation(perspective));
+            for (int j = NO_INDEX; j < dirty.removedCount; ++j) {
+                acc.removeFeature(perspective,
+                                  changeIndex(perspective, kingSquare,
+                                              dirty.removed[static_cast<std::size_t>(j)]));
+            }
+            for (int j = NO_INDEX; j < dirty.addedCount; ++j) {
+                acc.addFeature(perspective, changeIndex(perspective, kingSquare,
+                                                        dirty.added[static_cast<std::size_t>(j)]));
+            }
+            acc.setComputed(perspective, true);
+        }
+    }
+    return result;
 }
 
 LinearLayer::SIMDType LinearLayer::detectSIMD() {
@@ -422,9 +623,16 @@ LinearLayer::SIMDType LinearLayer::detectSIMD() {
 #endif
 }
 
-LinearLayer::LinearLayer(int in, int out)
+LinearLayer::LinearLayer(int in, int out, bool sparse)
     : inputSize(in), outputSize(out), weights(static_cast<size_t>(in) * static_cast<size_t>(out)),
-      biases(out), dotprodBiasAdjust(out), simdType(detectSIMD()) {}
+      biases(out), dotprodBiasAdjust(out), simdType(detectSIMD()),
+      sparseInput(sparse && in % kSparseBlockBytes == 0 &&
+                  in / kSparseBlockBytes <= kMaxSparseBlocks) {
+    // The 512-bit kernels consume 64 inputs per step; narrower layers use the 256-bit path.
+    if ((simdType == AVX512 || simdType == AVX512_VNNI) && in % kAvx512InputMultiple != 0) {
+        simdType = AVX2;
+    }
+}
 
 void LinearLayer::loadWeights(const int8_t* w, const int32_t* b) {
     std::copy(w, w + weights.size(), weights.begin());
@@ -441,6 +649,199 @@ void LinearLayer::loadWeights(const int8_t* w, const int32_t* b) {
         }
         dotprodBiasAdjust[static_cast<std::size_t>(i)] = 128 * weightSum;
     }
+
+    if (!sparseInput) {
+        return;
+    }
+    sparseWeights.resize(weights.size());
+    const int blockCount = inputSize / kSparseBlockBytes;
+    for (int block = NO_INDEX; block < blockCount; ++block) {
+        for (int o = NO_INDEX; o < outputSize; ++o) {
+            for (int j = NO_INDEX; j < kSparseBlockBytes; ++j) {
+                const auto dst = static_cast<std::size_t>(
+                    (((block * outputSize) + o) * kSparseBlockBytes) + j);
+                const auto src =
+                    static_cast<std::size_t>((o * inputSize) + (block * kSparseBlockBytes) + j);
+                sparseWeights[dst] = weights[src];
+            }
+        }
+    }
+}
+
+int LinearLayer::findNonZeroBlocks(const int8_t* input, uint16_t* blocks) const {
+    const int blockCount = inputSize / kSparseBlockBytes;
+    int count = NO_INDEX;
+    int k = NO_INDEX;
+#if NNUEBITBOARD_X86_SIMD
+#ifdef __AVX512F__
+    if (simdType == AVX512 || simdType == AVX512_VNNI) {
+        for (; k + kAvx512SparseBlocks <= blockCount; k += kAvx512SparseBlocks) {
+            const __m512i values = _mm512_loadu_si512(input + (k * kSparseBlockBytes));
+            auto mask = static_cast<unsigned int>(_mm512_test_epi32_mask(values, values));
+            while (mask) {
+                blocks[count++] = static_cast<uint16_t>(k + std::countr_zero(mask));
+                mask &= mask - ONE;
+            }
+        }
+    }
+#endif
+    const __m256i zero = _mm256_setzero_si256();
+    for (; k + kAvx2SparseBlocks <= blockCount; k += kAvx2SparseBlocks) {
+        const __m256i values = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(input + (k * kSparseBlockBytes)));
+        const __m256 zeroLanes = _mm256_castsi256_ps(_mm256_cmpeq_epi32(values, zero));
+        auto mask = static_cast<unsigned int>(~_mm256_movemask_ps(zeroLanes)) & 0xFFU;
+        while (mask) {
+            blocks[count++] = static_cast<uint16_t>(k + std::countr_zero(mask));
+            mask &= mask - ONE;
+        }
+    }
+#elif NNUEBITBOARD_ARM_NEON
+    for (; k + kNeonSparseBlocks <= blockCount; k += kNeonSparseBlocks) {
+        const uint32x4_t values = vld1q_u32(
+            reinterpret_cast<const uint32_t*>(input + static_cast<std::ptrdiff_t>(k * 4)));
+        const uint16x4_t nonZero = vmovn_u32(vtstq_u32(values, values));
+        const uint64_t lanes = vget_lane_u64(vreinterpret_u64_u16(nonZero), 0);
+        for (int lane = NO_INDEX; lane < kNeonSparseBlocks; ++lane) {
+            if ((lanes >> (16 * lane)) & 1U) {
+                blocks[count++] = static_cast<uint16_t>(k + lane);
+            }
+        }
+    }
+#endif
+    for (; k < blockCount; ++k) {
+        uint32_t word = 0;
+        std::memcpy(&word, input + (k * kSparseBlockBytes), sizeof(word));
+        if (word != 0) {
+            blocks[count++] = static_cast<uint16_t>(k);
+        }
+    }
+    return count;
+}
+
+void LinearLayer::forward_sparse_scalar(const int8_t* input, const uint16_t* blocks, int count,
+                                        int32_t* output) const {
+    std::copy(biases.begin(), biases.end(), output);
+    for (int i = NO_INDEX; i < count; ++i) {
+        const int block = blocks[i];
+        const int8_t* in = input + (block * kSparseBlockBytes);
+        const int8_t* column =
+            sparseWeights.data() + (static_cast<std::ptrdiff_t>(block) * outputSize *
+                                    static_cast<std::ptrdiff_t>(kSparseBlockBytes));
+        for (int o = NO_INDEX; o < outputSize; ++o) {
+            int32_t sum = 0;
+            for (int j = NO_INDEX; j < kSparseBlockBytes; ++j) {
+                sum += static_cast<int32_t>(static_cast<uint8_t>(in[j])) *
+                       static_cast<int32_t>(column[(o * kSparseBlockBytes) + j]);
+            }
+            output[o] += sum;
+        }
+    }
+}
+
+void LinearLayer::forward_sparse_avx2(const int8_t* input, const uint16_t* blocks, int count,
+                                      int32_t* output) const {
+#if NNUEBITBOARD_X86_SIMD
+    if (outputSize % kAvx2SparseOutputs != 0) {
+        forward_sparse_scalar(input, blocks, count, output);
+        return;
+    }
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (int g = NO_INDEX; g < outputSize; g += kAvx2SparseOutputs) {
+        __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(biases.data() + g));
+        for (int i = NO_INDEX; i < count; ++i) {
+            const int block = blocks[i];
+            int32_t word = 0;
+            std::memcpy(&word, input + (block * kSparseBlockBytes), sizeof(word));
+            const __m256i in = _mm256_set1_epi32(word);
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                sparseWeights.data() + (((block * outputSize) + g) * kSparseBlockBytes)));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + g), acc);
+    }
+#else
+    forward_sparse_scalar(input, blocks, count, output);
+#endif
+}
+
+void LinearLayer::forward_sparse_avx512_vnni(const int8_t* input, const uint16_t* blocks,
+                                             int count, int32_t* output) const {
+#ifdef __AVX512VNNI__
+    if (outputSize % kAvx512SparseOutputs != 0) {
+        forward_sparse_avx2(input, blocks, count, output);
+        return;
+    }
+    for (int g = NO_INDEX; g < outputSize; g += kAvx512SparseOutputs) {
+        __m512i acc = _mm512_loadu_si512(biases.data() + g);
+        for (int i = NO_INDEX; i < count; ++i) {
+            const int block = blocks[i];
+            int32_t word = 0;
+            std::memcpy(&word, input + (block * kSparseBlockBytes), sizeof(word));
+            const __m512i w = _mm512_loadu_si512(
+                sparseWeights.data() + (((block * outputSize) + g) * kSparseBlockBytes));
+            acc = _mm512_dpbusd_epi32(acc, _mm512_set1_epi32(word), w);
+        }
+        _mm512_storeu_si512(output + g, acc);
+    }
+#else
+    forward_sparse_avx2(input, blocks, count, output);
+#endif
+}
+
+void LinearLayer::forward_sparse_neon(const int8_t* input, const uint16_t* blocks, int count,
+                                      int32_t* output) const {
+#if NNUEBITBOARD_ARM_NEON
+    if (outputSize % kNeonSparseOutputs != 0) {
+        forward_sparse_scalar(input, blocks, count, output);
+        return;
+    }
+    for (int g = NO_INDEX; g < outputSize; g += kNeonSparseOutputs) {
+        int32x4_t acc = vld1q_s32(biases.data() + static_cast<std::ptrdiff_t>(g));
+        for (int i = NO_INDEX; i < count; ++i) {
+            const int block = blocks[i];
+            uint32_t word = 0;
+            std::memcpy(&word, input + static_cast<std::ptrdiff_t>(block * 4), sizeof(word));
+            const uint8x16_t inBytes = vreinterpretq_u8_u32(vdupq_n_u32(word));
+            const int16x8_t in16 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(inBytes)));
+            const int8x16_t w = vld1q_s8(sparseWeights.data() +
+                                         static_cast<std::ptrdiff_t>(((block * outputSize) + g) *
+                                                                     kSparseBlockBytes));
+            const int16x8_t wLo = vmovl_s8(vget_low_s8(w));
+            const int16x8_t wHi = vmovl_s8(vget_high_s8(w));
+            const int32x4_t p0 = vmull_s16(vget_low_s16(in16), vget_low_s16(wLo));
+            const int32x4_t p1 = vmull_s16(vget_high_s16(in16), vget_high_s16(wLo));
+            const int32x4_t p2 = vmull_s16(vget_low_s16(in16), vget_low_s16(wHi));
+            const int32x4_t p3 = vmull_s16(vget_high_s16(in16), vget_high_s16(wHi));
+            acc = vaddq_s32(acc, vpaddq_s32(vpaddq_s32(p0, p1), vpaddq_s32(p2, p3)));
+        }
+        vst1q_s32(output + static_cast<std::ptrdiff_t>(g), acc);
+    }
+#else
+    forward_sparse_scalar(input, blocks, count, output);
+#endif
+}
+
+void LinearLayer::forward_sparse(const int8_t* input, int32_t* output) const {
+    std::array<uint16_t, kMaxSparseBlocks> blocks{};
+    const int count = findNonZeroBlocks(input, blocks.data());
+
+    switch (simdType) {
+        case ARM_I8MM:
+        case ARM_DOTPROD:
+        case ARM_NEON:
+            forward_sparse_neon(input, blocks.data(), count, output);
+            break;
+        case SCALAR:
+            forward_sparse_scalar(input, blocks.data(), count, output);
+            break;
+        case AVX512_VNNI:
+            forward_sparse_avx512_vnni(input, blocks.data(), count, output);
+            break;
+        default:
+            forward_sparse_avx2(input, blocks.data(), count, output);
+            break;
+    }
 }
 
 void LinearLayer::forward_arm_neon(const int8_t* input, int32_t* output) const {
@@ -544,12 +945,13 @@ void LinearLayer::forward_avx512(const int8_t* input, int32_t* output) const {
                         (static_cast<std::ptrdiff_t>(i) * static_cast<std::ptrdiff_t>(inputSize));
 
         for (int j = NO_INDEX; j < inputSize; j += kAvx512DotProductStride) {
-            __m512i in_vec = _mm512_load_si512((__m512i*)(input + j));
-            __m512i w_vec = _mm512_load_si512((__m512i*)(w + j));
+            __m512i in_vec = _mm512_loadu_si512(input + j);
+            __m512i w_vec = _mm512_loadu_si512(w + j);
+            __m512i w_sign = _mm512_movm_epi8(_mm512_movepi8_mask(w_vec));
             __m512i in_lo = _mm512_unpacklo_epi8(in_vec, _mm512_setzero_si512());
             __m512i in_hi = _mm512_unpackhi_epi8(in_vec, _mm512_setzero_si512());
-            __m512i w_lo = _mm512_unpacklo_epi8(w_vec, _mm512_setzero_si512());
-            __m512i w_hi = _mm512_unpackhi_epi8(w_vec, _mm512_setzero_si512());
+            __m512i w_lo = _mm512_unpacklo_epi8(w_vec, w_sign);
+            __m512i w_hi = _mm512_unpackhi_epi8(w_vec, w_sign);
             sum = _mm512_add_epi32(sum, _mm512_madd_epi16(in_lo, w_lo));
             sum = _mm512_add_epi32(sum, _mm512_madd_epi16(in_hi, w_hi));
         }
@@ -569,8 +971,8 @@ void LinearLayer::forward_avx512_vnni(const int8_t* input, int32_t* output) cons
                         (static_cast<std::ptrdiff_t>(i) * static_cast<std::ptrdiff_t>(inputSize));
 
         for (int j = NO_INDEX; j < inputSize; j += kAvx512DotProductStride) {
-            __m512i in_vec = _mm512_load_si512((__m512i*)(input + j));
-            __m512i w_vec = _mm512_load_si512((__m512i*)(w + j));
+            __m512i in_vec = _mm512_loadu_si512(input + j);
+            __m512i w_vec = _mm512_loadu_si512(w + j);
             sum = _mm512_dpbusd_epi32(sum, in_vec, w_vec);
         }
 
@@ -585,6 +987,11 @@ void LinearLayer::forward(const void* input, void* output) const {
     const auto* in = static_cast<const int8_t*>(input);
     auto* out = static_cast<int32_t*>(output);
 
+    if (sparseInput) {
+        forward_sparse(in, out);
+        return;
+    }
+
     switch (simdType) {
         case ARM_I8MM:
             forward_arm_i8mm(in, out);
@@ -661,55 +1068,81 @@ void ClippedReLU::forward(const void* input, void* output) const {
 }
 
 NNUEEvaluator::NNUEEvaluator() {
-    fc1 = std::make_unique<LinearLayer>(COLOR_COUNT * L1_SIZE, L2_SIZE);
+    fc1 = std::make_unique<LinearLayer>(COLOR_COUNT * L1_SIZE, L2_SIZE, true);
     ac1 = std::make_unique<ClippedReLU>(L2_SIZE);
     fc2 = std::make_unique<LinearLayer>(L2_SIZE, L3_SIZE);
     ac2 = std::make_unique<ClippedReLU>(L3_SIZE);
     fc3 = std::make_unique<LinearLayer>(L3_SIZE, L3_SIZE);
     fc4 = std::make_unique<LinearLayer>(L3_SIZE, OUTPUT_SIZE);
-    featureWeights.resize(static_cast<size_t>(INPUT_DIMENSIONS) * static_cast<size_t>(L1_SIZE));
+    featureBiases.resize(static_cast<size_t>(L1_SIZE));
 }
 
-bool NNUEEvaluator::loadNetwork(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
+namespace {
+bool readLayer(NetworkFile::Reader& reader, LinearLayer& layer, int in, int out) {
+    const auto* weights =
+        reader.take<int8_t>(static_cast<std::size_t>(in) * static_cast<std::size_t>(out));
+    const auto* biases = reader.take<int32_t>(static_cast<std::size_t>(out));
+    if (!weights || !biases) {
         return false;
     }
+    layer.loadWeights(weights, biases);
+    return true;
+}
+} // namespace
 
+bool NNUEEvaluator::loadNetwork(const std::string& filename) {
+    auto mapping = NetworkFile::Mapping::open(filename);
+    return mapping && loadNetwork(std::move(mapping));
+}
+
+bool NNUEEvaluator::loadNetwork(std::shared_ptr<const NetworkFile::Mapping> mapping) {
+    NetworkFile::Reader reader(mapping->bytes());
     uint32_t magic = kCpuidBaseLeaf;
     uint32_t version = kCpuidBaseLeaf;
-    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    file.read(reinterpret_cast<char*>(&version), sizeof(version));
-
-    if (magic != kNetworkMagic || version != kNetworkVersion) {
+    if (!reader.readHeader(magic, version) || magic != NetworkFile::MAGIC ||
+        (version != kPackedVersion && version != kAlignedVersion)) {
+        return false;
+    }
+    reader.setAligned(version == kAlignedVersion);
+
+    const auto* weights = reader.take<int16_t>(static_cast<std::size_t>(INPUT_DIMENSIONS) *
+                                               static_cast<std::size_t>(L1_SIZE));
+    const auto* biases = reader.take<int16_t>(L1_SIZE);
+    if (!weights || !biases || !readLayer(reader, *fc1, COLOR_COUNT * L1_SIZE, L2_SIZE) ||
+        !readLayer(reader, *fc2, L2_SIZE, L3_SIZE) || !readLayer(reader, *fc3, L3_SIZE, L3_SIZE) ||
+        !readLayer(reader, *fc4, L3_SIZE, OUTPUT_SIZE)) {
         return false;
     }
 
-    file.read(reinterpret_cast<char*>(featureWeights.data()),
-              static_cast<std::streamsize>(featureWeights.size() * sizeof(int16_t)));
-
-    accumulator.init(featureWeights.data());
+    featureWeights = weights;
+    std::copy(biases, biases + L1_SIZE, featureBiases.begin());
+    network = std::move(mapping);
     return true;
 }
 
-void NNUEEvaluator::transformInput(const BitboardPosition& pos, int8_t* output) const {
-    const int perspective =
-        pos.getSideToMove() == ChessPieceColor::WHITE ? WHITE_PERSPECTIVE : BLACK_PERSPECTIVE;
-
-    if (!accumulator.isComputed(perspective)) {
-        accumulator.refresh(pos);
-    }
-
-    const auto* acc = accumulator.getAccumulation(perspective);
-
-    for (int i = NO_INDEX; i < COLOR_COUNT * L1_SIZE; ++i) {
-        int32_t val = acc[i];
-        val = std::max(NO_INDEX, std::min(QA, val));
-        output[i] = static_cast<int8_t>(val >> kActivationShiftBits);
+void NNUEEvaluator::transformInput(const Accumulator& acc, ChessPieceColor sideToMove,
+                                   int8_t* output) {
+    const int us = sideToMove == ChessPieceColor::WHITE ? WHITE_PERSPECTIVE : BLACK_PERSPECTIVE;
+    const int perspectives[COLOR_COUNT] = {us, ONE - us};
+
+    for (int half = NO_INDEX; half < COLOR_COUNT; ++half) {
+        const auto* values = acc.getAccumulation(perspectives[half]);
+        int8_t* out = output + (static_cast<std::ptrdiff_t>(half) * L1_SIZE);
+        for (int i = NO_INDEX; i < L1_SIZE; ++i) {
+            const int32_t val = std::clamp(static_cast<int32_t>(values[i]), NO_INDEX, QA);
+            out[i] = static_cast<int8_t>(val >> kActivationShiftBits);
+        }
     }
 }
 
 int NNUEEvaluator::evaluate(const BitboardPosition& pos) const {
+    Accumulator acc;
+    acc.init(featureWeights, featureBiases.data());
+    acc.refresh(pos);
+    return evaluate(acc, pos.getSideToMove());
+}
+
+int NNUEEvaluator::evaluate(const Accumulator& acc, ChessPieceColor sideToMove) const {
     alignas(SIMD_ALIGN) int8_t input[COLOR_COUNT * L1_SIZE];
     alignas(SIMD_ALIGN) int32_t hidden1[L2_SIZE];
     alignas(SIMD_ALIGN) int8_t hidden1_relu[L2_SIZE];
@@ -718,7 +1151,7 @@ int NNUEEvaluator::evaluate(const BitboardPosition& pos) const {
     alignas(SIMD_ALIGN) int32_t hidden3[L3_SIZE];
     alignas(SIMD_ALIGN) int8_t hidden3_relu[L3_SIZE];
     alignas(SIMD_ALIGN) int32_t output[OUTPUT_SIZE];
-    transformInput(pos, input);
+    transformInput(acc, sideToMove, input);
     fc1->forward(input, hidden1);
     ac1->forward(hidden1, hidden1_relu);
     fc2->forward(hidden1_relu, hidden2);
@@ -734,47 +1167,6 @@ int NNUEEvaluator::evaluate(const BitboardPosition& pos) const {
     return output[NO_INDEX] * kScoreScale / QAB;
 }
 
-void NNUEEvaluator::updateBeforeMove(const BitboardPosition& pos, int from, int to,
-                                     ChessPieceType piece, ChessPieceType captured) {
-
-    const int color =
-        pos.getColorAt(from) == ChessPieceColor::WHITE ? WHITE_PERSPECTIVE : BLACK_PERSPECTIVE;
-    int kingSquare = std::countr_zero(pos.getPieceBitboard(
-        ChessPieceType::KING,
-        color == WHITE_PERSPECTIVE ? ChessPieceColor::WHITE : ChessPieceColor::BLACK));
-    int kingBucket = FeatureTransformer::getKingBucket(kingSquare);
-
-    int fromFeature = FeatureTransformer::makeIndex(
-        from, static_cast<int>(piece) - PIECE_TYPE_OFFSET, color, kingBucket);
-    accumulator.removeFeature(WHITE_PERSPECTIVE, fromFeature);
-    accumulator.removeFeature(BLACK_PERSPECTIVE, fromFeature);
-
-    if (captured != ChessPieceType::NONE) {
-        int capturedColor = ONE - color;
-        int capturedFeature = FeatureTransformer::makeIndex(
-            to, static_cast<int>(captured) - PIECE_TYPE_OFFSET, capturedColor, kingBucket);
-        accumulator.removeFeature(WHITE_PERSPECTIVE, capturedFeature);
-        accumulator.removeFeature(BLACK_PERSPECTIVE, capturedFeature);
-    }
-}
-
-void NNUEEvaluator::updateAfterMove(const BitboardPosition& pos, int from, int to,
-                                    ChessPieceType piece, ChessPieceType promotion) {
-    (void)from;
-
-    const int color =
-        pos.getColorAt(to) == ChessPieceColor::WHITE ? WHITE_PERSPECTIVE : BLACK_PERSPECTIVE;
-    int kingSquare = std::countr_zero(pos.getPieceBitboard(
-        ChessPieceType::KING,
-        color == WHITE_PERSPECTIVE ? ChessPieceColor::WHITE : ChessPieceColor::BLACK));
-    int kingBucket = FeatureTransformer::getKingBucket(kingSquare);
-    ChessPieceType finalPiece = promotion != ChessPieceType::NONE ? promotion : piece;
-    int toFeature = FeatureTransformer::makeIndex(
-        to, static_cast<int>(finalPiece) - PIECE_TYPE_OFFSET, color, kingBucket);
-    accumulator.addFeature(WHITE_PERSPECTIVE, toFeature);
-    accumulator.addFeature(BLACK_PERSPECTIVE, toFeature);
-}
-
 bool init(const std::string& networkPath) {
     globalEvaluator = std::make_unique<NNUEEvaluator>();
     if (!globalEvaluator->loadNetwork(networkPath)) {
@@ -784,6 +1176,19 @@ bool init(const std::string& networkPath) {
     return true;
 }
 
+bool initEmbedded() {
+    if (NetworkFile::embeddedNetwork().empty()) {
+        return false;
+    }
+    auto mapping = NetworkFile::Mapping::wrap(NetworkFile::embeddedNetwork());
+    auto evaluator = std::make_unique<NNUEEvaluator>();
+    if (!mapping || !evaluator->loadNetwork(std::move(mapping))) {
+        return false;
+    }
+    globalEvaluator = std::move(evaluator);
+    return true;
+}
+
 int evaluate(const BitboardPosition& pos) {
     if (!globalEvaluator) {
         return NO_INDEX;
@@ -798,4 +1203,11 @@ int evaluate(const Board& board) {
     return globalEvaluator->evaluate(board);
 }
 
+int evaluate(const Board& board, AccumulatorStack& stack, RefreshCache& cache) {
+    if (!globalEvaluator) {
+        return NO_INDEX;
+    }
+    return globalEvaluator->evaluate(stack.current(board, *globalEvaluator, cache), board.turn);
+}
+
 } // namespace NNUEBitboard
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "NNUE.h"
+#include "NetworkFile.h"
 #include "core/BitboardOnly.h"
 #include "core/ChessBoard.h"
 
@@ -13,7 +15,9 @@
 
 namespace NNUEBitboard {
 
-constexpr int INPUT_DIMENSIONS = 768;
+constexpr int KING_BUCKETS = 32;
+constexpr int FEATURES_PER_BUCKET = 768;
+constexpr int INPUT_DIMENSIONS = FEATURES_PER_BUCKET * KING_BUCKETS;
 constexpr int L1_SIZE = 256;
 constexpr int L2_SIZE = 32;
 constexpr int L3_SIZE = 32;
@@ -23,7 +27,6 @@ constexpr int WHITE_PERSPECTIVE = 0;
 constexpr int BLACK_PERSPECTIVE = 1;
 constexpr int NO_INDEX = 0;
 constexpr int ONE = 1;
-constexpr int PIECE_TYPE_OFFSET = 1;
 
 constexpr int QA = 255;
 constexpr int QB = 64;
@@ -31,8 +34,11 @@ constexpr int QAB = QA * QB;
 
 constexpr size_t SIMD_ALIGN = 64;
 
+// Features are relative to each perspective: the board is flipped vertically for black and
+// mirrored horizontally when that side's king stands on files e-h, so a king bucket plus the
+// mirror flag determines every feature index.
 struct FeatureTransformer {
-    static constexpr int KING_BUCKETS = 32;
+    static constexpr int KING_BUCKETS = NNUEBitboard::KING_BUCKETS;
     static constexpr int SQUARES_PER_PIECE = 64;
     static constexpr int PIECE_TYPES = 6;
     static constexpr int FILE_MASK = 7;
@@ -40,6 +46,9 @@ struct FeatureTransformer {
     static constexpr int MIRROR_FILE_THRESHOLD = 4;
     static constexpr int MIRROR_FILE_BASE = 7;
     static constexpr int FILE_BUCKET_COUNT = 4;
+    static constexpr int RANK_FLIP = 56;
+    static constexpr int MIRROR_STATES = 2;
+    static constexpr int REFRESH_SLOTS = KING_BUCKETS * MIRROR_STATES;
 
     static int getKingBucket(int kingSquare) {
         int file = kingSquare & FILE_MASK;
@@ -58,6 +67,27 @@ struct FeatureTransformer {
         return square + (SQUARES_PER_PIECE * piece) + (kSquaresPerColor * color) +
                (kSquaresPerKingBucket * kingBucket);
     }
+
+    static int perspectiveSquare(int perspective, int square) {
+        return perspective == WHITE_PERSPECTIVE ? square : (square ^ RANK_FLIP);
+    }
+
+    static bool isMirrored(int perspective, int kingSquare) {
+        return (perspectiveSquare(perspective, kingSquare) & FILE_MASK) >= MIRROR_FILE_THRESHOLD;
+    }
+
+    static int refreshSlot(int perspective, int kingSquare) {
+        return (getKingBucket(perspectiveSquare(perspective, kingSquare)) * MIRROR_STATES) +
+               (isMirrored(perspective, kingSquare) ? ONE : NO_INDEX);
+    }
+
+    static int featureIndex(int perspective, int kingSquare, int square, int piece, int color) {
+        const int mirror = isMirrored(perspective, kingSquare) ? MIRROR_FILE_BASE : NO_INDEX;
+        const int oriented = perspectiveSquare(perspective, square) ^ mirror;
+        const int relativeColor = color == perspective ? NO_INDEX : ONE;
+        return makeIndex(oriented, piece, relativeColor,
+                         getKingBucket(perspectiveSquare(perspective, kingSquare)));
+    }
 };
 
 class alignas(SIMD_ALIGN) Accumulator {
@@ -65,11 +95,16 @@ private:
     alignas(SIMD_ALIGN) std::array<int16_t, L1_SIZE> perspective[COLOR_COUNT];
     bool computed[COLOR_COUNT] = {false, false};
     const int16_t* weights = nullptr;
+    const int16_t* biases = nullptr;
 
 public:
-    void init(const int16_t* featureWeights) {
+    void init(const int16_t* featureWeights, const int16_t* featureBiases = nullptr,
+              bool clearValues = true) {
         weights = featureWeights;
-        reset();
+        biases = featureBiases;
+        if (clearValues) {
+            reset();
+        }
     }
 
     void reset() {
@@ -81,6 +116,7 @@ public:
     }
 
     void refresh(const BitboardPosition& pos);
+    void refreshPerspective(const BitboardPosition& pos, int color);
     void addFeature(int color, int featureIdx);
     void removeFeature(int color, int featureIdx);
     void moveFeature(int color, int fromIdx, int toIdx);
@@ -89,9 +125,73 @@ public:
         return this->perspective[perspective].data();
     }
 
+    int16_t* getAccumulation(int perspective) {
+        return this->perspective[perspective].data();
+    }
+
     bool isComputed(int perspective) const {
         return computed[perspective];
     }
+
+    void setComputed(int perspective, bool value) {
+        computed[perspective] = value;
+    }
+};
+
+// Finny table: for every (perspective, king bucket, mirror) the accumulator and piece bitboards
+// it was last built from. Refreshing after a king move applies only the difference between that
+// snapshot and the current position.
+class NNUEEvaluator;
+
+class RefreshCache {
+public:
+    RefreshCache();
+
+    void clear();
+    void refresh(Accumulator& acc, int perspective, const BitboardPosition& pos,
+                 const NNUEEvaluator& evaluator);
+
+private:
+    struct Entry {
+        alignas(SIMD_ALIGN) std::array<int16_t, L1_SIZE> accumulation{};
+        Bitboard pieces[COLOR_COUNT][FeatureTransformer::PIECE_TYPES]{};
+        bool valid = false;
+    };
+
+    std::vector<Entry> entries;
+    const NNUEEvaluator* owner = nullptr;
+};
+
+// Per-thread accumulators indexed by ply, updated lazily and per perspective from the moves'
+// dirty pieces. A perspective whose king changes bucket or mirror state is rebuilt through the
+// refresh cache instead of from scratch.
+class AccumulatorStack {
+public:
+    AccumulatorStack();
+
+    void clear();
+    void push(const NNUE::DirtyPiece& dirty);
+    void pop();
+    const Accumulator& current(const Board& board, const NNUEEvaluator& evaluator,
+                               RefreshCache& cache);
+
+    std::size_t ply() const {
+        return top;
+    }
+
+    std::uint64_t refreshes() const {
+        return refreshCount;
+    }
+
+private:
+    struct Entry {
+        Accumulator accumulator;
+        NNUE::DirtyPiece dirty;
+    };
+
+    std::vector<Entry> entries;
+    std::size_t top = 0;
+    std::uint64_t refreshCount = 0;
 };
 
 class alignas(SIMD_ALIGN) LinearLayer {
@@ -112,9 +212,15 @@ private:
     };
     static SIMDType detectSIMD();
     SIMDType simdType;
+    // Weights regrouped by 4-byte input block (all outputs of block 0, then block 1, ...) so a
+    // sparse forward pass touches only the columns of nonzero input blocks.
+    alignas(SIMD_ALIGN) std::vector<int8_t> sparseWeights;
+    bool sparseInput;
+
+    int findNonZeroBlocks(const int8_t* input, uint16_t* blocks) const;
 
 public:
-    LinearLayer(int in, int out);
+    LinearLayer(int in, int out, bool sparse = false);
     void loadWeights(const int8_t* w, const int32_t* b);
     void forward_arm_neon(const int8_t* input, int32_t* output) const;
     void forward_arm_dotprod(const int8_t* input, int32_t* output) const;
@@ -122,6 +228,15 @@ public:
     void forward_avx2(const int8_t* input, int32_t* output) const;
     void forward_avx512(const int8_t* input, int32_t* output) const;
     void forward_avx512_vnni(const int8_t* input, int32_t* output) const;
+    void forward_sparse_scalar(const int8_t* input, const uint16_t* blocks, int count,
+                               int32_t* output) const;
+    void forward_sparse_avx2(const int8_t* input, const uint16_t* blocks, int count,
+                             int32_t* output) const;
+    void forward_sparse_avx512_vnni(const int8_t* input, const uint16_t* blocks, int count,
+                                    int32_t* output) const;
+    void forward_sparse_neon(const int8_t* input, const uint16_t* blocks, int count,
+                             int32_t* output) const;
+    void forward_sparse(const int8_t* input, int32_t* output) const;
     void forward(const void* input, void* output) const;
 };
 
@@ -146,38 +261,39 @@ private:
     std::unique_ptr<ClippedReLU> ac2;
     std::unique_ptr<LinearLayer> fc3;
     std::unique_ptr<LinearLayer> fc4;
-    alignas(SIMD_ALIGN) std::vector<int16_t> featureWeights;
-    mutable Accumulator accumulator;
-    void transformInput(const BitboardPosition& pos, int8_t* output) const;
+    std::shared_ptr<const NetworkFile::Mapping> network;
+    const int16_t* featureWeights = nullptr;
+    std::vector<int16_t> featureBiases;
+    static void transformInput(const Accumulator& acc, ChessPieceColor sideToMove,
+                               int8_t* output);
 
 public:
     NNUEEvaluator();
     ~NNUEEvaluator() = default;
     bool loadNetwork(const std::string& filename);
+    bool loadNetwork(std::shared_ptr<const NetworkFile::Mapping> mapping);
     int evaluate(const BitboardPosition& pos) const;
     int evaluate(const Board& board) const {
         return evaluate(BitboardPosition::fromBoard(board));
     }
+    int evaluate(const Accumulator& acc, ChessPieceColor sideToMove) const;
 
-    void updateBeforeMove(const BitboardPosition& pos, int from, int to, ChessPieceType piece,
-                          ChessPieceType captured);
-    void updateAfterMove(const BitboardPosition& pos, int from, int to, ChessPieceType piece,
-                         ChessPieceType promotion);
-
-    void refreshAccumulator(const BitboardPosition& pos) {
-        accumulator.refresh(pos);
+    const int16_t* weights() const {
+        return featureWeights;
     }
 
-    void refreshAccumulator(const Board& board) {
-        refreshAccumulator(BitboardPosition::fromBoard(board));
+    const int16_t* biases() const {
+        return featureBiases.data();
     }
 };
 
 extern std::unique_ptr<NNUEEvaluator> globalEvaluator;
 
 bool init(const std::string& networkPath);
+bool initEmbedded();
 
 int evaluate(const BitboardPosition& pos);
 int evaluate(const Board& board);
+int evaluate(const Board& board, AccumulatorStack& stack, RefreshCache& cache);
 
 } // namespace NNUEBitboard
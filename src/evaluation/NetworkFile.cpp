@@ -0,0 +1,118 @@
+#include "NetworkFile.h"
+
+#include <cstddef>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NETWORK_FILE_HAS_MMAP 1
+#else
+#define NETWORK_FILE_HAS_MMAP 0
+#endif
+
+#ifdef CHESS_ENGINE_EMBEDDED_NNUE
+#if defined(__APPLE__)
+#define NETWORK_FILE_SYMBOL(name) "_" #name
+#define NETWORK_FILE_RODATA ".const_data"
+#else
+#define NETWORK_FILE_SYMBOL(name) #name
+#define NETWORK_FILE_RODATA ".section .rodata"
+#endif
+// The file is assembled into read-only data, so it is paged in on demand like a mapped file.
+asm(NETWORK_FILE_RODATA "\n"
+    ".balign 64\n"
+    ".globl " NETWORK_FILE_SYMBOL(gEmbeddedNetworkBegin) "\n"
+    NETWORK_FILE_SYMBOL(gEmbeddedNetworkBegin) ":\n"
+    ".incbin \"" CHESS_ENGINE_EMBEDDED_NNUE "\"\n"
+    ".globl " NETWORK_FILE_SYMBOL(gEmbeddedNetworkEnd) "\n"
+    NETWORK_FILE_SYMBOL(gEmbeddedNetworkEnd) ":\n"
+    ".previous\n");
+extern "C" const std::byte gEmbeddedNetworkBegin[];
+extern "C" const std::byte gEmbeddedNetworkEnd[];
+#endif
+
+namespace NetworkFile {
+
+std::shared_ptr<const Mapping> Mapping::open(const std::string& path) {
+    std::shared_ptr<Mapping> mapping(new Mapping());
+#if NETWORK_FILE_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address != MAP_FAILED) {
+        mapping->data = static_cast<const std::byte*>(address);
+        mapping->size = size;
+        mapping->mapped = true;
+        return mapping;
+    }
+#endif
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+    const auto end = file.tellg();
+    if (end <= 0) {
+        return nullptr;
+    }
+    const auto length = static_cast<std::size_t>(end);
+    auto* buffer = static_cast<std::byte*>(::operator new(length, std::align_val_t{ALIGNMENT}));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(length))) {
+        ::operator delete(buffer, std::align_val_t{ALIGNMENT});
+        return nullptr;
+    }
+    mapping->data = buffer;
+    mapping->size = length;
+    mapping->owned = true;
+    return mapping;
+}
+
+std::shared_ptr<const Mapping> Mapping::wrap(std::span<const std::byte> bytes) {
+    if (bytes.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<Mapping> mapping(new Mapping());
+    mapping->data = bytes.data();
+    mapping->size = bytes.size();
+    return mapping;
+}
+
+Mapping::~Mapping() {
+#if NETWORK_FILE_HAS_MMAP
+    if (mapped) {
+        ::munmap(const_cast<std::byte*>(data), size);
+        return;
+    }
+#endif
+    if (owned) {
+        ::operator delete(const_cast<std::byte*>(data), std::align_val_t{ALIGNMENT});
+    }
+}
+
+std::span<const std::byte> embeddedNetwork() {
+#ifdef CHESS_ENGINE_EMBEDDED_NNUE
+    return {gEmbeddedNetworkBegin, static_cast<std::size_t>(gEmbeddedNetworkEnd -
+                                                            gEmbeddedNetworkBegin)};
+#else
+    return {};
+#endif
+}
+
+} // namespace NetworkFile
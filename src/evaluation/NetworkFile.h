@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+
+namespace NetworkFile {
+
+inline constexpr std::uint32_t MAGIC = 0x4E4E5545;
+inline constexpr std::size_t ALIGNMENT = 64;
+
+// Read-only bytes of a network. Files are mapped with mmap where available so every engine
+// process on a host shares one page-cache copy; elsewhere they are read into an aligned buffer.
+// Evaluators keep the mapping alive and point their weights straight into it.
+class Mapping {
+public:
+    static std::shared_ptr<const Mapping> open(const std::string& path);
+    // Wraps bytes with static storage duration, such as the embedded network. Nothing is copied.
+    static std::shared_ptr<const Mapping> wrap(std::span<const std::byte> bytes);
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+    ~Mapping();
+
+    std::span<const std::byte> bytes() const {
+        return {data, size};
+    }
+
+    bool isMapped() const {
+        return mapped;
+    }
+
+private:
+    Mapping() = default;
+
+    const std::byte* data = nullptr;
+    std::size_t size = 0;
+    bool mapped = false;
+    bool owned = false;
+};
+
+// Sequential cursor over a network image. In aligned images every array starts on an ALIGNMENT
+// boundary; legacy packed images only need each array to be naturally aligned.
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> bytes) : bytes(bytes) {}
+
+    bool readHeader(std::uint32_t& magic, std::uint32_t& version) {
+        const auto* header = take<std::uint32_t>(2);
+        if (!header) {
+            return false;
+        }
+        magic = header[0];
+        version = header[1];
+        return true;
+    }
+
+    void setAligned(bool value) {
+        aligned = value;
+    }
+
+    // Returns a pointer to count values in place, or nullptr if they overrun the image or would
+    // be misaligned.
+    template <typename T> const T* take(std::size_t count) {
+        std::size_t start = offset;
+        if (aligned) {
+            start = (start + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+        const std::size_t length = count * sizeof(T);
+        if (start > bytes.size() || length > bytes.size() - start) {
+            return nullptr;
+        }
+        const std::byte* p = bytes.data() + start;
+        if (reinterpret_cast<std::uintptr_t>(p) % alignof(T) != 0) {
+            return nullptr;
+        }
+        offset = start + length;
+        return reinterpret_cast<const T*>(p);
+    }
+
+private:
+    std::span<const std::byte> bytes;
+    std::size_t offset = 0;
+    bool aligned = false;
+};
+
+// Writes the aligned layout read back by Reader with setAligned(true).
+class Writer {
+public:
+    explicit Writer(std::ostream& out) : out(out) {}
+
+    void writeHeader(std::uint32_t version) {
+        const std::uint32_t header[2] = {MAGIC, version};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        offset += sizeof(header);
+    }
+
+    template <typename T> void write(std::span<const T> values) {
+        static constexpr char kPadding[ALIGNMENT] = {};
+        const std::size_t padding = (ALIGNMENT - (offset % ALIGNMENT)) % ALIGNMENT;
+        out.write(kPadding, static_cast<std::streamsize>(padding));
+        out.write(reinterpret_cast<const char*>(values.data()),
+                  static_cast<std::streamsize>(values.size_bytes()));
+        offset += padding + values.size_bytes();
+    }
+
+private:
+    std::ostream& out;
+    std::size_t offset = 0;
+};
+
+// Network linked into the binary at build time (see CHESS_ENGINE_EMBEDDED_NNUE), or an empty
+// span when none was embedded.
+std::span<const std::byte> embeddedNetwork();
+
+} // namespace NetworkFile
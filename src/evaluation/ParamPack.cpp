@@ -0,0 +1,91 @@
+#include "ParamPack.h"
+#include "PackedScore.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <optional>
+#include <string>
+
+namespace ParamPack {
+
+namespace {
+constexpr std::array<char, 4> kMagic = {'E', 'V', 'P', 'K'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = kMagic.size() + (2 * sizeof(std::uint32_t));
+constexpr std::size_t kFileSize = kHeaderSize + (EvalTrace::PARAM_COUNT * sizeof(std::int16_t));
+
+void putLittleEndian(unsigned char* out, std::uint32_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+std::uint32_t getLittleEndian(const unsigned char* in, std::size_t bytes) {
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+} // namespace
+
+void apply(const Pack& pack) {
+    active = pack;
+    PsqTable::refresh();
+}
+
+std::optional<Pack> load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::array<unsigned char, kFileSize + 1> bytes{};
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (static_cast<std::size_t>(file.gcount()) != kFileSize) {
+        return std::nullopt;
+    }
+    for (std::size_t i = 0; i < kMagic.size(); ++i) {
+        if (bytes[i] != static_cast<unsigned char>(kMagic[i])) {
+            return std::nullopt;
+        }
+    }
+    if (getLittleEndian(bytes.data() + kMagic.size(), sizeof(std::uint32_t)) != kVersion ||
+        getLittleEndian(bytes.data() + kMagic.size() + sizeof(std::uint32_t),
+                        sizeof(std::uint32_t)) != EvalTrace::PARAM_COUNT) {
+        return std::nullopt;
+    }
+
+    Pack pack;
+    for (std::size_t param = 0; param < EvalTrace::PARAM_COUNT; ++param) {
+        const auto raw = static_cast<std::uint16_t>(getLittleEndian(
+            bytes.data() + kHeaderSize + (param * sizeof(std::int16_t)), sizeof(std::int16_t)));
+        pack[param] = static_cast<std::int16_t>(raw);
+    }
+    return pack;
+}
+
+bool save(const Pack& pack, const std::string& path) {
+    std::array<unsigned char, kFileSize> bytes{};
+    for (std::size_t i = 0; i < kMagic.size(); ++i) {
+        bytes[i] = static_cast<unsigned char>(kMagic[i]);
+    }
+    putLittleEndian(bytes.data() + kMagic.size(), kVersion, sizeof(std::uint32_t));
+    putLittleEndian(bytes.data() + kMagic.size() + sizeof(std::uint32_t),
+                    static_cast<std::uint32_t>(EvalTrace::PARAM_COUNT), sizeof(std::uint32_t));
+    for (std::size_t param = 0; param < EvalTrace::PARAM_COUNT; ++param) {
+        if (pack[param] < std::numeric_limits<std::int16_t>::min() ||
+            pack[param] > std::numeric_limits<std::int16_t>::max()) {
+            return false;
+        }
+        putLittleEndian(bytes.data() + kHeaderSize + (param * sizeof(std::int16_t)),
+                        static_cast<std::uint16_t>(pack[param]), sizeof(std::int16_t));
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+} // namespace ParamPack
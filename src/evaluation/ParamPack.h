@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../core/ChessPiece.h"
+#include "EvalTrace.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+// Evaluation parameters that can be replaced at runtime. A pack holds every parameter the Texel
+// tuner fits, contiguously in EvalTrace::Param order, so tuning farms can compare parameter sets
+// from one binary via `setoption name EvalParams`.
+namespace ParamPack {
+
+struct Pack {
+    std::array<int, EvalTrace::PARAM_COUNT> values{};
+
+    constexpr int operator[](std::size_t param) const {
+        return values[param];
+    }
+
+    constexpr int& operator[](std::size_t param) {
+        return values[param];
+    }
+
+    constexpr int pieceSquare(ChessPieceType type, int square, bool endgame) const {
+        return values[(endgame ? EvalTrace::PST_EG : EvalTrace::PST_MG) +
+                      (static_cast<std::size_t>(type) * EvalTrace::kSquares) +
+                      static_cast<std::size_t>(square)];
+    }
+
+    bool operator==(const Pack&) const = default;
+};
+
+// The values compiled from EvaluationParams, MaterialValues and the TUNED_* tables.
+extern const Pack defaults;
+// The process-wide pack. Change it through apply() so the piece-square table follows.
+extern Pack active;
+#ifdef CHESS_ENGINE_THREAD_PARAMS
+// The pack the calling thread's evaluation reads. Point it elsewhere only together with
+// PsqTable::current, as a match runner worker does for each engine it plays. Only the
+// //:engine_match_lib build has it; every other build reads active directly.
+inline thread_local const Pack* current = &active;
+#endif
+
+void apply(const Pack& pack);
+
+// Binary file: "EVPK", format version and parameter count as little-endian uint32, then one
+// int16 per parameter. Returns nullopt unless the file matches this build's parameter layout.
+std::optional<Pack> load(const std::string& path);
+bool save(const Pack& pack, const std::string& path);
+
+} // namespace ParamPack
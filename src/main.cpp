@@ -1,3 +1,4 @@
+#include "ai/Datagen.h"
 #include "ai/NeuralNetwork.h"
 #include "core/Bitboard.h"
 #include "core/BitboardMoves.h"
@@ -9,16 +10,20 @@
 #include "evaluation/Evaluation.h"
 #include "evaluation/EvaluationTuning.h"
 #include "evaluation/HybridEvaluator.h"
+#include "evaluation/ParamPack.h"
 #include "evaluation/PositionAnalysis.h"
+#include "search/Bench.h"
 #include "search/ValidMoves.h"
 #include "search/search.h"
 #include "utils/ChessFormat.h"
+#include "utils/CommandLine.h"
 #include "utils/engine_globals.h"
 
 #include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <format>
 #include <iostream>
@@ -30,6 +35,8 @@ using ChessClock = std::chrono::steady_clock;
 using ChessDuration = std::chrono::milliseconds;
 using ChessTimePoint = ChessClock::time_point;
 
+using namespace CommandLine;
+
 namespace {
 constexpr int kBoardTopRow = BOARD_SIZE - 1;
 constexpr int kNominalMovesToGo = 40;
@@ -70,7 +77,7 @@ constexpr float kTrainingValidationSplit = 0.2F;
 constexpr int kEarlyStoppingPatience = 3;
 constexpr int kDefaultTrainingGames = 100;
 constexpr int kDefaultDataGenerationGames = 50;
-constexpr int kDefaultTuneIterations = 100;
+constexpr int kDefaultTuneIterations = 500;
 constexpr const char* kStartingFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 } // namespace
 
@@ -486,10 +493,64 @@ int main(int argc, char* argv[]) {
                     dataPath = argv[3];
                 }
 
-                generator.saveTrainingData(trainingData, dataPath);
+                if (dataPath.ends_with(".packed")) {
+                    generator.savePackedTrainingData(trainingData, dataPath);
+                } else {
+                    generator.saveTrainingData(trainingData, dataPath);
+                }
                 std::cout << "Training data saved to: " << dataPath << '\n';
                 std::cout << "Generated " << trainingData.size() << " training examples" << '\n';
                 return 0;
+            } else if (mode == "datagen") {
+                if (argc < 4) {
+                    std::cout << "Usage: engine_cli datagen <games> <output.packed> [--nodes=N] "
+                                 "[--threads=N] [--book=openings.epd] [--random-plies=N] "
+                                 "[--seed=N] [--hash=MB]\n";
+                    return 1;
+                }
+                initKnightAttacks();
+                initKingAttacks();
+                InitZobrist();
+                const std::vector<std::string> options(argv + 2, argv + argc);
+                Datagen::Config config;
+                config.games = std::stoi(argv[2]);
+                config.nodes = std::stoi(option(options, "nodes", "5000"));
+                config.threads = std::stoi(option(options, "threads", "0"));
+                config.randomPlies = std::stoi(option(options, "random-plies", "8"));
+                config.seed = static_cast<std::uint32_t>(
+                    std::stoul(option(options, "seed", "1")));
+                config.hashMb = std::stoi(option(options, "hash", "16"));
+                std::vector<std::string> openings;
+                if (const std::string book = option(options, "book", ""); !book.empty()) {
+                    openings = Datagen::loadOpenings(book);
+                    std::cout << "Loaded " << openings.size() << " openings from " << book << '\n';
+                }
+
+                const auto stats = Datagen::generate(config, openings, argv[3]);
+                if (!stats) {
+                    std::cout << "Could not write training data: " << argv[3] << '\n';
+                    return 1;
+                }
+                std::cout << "Wrote " << stats->positions << " positions from " << stats->games
+                          << " games to " << argv[3] << " (" << stats->duplicates
+                          << " duplicates, " << stats->filtered << " filtered), "
+                          << static_cast<long long>(stats->positionsPerSecond)
+                          << " positions/sec\n";
+                return 0;
+            } else if (mode == "bench") {
+                initKnightAttacks();
+                initKingAttacks();
+                InitZobrist();
+                const Bench::Config config =
+                    Bench::parseArgs(std::vector<std::string>(argv + 2, argv + argc));
+                const Bench::Result result =
+                    Bench::run(config, [](std::size_t index, const SearchResult& searched) {
+                        std::cout << Bench::positionLine(index, searched) << '\n';
+                    });
+                for (const std::string& line : Bench::summaryLines(config, result)) {
+                    std::cout << line << '\n';
+                }
+                return 0;
             } else if (mode == "--tune" || mode == "tune") {
                 if (argc < 3) {
                     std::cout << "Usage: engine_cli --tune <positions_file> [iterations]\n";
@@ -501,6 +562,8 @@ int main(int argc, char* argv[]) {
                     iterations = std::stoi(argv[3]);
                 }
 
+                initKnightAttacks();
+                initKingAttacks();
                 InitZobrist();
                 TexelTuner tuner;
                 if (!tuner.loadPositions(posFile)) {
@@ -511,6 +574,9 @@ int main(int argc, char* argv[]) {
                 tuner.optimize(iterations);
                 tuner.exportParams("tuned_params.txt");
                 std::cout << "Tuned parameters exported to tuned_params.txt\n";
+                if (ParamPack::save(tuner.pack(), "tuned_params.bin")) {
+                    std::cout << "Parameter pack written to tuned_params.bin\n";
+                }
                 return 0;
             } else if (mode == "analyze") {
                 std::cout << "Position Analysis Mode\n";
@@ -6,7 +6,10 @@
 #include "../core/Move.h"
 #include "../evaluation/Evaluation.h"
 #include "../evaluation/NNUE.h"
+#include "../evaluation/NNUEBitboard.h"
+#include "../evaluation/ParamPack.h"
 #include "../search/AdvancedSearch.h"
+#include "../search/Bench.h"
 #include "../search/ValidMoves.h"
 #include "../search/search.h"
 #include "../utils/ChessFormat.h"
@@ -115,6 +118,12 @@ private:
 }
 
 using CommandHandler = void (UCIEngine::*)(std::string_view);
+
+// A loaded network is only replaced once an embedded one has loaded; with nothing embedded this
+// leaves both evaluators untouched.
+bool loadEmbeddedNetwork() {
+    return NNUE::initEmbedded() || NNUEBitboard::initEmbedded();
+}
 } // namespace
 
 UCIEngine::UCIEngine() {
@@ -128,6 +137,8 @@ UCIEngine::UCIEngine() {
     openingBook = std::make_unique<EnhancedOpeningBook>();
     searchContext.threads = options.threads;
     searchContext.hashSizeMb = options.hashSize;
+    searchContext.pawnHashSizeMb = options.pawnHashSize;
+    loadEmbeddedNetwork();
     setUseNeuralNetwork(options.useNeuralNetwork);
 }
 
@@ -174,15 +185,16 @@ void UCIEngine::processCommand(std::string_view command) {
         return;
     }
 
-    static constexpr std::array<CommandHandler, 12> kCommands = {
+    static constexpr std::array<CommandHandler, 13> kCommands = {
         &UCIEngine::handleUCI,      &UCIEngine::handleIsReady,   &UCIEngine::handleSetOption,
         &UCIEngine::handleNewGame,  &UCIEngine::handlePosition,  &UCIEngine::handleGo,
         &UCIEngine::handleStop,     &UCIEngine::handlePonderHit, &UCIEngine::handleQuit,
         &UCIEngine::handleRegister, &UCIEngine::handleInfo,      &UCIEngine::handleBookStats,
+        &UCIEngine::handleBench,
     };
     static constexpr std::array<std::string_view, kCommands.size()> kCommandNames = {
-        "uci",  "isready",   "setoption", "ucinewgame", "position", "go",
-        "stop", "ponderhit", "quit",      "register",   "info",     "bookstats",
+        "uci",       "isready", "setoption", "ucinewgame", "position",  "go",    "stop",
+        "ponderhit", "quit",    "register",  "info",       "bookstats", "bench",
     };
 
     if (cmd == "debug") {
@@ -204,6 +216,8 @@ void UCIEngine::handleUCI(std::string_view /*args*/) {
     uci::output::println("id name ModernChess 1.0");
     uci::output::println("id author Chess Engine Team");
     uci::output::println("option name Hash type spin default 32 min 1 max 1024");
+    uci::output::println("option name PawnHash type spin default {} min 1 max {}",
+                         DEFAULT_PAWN_HASH_MB, MAX_PAWN_HASH_MB);
     uci::output::println("option name Threads type spin default 1 min 1 max 16");
     uci::output::println("option name MultiPV type spin default 1 min 1 max 10");
     uci::output::println("option name Ponder type check default false");
@@ -212,6 +226,7 @@ void UCIEngine::handleUCI(std::string_view /*args*/) {
     uci::output::println("option name Minimum Thinking Time type spin default 20 min 0 max 5000");
     uci::output::println("option name Use Neural Network type check default false");
     uci::output::println("option name EvalFile type string default ");
+    uci::output::println("option name EvalParams type string default ");
     uci::output::println("option name Use Tablebases type check default true");
     uci::output::println("option name SyzygyPath type string default ");
     uci::output::println("option name Debug type check default false");
@@ -236,8 +251,9 @@ void UCIEngine::handleSetOption(std::string_view command) {
         return;
     }
 
-    static constexpr std::array<std::pair<std::string_view, void (UCIEngine::*)(int)>, 5>
+    static constexpr std::array<std::pair<std::string_view, void (UCIEngine::*)(int)>, 6>
         kSpinOptions = {{{"Hash", &UCIEngine::setHashSize},
+                         {"PawnHash", &UCIEngine::setPawnHashSize},
                          {"Threads", &UCIEngine::setThreads},
                          {"MultiPV", &UCIEngine::setMultiPV},
                          {"Move Overhead", &UCIEngine::setMoveOverhead},
@@ -272,6 +288,11 @@ void UCIEngine::handleSetOption(std::string_view command) {
         return;
     }
 
+    if (name == "EvalParams") {
+        setEvalParams(value);
+        return;
+    }
+
     if (name == "SyzygyPath") {
         options.syzygyPath = std::string(value);
         if (!value.empty()) {
@@ -532,6 +553,28 @@ void UCIEngine::handleBookStats(std::string_view /*args*/) {
                        stats.averageWinRate, stats.averageRating);
 }
 
+void UCIEngine::handleBench(std::string_view args) {
+    if (isSearching.load()) {
+        uci::output::println("info string Search already in progress");
+        return;
+    }
+    joinSearchThread();
+
+    TokenView tokens(args);
+    std::vector<std::string> values;
+    while (const auto token = tokens.next()) {
+        values.emplace_back(*token);
+    }
+    const Bench::Config config = Bench::parseArgs(values);
+    const Bench::Result result =
+        Bench::run(config, [](std::size_t index, const SearchResult& searched) {
+            uci::output::println("{}", Bench::positionLine(index, searched));
+        });
+    for (const std::string& line : Bench::summaryLines(config, result)) {
+        uci::output::println("{}", line);
+    }
+}
+
 void UCIEngine::reportBestMove(const Move& move, const std::optional<Move>& ponderMove) {
     if (ponderMove) {
         uci::output::println("bestmove {} ponder {}", UCINotation::moveToUCI(move),
@@ -642,6 +685,7 @@ SearchResult UCIEngine::performSearch(const Board& board, int depth, int timeLim
     config.externalStopToken = stopToken.stop_possible() ? &stopToken : nullptr;
     searchContext.threads = options.threads;
     searchContext.hashSizeMb = options.hashSize;
+    searchContext.pawnHashSizeMb = options.pawnHashSize;
     result = iterativeDeepeningParallel(searchBoard, config, searchContext);
 
     return result;
@@ -652,6 +696,11 @@ void UCIEngine::setHashSize(int size) {
     searchContext.hashSizeMb = size;
 }
 
+void UCIEngine::setPawnHashSize(int size) {
+    options.pawnHashSize = std::clamp(size, 1, MAX_PAWN_HASH_MB);
+    searchContext.pawnHashSizeMb = options.pawnHashSize;
+}
+
 void UCIEngine::setThreads(int num) {
     options.threads = std::clamp(num, 1, 16);
     searchContext.threads = options.threads;
@@ -680,7 +729,7 @@ void UCIEngine::setMinimumThinkingTime(int time) {
 void UCIEngine::setUseNeuralNetwork(bool enabled) {
     options.useNeuralNetwork = enabled;
     if (enabled) {
-        if (NNUE::globalEvaluator) {
+        if (NNUE::globalEvaluator || NNUEBitboard::globalEvaluator) {
             setNNUEEnabled(true);
         } else {
             setNNUEEnabled(false);
@@ -694,12 +743,13 @@ void UCIEngine::setUseNeuralNetwork(bool enabled) {
 
 void UCIEngine::setEvalFile(std::string_view path) {
     options.evalFile = std::string(path);
+    NNUE::globalEvaluator.reset();
+    NNUEBitboard::globalEvaluator.reset();
     if (path.empty()) {
-        NNUE::globalEvaluator.reset();
-        setNNUEEnabled(false);
+        setNNUEEnabled(loadEmbeddedNetwork() && options.useNeuralNetwork);
         return;
     }
-    if (!NNUE::init(options.evalFile)) {
+    if (!NNUE::init(options.evalFile) && !NNUEBitboard::init(options.evalFile)) {
         uci::output::println("info string Failed to load NNUE model: {}", options.evalFile);
         setNNUEEnabled(false);
         return;
@@ -710,6 +760,21 @@ void UCIEngine::setEvalFile(std::string_view path) {
     }
 }
 
+void UCIEngine::setEvalParams(std::string_view path) {
+    options.evalParams = std::string(path);
+    if (path.empty()) {
+        ParamPack::apply(ParamPack::defaults);
+    } else if (const auto pack = ParamPack::load(options.evalParams)) {
+        ParamPack::apply(*pack);
+        uci::output::println("info string Evaluation parameters loaded: {}", options.evalParams);
+    } else {
+        uci::output::println("info string Failed to load evaluation parameters: {}",
+                             options.evalParams);
+        return;
+    }
+    board.psqScore = computePsqScore(board);
+}
+
 void UCIEngine::setUseTablebases(bool enabled) {
     options.useTablebases = enabled;
 }
@@ -747,8 +812,15 @@ std::optional<Move> UCINotation::uciToMove(std::string_view uciMove) {
     return Move{from, to};
 }
 
-int runUCIEngine() {
+int runUCIEngine(std::string_view evalParams, std::string_view command) {
     UCIEngine engine;
+    if (!evalParams.empty()) {
+        engine.processCommand(std::format("setoption name EvalParams value {}", evalParams));
+    }
+    if (!command.empty()) {
+        engine.processCommand(command);
+        return 0;
+    }
     engine.run();
     return 0;
 }
@@ -19,6 +19,7 @@ public:
     struct UCIOptions {
 
         int hashSize = 32;
+        int pawnHashSize = DEFAULT_PAWN_HASH_MB;
         int threads = 1;
         int multiPV = 1;
         bool ponder = false;
@@ -27,6 +28,7 @@ public:
         int minimumThinkingTime = 20;
         bool useNeuralNetwork = false;
         std::string evalFile;
+        std::string evalParams;
         bool useTablebases = true;
         std::string syzygyPath;
         bool debug = false;
@@ -50,6 +52,9 @@ public:
     void handleRegister(std::string_view command);
     void handleInfo(std::string_view command);
     void handleBookStats(std::string_view args = {});
+    // Non-standard: `bench [depth] [threads] [hashMb]` searches the built-in bench positions and
+    // prints the node total, time and NPS.
+    void handleBench(std::string_view args = {});
 
     void reportBestMove(const Move& move, const std::optional<Move>& ponderMove = std::nullopt);
     void reportInfo(int depth, int seldepth, int time, int nodes, int nps,
@@ -89,6 +94,7 @@ private:
                                int maxTime = 0, std::stop_token stopToken = {});
 
     void setHashSize(int size);
+    void setPawnHashSize(int size);
     void setThreads(int num);
     void setMultiPV(int num);
     void setPonder(bool enabled);
@@ -97,6 +103,7 @@ private:
     void setMinimumThinkingTime(int time);
     void setUseNeuralNetwork(bool enabled);
     void setEvalFile(std::string_view path);
+    void setEvalParams(std::string_view path);
     void setUseTablebases(bool enabled);
     void setDebug(bool enabled);
     void setShowCurrLine(bool enabled);
@@ -108,4 +115,6 @@ public:
     static std::optional<Move> uciToMove(std::string_view uciMove);
 };
 
-int runUCIEngine();
+// evalParams, when set, is loaded as if sent with `setoption name EvalParams`. command, when set,
+// is processed instead of reading commands from standard input.
+int runUCIEngine(std::string_view evalParams = {}, std::string_view command = {});
@@ -2,10 +2,26 @@
 
 #include <exception>
 #include <iostream>
+#include <string>
+#include <string_view>
+
+int main(int argc, char* argv[]) {
+    constexpr std::string_view kEvalParamsPrefix = "--eval-params=";
+    std::string_view evalParams;
+    // `engine_uci bench [depth] [threads] [hashMb]` runs the bench and exits.
+    std::string command;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.starts_with(kEvalParamsPrefix)) {
+            evalParams = arg.substr(kEvalParamsPrefix.size());
+        } else if (arg == "bench" || !command.empty()) {
+            command += command.empty() ? "" : " ";
+            command += arg;
+        }
+    }
 
-int main() {
     try {
-        return runUCIEngine();
+        return runUCIEngine(evalParams, command);
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << '\n';
         return 1;
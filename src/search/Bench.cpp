@@ -0,0 +1,148 @@
+#include "Bench.h"
+#include "../core/ChessBoard.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+// Far beyond any bench search, but small enough that the time manager's scaled limits stay in
+// range of an int.
+constexpr int kUnlimitedTimeMs = 24 * 60 * 60 * 1000;
+constexpr std::uint64_t kMsPerSecond = 1000;
+
+int parsePositive(const std::string& value, int fallback) {
+    int parsed = 0;
+    const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (ec != std::errc{} || ptr != value.data() + value.size() || parsed <= 0) {
+        return fallback;
+    }
+    return parsed;
+}
+} // namespace
+
+std::uint64_t Result::nodesPerSecond() const {
+    return nodes * kMsPerSecond / static_cast<std::uint64_t>(std::max(1LL, elapsedMs));
+}
+
+const std::vector<std::string>& positions() {
+    static const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r2q1rk1/1ppnbppp/p2p1nb1/3Pp3/2P1P1P1/2N2N1P/PPB1QP2/R1B2RK1 b - - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1bqk2r/ppp2ppp/2n2n2/2bpp3/4P3/2PP1N2/PP3PPP/RNBQKB1R w KQkq - 0 5",
+        "rnbqk2r/ppp1ppbp/3p1np1/8/2PPP3/2N5/PP3PPP/R1BQKBNR w KQkq - 0 5",
+        "r1bqkbnr/pp1ppppp/2n5/2p5/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "rnbqkb1r/ppp1pppp/5n2/3p4/3P1B2/5N2/PPP1PPPP/RN1QKB1R b KQkq - 3 3",
+        "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2N2N2/PPPP1PPP/R1BQK2R w KQkq - 6 5",
+        "r1bqk2r/pppp1ppp/2n1pn2/8/1bPP4/2N2N2/PP2PPPP/R1BQKB1R w KQkq - 2 5",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r2qk2r/ppp1bppp/2np1n2/4p3/2B1P1b1/2NP1N2/PPP2PPP/R1BQ1RK1 w kq - 4 7",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R1BQKB1R w KQ - 1 8",
+        "rn1qkb1r/pp2pppp/2p2n2/5b2/P1pP4/2N2N2/1P2PPPP/R1BQKB1R w KQkq - 1 6",
+        "2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+        "r3k2r/ppp1pp1p/2nqb1pn/3p4/4P3/2PP4/PP1NBPPP/R2QK1NR w KQkq - 1 5",
+        "2r1nrk1/p2q1ppp/bp1p4/n1pPp3/P1P1P3/2PBB1N1/4QPPP/R4RK1 w - - 0 1",
+        "r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b - - 0 1",
+        "2r2rk1/1bqnbpp1/1p1ppn1p/pP6/N1P1P3/P2B1N1P/1B2QPP1/R2R2K1 b - - 0 1",
+        "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/2N5/PPP2PPP/R1BQKB1R b KQkq - 2 5",
+        "2kr3r/ppp2ppp/2n5/2b1p3/4P1b1/2NP1N2/PPP2PPP/R1B1KB1R w KQ - 0 9",
+        "r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+        "3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+        "r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+        "r4k2/pb2bp1r/1p1qp2p/3pNp2/3P1P2/2N3P1/PPP1Q2P/2KRR3 w - - 0 1",
+        "r1bqk2r/pp2bppp/2p5/3pP3/P2Q1P2/2N1B3/1PP3PP/R4RK1 b kq - 0 1",
+        "r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+        "3rr1k1/pp3pp1/1qn2np1/8/3p4/PP1R1P2/2P1NQPP/R1B3K1 b - - 0 1",
+        "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+        "3rr3/2pq2pk/p2p1pnp/8/2QBPP2/1P6/P5PP/4RRK1 b - - 0 1",
+        "4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+        "2r3k1/5pp1/p3p2p/1p1n4/3P4/1P3N1P/P4PP1/2R3K1 b - - 0 28",
+        "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 0 1",
+        "8/6pk/1p6/8/PP3p1p/5P2/4KP1q/3Q4 w - - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+        "8/8/4kpp1/3p4/p2P3P/P3K1P1/8/8 w - - 0 40",
+        "8/k7/3p4/p2P1p2/P2P1P2/8/8/K7 w - - 0 1",
+        "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+        "6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 1",
+        "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+        "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+        "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+        "8/5p2/8/2k3P1/p3K3/8/1P6/8 b - - 0 1",
+        "8/5pk1/6p1/8/8/6P1/5PK1/8 w - - 0 1",
+        "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+        "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+        "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+        "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+        "8/8/2k5/3p4/3P4/2K5/8/8 w - - 0 1",
+        "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+    };
+    return fens;
+}
+
+Result run(const Config& config, const Report& report) {
+    SearchConfig searchConfig;
+    searchConfig.maxDepth = config.depth;
+    searchConfig.timeLimitMs = kUnlimitedTimeMs;
+    searchConfig.optimalTimeMs = kUnlimitedTimeMs;
+    searchConfig.maxTimeMs = kUnlimitedTimeMs;
+    SearchContext context;
+    context.threads = std::max(1, config.threads);
+    context.hashSizeMb = std::max(1, config.hashMb);
+
+    Result result;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < positions().size(); ++index) {
+        Board board;
+        board.InitializeFromFEN(positions()[index]);
+        // Each search allocates its own transposition table, so none carries over.
+        const SearchResult searched = iterativeDeepeningParallel(board, searchConfig, context);
+        result.nodes += static_cast<std::uint64_t>(std::max(0, searched.nodes));
+        if (report) {
+            report(index, searched);
+        }
+    }
+    result.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    return result;
+}
+
+std::string positionLine(std::size_t index, const SearchResult& searched) {
+    return std::format("Position {}/{}: {} nodes", index + 1, positions().size(), searched.nodes);
+}
+
+std::vector<std::string> summaryLines(const Config& config, const Result& result) {
+    return {
+        "===========================",
+        std::format("Depth {}, threads {}, hash {} MB", config.depth, config.threads,
+                    config.hashMb),
+        std::format("Total time (ms) : {}", result.elapsedMs),
+        std::format("Nodes searched  : {}", result.nodes),
+        std::format("Nodes/second    : {}", result.nodesPerSecond()),
+    };
+}
+
+Config parseArgs(const std::vector<std::string>& args) {
+    Config config;
+    if (!args.empty()) {
+        config.depth = parsePositive(args[0], config.depth);
+    }
+    if (args.size() > 1) {
+        config.threads = parsePositive(args[1], config.threads);
+    }
+    if (args.size() > 2) {
+        config.hashMb = parsePositive(args[2], config.hashMb);
+    }
+    return config;
+}
+
+} // namespace Bench
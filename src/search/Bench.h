@@ -0,0 +1,49 @@
+#pragma once
+
+#include "search.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Fixed-depth searches over a built-in set of positions. Every position starts from an empty
+// transposition table, so with one thread the node total is a signature of the search: a change
+// meant only to make the engine faster must leave it unchanged.
+namespace Bench {
+
+constexpr int kDefaultDepth = 5;
+constexpr int kDefaultThreads = 1;
+constexpr int kDefaultHashMb = 16;
+
+struct Config {
+    int depth = kDefaultDepth;
+    int threads = kDefaultThreads;
+    int hashMb = kDefaultHashMb;
+};
+
+struct Result {
+    std::uint64_t nodes = 0;
+    long long elapsedMs = 0;
+
+    std::uint64_t nodesPerSecond() const;
+};
+
+// Opening, middlegame and endgame positions, none of them in the opening book.
+const std::vector<std::string>& positions();
+
+// Called after each position with its index into positions() and the search result.
+using Report = std::function<void(std::size_t, const SearchResult&)>;
+
+Result run(const Config& config, const Report& report = {});
+
+// The lines engine_cli and engine_uci print, without line endings, so both report a run the same
+// way: one per position from a Report, then the summary once run() returns.
+std::string positionLine(std::size_t index, const SearchResult& searched);
+std::vector<std::string> summaryLines(const Config& config, const Result& result);
+
+// Parses "[depth] [threads] [hashMb]"; missing or invalid values keep their defaults.
+Config parseArgs(const std::vector<std::string>& args);
+
+} // namespace Bench
@@ -92,10 +92,11 @@ std::uint16_t packMoveKey(Move move) {
 
 } // namespace
 
-LazySMP::LazySMP(int threadCount, int hashMb, int contemptValue)
+LazySMP::LazySMP(int threadCount, int hashMb, int contemptValue, int pawnHashMb)
     : numThreads(threadCount > kZero ? threadCount
                                      : static_cast<int>(std::thread::hardware_concurrency())),
-      hashSizeMb(std::max(SearchConstants::kOne, hashMb)), contempt(contemptValue) {
+      hashSizeMb(std::max(SearchConstants::kOne, hashMb)),
+      pawnHashSizeMb(std::max(SearchConstants::kOne, pawnHashMb)), contempt(contemptValue) {
 
     if (numThreads == kZero) {
         numThreads = kDefaultThreadCount;
@@ -123,6 +124,7 @@ void LazySMP::searchThread(ThreadData* data, int maxDepth, int timeLimit,
     context->transTable.resize(
         std::max(SearchConstants::kOne, hashSizeMb / std::max(SearchConstants::kOne, numThreads)));
     context->transTable.newSearch();
+    context->pawnHash.resize(pawnHashSizeMb);
     context->nodeCount = kZero;
     int aspirationDelta = kDefaultAspirationDelta + data->aspirationDelta;
     int startDepth = std::max(kStartDepthBase, kStartDepthBase + data->depthOffset);
@@ -201,6 +203,8 @@ void LazySMP::searchThread(ThreadData* data, int maxDepth, int timeLimit,
         aspirationDelta = std::min(aspirationDelta * kAspirationGrowthFactor, kMaxAspirationDelta);
     }
 
+    shared->evalCacheProbes += context->evalCache.stats().probes;
+    shared->evalCacheHits += context->evalCache.stats().hits;
     data->searching = false;
 }
 
@@ -210,6 +214,8 @@ SearchResult LazySMP::search(const Board& board, int maxDepth, int timeLimit,
 
     shared->globalStop = false;
     shared->nodesSearched = kZero;
+    shared->evalCacheProbes = kZero;
+    shared->evalCacheHits = kZero;
     shared->bestDepth = kZero;
     shared->bestScore = kInvalidScore;
     shared->bestMove = chess::invalidMove();
@@ -270,6 +276,8 @@ SearchResult LazySMP::search(const Board& board, int maxDepth, int timeLimit,
         result.depth = shared->bestDepth;
     }
     result.nodes = shared->nodesSearched;
+    result.evalCache.probes = shared->evalCacheProbes;
+    result.evalCache.hits = shared->evalCacheHits;
 
     if (!isValidMove(result.bestMove)) {
         struct MoveStats {
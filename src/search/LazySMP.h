@@ -6,6 +6,7 @@
 #include "../utils/SearchThread.h"
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -40,6 +41,8 @@ public:
     struct SharedData {
         std::atomic<bool> globalStop;
         std::atomic<int> nodesSearched;
+        std::atomic<std::uint64_t> evalCacheProbes{0};
+        std::atomic<std::uint64_t> evalCacheHits{0};
         std::atomic<int> bestDepth;
         std::atomic<int> bestScore;
         Move bestMove;
@@ -52,7 +55,8 @@ public:
 
     explicit LazySMP(int threadCount = kAutoThreadCount,
                      int hashMb = SearchConstants::kDefaultTranspositionTableMb,
-                     int contemptValue = SearchConstants::kZero);
+                     int contemptValue = SearchConstants::kZero,
+                     int pawnHashMb = DEFAULT_PAWN_HASH_MB);
     ~LazySMP();
     SearchResult search(const Board& board, int maxDepth, int timeLimit,
                         const std::vector<Move>& excludedRootMoves = {});
@@ -67,6 +71,7 @@ private:
 
     int numThreads;
     int hashSizeMb;
+    int pawnHashSizeMb;
     int contempt;
     std::vector<std::unique_ptr<ThreadData>> threads;
     std::unique_ptr<SharedData> shared;
@@ -4,6 +4,7 @@
 #include "../core/CastlingConstants.h"
 #include "../core/ChessBoard.h"
 #include "../core/ChessPiece.h"
+#include "../core/PawnKeys.h"
 #include "../evaluation/Evaluation.h"
 #include "SearchTuning.h"
 #include "ValidMoves.h"
@@ -209,6 +210,46 @@ bool applyMoveToBitboards(const Board& board, int fromSquare, int toSquare, bool
     return true;
 }
 
+EvalWindow lazyEvalWindow(int alpha, int beta) {
+    return EvalWindow{alpha, beta, kLazyEvalMargin};
+}
+
+namespace {
+TieredEval evaluateNode(const Board& board, ParallelSearchContext& context,
+                        const EvalWindow& window) {
+    if (isNNUEEnabled()) {
+        if (NNUEBitboard::globalEvaluator) {
+            // The bitboard network scores for the side to move; the search works from white's
+            // point of view.
+            const int score = NNUEBitboard::evaluate(board, context.nnueBitboardStack,
+                                                     context.nnueRefreshCache);
+            return {board.turn == ChessPieceColor::WHITE ? score : -score, EvalTier::TACTICAL};
+        }
+        return {NNUE::evaluate(board, context.nnueStack), EvalTier::TACTICAL};
+    }
+    return evaluateTiered(board, window, context.contempt, &context.pawnHash,
+                          &context.materialHash);
+}
+} // namespace
+
+int evaluateForSearch(const Board& board, ParallelSearchContext& context,
+                      const EvalWindow& window) {
+    return evaluateNode(board, context, window).score;
+}
+
+int evaluateForSearch(const Board& board, ParallelSearchContext& context, uint64_t zobristKey,
+                      const EvalWindow& window) {
+    const uint64_t cacheKey = zobristKey ^ board.pawnKey;
+    if (const auto cached = context.evalCache.probe(cacheKey)) {
+        return *cached;
+    }
+    const TieredEval eval = evaluateNode(board, context, window);
+    if (eval.tier == EvalTier::TACTICAL) {
+        context.evalCache.store(cacheKey, eval.score);
+    }
+    return eval.score;
+}
+
 uint64_t resolveZobristKey(const Board& board, uint64_t key) {
     return (key == kUnsetZobristKey) ? ComputeZobrist(board) : key;
 }
@@ -301,6 +342,8 @@ bool applySearchMoveWithData(Board& board, int fromSquare, int toSquare, bool au
     moveData.previousWhitePieces = board.whitePieces;
     moveData.previousBlackPieces = board.blackPieces;
     moveData.previousAllPieces = board.allPieces;
+    moveData.previousPawnKey = board.pawnKey;
+    moveData.previousPsqScore = board.psqScore;
 
     recordUndoSquare(moveData, board, fromSquare);
     recordUndoSquare(moveData, board, toSquare);
@@ -350,13 +393,16 @@ bool applySearchMoveWithData(Board& board, int fromSquare, int toSquare, bool au
     }
 
     if (isEnPassant && moveData.captureSquare >= kZero) {
+        board.psqScore -= PsqTable::value(moveData.capturedPiece, moveData.captureSquare);
         board.squares[moveData.captureSquare].piece = Piece();
         if (movingPiece.PieceColor == ChessPieceColor::WHITE) {
             clear_bit(board.blackPawns, moveData.captureSquare);
             clear_bit(board.blackPieces, moveData.captureSquare);
+            board.pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::BLACK, moveData.captureSquare);
         } else {
             clear_bit(board.whitePawns, moveData.captureSquare);
             clear_bit(board.whitePieces, moveData.captureSquare);
+            board.pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::WHITE, moveData.captureSquare);
         }
         clear_bit(board.allPieces, moveData.captureSquare);
     }
@@ -379,12 +425,16 @@ bool applySearchMoveWithData(Board& board, int fromSquare, int toSquare, bool au
         if (movingPiece.PieceColor == ChessPieceColor::WHITE) {
             clear_bit(board.whitePawns, toSquare);
             set_bit(board.whiteQueens, toSquare);
+            board.pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::WHITE, toSquare);
         } else {
             clear_bit(board.blackPawns, toSquare);
             set_bit(board.blackQueens, toSquare);
+            board.pawnKey ^= PawnKeys::pawnKey(ChessPieceColor::BLACK, toSquare);
         }
         board.squares[toSquare].piece = Piece(movingPiece.PieceColor, ChessPieceType::QUEEN);
         board.squares[toSquare].piece.moved = true;
+        board.psqScore += PsqTable::value(board.squares[toSquare].piece, toSquare) -
+                          PsqTable::value(movingPiece, toSquare);
     }
 
     if (movingPiece.PieceType == ChessPieceType::KING) {
@@ -461,6 +511,31 @@ void undoSearchMoveWithData(Board& board, const MoveApplicationData& moveData) {
     board.whitePieces = moveData.previousWhitePieces;
     board.blackPieces = moveData.previousBlackPieces;
     board.allPieces = moveData.previousAllPieces;
+    board.pawnKey = moveData.previousPawnKey;
+    board.psqScore = moveData.previousPsqScore;
+}
+
+bool makeSearchMove(Board& board, Move move, MoveApplicationData& moveData,
+                    ParallelSearchContext& context) {
+    if (!applySearchMoveWithData(board, move.first, move.second, true, &moveData)) {
+        return false;
+    }
+    NNUE::DirtyPiece dirty;
+    for (int i = kZero; i < moveData.changedSquareCount; ++i) {
+        const int square = moveData.changedSquares[static_cast<std::size_t>(i)];
+        dirty.remove(square, moveData.previousPieces[static_cast<std::size_t>(i)]);
+        dirty.add(square, board.squares[square].piece);
+    }
+    context.nnueStack.push(dirty);
+    context.nnueBitboardStack.push(dirty);
+    return true;
+}
+
+void unmakeSearchMove(Board& board, const MoveApplicationData& moveData,
+                      ParallelSearchContext& context) {
+    undoSearchMoveWithData(board, moveData);
+    context.nnueStack.pop();
+    context.nnueBitboardStack.pop();
 }
 } // namespace SearchInternal
 
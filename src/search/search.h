@@ -24,6 +24,7 @@
 
 #include "../core/ChessBoard.h"
 #include "../evaluation/Evaluation.h"
+#include "../evaluation/NNUEBitboard.h"
 #include "TranspositionTableV2.h"
 #include "ValidMoves.h"
 
@@ -202,6 +203,12 @@ struct ParallelSearchContext {
     const std::stop_token* externalStopToken = nullptr;
     int nodeCount;
     TranspositionTableAdapter transTable;
+    PawnHashTable pawnHash;
+    MaterialHashTable materialHash;
+    EvalCache evalCache;
+    NNUE::AccumulatorStack nnueStack;
+    NNUEBitboard::AccumulatorStack nnueBitboardStack;
+    NNUEBitboard::RefreshCache nnueRefreshCache;
     ThreadSafeHistory historyTable;
     KillerMoves killerMoves;
     std::chrono::steady_clock::time_point startTime;
@@ -217,6 +224,8 @@ struct ParallelSearchContext {
     int optimalTimeMs = SearchConstants::kZero;
     int maxTimeMs = SearchConstants::kZero;
     int tbHits = SearchConstants::kZero;
+    // Stops the search once nodeCount reaches it; 0 searches without a node limit.
+    int nodeLimit = SearchConstants::kZero;
     bool useSyzygy = false;
 
     int continuationHistory[SearchConstants::kPieceTypeCount][SearchConstants::kBoardSquareCount]
@@ -282,6 +291,7 @@ struct SearchResult {
     int depth;
     int nodes;
     int timeMs;
+    EvalCacheStats evalCache;
     SearchResult();
 };
 
@@ -300,6 +310,7 @@ struct SearchConfig {
 struct SearchContext {
     int threads = SearchConstants::kOne;
     int hashSizeMb = SearchConstants::kDefaultTranspositionTableMb;
+    int pawnHashSizeMb = DEFAULT_PAWN_HASH_MB;
 };
 
 void InitZobrist();
@@ -339,6 +350,12 @@ std::vector<Move> GetAllMoves(Board& board, ChessPieceColor color);
 std::string getBookMove(const std::string& fen);
 SearchResult iterativeDeepeningParallel(Board& board, const SearchConfig& config,
                                         SearchContext& searchContext);
+// Single-threaded iterative deepening that stops after nodeLimit nodes or, when timeLimitMs is
+// positive, after that many milliseconds, or after the first iteration if that alone takes more,
+// and returns the deepest completed iteration. The caller owns the context, so its transposition
+// table and histories carry over from one search to the next; set repetitionHistory before calling.
+SearchResult searchFixedNodes(Board& board, ParallelSearchContext& context, int nodeLimit,
+                              int maxDepth, int timeLimitMs = 0);
 int PrincipalVariationSearch(Board& board, int depth, int alpha, int beta, bool maximizingPlayer,
                              int ply, ThreadSafeHistory& historyTable,
                              ParallelSearchContext& context, bool isPVNode = true,
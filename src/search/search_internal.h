@@ -142,8 +142,9 @@ inline constexpr int kPositionalScoreDivisor = 10;
 
 inline constexpr int kContinuationPlyLimit = 64;
 inline constexpr int kZeroWindowOffset = 1;
-inline constexpr int kFastEvalDepthThreshold = 6;
-inline constexpr int kFastEvalQuiescencePlyThreshold = 2;
+inline constexpr int kLazyEvalDepthThreshold = 6;
+inline constexpr int kLazyEvalQuiescencePlyThreshold = 2;
+inline constexpr int kLazyEvalMargin = 150;
 inline constexpr std::uint64_t kUnsetZobristKey = std::numeric_limits<std::uint64_t>::max();
 inline constexpr int kZobristCastlingStateCount = 16;
 inline constexpr int kNoEpSquare = kInvalidSquare;
@@ -202,20 +203,8 @@ struct MoveApplicationData {
     Bitboard previousWhitePieces = EMPTY;
     Bitboard previousBlackPieces = EMPTY;
     Bitboard previousAllPieces = EMPTY;
-};
-
-class ScopedFastEvalMode {
-public:
-    explicit ScopedFastEvalMode(bool enableFast) : previousMode(isFastEvaluationMode()) {
-        setFastEvaluationMode(enableFast);
-    }
-
-    ~ScopedFastEvalMode() {
-        setFastEvaluationMode(previousMode);
-    }
-
-private:
-    bool previousMode;
+    std::uint64_t previousPawnKey = 0;
+    PackedScore previousPsqScore = ZERO_SCORE;
 };
 
 struct BitboardMoveState {
@@ -230,6 +219,7 @@ struct RootSplitResult {
     int score = kZero;
     Move bestMove = {kInvalidSquare, kInvalidSquare};
     int nodes = kZero;
+    EvalCacheStats evalCache;
     bool hasLegalMove = false;
     bool timeExpired = false;
 };
@@ -342,6 +332,7 @@ struct RootSplitSharedState {
     int depth = kZero;
     bool maximizingPlayer = true;
     int hashSizeMb = SearchConstants::kDefaultTranspositionTableMb;
+    int pawnHashSizeMb = DEFAULT_PAWN_HASH_MB;
     ThreadSafeHistory historySeed;
     std::vector<uint64_t> repetitionHistory;
     std::chrono::steady_clock::time_point startTime;
@@ -352,6 +343,8 @@ struct RootSplitSharedState {
     bool useSyzygy = false;
     std::atomic<int> nextMoveIndex{0};
     std::atomic<long long> nodes{0};
+    std::atomic<std::uint64_t> evalCacheProbes{0};
+    std::atomic<std::uint64_t> evalCacheHits{0};
     std::atomic<bool> stop{false};
     std::atomic<bool> timeExpired{false};
     std::mutex bestMutex;
@@ -371,6 +364,11 @@ Bitboard attackersToSquare(const Bitboard pieces[2][kPieceTypePerColorCount], Bi
 bool popLeastValuableAttacker(const Bitboard pieces[2][kPieceTypePerColorCount], Bitboard attackers,
                               int colorIndex, int& attackerSquareOut, int& attackerPieceOut);
 int computeGamePhase(const Board& board);
+EvalWindow lazyEvalWindow(int alpha, int beta);
+int evaluateForSearch(const Board& board, ParallelSearchContext& context,
+                      const EvalWindow& window = EvalWindow{});
+int evaluateForSearch(const Board& board, ParallelSearchContext& context, uint64_t zobristKey,
+                      const EvalWindow& window = EvalWindow{});
 bool applyMoveToBitboards(const Board& board, int fromSquare, int toSquare, bool autoPromoteToQueen,
                           BitboardMoveState& state);
 uint64_t resolveZobristKey(const Board& board, uint64_t key);
@@ -380,6 +378,10 @@ uint64_t computeChildZobrist(uint64_t parentKey, const Board& childBoard, int fr
 bool applySearchMoveWithData(Board& board, int fromSquare, int toSquare, bool autoPromoteToQueen,
                              MoveApplicationData* moveDataOut = nullptr);
 void undoSearchMoveWithData(Board& board, const MoveApplicationData& moveData);
+bool makeSearchMove(Board& board, Move move, MoveApplicationData& moveData,
+                    ParallelSearchContext& context);
+void unmakeSearchMove(Board& board, const MoveApplicationData& moveData,
+                      ParallelSearchContext& context);
 bool hasNonPawnMaterial(const Board& board, ChessPieceColor side);
 int computeNullMoveReduction(int depth, int evalMargin);
 int toTtScore(int score, int ply);
@@ -395,13 +397,14 @@ int chooseRootSplitWorkerCount(int depth, int numThreads, int remainingMoves);
 bool isPreferredRootMove(Move lhs, Move rhs);
 bool checkRootSplitTimeLimit(RootSplitSharedState& shared);
 bool evaluateRootSplitMove(const RootSplitSharedState& shared, Move move, int alphaWindow,
-                           int betaWindow, int& evalOut, int& nodesOut);
+                           int betaWindow, int& evalOut, int& nodesOut,
+                           EvalCacheStats& evalCacheOut);
 void commitRootSplitResult(RootSplitSharedState& shared, int eval, Move move);
 void rootSplitWorker(RootSplitSharedState& shared);
 RootSplitResult searchRootMovesYBWC(const Board& board, int depth, int alpha, int beta,
                                     bool maximizingPlayer, const ThreadSafeHistory& historyTable,
                                     const ParallelSearchContext& context, int numThreads,
-                                    int hashSizeMb);
+                                    int hashSizeMb, int pawnHashSizeMb);
 int staticExchangeEvaluation(const Board& board, int fromSquare, int toSquare);
 bool isPromotion(const Board& board, int from, int to);
 bool isCastling(const Board& board, int from, int to);
@@ -47,6 +47,10 @@ bool countNodeAndCheckTime(ParallelSearchContext& context) {
     }
 
     ++context.nodeCount;
+    if (context.nodeLimit > kZero && context.nodeCount >= context.nodeLimit) {
+        context.stopSearch = true;
+        return false;
+    }
     if ((context.nodeCount & kTimeCheckMask) != kZero) {
         return true;
     }
@@ -94,8 +98,7 @@ int QuiescenceSearch(Board& board, int alpha, int beta, bool maximizingPlayer,
                      ThreadSafeHistory& historyTable, ParallelSearchContext& context, int ply,
                      uint64_t zobristKey) {
     if (ply < kZero || ply >= kMaxSearchPly) {
-        ScopedFastEvalMode fastEvalScope(true);
-        return evaluatePosition(board, context.contempt);
+        return evaluateForSearch(board, context, lazyEvalWindow(alpha, beta));
     }
 
     if (board.halfmoveClock >= 100) {
@@ -146,9 +149,9 @@ int QuiescenceSearch(Board& board, int alpha, int beta, bool maximizingPlayer,
         return mateScore;
     }
 
-    const bool useFastEval = !inCheck && ply > kFastEvalQuiescencePlyThreshold;
-    ScopedFastEvalMode fastEvalScope(useFastEval);
-    int standPat = evaluatePosition(board, context.contempt);
+    const bool useLazyEval = !inCheck && ply > kLazyEvalQuiescencePlyThreshold;
+    int standPat = evaluateForSearch(board, context, nodeZobristKey,
+                                     useLazyEval ? lazyEvalWindow(alpha, beta) : EvalWindow{});
 
     if (inCheck) {
         standPat = maximizingPlayer ? -kMateScore : kMateScore;
@@ -251,14 +254,14 @@ int QuiescenceSearch(Board& board, int alpha, int beta, bool maximizingPlayer,
 
         const Move move = pickNextScoredMove(scoredMoves, scoredIndex).move;
         MoveApplicationData moveData{};
-        if (!applySearchMoveWithData(board, move.first, move.second, true, &moveData)) {
+        if (!makeSearchMove(board, move, moveData, context)) {
             continue;
         }
         uint64_t childZobristKey =
             computeChildZobrist(nodeZobristKey, board, move.first, move.second, moveData);
 
         if (isInCheck(board, currentColor)) {
-            undoSearchMoveWithData(board, moveData);
+            unmakeSearchMove(board, moveData, context);
             continue;
         }
         board.turn = (board.turn == ChessPieceColor::WHITE) ? ChessPieceColor::BLACK
@@ -266,7 +269,7 @@ int QuiescenceSearch(Board& board, int alpha, int beta, bool maximizingPlayer,
 
         int eval = QuiescenceSearch(board, alpha, beta, !maximizingPlayer, historyTable, context,
                                     ply + kOne, childZobristKey);
-        undoSearchMoveWithData(board, moveData);
+        unmakeSearchMove(board, moveData, context);
         if (context.stopSearch) {
             return kZero;
         }
@@ -378,8 +381,9 @@ int PrincipalVariationSearch(Board& board, int depth, int alpha, int beta, bool
     }
     TTEntry ttData = ttEntry.value_or(TTEntry{});
 
-    ScopedFastEvalMode fastEvalScope(!isPVNode && depth <= kFastEvalDepthThreshold);
-    int staticEval = evaluatePosition(board, context.contempt);
+    const bool useLazyEval = !isPVNode && depth <= kLazyEvalDepthThreshold;
+    int staticEval = evaluateForSearch(board, context, nodeZobristKey,
+                                       useLazyEval ? lazyEvalWindow(alpha, beta) : EvalWindow{});
     int gamePhase = computeGamePhase(board);
 
     if (!isPVNode) {
@@ -432,7 +436,9 @@ int PrincipalVariationSearch(Board& board, int depth, int alpha, int beta, bool
             }
         }
 
-        if (AdvancedSearch::multiCutPruning(board, depth, alpha, beta, kMultiCutReductionMoves)) {
+        // Multi-cut verifies on a private context whose nodes a node limit cannot see.
+        if (context.nodeLimit == kZero &&
+            AdvancedSearch::multiCutPruning(board, depth, alpha, beta, kMultiCutReductionMoves)) {
             return beta;
         }
     }
@@ -514,14 +520,14 @@ int PrincipalVariationSearch(Board& board, int depth, int alpha, int beta, bool
         }
 
         MoveApplicationData moveData{};
-        if (!applySearchMoveWithData(board, move.first, move.second, true, &moveData)) {
+        if (!makeSearchMove(board, move, moveData, context)) {
             continue;
         }
         uint64_t childZobristKey =
             computeChildZobrist(nodeZobristKey, board, move.first, move.second, moveData);
         isCaptureMove = moveData.captureSquare >= kZero;
         if (isInCheck(board, movingColor)) {
-            undoSearchMoveWithData(board, moveData);
+            unmakeSearchMove(board, moveData, context);
             continue;
         }
 
@@ -589,7 +595,7 @@ int PrincipalVariationSearch(Board& board, int depth, int alpha, int beta, bool
             }
         }
 
-        undoSearchMoveWithData(board, moveData);
+        unmakeSearchMove(board, moveData, context);
 
         movesSearched++;
         if (!isCaptureMove) {
@@ -778,9 +784,10 @@ int AlphaBetaSearch(Board& board, int depth, int alpha, int beta, bool maximizin
         return drawScore;
     }
 
-    ScopedFastEvalMode fastEvalScope(depth <= kFastEvalDepthThreshold);
     const bool sideInCheck = isInCheck(board, currentColor);
-    int staticEval = evaluatePosition(board, context.contempt);
+    int staticEval = evaluateForSearch(
+        board, context, nodeZobristKey,
+        depth <= kLazyEvalDepthThreshold ? lazyEvalWindow(alpha, beta) : EvalWindow{});
 
     if (depth >= kNullMoveMinDepth && depth <= kNullMoveMaxDepth && ply < kNullMovePlyLimit &&
         !sideInCheck && hasNonPawnMaterial(board, currentColor)) {
@@ -882,14 +889,14 @@ int AlphaBetaSearch(Board& board, int depth, int alpha, int beta, bool maximizin
             }
 
             MoveApplicationData moveData{};
-            if (!applySearchMoveWithData(board, move.first, move.second, true, &moveData)) {
+            if (!makeSearchMove(board, move, moveData, context)) {
                 continue;
             }
             uint64_t childZobristKey =
                 computeChildZobrist(nodeZobristKey, board, move.first, move.second, moveData);
 
             if (isInCheck(board, currentColor)) {
-                undoSearchMoveWithData(board, moveData);
+                unmakeSearchMove(board, moveData, context);
                 continue;
             }
             board.turn = (board.turn == ChessPieceColor::WHITE) ? ChessPieceColor::BLACK
@@ -950,7 +957,7 @@ int AlphaBetaSearch(Board& board, int depth, int alpha, int beta, bool maximizin
                 }
             }
 
-            undoSearchMoveWithData(board, moveData);
+            unmakeSearchMove(board, moveData, context);
 
             moveCount++;
             if (context.stopSearch) {
@@ -1041,14 +1048,14 @@ int AlphaBetaSearch(Board& board, int depth, int alpha, int beta, bool maximizin
             }
 
             MoveApplicationData moveData{};
-            if (!applySearchMoveWithData(board, move.first, move.second, true, &moveData)) {
+            if (!makeSearchMove(board, move, moveData, context)) {
                 continue;
             }
             uint64_t childZobristKey =
                 computeChildZobrist(nodeZobristKey, board, move.first, move.second, moveData);
 
             if (isInCheck(board, currentColor)) {
-                undoSearchMoveWithData(board, moveData);
+                unmakeSearchMove(board, moveData, context);
                 continue;
             }
             board.turn = (board.turn == ChessPieceColor::WHITE) ? ChessPieceColor::BLACK
@@ -1109,7 +1116,7 @@ int AlphaBetaSearch(Board& board, int depth, int alpha, int beta, bool maximizin
                 }
             }
 
-            undoSearchMoveWithData(board, moveData);
+            unmakeSearchMove(board, moveData, context);
 
             moveCount++;
             if (context.stopSearch) {
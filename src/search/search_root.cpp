@@ -55,7 +55,8 @@ bool checkRootSplitTimeLimit(RootSplitSharedState& shared) {
 }
 
 bool evaluateRootSplitMove(const RootSplitSharedState& shared, Move move, int alphaWindow,
-                           int betaWindow, int& evalOut, int& nodesOut) {
+                           int betaWindow, int& evalOut, int& nodesOut,
+                           EvalCacheStats& evalCacheOut) {
     if (shared.depth <= kZero || shared.board == nullptr) {
         return false;
     }
@@ -88,11 +89,13 @@ bool evaluateRootSplitMove(const RootSplitSharedState& shared, Move move, int al
     localContext.useSyzygy = shared.useSyzygy;
     localContext.transTable.resize(std::max(kOne, shared.hashSizeMb));
     localContext.transTable.newSearch();
+    localContext.pawnHash.resize(shared.pawnHashSizeMb);
 
     evalOut = AlphaBetaSearch(newBoard, shared.depth - kOne, alphaWindow, betaWindow,
                               !shared.maximizingPlayer, kOne, localHistory, localContext,
                               childZobristKey);
     nodesOut = localContext.nodeCount;
+    evalCacheOut = localContext.evalCache.stats();
     return true;
 }
 
@@ -139,11 +142,15 @@ void rootSplitWorker(RootSplitSharedState& shared) {
 
         int eval = kZero;
         int nodes = kZero;
-        if (!evaluateRootSplitMove(shared, move, alphaWindow, betaWindow, eval, nodes)) {
+        EvalCacheStats evalCache;
+        if (!evaluateRootSplitMove(shared, move, alphaWindow, betaWindow, eval, nodes,
+                                   evalCache)) {
             continue;
         }
 
         shared.nodes.fetch_add(nodes, std::memory_order_relaxed);
+        shared.evalCacheProbes.fetch_add(evalCache.probes, std::memory_order_relaxed);
+        shared.evalCacheHits.fetch_add(evalCache.hits, std::memory_order_relaxed);
         commitRootSplitResult(shared, eval, move);
     }
 }
@@ -151,7 +158,7 @@ void rootSplitWorker(RootSplitSharedState& shared) {
 RootSplitResult searchRootMovesYBWC(const Board& board, int depth, int alpha, int beta,
                                     bool maximizingPlayer, const ThreadSafeHistory& historyTable,
                                     const ParallelSearchContext& context, int numThreads,
-                                    int hashSizeMb) {
+                                    int hashSizeMb, int pawnHashSizeMb) {
     RootSplitResult result;
     if (numThreads <= kOne || depth <= kZero) {
         return result;
@@ -196,6 +203,7 @@ RootSplitResult searchRootMovesYBWC(const Board& board, int depth, int alpha, in
     shared.depth = depth;
     shared.maximizingPlayer = maximizingPlayer;
     shared.hashSizeMb = std::max(kOne, hashSizeMb);
+    shared.pawnHashSizeMb = std::max(kOne, pawnHashSizeMb);
     shared.historySeed = historyTable;
     shared.repetitionHistory = context.repetitionHistory;
     shared.startTime = context.startTime;
@@ -212,12 +220,15 @@ RootSplitResult searchRootMovesYBWC(const Board& board, int depth, int alpha, in
     for (int i = kZero; i < static_cast<int>(rootMoves.size()); ++i) {
         int eval = kZero;
         int nodes = kZero;
+        EvalCacheStats evalCache;
         if (!evaluateRootSplitMove(shared, rootMoves[static_cast<std::size_t>(i)].move,
-                                   shared.alpha, shared.beta, eval, nodes)) {
+                                   shared.alpha, shared.beta, eval, nodes, evalCache)) {
             continue;
         }
 
         shared.nodes.fetch_add(nodes, std::memory_order_relaxed);
+        shared.evalCacheProbes.fetch_add(evalCache.probes, std::memory_order_relaxed);
+        shared.evalCacheHits.fetch_add(evalCache.hits, std::memory_order_relaxed);
         commitRootSplitResult(shared, eval, rootMoves[static_cast<std::size_t>(i)].move);
         seededIndex = i;
         break;
@@ -257,6 +268,8 @@ RootSplitResult searchRootMovesYBWC(const Board& board, int depth, int alpha, in
     const long long totalNodes = shared.nodes.load(std::memory_order_relaxed);
     result.nodes = (totalNodes > std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max()
                                                                   : static_cast<int>(totalNodes);
+    result.evalCache.probes = shared.evalCacheProbes.load(std::memory_order_relaxed);
+    result.evalCache.hits = shared.evalCacheHits.load(std::memory_order_relaxed);
     result.timeExpired = shared.timeExpired.load(std::memory_order_relaxed);
     return result;
 }
@@ -280,10 +293,11 @@ SearchResult iterativeDeepeningParallel(Board& board, const SearchConfig& config
     const int maxTimeMs = config.maxTimeMs;
     const int numThreads = std::max(kOne, searchContext.threads);
     const int hashSizeMb = std::max(kOne, searchContext.hashSizeMb);
+    const int pawnHashSizeMb = std::max(kOne, searchContext.pawnHashSizeMb);
 
     if (numThreads > kOne && multiPV == kOne) {
         auto smpStart = std::chrono::steady_clock::now();
-        LazySMP smp(numThreads, hashSizeMb, contempt);
+        LazySMP smp(numThreads, hashSizeMb, contempt, pawnHashSizeMb);
         SearchResult smpResult = smp.search(board, maxDepth, timeLimitMs);
         const auto smpElapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                                       std::chrono::steady_clock::now() - smpStart)
@@ -309,6 +323,7 @@ SearchResult iterativeDeepeningParallel(Board& board, const SearchConfig& config
     context.useSyzygy = !Syzygy::getPath().empty();
     context.transTable.resize(std::max(SearchConstants::kOne, hashSizeMb));
     context.transTable.newSearch();
+    context.pawnHash.resize(pawnHashSizeMb);
     int lastScore = kZero;
     const int aspirationWindow = SearchTuning::aspirationWindow();
     std::string fen = getFEN(board);
@@ -391,11 +406,13 @@ SearchResult iterativeDeepeningParallel(Board& board, const SearchConfig& config
                 if (shouldUseRootSplitAttempt) {
                     RootSplitResult rootSplitResult = searchRootMovesYBWC(
                         board, depth, alpha, beta, board.turn == ChessPieceColor::WHITE,
-                        context.historyTable, context, numThreads, hashSizeMb);
+                        context.historyTable, context, numThreads, hashSizeMb,
+                        pawnHashSizeMb);
                     if (rootSplitResult.hasLegalMove) {
                         searchScore = rootSplitResult.score;
                         depthBestMove = rootSplitResult.bestMove;
                         context.nodeCount += rootSplitResult.nodes;
+                        context.evalCache.mergeStats(rootSplitResult.evalCache);
                         if (rootSplitResult.timeExpired) {
                             context.stopSearch = true;
                         }
@@ -517,6 +534,90 @@ SearchResult iterativeDeepeningParallel(Board& board, const SearchConfig& config
         std::chrono::duration_cast<std::chrono::milliseconds>(endTime - context.startTime).count();
     result.timeMs = (elapsedMs > std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max()
                                                                   : static_cast<int>(elapsedMs);
+    result.evalCache = context.evalCache.stats();
 
     return result;
 }
+
+SearchResult searchFixedNodes(Board& board, ParallelSearchContext& context, int nodeLimit,
+                              int maxDepth, int timeLimitMs) {
+    SearchResult result;
+    context.startTime = std::chrono::steady_clock::now();
+    context.timeLimitMs = kZero;
+    // The first iteration always completes so there is a score and a move to return.
+    context.nodeLimit = kZero;
+    context.nodeCount = kZero;
+    context.stopSearch = false;
+    context.nnueStack.clear();
+    context.nnueBitboardStack.clear();
+    context.transTable.newSearch();
+
+    std::vector<Move> legalMoves;
+    for (const auto& move : GetAllMoves(board, board.turn)) {
+        if (IsMoveLegal(board, move.first, move.second)) {
+            legalMoves.push_back(move);
+        }
+    }
+
+    const uint64_t rootZobristKey = ComputeZobrist(board);
+    const bool maximizingPlayer = board.turn == ChessPieceColor::WHITE;
+    const int aspirationWindow = SearchTuning::aspirationWindow();
+    for (int depth = kOne; depth <= maxDepth; ++depth) {
+        int alpha = -kMateScore;
+        int beta = kMateScore;
+        if (depth > kEarlyDepthNoAspirationLimit) {
+            alpha = result.score - aspirationWindow;
+            beta = result.score + aspirationWindow;
+        }
+
+        int searchScore = kZero;
+        for (int attempt = kOne;; ++attempt) {
+            searchScore = PrincipalVariationSearch(board, depth, alpha, beta, maximizingPlayer,
+                                                   kZero, context.historyTable, context, true,
+                                                   rootZobristKey);
+            if (context.stopSearch || attempt >= kMaxSearchAttempts) {
+                break;
+            }
+            if (searchScore <= alpha) {
+                alpha = std::max(alpha - (aspirationWindow * (kOne << attempt)), -kMateScore);
+            } else if (searchScore >= beta) {
+                beta = std::min(beta + (aspirationWindow * (kOne << attempt)), kMateScore);
+            } else {
+                break;
+            }
+        }
+        if (context.stopSearch) {
+            break;
+        }
+
+        result.score = searchScore;
+        result.depth = depth;
+        if (const auto rootEntry = context.transTable.find(rootZobristKey);
+            rootEntry && moveExistsInList(legalMoves, rootEntry->bestMove)) {
+            result.bestMove = rootEntry->bestMove;
+        }
+        // The next iteration takes longer than all before it, so none starts past half the time.
+        if (context.nodeCount >= nodeLimit ||
+            (timeLimitMs > kZero && isTimeUp(context.startTime, timeLimitMs / kTwo))) {
+            break;
+        }
+        context.nodeLimit = nodeLimit;
+        context.timeLimitMs = timeLimitMs;
+    }
+
+    if (result.bestMove.first < kZero && !legalMoves.empty()) {
+        std::vector<ScoredMove> scoredMoves = scoreMovesOptimized(
+            board, legalMoves, context.historyTable, context.killerMoves, kZero);
+        std::ranges::sort(scoredMoves, std::greater<ScoredMove>());
+        result.bestMove = scoredMoves[kZero].move;
+    }
+    result.nodes = context.nodeCount;
+    context.nodeLimit = kZero;
+    context.timeLimitMs = kZero;
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - context.startTime)
+                               .count();
+    result.timeMs = (elapsedMs > std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max()
+                                                                  : static_cast<int>(elapsedMs);
+    return result;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// `--key=value` options and `--flag` switches for the command-line tools. Arguments are matched
+// wherever they appear, so positional arguments can be passed along unchanged.
+namespace CommandLine {
+
+// The value of the first --key=value argument, or fallback if there is none.
+[[nodiscard]] inline std::string option(const std::vector<std::string>& args, std::string_view key,
+                                        std::string_view fallback) {
+    const std::string prefix = "--" + std::string(key) + "=";
+    for (const std::string& arg : args) {
+        if (arg.starts_with(prefix)) {
+            return arg.substr(prefix.size());
+        }
+    }
+    return std::string(fallback);
+}
+
+// The values of every --key=value argument, in order.
+[[nodiscard]] inline std::vector<std::string> repeatedOption(const std::vector<std::string>& args,
+                                                             std::string_view key) {
+    const std::string prefix = "--" + std::string(key) + "=";
+    std::vector<std::string> values;
+    for (const std::string& arg : args) {
+        if (arg.starts_with(prefix)) {
+            values.push_back(arg.substr(prefix.size()));
+        }
+    }
+    return values;
+}
+
+[[nodiscard]] inline bool hasFlag(const std::vector<std::string>& args, std::string_view flag) {
+    const std::string expected = "--" + std::string(flag);
+    for (const std::string& arg : args) {
+        if (arg == expected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace CommandLine
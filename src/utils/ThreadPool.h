@@ -0,0 +1,118 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. run() hands out task indices to the
+// workers and the calling thread and returns once every index has finished, so the same pool
+// can be reused for every batch without respawning threads.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0) {
+        if (threads <= 0) {
+            const unsigned int hardware = std::thread::hardware_concurrency();
+            threads = hardware == 0U ? 1 : static_cast<int>(hardware);
+        }
+        workers_.reserve(static_cast<std::size_t>(threads - 1));
+        for (int i = 1; i < threads; ++i) {
+            workers_.emplace_back([this](const std::stop_token& token) { workerLoop(token); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& worker : workers_) {
+                worker.request_stop();
+            }
+        }
+        wake_.notify_all();
+        // Join before the mutex and condition variables are destroyed.
+        workers_.clear();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    int size() const {
+        return static_cast<int>(workers_.size()) + 1;
+    }
+
+    // Calls task(i) once for every i in [0, count). Indices run in no particular order or
+    // thread; callers that need reproducible results must combine per-index outputs themselves.
+    void run(std::size_t count, const std::function<void(std::size_t)>& task) {
+        if (count == 0) {
+            return;
+        }
+        std::uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            count_ = count;
+            next_ = 0;
+            pending_ = count;
+            generation = ++generation_;
+        }
+        wake_.notify_all();
+        drain(generation);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    void workerLoop(const std::stop_token& token) {
+        std::uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return token.stop_requested() || generation_ != seen; });
+                if (token.stop_requested()) {
+                    return;
+                }
+                seen = generation_;
+            }
+            drain(seen);
+        }
+    }
+
+    // Indices are claimed under the lock together with the generation check, so a worker that
+    // wakes late can never pick up an index of a newer run with the previous run's task.
+    void drain(std::uint64_t generation) {
+        while (true) {
+            const std::function<void(std::size_t)>* task = nullptr;
+            std::size_t index = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (generation != generation_ || task_ == nullptr || next_ >= count_) {
+                    return;
+                }
+                task = task_;
+                index = next_++;
+            }
+            (*task)(index);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) {
+                done_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::jthread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(std::size_t)>* task_ = nullptr;
+    std::size_t count_ = 0;
+    std::size_t next_ = 0;
+    std::size_t pending_ = 0;
+    std::uint64_t generation_ = 0;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -24,10 +26,25 @@ public:
         return reg;
     }
 
-    void add(std::string_view name, std::reference_wrapper<int> value, int def, int min, int max,
-             int step) {
+#ifdef CHESS_ENGINE_THREAD_PARAMS
+    // Values the calling thread reads instead of the registered globals, indexed like all(). The
+    // match runner points each worker at the set of the engine it is searching for.
+    static inline thread_local const std::vector<int>* threadValues = nullptr;
+
+    static int read(int global, std::size_t index) {
+        return threadValues != nullptr ? (*threadValues)[index] : global;
+    }
+#else
+    static int read(int global, std::size_t /*index*/) {
+        return global;
+    }
+#endif
+
+    std::size_t add(std::string_view name, std::reference_wrapper<int> value, int def, int min,
+                    int max, int step) {
         value.get() = def;
         params.push_back({std::string(name), value, def, min, max, step});
+        return params.size() - 1;
     }
 
     [[nodiscard]] const std::vector<TunableParam>& all() const {
@@ -47,6 +64,35 @@ public:
         return false;
     }
 
+    // The current global values, indexed like all().
+    [[nodiscard]] std::vector<int> values() const {
+        std::vector<int> result;
+        result.reserve(params.size());
+        for (const auto& param : params) {
+            result.push_back(param.value.get());
+        }
+        return result;
+    }
+
+    // Like set(), but on a value set from values() instead of the globals.
+    bool set(std::vector<int>& values, std::string_view name, int val) const {
+        const auto index = indexOf(name);
+        if (!index || val < params[*index].minValue || val > params[*index].maxValue) {
+            return false;
+        }
+        values[*index] = val;
+        return true;
+    }
+
+    [[nodiscard]] std::optional<std::size_t> indexOf(std::string_view name) const {
+        for (std::size_t index = 0; index < params.size(); ++index) {
+            if (params[index].name == name) {
+                return index;
+            }
+        }
+        return std::nullopt;
+    }
+
     [[nodiscard]] const TunableParam* find(std::string_view name) const {
         for (const auto& param : params) {
             if (param.name == name) {
@@ -65,10 +111,11 @@ public:
 
 #define TUNABLE(name, def, min, max, step)                                                         \
     inline int TUNABLE_##name = def;                                                               \
-    inline const bool TUNABLE_REGISTERED_##name = [] {                                             \
-        TunableRegistry::instance().add(#name, std::ref(TUNABLE_##name), def, min, max, step);     \
-        return true;                                                                               \
-    }()
+    inline const std::size_t TUNABLE_INDEX_##name =                                                \
+        TunableRegistry::instance().add(#name, std::ref(TUNABLE_##name), def, min, max, step)
+
+// Reads a parameter as the calling thread sees it; see TunableRegistry::threadValues.
+#define TUNABLE_VALUE(name) TunableRegistry::read(TUNABLE_##name, TUNABLE_INDEX_##name)
 
 TUNABLE(LMR_BASE, 75, 50, 120, 5);
 TUNABLE(LMR_DIVISOR, 300, 200, 500, 10);
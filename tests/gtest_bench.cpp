@@ -0,0 +1,79 @@
+#include "core/ChessBoard.h"
+#include "search/Bench.h"
+#include "search/search.h"
+#include "test_helpers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class BenchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+    }
+};
+
+TEST_F(BenchTest, PositionsAreDistinctAndPlayable) {
+    const auto& fens = Bench::positions();
+    EXPECT_GE(fens.size(), 50U);
+    std::unordered_set<std::uint64_t> keys;
+    for (const std::string& fen : fens) {
+        Board board;
+        ASSERT_TRUE(board.fromFEN(fen).has_value()) << fen;
+        EXPECT_TRUE(keys.insert(ComputeZobrist(board)).second) << fen;
+        EXPECT_FALSE(GetAllMoves(board, board.turn).empty()) << fen;
+    }
+}
+
+TEST_F(BenchTest, ParsesDepthThreadsAndHash) {
+    const Bench::Config defaults = Bench::parseArgs({});
+    EXPECT_EQ(defaults.depth, Bench::kDefaultDepth);
+    EXPECT_EQ(defaults.threads, Bench::kDefaultThreads);
+    EXPECT_EQ(defaults.hashMb, Bench::kDefaultHashMb);
+
+    const Bench::Config config = Bench::parseArgs({"7", "2", "64"});
+    EXPECT_EQ(config.depth, 7);
+    EXPECT_EQ(config.threads, 2);
+    EXPECT_EQ(config.hashMb, 64);
+    EXPECT_EQ(Bench::parseArgs({"x", "0"}).depth, Bench::kDefaultDepth);
+    EXPECT_EQ(Bench::parseArgs({"x", "0"}).threads, Bench::kDefaultThreads);
+}
+
+TEST_F(BenchTest, FormatsPositionAndSummaryLines) {
+    SearchResult searched;
+    searched.nodes = 1234;
+    EXPECT_EQ(Bench::positionLine(0, searched),
+              std::format("Position 1/{}: 1234 nodes", Bench::positions().size()));
+
+    const Bench::Config config = Bench::parseArgs({"7", "2", "64"});
+    Bench::Result result;
+    result.nodes = 5000;
+    result.elapsedMs = 250;
+    const std::vector<std::string> expected = {
+        "===========================",
+        "Depth 7, threads 2, hash 64 MB",
+        "Total time (ms) : 250",
+        "Nodes searched  : 5000",
+        "Nodes/second    : 20000",
+    };
+    EXPECT_EQ(Bench::summaryLines(config, result), expected);
+}
+
+TEST_F(BenchTest, SingleThreadedNodeCountIsRepeatable) {
+    Bench::Config config;
+    config.depth = 2;
+    config.hashMb = 1;
+    std::size_t reports = 0;
+    const Bench::Result first =
+        Bench::run(config, [&](std::size_t, const SearchResult& searched) {
+            EXPECT_GT(searched.nodes, 1);
+            ++reports;
+        });
+    EXPECT_EQ(reports, Bench::positions().size());
+    EXPECT_GT(first.nodes, 0U);
+    EXPECT_EQ(Bench::run(config).nodes, first.nodes);
+}
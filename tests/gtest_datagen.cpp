@@ -0,0 +1,75 @@
+#include "ai/Datagen.h"
+#include "ai/PositionFile.h"
+#include "core/ChessBoard.h"
+#include "test_helpers.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+class DatagenTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+    }
+};
+
+TEST_F(DatagenTest, FixedNodeSearchStopsAtNodeLimit) {
+    Board board;
+    board.InitializeFromFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    const std::string fen = board.toFEN();
+    auto context = std::make_unique<ParallelSearchContext>(1);
+    for (const int limit : {5000, 20000}) {
+        const SearchResult result = searchFixedNodes(board, *context, limit, 64);
+        EXPECT_LE(result.nodes, limit);
+        EXPECT_GE(result.depth, 1);
+        EXPECT_TRUE(isSearchMoveLegal(board, result.bestMove));
+        EXPECT_EQ(board.toFEN(), fen);
+    }
+    EXPECT_EQ(context->nodeLimit, 0);
+}
+
+TEST_F(DatagenTest, OpeningsAreReadFromEpd) {
+    const auto path = std::filesystem::temp_directory_path() / "datagen-openings.epd";
+    {
+        std::ofstream out(path);
+        out << "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 id \"e4\";\n\n"
+            << "rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq - bm d5;\n";
+    }
+    const auto openings = Datagen::loadOpenings(path.string());
+    ASSERT_EQ(openings.size(), 2U);
+    EXPECT_EQ(openings[0], "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    EXPECT_EQ(openings[1], "rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1");
+    std::filesystem::remove(path);
+}
+
+TEST_F(DatagenTest, WritesUniqueQuietPositions) {
+    Datagen::Config config;
+    config.games = 6;
+    config.threads = 2;
+    config.nodes = 1000;
+    config.hashMb = 1;
+    config.maxPlies = 60;
+    const auto path = std::filesystem::temp_directory_path() / "datagen-test.packed";
+    const auto stats = Datagen::generate(config, {}, path.string());
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->games, 6U);
+    EXPECT_GT(stats->positions, 0U);
+
+    PositionFile::Reader reader;
+    ASSERT_TRUE(reader.open(path.string()));
+    EXPECT_EQ(reader.size(), stats->positions);
+    std::unordered_set<std::uint64_t> keys;
+    PositionFile::PackedPosition packed;
+    while (reader.next(packed)) {
+        Board board;
+        packed.unpack(board);
+        EXPECT_TRUE(keys.insert(ComputeZobrist(board) ^ board.pawnKey).second) << board.toFEN();
+        EXPECT_FALSE(isInCheck(board, board.turn)) << board.toFEN();
+        EXPECT_LE(packed.result, 2);
+    }
+    EXPECT_EQ(keys.size(), stats->positions);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,103 @@
+#include "core/BitboardMoves.h"
+#include "core/ChessBoard.h"
+#include "evaluation/Evaluation.h"
+#include "gtest/gtest.h"
+#include "search/search.h"
+#include "test_helpers.h"
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr const char* kCorpusPath = "tests/data/eval_regression.epd";
+constexpr std::size_t kFenFieldCount = 4;
+
+struct RegressionCase {
+    std::string fen;
+    std::map<std::string, int> expected;
+};
+
+std::vector<RegressionCase> loadCorpus() {
+    std::vector<RegressionCase> cases;
+    std::ifstream input(kCorpusPath);
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        RegressionCase entry;
+        std::string field;
+        for (std::size_t i = 0; i < kFenFieldCount && fields >> field; ++i) {
+            entry.fen += (i == 0 ? "" : " ") + field;
+        }
+        std::string operation;
+        while (std::getline(fields, operation, ';')) {
+            std::istringstream parts(operation);
+            std::string opcode;
+            int value = 0;
+            if (parts >> opcode >> value) {
+                entry.expected.emplace(opcode, value);
+            }
+        }
+        cases.push_back(std::move(entry));
+    }
+    return cases;
+}
+
+int positionalTierEvaluation(const Board& board) {
+    EvalWindow window;
+    window.maxTier = EvalTier::POSITIONAL;
+    return evaluateTiered(board, window).score;
+}
+
+class EvalRegressionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+        setNNUEEnabled(false);
+    }
+};
+
+} // namespace
+
+TEST_F(EvalRegressionTest, EvaluationTermsMatchEpdCorpus) {
+    const std::vector<RegressionCase> cases = loadCorpus();
+    ASSERT_FALSE(cases.empty()) << "missing " << kCorpusPath;
+
+    const std::vector<std::pair<std::string, std::function<int(const Board&)>>> terms = {
+        {"pawns", [](const Board& b) { return evaluatePawnStructure(b); }},
+        {"mobility", [](const Board& b) { return evaluateMobility(b); }},
+        {"center", [](const Board& b) { return evaluateCenterControl(b); }},
+        {"kingw", [](const Board& b) { return evaluateKingSafety(b, ChessPieceColor::WHITE); }},
+        {"kingb", [](const Board& b) { return evaluateKingSafety(b, ChessPieceColor::BLACK); }},
+        {"hangw", [](const Board& b) { return evaluateHangingPieces(b, ChessPieceColor::WHITE); }},
+        {"hangb", [](const Board& b) { return evaluateHangingPieces(b, ChessPieceColor::BLACK); }},
+        {"qtrap", [](const Board& b) { return evaluateQueenTrapDanger(b); }},
+        {"tactical", [](const Board& b) { return evaluateTacticalSafety(b); }},
+        {"passedw", [](const Board& b) { return evaluatePassedPawns(b, ChessPieceColor::WHITE); }},
+        {"passedb", [](const Board& b) { return evaluatePassedPawns(b, ChessPieceColor::BLACK); }},
+        {"bpair", [](const Board& b) { return evaluateBishopPair(b); }},
+        {"rooks", [](const Board& b) { return evaluateRooksOnOpenFiles(b); }},
+        {"endgame", [](const Board& b) { return evaluateEndgame(b); }},
+        {"eval", [](const Board& b) { return evaluatePosition(b); }},
+        {"tier2", positionalTierEvaluation},
+    };
+
+    for (const auto& entry : cases) {
+        Board board;
+        board.InitializeFromFEN(entry.fen);
+        for (const auto& [opcode, term] : terms) {
+            const auto expected = entry.expected.find(opcode);
+            ASSERT_NE(expected, entry.expected.end()) << opcode << " missing for " << entry.fen;
+            EXPECT_EQ(term(board), expected->second) << opcode << " for " << entry.fen;
+        }
+    }
+}
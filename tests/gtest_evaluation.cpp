@@ -1,3 +1,4 @@
+#include "ai/EndgameTablebase.h"
 #include "core/BitboardMoves.h"
 #include "core/ChessBoard.h"
 #include "evaluation/Evaluation.h"
@@ -5,6 +6,8 @@
 #include "search/search.h"
 #include "test_helpers.h"
 
+#include <array>
+
 class EvaluationTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -67,3 +70,127 @@ TEST_F(EvaluationTest, CheckmatePositionScoresExtremelyHigh) {
 
     EXPECT_GT(std::abs(result.score), 9000);
 }
+
+TEST_F(EvaluationTest, PawnHashTableMatchesUncachedEvaluation) {
+    PawnHashTable pawnTable(1);
+    constexpr std::array<const char*, 4> kFens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+        "8/5k2/3p4/1p1Pp2p/pP2Pp1P/P4P1K/8/8 b - - 99 50",
+        "6k1/5ppp/8/8/1P6/8/5PPP/6K1 w - - 0 1"};
+
+    for (const char* fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        const int uncached = evaluatePosition(board);
+        EXPECT_EQ(evaluatePosition(board, 0, &pawnTable), uncached) << fen;
+        EXPECT_EQ(evaluatePosition(board, 0, &pawnTable), uncached) << fen;
+    }
+}
+
+TEST_F(EvaluationTest, PawnKeyTracksIncrementalMoves) {
+    Board board;
+    board.InitializeFromFEN("4k3/3P4/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    EXPECT_EQ(board.pawnKey, computePawnHash(board));
+
+    ASSERT_TRUE(applySearchMove(board, 36, 43));
+    EXPECT_EQ(board.pawnKey, computePawnHash(board));
+
+    ASSERT_TRUE(applySearchMove(board, 51, 59));
+    EXPECT_EQ(board.pawnKey, computePawnHash(board));
+
+    ASSERT_TRUE(board.movePiece(4, 12));
+    EXPECT_EQ(board.pawnKey, computePawnHash(board));
+}
+
+TEST_F(EvaluationTest, PawnHashTableSizeIsPowerOfTwo) {
+    PawnHashTable pawnTable(3);
+    EXPECT_GT(pawnTable.size(), 0U);
+    EXPECT_EQ(pawnTable.size() & (pawnTable.size() - 1), 0U);
+}
+
+TEST_F(EvaluationTest, MaterialTableDispatchesSpecializedEndgames) {
+    MaterialHashTable materialTable;
+    Board board;
+    board.InitializeFromFEN("8/8/4k3/8/8/8/3RK3/8 w - - 0 1");
+    EXPECT_EQ(materialTable.probe(board).endgameEvaluator, &EndgameKnowledge::evaluateKRK);
+    EXPECT_EQ(materialTable.probe(board).gamePhase, 2);
+
+    board.InitializeFromFEN("8/8/4k3/8/8/8/4K3/8 w - - 0 1");
+    EXPECT_EQ(materialTable.probe(board).endgameEvaluator, nullptr);
+    EXPECT_EQ(materialTable.probe(board).gamePhase, 0);
+}
+
+TEST_F(EvaluationTest, MaterialTableMatchesUncachedEvaluation) {
+    MaterialHashTable materialTable;
+    constexpr std::array<const char*, 3> kFens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+        "8/8/4k3/8/8/2B5/3BK3/8 b - - 0 1"};
+
+    for (const char* fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        EXPECT_EQ(computeMaterialEntry(board).gamePhase, materialTable.probe(board).gamePhase);
+        EXPECT_EQ(evaluatePosition(board, 0, nullptr, &materialTable), evaluatePosition(board))
+            << fen;
+    }
+}
+
+TEST_F(EvaluationTest, InsufficientMaterialScalesToDraw) {
+    Board board;
+    board.InitializeFromFEN("8/8/4k3/8/8/8/3NK3/8 w - - 0 1");
+    const MaterialHashEntry entry = computeMaterialEntry(board);
+    ASSERT_NE(entry.scaleFunction, nullptr);
+    EXPECT_EQ(entry.scaleFunction(board), SCALE_FACTOR_DRAW);
+}
+
+TEST_F(EvaluationTest, PackedScoreRoundTripsNegativeHalves) {
+    constexpr std::array<std::array<int, 2>, 4> kPairs = {
+        {{0, 0}, {-25, 40}, {310, -1200}, {-20000, -19950}}};
+    for (const auto& [mg, eg] : kPairs) {
+        const PackedScore score = makeScore(mg, eg);
+        EXPECT_EQ(mgValue(score), mg);
+        EXPECT_EQ(egValue(score), eg);
+    }
+    EXPECT_EQ(makeScore(-25, 40) + makeScore(310, -1200), makeScore(285, -1160));
+}
+
+TEST_F(EvaluationTest, PsqScoreTracksBoardMoves) {
+    Board board;
+    board.InitializeFromFEN("r3k2r/pppq1ppp/2n2n2/3pp3/3PP3/2N2N2/PPPQ1PPP/R3K2R w KQkq - 0 1");
+    EXPECT_EQ(board.psqScore, computePsqScore(board));
+
+    ASSERT_TRUE(board.movePiece(28, 35));
+    EXPECT_EQ(board.psqScore, computePsqScore(board));
+
+    ASSERT_TRUE(board.movePiece(42, 35));
+    EXPECT_EQ(board.psqScore, computePsqScore(board));
+
+    ASSERT_TRUE(applySearchMove(board, 4, 6));
+    EXPECT_EQ(board.psqScore, computePsqScore(board));
+}
+
+TEST_F(EvaluationTest, LazyEvaluationStopsOutsideWindow) {
+    Board board;
+    board.InitializeFromFEN("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 0 1");
+
+    const TieredEval full = evaluateTiered(board, EvalWindow{});
+    EXPECT_EQ(full.tier, EvalTier::TACTICAL);
+    EXPECT_EQ(full.score, evaluatePosition(board));
+
+    EvalWindow materialOnly;
+    materialOnly.maxTier = EvalTier::MATERIAL;
+    const TieredEval material = evaluateTiered(board, materialOnly);
+    EXPECT_EQ(material.tier, EvalTier::MATERIAL);
+
+    const EvalWindow farAbove{material.score + 2000, material.score + 2001, 100};
+    const TieredEval lazyLow = evaluateTiered(board, farAbove);
+    EXPECT_EQ(lazyLow.tier, EvalTier::MATERIAL);
+    EXPECT_EQ(lazyLow.score, material.score);
+
+    const EvalWindow aroundScore{full.score - 1, full.score + 1, 100};
+    const TieredEval inside = evaluateTiered(board, aroundScore);
+    EXPECT_EQ(inside.tier, EvalTier::TACTICAL);
+    EXPECT_EQ(inside.score, full.score);
+}
@@ -0,0 +1,89 @@
+#include "ai/MatchRunner.h"
+#include "core/PackedScore.h"
+#include "evaluation/EvalTrace.h"
+#include "evaluation/ParamPack.h"
+#include "test_helpers.h"
+#include "utils/TunableParams.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+MatchRunner::Config quickConfig(int games) {
+    MatchRunner::Config config;
+    config.games = games;
+    config.threads = 2;
+    config.nodes = 300;
+    config.hashMb = 1;
+    config.maxPlies = 160;
+    config.sprt = false;
+    return config;
+}
+} // namespace
+
+class MatchRunnerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+    }
+};
+
+TEST_F(MatchRunnerTest, EloAndLlrFollowThePairScores) {
+    MatchRunner::Stats even;
+    even.pairs = {0, 10, 30, 10, 0};
+    EXPECT_NEAR(MatchRunner::estimateElo(even).elo, 0.0, 1e-9);
+    EXPECT_GT(MatchRunner::estimateElo(even).margin, 0.0);
+    EXPECT_LT(MatchRunner::logLikelihoodRatio(even, 0.0, 5.0), 0.0);
+
+    MatchRunner::Stats ahead;
+    ahead.pairs = {0, 5, 30, 25, 5};
+    EXPECT_GT(MatchRunner::estimateElo(ahead).elo, 30.0);
+    EXPECT_GT(MatchRunner::logLikelihoodRatio(ahead, 0.0, 5.0), 0.0);
+    EXPECT_EQ(MatchRunner::logLikelihoodRatio(MatchRunner::Stats{}, 0.0, 5.0), 0.0);
+
+    const MatchRunner::Config config;
+    EXPECT_NEAR(MatchRunner::sprtUpperBound(config), std::log(19.0), 1e-9);
+    EXPECT_NEAR(MatchRunner::sprtLowerBound(config), -std::log(19.0), 1e-9);
+}
+
+TEST_F(MatchRunnerTest, PlaysEveryPairAndRestoresTheCallerBinding) {
+    const std::vector<std::string> openings = {
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "rnbqkb1r/pp1ppppp/5n2/2p5/2P5/5N2/PP1PPPPP/RNBQKB1R w KQkq - 2 3"};
+    const MatchRunner::Engine engine = MatchRunner::currentEngine("engine");
+    int reports = 0;
+    const MatchRunner::Stats stats = MatchRunner::run(
+        quickConfig(4), engine, engine, openings, [&](const MatchRunner::Stats&) { ++reports; });
+
+    EXPECT_EQ(stats.games(), 4);
+    EXPECT_EQ(reports, 2);
+    int pairs = 0;
+    for (const int count : stats.pairs) {
+        pairs += count;
+    }
+    EXPECT_EQ(pairs, 2);
+    EXPECT_EQ(ParamPack::current, &ParamPack::active);
+    EXPECT_EQ(PsqTable::current, &PsqTable::table);
+    EXPECT_EQ(TunableRegistry::threadValues, nullptr);
+}
+
+TEST_F(MatchRunnerTest, EnginesPlayWithTheirOwnParameters) {
+    MatchRunner::Engine test = MatchRunner::currentEngine("test");
+    MatchRunner::Engine base = MatchRunner::currentEngine("base");
+    // The baseline values every piece as a pawn and so gives its pieces away.
+    for (std::size_t piece = 1; piece < EvalTrace::PST_MG - EvalTrace::MATERIAL; ++piece) {
+        base.params[EvalTrace::MATERIAL + piece] = base.params[EvalTrace::MATERIAL];
+    }
+    const auto index = TunableRegistry::instance().indexOf("NULL_MOVE_R");
+    ASSERT_TRUE(index.has_value());
+    EXPECT_TRUE(TunableRegistry::instance().set(base.tunables, "NULL_MOVE_R", 2));
+    EXPECT_EQ(base.tunables[*index], 2);
+    EXPECT_FALSE(TunableRegistry::instance().set(base.tunables, "NULL_MOVE_R", 99));
+
+    const MatchRunner::Stats stats = MatchRunner::run(quickConfig(4), test, base, {});
+    EXPECT_EQ(stats.games(), 4);
+    EXPECT_GT(stats.wins, stats.losses);
+    EXPECT_EQ(ParamPack::active, ParamPack::defaults);
+}
@@ -0,0 +1,102 @@
+#include "ai/NeuralNetwork.h"
+#include "ai/QuantizedNetwork.h"
+#include "core/ChessBoard.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+const std::vector<std::string> kFens = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "8/5k2/8/3K4/8/8/2Q5/8 b - - 0 1",
+    "r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1",
+};
+} // namespace
+
+TEST(NeuralNetwork, EncodingUsesOneSlotPerPiece) {
+    Board board;
+    board.InitializeFromFEN(kFens[0]);
+    NeuralNetworkEvaluator nn;
+    const std::vector<float> encoding = nn.encodePosition(board);
+
+    EXPECT_EQ(std::count(encoding.begin(), encoding.end(), 1.0F), 32);
+    EXPECT_EQ(encoding[(8 * 12) + 0], 1.0F);
+    EXPECT_EQ(encoding[(60 * 12) + 6 + 5], 1.0F);
+}
+
+TEST(NeuralNetwork, QuantizedEvaluationTracksFloatModel) {
+    NeuralNetworkEvaluator nn;
+    for (const auto& fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        EXPECT_NEAR(nn.evaluateQuantized(board), nn.evaluatePosition(board), 5.0F) << fen;
+    }
+}
+
+TEST(NeuralNetwork, IncrementalAccumulatorMatchesRefresh) {
+    NeuralNetworkEvaluator nn;
+    QuantizedNetwork::Accumulator shared;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const auto& fen : kFens) {
+            Board board;
+            board.InitializeFromFEN(fen);
+            QuantizedNetwork::Accumulator fresh;
+            EXPECT_EQ(nn.evaluateQuantized(board, shared), nn.evaluateQuantized(board, fresh))
+                << fen;
+        }
+    }
+}
+
+namespace {
+std::vector<std::pair<Board, float>> makeTrainingData(std::size_t count) {
+    std::vector<std::pair<Board, float>> data(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        data[i].first.InitializeFromFEN(kFens[i % kFens.size()]);
+        data[i].second = static_cast<float>((static_cast<int>(i % kFens.size()) * 150) - 300);
+    }
+    return data;
+}
+
+NeuralNetworkEvaluator::NetworkConfig trainingConfig(int threads) {
+    NeuralNetworkEvaluator::NetworkConfig config;
+    config.batchSize = 64;
+    config.trainingThreads = threads;
+    return config;
+}
+} // namespace
+
+TEST(NeuralNetwork, MinibatchTrainingReducesLoss) {
+    NeuralNetworkEvaluator nn(trainingConfig(2));
+    const auto data = makeTrainingData(240);
+    const auto first = nn.train(data);
+    NeuralNetworkEvaluator::TrainingStats last;
+    for (int epoch = 0; epoch < 20; ++epoch) {
+        last = nn.train(data);
+    }
+
+    EXPECT_EQ(last.positions, data.size());
+    EXPECT_GT(last.positionsPerSecond, 0.0);
+    EXPECT_LT(last.averageLoss, first.averageLoss * 0.5F);
+}
+
+TEST(NeuralNetwork, TrainingIsIndependentOfThreadCount) {
+    NeuralNetworkEvaluator single(trainingConfig(1));
+    NeuralNetworkEvaluator parallel(trainingConfig(3));
+    const auto data = makeTrainingData(200);
+    for (int epoch = 0; epoch < 2; ++epoch) {
+        EXPECT_EQ(single.train(data).averageLoss, parallel.train(data).averageLoss);
+    }
+
+    for (const auto& fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        EXPECT_EQ(single.evaluatePosition(board), parallel.evaluatePosition(board)) << fen;
+    }
+}
@@ -4,25 +4,30 @@
 #include "evaluation/Evaluation.h"
 #include "evaluation/NNUE.h"
 #include "evaluation/NNUEBitboard.h"
+#include "evaluation/NetworkFile.h"
 #include "gtest/gtest.h"
+#include "protocol/uci.h"
 #include "search/search.h"
+#include "search/search_internal.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace {
-std::filesystem::path writeGeneratedNnueModel(int32_t outputBias = 64) {
-    const auto path = std::filesystem::temp_directory_path() / "generated-test.nnue";
+std::filesystem::path writeGeneratedNnueModel(int32_t outputBias = 64, bool patterned = false,
+                                              bool aligned = false) {
+    const auto path = std::filesystem::temp_directory_path() /
+                      (aligned ? "generated-test-aligned.nnue" : "generated-test.nnue");
     std::ofstream out(path, std::ios::binary | std::ios::trunc);
 
-    const int32_t magic = 0x4E4E5545;
-    const int32_t version = 1;
-    out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
-
     std::vector<int16_t> ftWeights(
         static_cast<std::size_t>(NNUE::INPUT_DIMENSIONS) * static_cast<std::size_t>(NNUE::L1_SIZE),
         0);
@@ -38,7 +43,35 @@ std::filesystem::path writeGeneratedNnueModel(int32_t outputBias = 64) {
     std::vector<int16_t> outputWeights(
         static_cast<std::size_t>(NNUE::L3_SIZE) * static_cast<std::size_t>(NNUE::OUTPUT_SIZE), 0);
     std::vector<int32_t> outputBiases(NNUE::OUTPUT_SIZE, outputBias);
+    if (patterned) {
+        for (std::size_t i = 0; i < ftWeights.size(); ++i) {
+            ftWeights[i] = static_cast<int16_t>(static_cast<int>((i * 37) % 23) - 11);
+        }
+        for (std::size_t i = 0; i < hidden1Weights.size(); ++i) {
+            hidden1Weights[i] = static_cast<int16_t>(static_cast<int>((i * 13) % 7) - 3);
+        }
+        std::fill(hidden2Weights.begin(), hidden2Weights.end(), int16_t{1});
+        std::fill(outputWeights.begin(), outputWeights.end(), int16_t{1});
+    }
+
+    if (aligned) {
+        NetworkFile::Writer writer(out);
+        writer.writeHeader(2);
+        writer.write(std::span<const int16_t>(ftWeights));
+        writer.write(std::span<const int32_t>(ftBiases));
+        writer.write(std::span<const int16_t>(hidden1Weights));
+        writer.write(std::span<const int32_t>(hidden1Biases));
+        writer.write(std::span<const int16_t>(hidden2Weights));
+        writer.write(std::span<const int32_t>(hidden2Biases));
+        writer.write(std::span<const int16_t>(outputWeights));
+        writer.write(std::span<const int32_t>(outputBiases));
+        return path;
+    }
 
+    const int32_t magic = 0x4E4E5545;
+    const int32_t version = 1;
+    out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
     out.write(reinterpret_cast<const char*>(ftWeights.data()),
               static_cast<std::streamsize>(ftWeights.size() * sizeof(int16_t)));
     out.write(reinterpret_cast<const char*>(ftBiases.data()),
@@ -60,24 +93,78 @@ std::filesystem::path writeGeneratedNnueModel(int32_t outputBias = 64) {
     return path;
 }
 
-std::filesystem::path writeGeneratedBitboardNnueModel() {
-    const auto path = std::filesystem::temp_directory_path() / "generated-test-bitboard.nnue";
+template <typename T> void writeValues(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+std::vector<T> patternedValues(std::size_t size, int mul, int mod, int scale) {
+    std::vector<T> values(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        const int offset = static_cast<int>((i * static_cast<std::size_t>(mul)) %
+                                            static_cast<std::size_t>(mod)) -
+                           (mod / 2);
+        values[i] = static_cast<T>(offset * scale);
+    }
+    return values;
+}
+
+std::filesystem::path writeGeneratedBitboardNnueModel(bool patterned = false,
+                                                      bool aligned = false) {
+    const auto path = std::filesystem::temp_directory_path() /
+                      (aligned ? "generated-test-bitboard-aligned.nnue"
+                               : "generated-test-bitboard.nnue");
     std::ofstream out(path, std::ios::binary | std::ios::trunc);
 
-    const uint32_t magic = 0x4E4E5545;
-    const uint32_t version = 2;
-    out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    NetworkFile::Writer writer(out);
+    const auto emit = [&](const auto& values) {
+        if (aligned) {
+            writer.write(std::span(values));
+        } else {
+            writeValues(out, values);
+        }
+    };
+    if (aligned) {
+        writer.writeHeader(4);
+    } else {
+        const uint32_t magic = 0x4E4E5545;
+        const uint32_t version = 3;
+        out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
 
-    std::vector<int16_t> featureWeights(static_cast<std::size_t>(NNUEBitboard::INPUT_DIMENSIONS) *
-                                            static_cast<std::size_t>(NNUEBitboard::L1_SIZE),
-                                        0);
-    out.write(reinterpret_cast<const char*>(featureWeights.data()),
-              static_cast<std::streamsize>(featureWeights.size() * sizeof(int16_t)));
+    const auto size = [](int in, int out) {
+        return static_cast<std::size_t>(in) * static_cast<std::size_t>(out);
+    };
+    const int scale = patterned ? 16 : 0;
+    const std::size_t featureCount = size(NNUEBitboard::INPUT_DIMENSIONS, NNUEBitboard::L1_SIZE);
+    emit(patternedValues<int16_t>(featureCount, 37, 23, scale));
+    emit(patternedValues<int16_t>(size(1, NNUEBitboard::L1_SIZE), 11, 23, scale));
+    const int layers[][2] = {{NNUEBitboard::COLOR_COUNT * NNUEBitboard::L1_SIZE,
+                              NNUEBitboard::L2_SIZE},
+                             {NNUEBitboard::L2_SIZE, NNUEBitboard::L3_SIZE},
+                             {NNUEBitboard::L3_SIZE, NNUEBitboard::L3_SIZE},
+                             {NNUEBitboard::L3_SIZE, NNUEBitboard::OUTPUT_SIZE}};
+    for (const auto& layer : layers) {
+        emit(patternedValues<int8_t>(size(layer[0], layer[1]), 13, 7, scale));
+        emit(std::vector<int32_t>(static_cast<std::size_t>(layer[1]), 0));
+    }
     out.close();
 
     return path;
 }
+
+const int16_t* bitboardAccumulation(const NNUEBitboard::Accumulator& acc, int perspective) {
+    return acc.getAccumulation(perspective);
+}
+
+bool sameAccumulation(const NNUEBitboard::Accumulator& lhs, const NNUEBitboard::Accumulator& rhs,
+                      int perspective) {
+    return std::equal(bitboardAccumulation(lhs, perspective),
+                      bitboardAccumulation(lhs, perspective) + NNUEBitboard::L1_SIZE,
+                      bitboardAccumulation(rhs, perspective));
+}
 } // namespace
 
 class NNUETest : public ::testing::Test {
@@ -123,6 +210,24 @@ TEST_F(NNUETest, FailedNnueInitDoesNotKeepEvaluatorAlive) {
     EXPECT_EQ(NNUE::globalEvaluator.get(), nullptr);
 }
 
+TEST_F(NNUETest, LoadedNetworkSurvivesEngineConstructionWithoutEmbeddedNetwork) {
+    const auto path = writeGeneratedBitboardNnueModel();
+    ASSERT_TRUE(NNUEBitboard::init(path.string()));
+    std::filesystem::remove(path);
+    const NNUEBitboard::NNUEEvaluator* loaded = NNUEBitboard::globalEvaluator.get();
+    if (!NetworkFile::embeddedNetwork().empty()) {
+        GTEST_SKIP() << "built with an embedded network";
+    }
+
+    EXPECT_FALSE(NNUEBitboard::initEmbedded());
+    EXPECT_FALSE(NNUE::initEmbedded());
+    EXPECT_EQ(NNUEBitboard::globalEvaluator.get(), loaded);
+
+    const UCIEngine engine;
+    EXPECT_EQ(NNUEBitboard::globalEvaluator.get(), loaded);
+    EXPECT_EQ(NNUE::globalEvaluator.get(), nullptr);
+}
+
 TEST_F(NNUETest, GeneratedModelLoadsAndDrivesEvaluation) {
     const auto path = writeGeneratedNnueModel();
     Board board;
@@ -153,3 +258,285 @@ TEST_F(NNUETest, GeneratedBitboardModelLoadsAndEvaluatesFromBoard) {
 
     std::filesystem::remove(path);
 }
+
+TEST_F(NNUETest, BitboardEvaluationIsWhiteRelativeForSearch) {
+    const auto path = writeGeneratedBitboardNnueModel(true);
+    ASSERT_TRUE(NNUEBitboard::init(path.string()));
+    std::filesystem::remove(path);
+    setNNUEEnabled(true);
+
+    Board board;
+    board.InitializeFromFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    Board mirrored;
+    mirrored.InitializeFromFEN(
+        "rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR b KQkq - 2 3");
+
+    const int white = evaluatePosition(board);
+    ASSERT_NE(white, 0);
+    EXPECT_EQ(evaluatePosition(mirrored), -white);
+
+    auto context = std::make_unique<ParallelSearchContext>(1);
+    const EvalWindow window = SearchInternal::lazyEvalWindow(
+        -SearchInternal::kMateScore, SearchInternal::kMateScore);
+    EXPECT_EQ(SearchInternal::evaluateForSearch(board, *context, window), white);
+    EXPECT_EQ(SearchInternal::evaluateForSearch(mirrored, *context, window), -white);
+}
+
+TEST_F(NNUETest, AccumulatorStackTracksSearchMakeUnmake) {
+    const auto path = writeGeneratedNnueModel(64, true);
+    ASSERT_TRUE(NNUE::init(path.string()));
+    std::filesystem::remove(path);
+
+    Board board;
+    board.InitializeFromFEN("r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+    auto context = std::make_unique<ParallelSearchContext>(1);
+
+    const auto expectMatchesRefresh = [&](const char* stage) {
+        NNUE::Accumulator fresh;
+        NNUE::globalEvaluator->initAccumulator(fresh);
+        fresh.refresh(board);
+        const NNUE::Accumulator& incremental =
+            context->nnueStack.current(board, *NNUE::globalEvaluator);
+        EXPECT_EQ(incremental.white, fresh.white) << stage;
+        EXPECT_EQ(incremental.black, fresh.black) << stage;
+        EXPECT_EQ(NNUE::evaluate(board, context->nnueStack), NNUE::evaluate(board)) << stage;
+    };
+
+    expectMatchesRefresh("root");
+    const std::vector<Move> moves = {{36, 43}, {60, 62}, {4, 6}, {61, 53}, {49, 56}};
+    std::vector<SearchInternal::MoveApplicationData> history(moves.size());
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        ASSERT_TRUE(SearchInternal::makeSearchMove(board, moves[i], history[i], *context)) << i;
+        board.turn = (board.turn == ChessPieceColor::WHITE) ? ChessPieceColor::BLACK
+                                                            : ChessPieceColor::WHITE;
+        expectMatchesRefresh("make");
+    }
+    EXPECT_EQ(context->nnueStack.ply(), moves.size());
+
+    for (std::size_t i = moves.size(); i > 0; --i) {
+        SearchInternal::unmakeSearchMove(board, history[i - 1], *context);
+        expectMatchesRefresh("unmake");
+    }
+    EXPECT_EQ(context->nnueStack.ply(), 0U);
+    EXPECT_EQ(context->nnueStack.refreshes(), 1U);
+}
+
+TEST_F(NNUETest, BitboardRefreshCacheMatchesFullRefresh) {
+    const auto path = writeGeneratedBitboardNnueModel(true);
+    ASSERT_TRUE(NNUEBitboard::init(path.string()));
+    std::filesystem::remove(path);
+    const NNUEBitboard::NNUEEvaluator& evaluator = *NNUEBitboard::globalEvaluator;
+
+    const std::vector<std::string> fens = {
+        "r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq - 0 1",
+        "r4rk1/1P6/8/3pP3/8/8/8/2KR3R w - - 0 2",
+        "r3k2r/8/8/3pP3/8/8/8/R3K2R b KQkq - 0 1",
+        "r4rk1/8/4P3/3p4/8/8/8/1K1R3R b - - 0 3",
+        "8/8/3k4/8/8/4K3/8/8 w - - 0 1",
+    };
+    NNUEBitboard::RefreshCache cache;
+    for (const auto& fen : fens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        const BitboardPosition pos = BitboardPosition::fromBoard(board);
+
+        NNUEBitboard::Accumulator fresh;
+        fresh.init(evaluator.weights(), evaluator.biases());
+        fresh.refresh(pos);
+        NNUEBitboard::Accumulator cached;
+        cached.init(evaluator.weights(), evaluator.biases());
+        for (int perspective = 0; perspective < NNUEBitboard::COLOR_COUNT; ++perspective) {
+            cache.refresh(cached, perspective, pos, evaluator);
+            EXPECT_TRUE(cached.isComputed(perspective));
+            EXPECT_TRUE(sameAccumulation(cached, fresh, perspective)) << fen;
+        }
+    }
+}
+
+TEST_F(NNUETest, BitboardAccumulatorStackTracksKingBuckets) {
+    const auto path = writeGeneratedBitboardNnueModel(true);
+    ASSERT_TRUE(NNUEBitboard::init(path.string()));
+    std::filesystem::remove(path);
+    setNNUEEnabled(true);
+
+    Board board;
+    board.InitializeFromFEN("r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq - 0 1");
+    auto context = std::make_unique<ParallelSearchContext>(1);
+
+    const auto expectMatchesRefresh = [&](const char* stage) {
+        NNUEBitboard::Accumulator fresh;
+        fresh.init(NNUEBitboard::globalEvaluator->weights(),
+                   NNUEBitboard::globalEvaluator->biases());
+        fresh.refresh(BitboardPosition::fromBoard(board));
+        const NNUEBitboard::Accumulator& incremental = context->nnueBitboardStack.current(
+            board, *NNUEBitboard::globalEvaluator, context->nnueRefreshCache);
+        for (int perspective = 0; perspective < NNUEBitboard::COLOR_COUNT; ++perspective) {
+            EXPECT_TRUE(sameAccumulation(incremental, fresh, perspective))
+                << stage << " perspective " << perspective;
+        }
+        EXPECT_EQ(NNUEBitboard::evaluate(board, context->nnueBitboardStack,
+                                         context->nnueRefreshCache),
+                  NNUEBitboard::evaluate(board))
+            << stage;
+    };
+
+    expectMatchesRefresh("root");
+    const std::vector<Move> moves = {{4, 2}, {60, 62}, {2, 1}, {62, 55}, {36, 44}, {49, 56}};
+    std::vector<SearchInternal::MoveApplicationData> history(moves.size());
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        ASSERT_TRUE(SearchInternal::makeSearchMove(board, moves[i], history[i], *context)) << i;
+        board.turn = (board.turn == ChessPieceColor::WHITE) ? ChessPieceColor::BLACK
+                                                            : ChessPieceColor::WHITE;
+        expectMatchesRefresh("make");
+    }
+    EXPECT_EQ(context->nnueBitboardStack.ply(), moves.size());
+
+    for (std::size_t i = moves.size(); i > 0; --i) {
+        SearchInternal::unmakeSearchMove(board, history[i - 1], *context);
+        expectMatchesRefresh("unmake");
+    }
+    EXPECT_EQ(context->nnueBitboardStack.ply(), 0U);
+    EXPECT_EQ(context->nnueBitboardStack.refreshes(), 6U);
+}
+
+TEST_F(NNUETest, BitboardSparseFirstLayerMatchesDenseForward) {
+    constexpr int kInputs = NNUEBitboard::COLOR_COUNT * NNUEBitboard::L1_SIZE;
+    constexpr int kOutputs = NNUEBitboard::L2_SIZE;
+    const std::vector<int8_t> weights = patternedValues<int8_t>(
+        static_cast<std::size_t>(kInputs) * static_cast<std::size_t>(kOutputs), 29, 255, 1);
+    const std::vector<int32_t> biases =
+        patternedValues<int32_t>(static_cast<std::size_t>(kOutputs), 7, 101, 3);
+
+    NNUEBitboard::LinearLayer dense(kInputs, kOutputs);
+    NNUEBitboard::LinearLayer sparse(kInputs, kOutputs, true);
+    dense.loadWeights(weights.data(), biases.data());
+    sparse.loadWeights(weights.data(), biases.data());
+
+    for (int density : {0, 3, 17, 64, 100}) {
+        alignas(NNUEBitboard::SIMD_ALIGN) std::array<int8_t, kInputs> input{};
+        for (int i = 0; i < kInputs; ++i) {
+            if ((i * 37) % 100 < density) {
+                input[static_cast<std::size_t>(i)] = static_cast<int8_t>((i * 13) % 128);
+            }
+        }
+        alignas(NNUEBitboard::SIMD_ALIGN) std::array<int32_t, kOutputs> expected{};
+        alignas(NNUEBitboard::SIMD_ALIGN) std::array<int32_t, kOutputs> actual{};
+        dense.forward(input.data(), expected.data());
+        sparse.forward(input.data(), actual.data());
+        EXPECT_EQ(actual, expected) << "density " << density;
+    }
+}
+
+TEST_F(NNUETest, FusedAccumulatorUpdateMatchesSingleFeatureUpdates) {
+    const auto path = writeGeneratedNnueModel(64, true);
+    ASSERT_TRUE(NNUE::init(path.string()));
+    std::filesystem::remove(path);
+
+    Board board;
+    board.InitializeFromFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    NNUE::Accumulator parent;
+    NNUE::globalEvaluator->initAccumulator(parent);
+    parent.refresh(board);
+
+    NNUE::Accumulator sequential;
+    NNUE::globalEvaluator->initAccumulator(sequential);
+    sequential.reset();
+    for (int sq = 0; sq < 64; ++sq) {
+        const Piece& piece = board.squares[sq].piece;
+        if (piece.PieceType != ChessPieceType::NONE) {
+            sequential.addFeature(NNUE::FeatureIndex::index(sq, piece.PieceType, piece.PieceColor));
+        }
+    }
+    EXPECT_EQ(sequential.white, parent.white);
+    EXPECT_EQ(sequential.black, parent.black);
+
+    const int added[] = {
+        NNUE::FeatureIndex::index(6, ChessPieceType::KING, ChessPieceColor::WHITE),
+        NNUE::FeatureIndex::index(5, ChessPieceType::ROOK, ChessPieceColor::WHITE)};
+    const int removed[] = {
+        NNUE::FeatureIndex::index(4, ChessPieceType::KING, ChessPieceColor::WHITE),
+        NNUE::FeatureIndex::index(7, ChessPieceType::ROOK, ChessPieceColor::WHITE)};
+    NNUE::Accumulator fused;
+    fused.update(parent, added, 2, removed, 2);
+    for (const int feature : removed) {
+        sequential.removeFeature(feature);
+    }
+    for (const int feature : added) {
+        sequential.addFeature(feature);
+    }
+    EXPECT_EQ(fused.white, sequential.white);
+    EXPECT_EQ(fused.black, sequential.black);
+}
+
+TEST_F(NNUETest, AlignedNetworkFormatMatchesPackedFormat) {
+    const auto packed = writeGeneratedNnueModel(64, true);
+    const auto aligned = writeGeneratedNnueModel(64, true, true);
+    EXPECT_EQ(std::filesystem::file_size(aligned) % NetworkFile::ALIGNMENT, 4U);
+
+    const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 2 3",
+    };
+    std::vector<int> expected;
+    ASSERT_TRUE(NNUE::init(packed.string()));
+    for (const auto& fen : fens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        expected.push_back(NNUE::evaluate(board));
+    }
+
+    ASSERT_TRUE(NNUE::init(aligned.string()));
+    for (std::size_t i = 0; i < fens.size(); ++i) {
+        Board board;
+        board.InitializeFromFEN(fens[i]);
+        EXPECT_EQ(NNUE::evaluate(board), expected[i]) << fens[i];
+    }
+
+    std::filesystem::resize_file(aligned, std::filesystem::file_size(aligned) - 1);
+    EXPECT_FALSE(NNUE::init(aligned.string()));
+    EXPECT_EQ(NNUE::globalEvaluator.get(), nullptr);
+
+    std::filesystem::remove(packed);
+    std::filesystem::remove(aligned);
+}
+
+TEST_F(NNUETest, AlignedBitboardNetworkMatchesPackedFormat) {
+    const auto packed = writeGeneratedBitboardNnueModel(true);
+    const auto aligned = writeGeneratedBitboardNnueModel(true, true);
+    Board board;
+    board.InitializeFromFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 2 3");
+
+    ASSERT_TRUE(NNUEBitboard::init(packed.string()));
+    const int expected = NNUEBitboard::evaluate(board);
+    ASSERT_TRUE(NNUEBitboard::init(aligned.string()));
+    EXPECT_EQ(NNUEBitboard::evaluate(board), expected);
+
+    std::filesystem::remove(packed);
+    std::filesystem::remove(aligned);
+}
+
+TEST_F(NNUETest, BatchEvaluationMatchesSingleEvaluation) {
+    const auto path = writeGeneratedNnueModel(64, true);
+    ASSERT_TRUE(NNUE::init(path.string()));
+    std::filesystem::remove(path);
+
+    const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 2 3",
+        "r3k2r/1P6/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1",
+        "8/5k2/8/3K4/8/8/2Q5/8 b - - 0 1",
+        "2r2rk1/pp1bqppp/2n1pn2/3p4/3P4/2NBPN2/PPQ2PPP/2R2RK1 w - - 4 12",
+    };
+    std::vector<Board> boards(203);
+    std::vector<int> expected(boards.size());
+    for (std::size_t i = 0; i < boards.size(); ++i) {
+        boards[i].InitializeFromFEN(fens[i % fens.size()]);
+        expected[i] = NNUE::evaluate(boards[i]);
+    }
+
+    for (const int threads : {1, 3}) {
+        std::vector<int> scores(boards.size(), -1);
+        NNUE::evaluateBatch(boards, scores, threads);
+        EXPECT_EQ(scores, expected) << threads;
+    }
+}
@@ -0,0 +1,127 @@
+#include "ai/NNUETrainer.h"
+#include "core/ChessBoard.h"
+#include "core/ChessPiece.h"
+#include "evaluation/NNUE.h"
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+constexpr const char* kStartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Start position with random non-king pieces removed, scored by material balance.
+std::vector<NNUETraining::Sample> makeSamples(std::size_t count) {
+    std::mt19937 rng(7U); // NOLINT(bugprone-random-generator-seed)
+    std::bernoulli_distribution keep(0.6);
+    std::vector<NNUETraining::Sample> samples(count);
+    for (auto& sample : samples) {
+        Board board;
+        board.InitializeFromFEN(kStartFen);
+        float material = 0.0F;
+        for (int sq = 0; sq < 64; ++sq) {
+            Piece& piece = board.squares[sq].piece;
+            if (piece.PieceType == ChessPieceType::NONE) {
+                continue;
+            }
+            if (piece.PieceType != ChessPieceType::KING && !keep(rng)) {
+                piece = Piece();
+                continue;
+            }
+            if (piece.PieceType != ChessPieceType::KING) {
+                const auto value = static_cast<float>(piece.PieceValue);
+                material += piece.PieceColor == ChessPieceColor::WHITE ? value : -value;
+            }
+        }
+        board.updateBitboards();
+        EXPECT_TRUE(NNUETraining::makeSample(board, material, 0.5F, sample));
+    }
+    return samples;
+}
+
+class VectorReader : public NNUETraining::SampleReader {
+public:
+    explicit VectorReader(const std::vector<NNUETraining::Sample>& samples) : samples(samples) {}
+
+    bool next(NNUETraining::Sample& sample) override {
+        if (position == samples.size()) {
+            return false;
+        }
+        sample = samples[position++];
+        return true;
+    }
+
+    bool rewind() override {
+        position = 0;
+        return true;
+    }
+
+private:
+    const std::vector<NNUETraining::Sample>& samples;
+    std::size_t position = 0;
+};
+
+NNUETraining::TrainerConfig trainerConfig(int threads) {
+    NNUETraining::TrainerConfig config;
+    config.batchSize = 128;
+    config.threads = threads;
+    config.shuffleWindow = 512;
+    return config;
+}
+} // namespace
+
+TEST(NNUETrainer, SampleRoundTripsThroughBoard) {
+    Board board;
+    board.InitializeFromFEN(kStartFen);
+    NNUETraining::Sample sample;
+    ASSERT_TRUE(NNUETraining::makeSample(board, 25.0F, 1.0F, sample));
+    EXPECT_EQ(sample.featureCount, 32);
+
+    const Board rebuilt = NNUETraining::sampleBoard(sample);
+    for (int sq = 0; sq < 64; ++sq) {
+        EXPECT_EQ(rebuilt.squares[sq].piece.PieceType, board.squares[sq].piece.PieceType) << sq;
+        EXPECT_EQ(rebuilt.squares[sq].piece.PieceColor, board.squares[sq].piece.PieceColor) << sq;
+    }
+    EXPECT_EQ(rebuilt.allPieces, board.allPieces);
+}
+
+TEST(NNUETrainer, ExportedNetworkMatchesFloatModel) {
+    const auto samples = makeSamples(1024);
+    VectorReader reader(samples);
+    NNUETraining::Trainer trainer(trainerConfig(2));
+    const auto first = trainer.trainEpoch(reader);
+    NNUETraining::EpochStats last;
+    for (int epoch = 0; epoch < 15; ++epoch) {
+        last = trainer.trainEpoch(reader);
+    }
+    EXPECT_EQ(last.positions, samples.size());
+    EXPECT_LT(last.averageLoss, first.averageLoss * 0.5F);
+
+    const auto path = std::filesystem::temp_directory_path() / "trained-test.nnue";
+    ASSERT_TRUE(trainer.exportNetwork(path.string()));
+    NNUE::NNUEEvaluator evaluator;
+    ASSERT_TRUE(evaluator.loadNetwork(path.string()));
+
+    const auto check = trainer.validate(evaluator, samples);
+    EXPECT_EQ(check.positions, samples.size());
+    EXPECT_LT(check.meanAbsError, 1.0);
+    EXPECT_LT(check.maxAbsError, 3.0);
+    std::filesystem::remove(path);
+}
+
+TEST(NNUETrainer, TrainingIsIndependentOfThreadCount) {
+    const auto samples = makeSamples(640);
+    NNUETraining::Trainer single(trainerConfig(1));
+    NNUETraining::Trainer parallel(trainerConfig(3));
+    const std::span<const NNUETraining::Sample> all(samples);
+    for (std::size_t i = 0; i < samples.size(); i += 160) {
+        EXPECT_EQ(single.trainBatch(all.subspan(i, 160)), parallel.trainBatch(all.subspan(i, 160)));
+    }
+    for (std::size_t i = 0; i < samples.size(); i += 37) {
+        EXPECT_EQ(single.predict(samples[i]), parallel.predict(samples[i])) << i;
+    }
+}
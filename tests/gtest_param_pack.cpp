@@ -0,0 +1,126 @@
+#include "core/ChessBoard.h"
+#include "evaluation/EvalTrace.h"
+#include "evaluation/Evaluation.h"
+#include "evaluation/EvaluationTuning.h"
+#include "evaluation/ParamPack.h"
+#include "test_helpers.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <string>
+
+namespace {
+constexpr const char* kMiddlegameFen =
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 b - - 0 10";
+constexpr const char* kExtraBishopFen = "4k3/ppp5/8/8/8/8/PPP5/2B1K3 w - - 0 1";
+
+int evaluateFen(const std::string& fen) {
+    Board board;
+    board.InitializeFromFEN(fen);
+    return evaluatePosition(board);
+}
+} // namespace
+
+class ParamPackTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+    }
+
+    void TearDown() override {
+        ParamPack::apply(ParamPack::defaults);
+    }
+};
+
+TEST_F(ParamPackTest, DefaultsAreTheCompiledValues) {
+    EXPECT_EQ(ParamPack::active, ParamPack::defaults);
+    EXPECT_EQ(ParamPack::defaults[EvalTrace::MATERIAL + 4], EvaluationParams::QUEEN_VALUE);
+    EXPECT_EQ(ParamPack::defaults.pieceSquare(ChessPieceType::KNIGHT, 27, false),
+              EvaluationParams::TUNED_KNIGHT_MG[27]);
+    EXPECT_EQ(ParamPack::defaults.pieceSquare(ChessPieceType::KING, 0, true),
+              EvaluationParams::TUNED_KING_EG[0]);
+    EXPECT_EQ(ParamPack::defaults[EvalTrace::KING_SEMI_OPEN_FILE],
+              KING_SAFETY_SEMI_OPEN_FILE_PENALTY);
+    EXPECT_EQ(ParamPack::defaults[EvalTrace::TEMPO], EvaluationParams::TEMPO_BONUS);
+}
+
+TEST_F(ParamPackTest, SaveLoadRoundTrip) {
+    ParamPack::Pack pack = ParamPack::defaults;
+    pack[EvalTrace::PST_EG + 5] = -321;
+    pack[EvalTrace::TEMPO] = 17;
+    const auto path = std::filesystem::temp_directory_path() / "param-pack.bin";
+    ASSERT_TRUE(ParamPack::save(pack, path.string()));
+
+    const auto loaded = ParamPack::load(path.string());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(*loaded, pack);
+    std::filesystem::remove(path);
+
+    pack[EvalTrace::BISHOP_PAIR] = 40000;
+    EXPECT_FALSE(ParamPack::save(pack, path.string()));
+}
+
+TEST_F(ParamPackTest, LoadRejectsOtherLayouts) {
+    const auto path = std::filesystem::temp_directory_path() / "param-pack-bad.bin";
+    ASSERT_TRUE(ParamPack::save(ParamPack::defaults, path.string()));
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    const auto rewrite = [&path](const std::string& contents) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    };
+
+    std::string badMagic = bytes;
+    badMagic[0] = 'X';
+    rewrite(badMagic);
+    EXPECT_FALSE(ParamPack::load(path.string()).has_value());
+
+    std::string badCount = bytes;
+    badCount[8] = static_cast<char>(badCount[8] + 1);
+    rewrite(badCount);
+    EXPECT_FALSE(ParamPack::load(path.string()).has_value());
+
+    rewrite(bytes.substr(0, bytes.size() - 1));
+    EXPECT_FALSE(ParamPack::load(path.string()).has_value());
+
+    rewrite(bytes + '\0');
+    EXPECT_FALSE(ParamPack::load(path.string()).has_value());
+
+    EXPECT_FALSE(ParamPack::load(path.string() + ".missing").has_value());
+    std::filesystem::remove(path);
+}
+
+TEST_F(ParamPackTest, ApplyChangesTheEvaluation) {
+    const int baseline = evaluateFen(kMiddlegameFen);
+    const int extraBishop = evaluateFen(kExtraBishopFen);
+
+    ParamPack::Pack pack = ParamPack::defaults;
+    pack[EvalTrace::MATERIAL + 2] += 50;
+    ParamPack::apply(pack);
+    EXPECT_GT(evaluateFen(kExtraBishopFen), extraBishop);
+
+    pack = ParamPack::defaults;
+    pack[EvalTrace::TEMPO] += 20;
+    ParamPack::apply(pack);
+    EXPECT_NE(evaluateFen(kMiddlegameFen), baseline);
+
+    ParamPack::apply(ParamPack::defaults);
+    EXPECT_EQ(evaluateFen(kMiddlegameFen), baseline);
+}
+
+TEST_F(ParamPackTest, TunerStartsFromTheActivePack) {
+    ParamPack::Pack pack = ParamPack::defaults;
+    pack[EvalTrace::ROOK_OPEN_FILE] = 33;
+    ParamPack::apply(pack);
+
+    TexelTuner tuner(1);
+    EXPECT_EQ(tuner.param(EvalTrace::ROOK_OPEN_FILE), 33);
+    EXPECT_EQ(tuner.pack(), pack);
+}
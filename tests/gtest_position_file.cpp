@@ -0,0 +1,169 @@
+#include "ai/NNUETrainer.h"
+#include "ai/NeuralNetwork.h"
+#include "ai/PositionFile.h"
+#include "core/ChessBoard.h"
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+const std::vector<std::string> kFens = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r3k2r/1P6/8/3pP3/8/8/8/R3K2R w Kq d6 0 41",
+    "8/5k2/8/3K4/8/8/2Q5/8 b - - 17 80",
+};
+
+std::vector<PositionFile::PackedPosition> selfPlayPositions() {
+    TrainingDataGenerator generator;
+    std::vector<PositionFile::PackedPosition> positions;
+    for (const auto& example : generator.generateSelfPlayData(12, 80)) {
+        PositionFile::PackedPosition packed;
+        EXPECT_TRUE(PositionFile::PackedPosition::pack(
+            example.position, static_cast<int>(example.targetScore), example.gameResult, packed));
+        positions.push_back(packed);
+    }
+    return positions;
+}
+
+std::filesystem::path writePositions(std::span<const PositionFile::PackedPosition> positions,
+                                     const PositionFile::WriterOptions& options,
+                                     const std::string& name) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    PositionFile::Writer writer(path.string(), options);
+    EXPECT_TRUE(writer.isOpen());
+    writer.write(positions);
+    EXPECT_EQ(writer.positions(), positions.size());
+    EXPECT_TRUE(writer.close());
+    return path;
+}
+
+bool samePosition(const PositionFile::PackedPosition& a, const PositionFile::PackedPosition& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+} // namespace
+
+TEST(PositionFile, PackedPositionRoundTripsThroughFen) {
+    for (const auto& fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        PositionFile::PackedPosition packed;
+        ASSERT_TRUE(PositionFile::PackedPosition::pack(board, -250, 1.0F, packed)) << fen;
+        EXPECT_EQ(packed.score, -250);
+        EXPECT_EQ(packed.gameResult(), 1.0F);
+
+        Board unpacked;
+        packed.unpack(unpacked);
+        EXPECT_EQ(unpacked.toFEN(), board.toFEN()) << fen;
+        EXPECT_EQ(unpacked.allPieces, board.allPieces) << fen;
+    }
+}
+
+TEST(PositionFile, ScoresAndResultsAreClamped) {
+    Board board;
+    board.InitializeFromFEN(kFens[0]);
+    PositionFile::PackedPosition packed;
+    ASSERT_TRUE(PositionFile::PackedPosition::pack(board, 100000, 0.3F, packed));
+    EXPECT_EQ(packed.score, 32767);
+    EXPECT_EQ(packed.gameResult(), 0.5F);
+    ASSERT_TRUE(PositionFile::PackedPosition::pack(board, -100000, -1.0F, packed));
+    EXPECT_EQ(packed.score, -32767);
+    EXPECT_EQ(packed.gameResult(), 0.0F);
+}
+
+TEST(PositionFile, ReaderReturnsWrittenPositions) {
+    const auto positions = selfPlayPositions();
+    ASSERT_GT(positions.size(), 300U);
+    for (const bool compress : {false, true}) {
+        PositionFile::WriterOptions options;
+        options.compress = compress;
+        options.chunkPositions = 100;
+        options.threads = 3;
+        const auto path = writePositions(positions, options, "positions-test.packed");
+
+        PositionFile::Reader reader;
+        ASSERT_TRUE(reader.open(path.string()));
+        EXPECT_EQ(reader.size(), positions.size());
+        for (int pass = 0; pass < 2; ++pass) {
+            reader.rewind();
+            PositionFile::PackedPosition read;
+            std::size_t count = 0;
+            while (reader.next(read)) {
+                ASSERT_LT(count, positions.size());
+                EXPECT_TRUE(samePosition(read, positions[count])) << count;
+                ++count;
+            }
+            EXPECT_EQ(count, positions.size()) << compress;
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(PositionFile, CompressionShrinksGameSequences) {
+    const auto positions = selfPlayPositions();
+    PositionFile::WriterOptions raw;
+    raw.compress = false;
+    const auto rawPath = writePositions(positions, raw, "positions-raw.packed");
+    const auto packedPath = writePositions(positions, {}, "positions-compressed.packed");
+
+    EXPECT_LT(std::filesystem::file_size(packedPath), std::filesystem::file_size(rawPath) / 2);
+    std::filesystem::remove(rawPath);
+    std::filesystem::remove(packedPath);
+}
+
+TEST(PositionFile, TruncatedFileStopsAtLastCompleteChunk) {
+    const auto positions = selfPlayPositions();
+    PositionFile::WriterOptions options;
+    options.compress = false;
+    options.chunkPositions = 64;
+    const auto path = writePositions(positions, options, "positions-truncated.packed");
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+
+    PositionFile::Reader reader;
+    ASSERT_TRUE(reader.open(path.string()));
+    const std::size_t complete = ((positions.size() - 1) / 64) * 64;
+    EXPECT_EQ(reader.size(), complete);
+    PositionFile::PackedPosition read;
+    std::size_t count = 0;
+    while (reader.next(read)) {
+        ++count;
+    }
+    EXPECT_EQ(count, complete);
+    std::filesystem::remove(path);
+}
+
+TEST(PositionFile, PackedSamplesMatchBoardSamples) {
+    std::vector<PositionFile::PackedPosition> positions;
+    for (const auto& fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        ASSERT_TRUE(PositionFile::PackedPosition::pack(board, 40, 0.0F, positions.emplace_back()));
+    }
+    const auto path = writePositions(positions, {}, "positions-samples.packed");
+
+    const auto reader = NNUETraining::openSampleFile(path.string());
+    ASSERT_NE(reader, nullptr);
+    for (const auto& fen : kFens) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        NNUETraining::Sample expected;
+        ASSERT_TRUE(NNUETraining::makeSample(board, 40.0F, 0.0F, expected));
+        NNUETraining::Sample sample;
+        ASSERT_TRUE(reader->next(sample));
+        ASSERT_EQ(sample.featureCount, expected.featureCount) << fen;
+        for (int k = 0; k < sample.featureCount; ++k) {
+            EXPECT_EQ(sample.features[k], expected.features[k]) << fen;
+        }
+        EXPECT_EQ(sample.score, 40.0F);
+        EXPECT_EQ(sample.result, 0.0F);
+    }
+    NNUETraining::Sample extra;
+    EXPECT_FALSE(reader->next(extra));
+    std::filesystem::remove(path);
+}
@@ -5,6 +5,7 @@
 #include "search/search_internal.h"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 
 namespace {
@@ -22,9 +23,12 @@ protected:
 
         const std::string originalFen = board.toFEN();
         const uint64_t originalHash = ComputeZobrist(board);
+        const PackedScore originalPsqScore = board.psqScore;
+        EXPECT_EQ(originalPsqScore, computePsqScore(board));
 
         SearchInternal::MoveApplicationData moveData{};
         ASSERT_TRUE(SearchInternal::applySearchMoveWithData(board, from, to, true, &moveData));
+        EXPECT_EQ(board.psqScore, computePsqScore(board));
 
         const uint64_t childHash =
             SearchInternal::computeChildZobrist(originalHash, board, from, to, moveData);
@@ -35,6 +39,7 @@ protected:
         SearchInternal::undoSearchMoveWithData(board, moveData);
         EXPECT_EQ(board.toFEN(), originalFen);
         EXPECT_EQ(ComputeZobrist(board), originalHash);
+        EXPECT_EQ(board.psqScore, originalPsqScore);
     }
 };
 } // namespace
@@ -58,3 +63,20 @@ TEST_F(SearchInvariantTest, CastlingRoundTripPreservesFenAndHash) {
 TEST_F(SearchInvariantTest, PromotionRoundTripPreservesFenAndHash) {
     expectRoundTrip("4k3/P7/8/8/8/8/8/4K3 w - - 0 1", 48, 56);
 }
+
+TEST_F(SearchInvariantTest, EvalCacheReturnsStoredEvaluation) {
+    Board board;
+    board.InitializeFromFEN("r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9");
+    ParallelSearchContext context(1);
+    const uint64_t key = ComputeZobrist(board);
+
+    const int uncached = evaluatePosition(board);
+    EXPECT_EQ(SearchInternal::evaluateForSearch(board, context, key), uncached);
+    EXPECT_EQ(SearchInternal::evaluateForSearch(board, context, key), uncached);
+    EXPECT_EQ(context.evalCache.stats().probes, 2U);
+    EXPECT_EQ(context.evalCache.stats().hits, 1U);
+
+    EXPECT_FALSE(context.evalCache.probe(key ^ 0xFFFF0000ULL).has_value());
+    context.evalCache.store(key, -1234);
+    EXPECT_EQ(context.evalCache.probe(key), std::optional<int>(-1234));
+}
@@ -0,0 +1,102 @@
+#include "ai/Spsa.h"
+#include "test_helpers.h"
+#include "utils/TunableParams.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+Spsa::Config quickConfig() {
+    Spsa::Config config;
+    config.iterations = 2;
+    config.pairsPerIteration = 1;
+    config.trajectoryInterval = 1;
+    config.match.threads = 1;
+    config.match.nodes = 200;
+    config.match.hashMb = 1;
+    config.match.maxPlies = 60;
+    return config;
+}
+} // namespace
+
+class SpsaTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+    }
+};
+
+TEST_F(SpsaTest, RegisteredParamsFollowTheRegistry) {
+    const auto defaults = Spsa::registeredParams();
+    ASSERT_TRUE(defaults.has_value());
+    ASSERT_EQ(defaults->size(), Spsa::defaultParamNames().size());
+    for (std::size_t i = 0; i < defaults->size(); ++i) {
+        EXPECT_EQ((*defaults)[i].name, Spsa::defaultParamNames()[i]);
+    }
+    EXPECT_TRUE(std::ranges::none_of(
+        *defaults, [](const Spsa::Param& param) { return param.name == "SE_MARGIN_BASE"; }));
+
+    const auto named = Spsa::registeredParams({"NULL_MOVE_R"});
+    ASSERT_TRUE(named.has_value());
+    ASSERT_EQ(named->size(), 1U);
+    EXPECT_EQ((*named)[0].index, *TunableRegistry::instance().indexOf("NULL_MOVE_R"));
+    EXPECT_EQ((*named)[0].value, (*named)[0].defaultValue);
+
+    EXPECT_FALSE(Spsa::registeredParams({"NULL_MOVE_R", "NOT_A_PARAMETER"}).has_value());
+}
+
+TEST_F(SpsaTest, IterationsStayInRangeAndResumeFromCheckpoint) {
+    const auto params = Spsa::registeredParams({"NULL_MOVE_R", "LMR_BASE"});
+    ASSERT_TRUE(params.has_value());
+    Spsa::State state;
+    state.params = *params;
+
+    Spsa::Tuner tuner(quickConfig(), state);
+    tuner.iterate({});
+    tuner.iterate({});
+    const Spsa::State& tuned = tuner.state();
+    EXPECT_EQ(tuned.iteration, 2);
+    EXPECT_EQ(tuned.wins + tuned.draws + tuned.losses, 4);
+    ASSERT_EQ(tuned.trajectory.size(), 3U);
+    for (const Spsa::Param& param : tuned.params) {
+        EXPECT_GE(param.value, param.minValue);
+        EXPECT_LE(param.value, param.maxValue);
+    }
+
+    const auto checkpoint = std::filesystem::temp_directory_path() / "spsa-test.checkpoint";
+    ASSERT_TRUE(Spsa::saveCheckpoint(tuned, checkpoint.string()));
+    const auto loaded = Spsa::loadCheckpoint(checkpoint.string(), *params);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->iteration, tuned.iteration);
+    EXPECT_EQ(loaded->wins, tuned.wins);
+    EXPECT_EQ(loaded->trajectory.size(), tuned.trajectory.size());
+    for (std::size_t i = 0; i < tuned.params.size(); ++i) {
+        EXPECT_NEAR(loaded->params[i].value, tuned.params[i].value, 1e-6);
+    }
+    EXPECT_FALSE(Spsa::loadCheckpoint(checkpoint.string(), *Spsa::registeredParams({"LMR_BASE"}))
+                     .has_value());
+    std::filesystem::remove(checkpoint);
+}
+
+TEST_F(SpsaTest, JsonListsEveryParameter) {
+    const auto params = Spsa::registeredParams({"NULL_MOVE_R"});
+    ASSERT_TRUE(params.has_value());
+    Spsa::State state;
+    state.params = *params;
+    state.trajectory.push_back(Spsa::Sample{0, {state.params[0].value}});
+
+    const auto path = std::filesystem::temp_directory_path() / "spsa-test.json";
+    ASSERT_TRUE(Spsa::writeJson(quickConfig(), state, path.string()));
+    std::ifstream in(path);
+    std::stringstream json;
+    json << in.rdbuf();
+    EXPECT_NE(json.str().find("\"benchmark\": \"spsa_tune\""), std::string::npos);
+    EXPECT_NE(json.str().find("{\"id\": \"NULL_MOVE_R\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"trajectory\""), std::string::npos);
+    std::filesystem::remove(path);
+}
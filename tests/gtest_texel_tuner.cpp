@@ -0,0 +1,123 @@
+#include "core/ChessBoard.h"
+#include "evaluation/EvalTrace.h"
+#include "evaluation/Evaluation.h"
+#include "evaluation/EvaluationTuning.h"
+#include "test_helpers.h"
+
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+const std::vector<std::pair<std::string, double>> kPositions = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0.5},
+    {"r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3", 0.5},
+    {"rnbqkb1r/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 1.0},
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNB1KBNR w KQkq - 0 1", 0.0},
+    {"8/5k2/8/3K4/8/8/2Q5/8 b - - 17 80", 1.0},
+    {"8/8/4k3/8/8/3K4/2r5/8 w - - 0 60", 0.0},
+    {"4k3/8/8/8/8/8/4P3/4K3 w - - 0 50", 0.5},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 0.5},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 b - - 0 10", 0.5},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 0.0},
+    {"8/8/8/4k3/8/8/8/4KB2 w - - 0 1", 0.5},
+};
+
+std::filesystem::path writePositions(const std::vector<std::string>& lines,
+                                     const std::string& name) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path);
+    for (const auto& line : lines) {
+        out << line << '\n';
+    }
+    return path;
+}
+
+void addPositions(TexelTuner& tuner, int copies) {
+    for (const auto& [fen, result] : kPositions) {
+        Board board;
+        board.InitializeFromFEN(fen);
+        for (int i = 0; i < copies; ++i) {
+            tuner.addPosition(board, result);
+        }
+    }
+}
+
+} // namespace
+
+class TexelTunerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initEngineForTests();
+    }
+};
+
+TEST_F(TexelTunerTest, TraceReproducesEvaluation) {
+    TexelTuner tuner(1);
+    addPositions(tuner, 1);
+    ASSERT_EQ(tuner.size(), kPositions.size());
+    for (std::size_t i = 0; i < kPositions.size(); ++i) {
+        Board board;
+        board.InitializeFromFEN(kPositions[i].first);
+        EvalTrace::Recorder recorder;
+        const int score = evaluatePosition(board);
+        EXPECT_EQ(traceEvaluation(board, recorder), score) << kPositions[i].first;
+        // The engine rounds each scaled component separately.
+        EXPECT_NEAR(tuner.evaluate(i), score, 2.0) << kPositions[i].first;
+    }
+}
+
+TEST_F(TexelTunerTest, DefaultParamsAreTheEngineValues) {
+    TexelTuner tuner(1);
+    EXPECT_EQ(tuner.param(EvalTrace::MATERIAL + 1), EvaluationParams::KNIGHT_VALUE);
+    EXPECT_EQ(tuner.param(EvalTrace::PST_EG + 63), EvaluationParams::TUNED_PAWN_EG[63]);
+    EXPECT_EQ(tuner.param(EvalTrace::KING_OPEN_FILE), KING_SAFETY_OPEN_FILE_PENALTY);
+    EXPECT_EQ(tuner.param(EvalTrace::TEMPO), EvaluationParams::TEMPO_BONUS);
+
+    const auto path = std::filesystem::temp_directory_path() / "texel-export.txt";
+    tuner.exportParams(path.string());
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    EXPECT_NE(text.str().find("constexpr int TEMPO_BONUS = 10;"), std::string::npos);
+    EXPECT_NE(text.str().find("constexpr PieceSquareTable TUNED_KING_EG = {\n    -74, -35,"),
+              std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST_F(TexelTunerTest, LoadSkipsMalformedLines) {
+    const auto path = writePositions({kPositions[0].first + ";1-0", kPositions[2].first + ", 0.75",
+                                      kPositions[3].first + ";0-1", kPositions[4].first + ";draw",
+                                      "not a fen;1/2-1/2", "", kPositions[1].first + ";1/2-1/2"},
+                                     "texel-load.txt");
+    TexelTuner tuner(2);
+    ASSERT_TRUE(tuner.loadPositions(path.string()));
+    EXPECT_EQ(tuner.size(), 4U);
+    std::filesystem::remove(path);
+
+    TexelTuner missing(1);
+    EXPECT_FALSE(missing.loadPositions(path.string()));
+}
+
+TEST_F(TexelTunerTest, OptimizeReducesErrorIndependentOfThreads) {
+    TexelTuner single(1);
+    TexelTuner parallel(3);
+    // More positions than one gradient chunk, so the parallel run splits the batch.
+    addPositions(single, 3000);
+    addPositions(parallel, 3000);
+
+    single.optimize(0);
+    const double initial = single.computeError();
+    single.optimize(30);
+    parallel.optimize(30);
+    EXPECT_LT(single.computeError(), initial);
+    EXPECT_EQ(single.computeError(), parallel.computeError());
+    for (std::size_t param = 0; param < EvalTrace::PARAM_COUNT; ++param) {
+        ASSERT_EQ(single.param(param), parallel.param(param)) << param;
+    }
+}
@@ -207,3 +207,15 @@ TEST(UCI, SearchStillWorksAfterOptionUpdates) {
     const std::string output = capture.str();
     EXPECT_NE(output.find("bestmove "), std::string::npos);
 }
+
+TEST(UCI, BenchReportsNodesAndSpeed) {
+    UCIEngine engine;
+    UciOutputCapture capture;
+
+    engine.processCommand("bench 1 1 1");
+
+    const std::string output = capture.str();
+    EXPECT_NE(output.find("Position 50/50: "), std::string::npos) << output;
+    EXPECT_NE(output.find("Nodes searched  : "), std::string::npos) << output;
+    EXPECT_NE(output.find("Nodes/second    : "), std::string::npos) << output;
+}